@@ -2,14 +2,6 @@
 #include <iostream>
 #include <algorithm>
 #include <cmath>
-#include "../Attitude_Control/src/Attitude_Control_System.cpp"
-#include "../Attitude_Control/src/motor.cpp"
-#include "../Attitude_Control/src/control_wheels.cpp"
-#include "../Ridged_Body/src/Ridged_Body.cpp"
-#include "../Ridged_Body/src/Satellite_Box.cpp"
-
-#include "../Propulsion/src/Propulsion_System_PIC2D.cpp"
-#include "../Propulsion/src/hall_thruster_PIC2D.cpp"
 
 using namespace std;
 
@@ -65,20 +57,23 @@ double angle_between_vectors(const double* A, const double* B) {
     return std::acos(val);  // angle in radians, [0, pi]
 }
 
-ACS_Sim::ACS_Sim(double timestep, double max_time)
-    : Sim_Object(timestep, max_time) {}
+ACS_Sim::ACS_Sim(double timestep, double max_time, const ACS_Sim_params& p)
+    : Sim_Object(timestep, max_time), integrator(ODE_RK4), params(p) {}
+
+const ACS_Sim_summary& ACS_Sim::get_summary() const {
+    return summary;
+}
 
 void ACS_Sim::initialize() {
-    for (int i = 0; i < 3; i++) {
-        I[i] = 0;
-        w[i] = 0;
-        dI[i] = 0;
-        dw[i] = 0;
+    wheels.set_layout(params.layout);
+    if (params.failed_wheel >= 0) wheels.fail_wheel(params.failed_wheel);
 
+    for (int i = 0; i < 3; i++) {
         //PID controller
-        Kp[i] = 8.0;
-        Ki[i] = 0.05;
-        Kd[i] = 0.3;
+        Kp[i] = params.Kp[i];
+        Ki[i] = params.Ki[i];
+        Kd[i] = params.Kd[i];
+        integral[i] = 0;
         prev_error[i] = 0;
     }
 
@@ -91,9 +86,9 @@ void ACS_Sim::initialize() {
     //thruster initialization
         // Initialize velocity PID
         for (int i = 0; i < 3; ++i) {
-            Kp_v[i] = 10.0;
-            Ki_v[i] = 0.5;
-            Kd_v[i] = 1.0;
+            Kp_v[i] = params.Kp_v[i];
+            Ki_v[i] = params.Ki_v[i];
+            Kd_v[i] = params.Kd_v[i];
             velocity_integral[i] = 0.0;
             velocity_error_prev[i] = 0.0;
     
@@ -102,6 +97,7 @@ void ACS_Sim::initialize() {
     
         // Initialize propulsion
         propulsion = Propulsion_System_PIC2D(2.0, 2.0, 2.0, 0.5, 1.0);
+        propulsion.set_verbose(verbose);
         double orientation[3] = {0, 0, -1};  // Example thrust direction
         double pos[3];
         double R[3][3];
@@ -109,19 +105,34 @@ void ACS_Sim::initialize() {
         Sattelite_Body.get_R(R);
         propulsion.set_all_thruster_ref_ori(orientation);
         propulsion.update_all_pos_ori(pos, R);
+        propulsion.set_seed(params.seed);
         propulsion.initialize_all_HET_sim();
         propulsion.turn_all_on();
     
 
     //Body initialization
-    Sattelite_Body.initialize_body(1, 0.5);
+    Sattelite_Body.initialize_body(params.mass, params.side_length);
     Sattelite_Body.get_R(R_matrix);
     Sattelite_Body.get_w(Sat_w);
     Sattelite_Body.get_Qori(Sat_q);
+
+    summary = ACS_Sim_summary();
+    initial_tankmass = propulsion.get_current_tankmass();
+    for (int i = 0; i < 3; i++) net_force[i] = 0.0;
+
+    // The wheels declare their stiffness, the propulsion its rate
+    scheduler = multi_rate_scheduler();
+    scheduler.add_task([this](double, double h) { control_attitude(h); });
+    scheduler.add_task([this](double t, double h) { wheels.propagate(integrator, t, h); }, 1, wheels.get_max_step());
+    scheduler.add_task([this](double, double h) { step_body(h); });
+    scheduler.add_task([this](double, double h) { step_propulsion(h); }, params.propulsion_divisor);
 }
 
-void ACS_Sim::update(double delta) {
-    double curr_j_axis[3];
+void ACS_Sim::control_attitude(double delta)
+    //Description:      Attitude PID on the error of the body y axis, its three axis voltages allocated over the wheels
+    //Preconditions:    delta is the control period
+    //Postconditions:   Wheel voltages set, held until the next control step
+{
     double target_ref_vec[3] = {target_vec[0], target_vec[1], target_vec[2]};
     double error[3], derivative[3];
     double vec_errors[3];
@@ -169,12 +180,11 @@ void ACS_Sim::update(double delta) {
     error_around_axis[1] = error[2] * error[0]; //error around y
 
     // Print raw angle errors for debugg
-    std::cout << "Angle Errors (rad): X: " << error_around_axis[0] //e_x
+    if (verbose) std::cout << "Angle Errors (rad): X: " << error_around_axis[0] //e_x
               << ", Y: " << error_around_axis[1] //e_y
               << ", Z: " << error_around_axis[2] << "\n"; // e_z
 
     // PID loop
-    double V_in[3];
 
     for (int i = 0; i < 3; i++) {
         //error[i] = error[i] / 3.14;
@@ -185,69 +195,48 @@ void ACS_Sim::update(double delta) {
 
         V_in[i] = Kp[i]*error_around_axis[i] + Ki[i]*integral[i] + Kd[i]*derivative[i];
 
-        cout << "<<<<<<<<<< == " << V_in[i] << "== >>>>>>>>>>> \n";
+        if (verbose) cout << "<<<<<<<<<< == " << V_in[i] << "== >>>>>>>>>>> \n";
         V_in[i] = clamp(V_in[i], -10.0, 10.0);  // Adjust clamp as needed
-
-        ACS.motor_clock(i, V_in[i]);
     }
 
+    // Axis voltages allocated over the wheels, the pseudo-inverse only recomputed when a wheel fails
+    wheels.command_voltage(Vector3d(V_in[0], V_in[1], V_in[2]), 10.0);
+
     // Log controller output
-    std::cout << "Input Voltages: X: " << V_in[0]
+    if (verbose) std::cout << "Input Voltages: X: " << V_in[0]
               << ", Y: " << V_in[1]
               << ", Z: " << V_in[2] << "\n";
+}
 
-    // === Motor Physics ===
-    for (int i = 0; i < 3; i++) {
-        I_prev[i] = I[i];
-        w_prev[i] = w[i];
-    }
-
-
-    ACS.update_all_ori(R_matrix);
-    ACS.updateAll_I(I_prev);
-    ACS.updateAll_omega(w_prev);
-
-    ACS.state_deriv_getALL_dI(dI);
-    ACS.state_deriv_getALL_Alpha(dw);
-
-    //try rk4 integration maybe this is the issue
-    for (int i = 0; i < 3; i++) {
-        I[i] = I_prev[i] + dI[i] * delta;
-        w[i] = w_prev[i] + dw[i] * delta;
-    }
-
-    //ACS.updateAll_I(I);
-    //ACS.updateAll_omega(w);
-
-    double torque[3];
-    ACS.get_total_torque(torque);
+void ACS_Sim::step_body(double delta)
+    //Description:      Rigid body over one step, driven by the wheel torque at the end of the frame
+    //Preconditions:    Wheels already advanced over the whole frame
+    //Postconditions:   Body rates, attitude and rotation matrix at the end of the step
+{
+    Matrix3d R;
+    R.insert(R_matrix[0][0], R_matrix[0][1], R_matrix[0][2],
+             R_matrix[1][0], R_matrix[1][1], R_matrix[1][2],
+             R_matrix[2][0], R_matrix[2][1], R_matrix[2][2]);
+    torque = wheels.get_total_torque(R);
 
     // === Apply to Rigid Body ===
-    Sattelite_Body.update_torque(torque[0], torque[1], torque[2]);
+    Sattelite_Body.update_torque(torque.x, torque.y, torque.z);
+    Sattelite_Body.propagate_lie(delta);
     Sattelite_Body.get_w(Sat_w);
     Sattelite_Body.get_Qori(Sat_q);
-    Sattelite_Body.state_deriv_get_alpha(Sat_dw);
-
-    for (int i = 0; i < 3; i++) {
-        Sat_w[i] += delta * Sat_dw[i];
-    }
-
-    Sattelite_Body.update_w(Sat_w[0], Sat_w[1], Sat_w[2]);
-    Sattelite_Body.state_deriv_getQori(Sat_dq);
-
-    for (int i = 0; i < 4; i++) {
-        Sat_q[i] += 0.5 * delta * Sat_dq[i];
-    }
-
-    Sattelite_Body.update_Qori(Sat_q);
     Sattelite_Body.get_R(R_matrix);
+}
 
+void ACS_Sim::step_propulsion(double delta)
+    //Description:      Velocity PID and the Hall thrusters, their force held until the next propulsion step
+    //Preconditions:    Body already advanced over the frame that starts the step
+    //Postconditions:   Thruster force on the body updated
+{
     // =============================
     // Thruster PID setup
     // =============================
     
     // === VELOCITY PID CONTROLLER ===
-    double current_velocity[3];
     double pos[3], R_body[3][3];
     Sattelite_Body.get_v(current_velocity);
     Sattelite_Body.get_pos(pos);
@@ -277,10 +266,37 @@ void ACS_Sim::update(double delta) {
     }
 
     // === APPLY THRUSTER FORCE ===
-    double net_force[3], force_pos[3];
+    double force_pos[3];
     propulsion.get_all_force(net_force, force_pos);
     propulsion.update_tankmass();
+    for (int i = 0; i < 3; i++) net_force[i] += params.thruster_bias[i];
     Sattelite_Body.update_force(net_force[0], net_force[1], net_force[2]);
+}
+
+void ACS_Sim::update(double delta) {
+    // Control, wheels subcycled at their own step, body, then propulsion every few frames
+    scheduler.run_frame(time, delta);
+    Sattelite_Body.get_v(current_velocity);
+
+    // === Figures of merit ===
+    double pointing = acos(clamp(dot(curr_j_axis, target_vec), -1.0, 1.0));
+    if (summary.steps == 0) summary.initial_pointing_error = pointing;
+    summary.pointing_error = pointing;
+    summary.max_pointing_error = max(summary.max_pointing_error, pointing);
+    if (pointing > params.settle_band) {
+        summary.settling_time = time + delta;
+        if (summary.reached_band && summary.initial_pointing_error > 0.0)
+            summary.overshoot = max(summary.overshoot, pointing / summary.initial_pointing_error);
+    } else {
+        summary.reached_band = true;
+    }
+    summary.max_rate = max(summary.max_rate, norm(Sat_w));
+    summary.motor_energy += wheels.get_power() * delta;
+    summary.final_speed = norm(current_velocity);
+    summary.propellant_used = initial_tankmass - propulsion.get_current_tankmass();
+    summary.steps++;
+
+    if (!verbose) return;
 
     std::cout << "Thrust Force Applied: [" << net_force[0] << ", " << net_force[1] << ", " << net_force[2] << "]\n";
     std::cout << "Velocity: [" << current_velocity[0] << ", " << current_velocity[1] << ", " << current_velocity[2] << "]\n";
@@ -290,9 +306,11 @@ void ACS_Sim::update(double delta) {
     //==============================
     
     cout << "===== \n";
-    cout << "Current Each Motor Draws: " << I[0] << ", " << I[1] << ", " << I[2] << "\n";
-    cout << "Total Angular Velocity: " << w[0] << " rad/s, " << w[1] << " rad/s, " << w[2] << " rad/s\n";
-    cout << "Total Torque : " << torque[0] << " Nm, " << torque[1] << " Nm, " << torque[2] << " Nm\n";
+    cout << "Current Each Motor Draws:";
+    for (int k = 0; k < wheels.size(); k++) cout << " " << wheels.get_I(k);
+    cout << "\nAngular Velocity of Each Wheel:";
+    for (int k = 0; k < wheels.size(); k++) cout << " " << wheels.get_omega(k) << " rad/s";
+    cout << "\nTotal Torque : " << torque.x << " Nm, " << torque.y << " Nm, " << torque.z << " Nm\n";
     cout << "==============Values For Controller============= \n \n";
     cout << "Input Voltage in Each Motor: " << V_in[0] << " Volts, " << V_in[1] << " Volts, " << V_in[2] << " Volts \n";
     cout << "Target Vector: " << target_vec[0] << " , " << target_vec[1] << " , " << target_vec[2] << " \n";
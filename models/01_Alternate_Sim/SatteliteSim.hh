@@ -5,7 +5,7 @@
 
 #include "../Ridged_Body/include/Ridged_Body.hh"
 
-#include "../Attitude_Control/include/Attitude_Control_System.hh"
+#include "../Attitude_Control/include/wheel_array.hh"
 #include "../Enviroment/include/cilestial_body.hh"
 
 #include "../EPS/include/Battery.hh"
@@ -18,20 +18,56 @@
 
 #include "../Recources/include/force_torque_tracker.hh"
 #include "../Recources/include/functions.hh"
+#include "../Recources/include/multi_rate.hh"
 
 #include "../Propulsion/include/Propulsion_System_PIC2D.hh"
 
+// Vehicle and controller parameters of one run; the defaults are the nominal vehicle
+struct ACS_Sim_params {
+    double mass = 1.0;          // kg
+    double side_length = 0.5;   // m, sets the inertia of the box body
+
+    // attitude PID
+    double Kp[3] = {8.0, 8.0, 8.0};
+    double Ki[3] = {0.05, 0.05, 0.05};
+    double Kd[3] = {0.3, 0.3, 0.3};
+
+    // velocity PID
+    double Kp_v[3] = {10.0, 10.0, 10.0};
+    double Ki_v[3] = {0.5, 0.5, 0.5};
+    double Kd_v[3] = {1.0, 1.0, 1.0};
+
+    double thruster_bias[3] = {0.0, 0.0, 0.0};  // N, global frame, added to the thruster force
+    double settle_band = 0.05;                  // rad, pointing error counted as settled
+    unsigned seed = 0;                          // seeds the HET particle simulations
+
+    wheel_layout layout = WHEEL_ORTHOGONAL;     // reaction wheels, allocated from the three axis voltages
+    int failed_wheel = -1;                      // wheel failed from the start, -1 for none
+
+    int propulsion_divisor = 1;                 // frames per step of the velocity PID and Hall thrusters
+};
+
+// Figures of merit of a run, accumulated by every update
+struct ACS_Sim_summary {
+    double pointing_error = 0.0;      // rad, final angle between the body y axis and the target
+    double max_pointing_error = 0.0;  // rad
+    double initial_pointing_error = 0.0;  // rad
+    double settling_time = 0.0;       // s, time after which the pointing error stays inside settle_band
+    double overshoot = 0.0;           // largest error after first reaching settle_band, relative to the initial error
+    bool reached_band = false;
+    double max_rate = 0.0;            // rad/s, largest body rate magnitude
+    double motor_energy = 0.0;        // J, sum of |V*I|*dt over the motors
+    double final_speed = 0.0;         // m/s
+    double propellant_used = 0.0;     // kg
+    int steps = 0;
+};
+
 class ACS_Sim : public Sim_Object {
     private:
-        Attitude_Control_System ACS;
-        double I[3];
-        double w[3];
-        double I_prev[3];
-        double w_prev[3];
+        wheel_array wheels;
         double R_matrix_ori[3][3];
-
-        double dI[3];
-        double dw[3];
+        double V_in[3];         // axis voltages of the attitude PID
+        Vector3d torque;        // wheel torque on the body, global frame
 
         //SATTELITE BODY
         ridged_body Sattelite_Body;
@@ -42,9 +78,14 @@ class ACS_Sim : public Sim_Object {
         double Sat_Torque[3]; //state
         double Sat_w[3]; //integ
         double Sat_q[4];
-        double Sat_dw[3];
-        double Sat_dq[4];
         double R_matrix[3][3];
+        double curr_j_axis[3];  // body y axis at the last control step
+
+        // RK4 for the motor currents and speeds, subcycled at the step the wheels allow
+        ode_integrator integrator;
+
+        // Control, wheels, body and propulsion, each at its own rate inside a frame
+        multi_rate_scheduler scheduler;
 
         //PID Controll Variables
         //PID gains
@@ -69,15 +110,29 @@ class ACS_Sim : public Sim_Object {
 
         // Target velocity
         double target_velocity[3];
-        
+        double current_velocity[3];
+        double net_force[3];    // thruster force on the body
+
+        ACS_Sim_params params;
+        ACS_Sim_summary summary;
+        double initial_tankmass;
+
+        //Description: the models run by the scheduler
+        void control_attitude(double /*dt*/);
+        void step_body(double /*dt*/);
+        void step_propulsion(double /*dt*/);
+
     protected:
         void initialize() override;
         void update(double dt) override;
     public:
-        ACS_Sim(double timestep, double max_time = -1.0);
+        ACS_Sim(double timestep, double max_time = -1.0, const ACS_Sim_params& = ACS_Sim_params());
         void set_current_voltage(const double);
         void get_drawn_current(double[3]);
 
+        //Description: figures of merit of the steps run so far
+        const ACS_Sim_summary& get_summary() const;
+
 };
 
 /*
@@ -0,0 +1,165 @@
+/*
+PURPOSE: (Headless PID gain sweep for ACS_Sim. Evaluates a grid or a
+          Latin hypercube sample of attitude and velocity gain sets on
+          every core and writes settling time, overshoot and energy of
+          each set as one CSV line.)
+NOTE:    (A case stops early once it diverges: body rate or speed past
+          their limits, or a non finite state. Its figures are then those
+          at the time it was stopped and the diverged column is 1.
+
+          The grid takes n levels of every gain, n^6 cases. The Latin
+          hypercube takes n cases, one in each of n strata of every gain,
+          drawn from mt19937(seed). Gains are spaced logarithmically
+          between the bounds of gain_range.)
+COMMANDS:
+    : make gain_sweep
+    : ./gain_sweep grid <levels> <duration s> <output.csv> [workers]
+    : ./gain_sweep lhs <cases> <duration s> <output.csv> [seed] [workers]
+*/
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "headless_cases.hh"
+
+using namespace std;
+
+struct gain_range {
+    const char* name;
+    double low;
+    double high;
+};
+
+// Swept gains, the same on all three axes
+const int GAINS = 6;
+const gain_range ranges[GAINS] = {
+    {"Kp",   1.0,   32.0},
+    {"Ki",   0.005, 0.5},
+    {"Kd",   0.03,  3.0},
+    {"Kp_v", 1.0,   40.0},
+    {"Ki_v", 0.05,  2.0},
+    {"Kd_v", 0.1,   4.0},
+};
+
+// Divergence limits
+const double MAX_RATE = 50.0;    // rad/s
+const double MAX_SPEED = 100.0;  // m/s
+
+// Gain at fraction u in [0, 1] of its range
+double gain_at(int g, double u) {
+    return ranges[g].low * pow(ranges[g].high / ranges[g].low, u);
+}
+
+ACS_Sim_params params_from(const double gains[GAINS]) {
+    ACS_Sim_params p;
+    for (int i = 0; i < 3; i++) {
+        p.Kp[i] = gains[0];
+        p.Ki[i] = gains[1];
+        p.Kd[i] = gains[2];
+        p.Kp_v[i] = gains[3];
+        p.Ki_v[i] = gains[4];
+        p.Kd_v[i] = gains[5];
+    }
+    return p;
+}
+
+// Every combination of the levels, the first gain varying slowest
+vector<array<double, GAINS>> grid_cases(int levels) {
+    vector<array<double, GAINS>> cases;
+    long total = 1;
+    for (int g = 0; g < GAINS; g++) total *= levels;
+    for (long c = 0; c < total; c++) {
+        array<double, GAINS> gains;
+        long rest = c;
+        for (int g = GAINS - 1; g >= 0; g--) {
+            int level = rest % levels;
+            rest /= levels;
+            gains[g] = gain_at(g, levels > 1 ? double(level) / (levels - 1) : 0.5);
+        }
+        cases.push_back(gains);
+    }
+    return cases;
+}
+
+// n cases, every gain takes each of its n strata exactly once
+vector<array<double, GAINS>> lhs_cases(int n, unsigned seed) {
+    mt19937 gen(seed);
+    uniform_real_distribution<double> u(0.0, 1.0);
+    vector<array<double, GAINS>> cases(n);
+    vector<int> strata(n);
+    for (int g = 0; g < GAINS; g++) {
+        iota(strata.begin(), strata.end(), 0);
+        shuffle(strata.begin(), strata.end(), gen);
+        for (int c = 0; c < n; c++) cases[c][g] = gain_at(g, (strata[c] + u(gen)) / n);
+    }
+    return cases;
+}
+
+bool diverged(const ACS_Sim_summary& s) {
+    return !(s.max_rate < MAX_RATE) || !(s.final_speed < MAX_SPEED) ||
+           !isfinite(s.pointing_error) || !isfinite(s.motor_energy);
+}
+
+int main(int argc, char** argv) {
+    bool grid = argc > 1 && strcmp(argv[1], "grid") == 0;
+    bool lhs = argc > 1 && strcmp(argv[1], "lhs") == 0;
+    if (argc < 5 || !(grid || lhs)) {
+        cerr << "usage: " << argv[0] << " grid <levels> <duration s> <output.csv> [workers]\n"
+             << "       " << argv[0] << " lhs <cases> <duration s> <output.csv> [seed] [workers]\n";
+        return 1;
+    }
+    int n = atoi(argv[2]);
+    double duration = atof(argv[3]);
+    unsigned seed = (lhs && argc > 5) ? static_cast<unsigned>(strtoul(argv[5], nullptr, 10)) : 1;
+    int workers_arg = grid ? 5 : 6;
+    int workers = (argc > workers_arg) ? atoi(argv[workers_arg]) : 0;
+
+    vector<array<double, GAINS>> cases = grid ? grid_cases(n) : lhs_cases(n, seed);
+
+    ofstream out(argv[4]);
+    if (!out) {
+        cerr << "cannot open " << argv[4] << "\n";
+        return 1;
+    }
+    out << "case";
+    for (int g = 0; g < GAINS; g++) out << "," << ranges[g].name;
+    out << ",settling_time,overshoot,settled,pointing_error,max_rate,motor_energy,propellant_used,diverged,sim_time\n";
+
+    work_pool pool(workers);
+    int n_diverged = 0;
+    auto start = chrono::steady_clock::now();
+    run_headless_cases(pool, static_cast<int>(cases.size()), duration,
+        [&cases](int c) { return params_from(cases[c].data()); },
+        [](const ACS_Sim& sim) { return diverged(sim.get_summary()); },
+        [&](int c, const ACS_Sim_params&, const ACS_Sim& sim, bool stopped) {
+            const ACS_Sim_summary& s = sim.get_summary();
+            stopped = stopped || diverged(s);
+            // Settled when the pointing error stayed inside the band for the last tenth of the run
+            bool settled = !stopped && s.settling_time <= 0.9 * sim.get_time();
+            n_diverged += stopped ? 1 : 0;
+
+            char line[512];
+            int len = snprintf(line, sizeof(line), "%d", c);
+            for (int g = 0; g < GAINS; g++) len += snprintf(line + len, sizeof(line) - len, ",%.6g", cases[c][g]);
+            snprintf(line + len, sizeof(line) - len, ",%.6g,%.6g,%d,%.6g,%.6g,%.6g,%.6g,%d,%.6g\n",
+                     s.settling_time, s.overshoot, settled ? 1 : 0, s.pointing_error, s.max_rate,
+                     s.motor_energy, s.propellant_used, stopped ? 1 : 0, sim.get_time());
+            return string(line);
+        },
+        out);
+
+    double elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << cases.size() << " gain sets of " << duration << " s on " << pool.size() << " workers in "
+         << elapsed << " s, " << n_diverged << " stopped early as diverged\n";
+    return 0;
+}
@@ -0,0 +1,35 @@
+/*
+PURPOSE:    This is the implementation of file 'headless_cases.hh'
+*/
+
+#include "headless_cases.hh"
+#include <mutex>
+
+void run_headless_cases(work_pool& pool, int cases, double duration, const case_params& params,
+                        const case_stop& stop, const case_line& line, std::ostream& out)
+    //Description:      Runs every case on the pool and writes one line per case.
+    //Preconditions:    cases >= 0, duration > 0; the callbacks do not throw.
+    //Postconditions:   Every case ran to its duration or until stop; each line is flushed when its case ends.
+{
+    std::mutex setup_lock, out_lock;
+    pool.run(cases, [&](int c, int) {
+        ACS_Sim_params p = params(c);
+        ACS_Sim sim(40, duration, p);
+        sim.set_realtime(false);
+        sim.set_verbose(false);
+        {
+            std::lock_guard<std::mutex> guard(setup_lock);
+            sim.start();
+        }
+        bool stopped = false;
+        while (sim.advance()) {
+            if (stop && stop(sim)) {
+                stopped = true;
+                break;
+            }
+        }
+
+        std::lock_guard<std::mutex> guard(out_lock);
+        out << line(c, p, sim, stopped) << std::flush;
+    });
+}
@@ -0,0 +1,35 @@
+/*
+PURPOSE: (Runs headless ACS_Sim cases on a work_pool for the batch drivers
+          (monte_carlo, gain_sweep). Every case is built from its own
+          parameters, started, advanced quiet and unpaced to its duration
+          or until the driver stops it, and reported as one line.)
+NOTE:    (Case setup is serialized: the PIC particle loading of the HET
+          sims draws from the process wide std::rand. Lines are written
+          whole, in the order the cases finish.)
+*/
+
+#ifndef HEADLESS_CASES_HH
+#define HEADLESS_CASES_HH
+
+#include <functional>
+#include <ostream>
+#include <string>
+
+#include "SatteliteSim.hh"
+#include "../Recources/include/work_pool.hh"
+
+//Description: parameters of case c
+typedef std::function<ACS_Sim_params(int /*case*/)> case_params;
+
+//Description: true to end a case before its duration; checked after every step
+typedef std::function<bool(const ACS_Sim&)> case_stop;
+
+//Description: the output line of a finished case, called under the output lock
+typedef std::function<std::string(int /*case*/, const ACS_Sim_params&, const ACS_Sim&, bool /*stopped*/)> case_line;
+
+//Description: runs cases 0 .. cases-1 of duration seconds on the pool and writes their lines to out;
+//             stop may be empty for cases that always run to their duration
+void run_headless_cases(work_pool& /*pool*/, int /*cases*/, double /*duration*/, const case_params& /*params*/,
+                        const case_stop& /*stop*/, const case_line& /*line*/, std::ostream& /*out*/);
+
+#endif
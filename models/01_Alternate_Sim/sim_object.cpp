@@ -34,21 +34,52 @@ Sim_Object::Sim_Object(int step, double max_time)
     dt = 1.0 / timestep;
     maxTime = max_time;
     time = 0.0;
+    realtime = true;
+    verbose = true;
+}
+
+void Sim_Object::set_realtime(bool enabled)
+{
+    realtime = enabled;
+}
+
+void Sim_Object::set_verbose(bool enabled)
+{
+    verbose = enabled;
+}
+
+void Sim_Object::start()
+{
+    initialize();
+}
+
+bool Sim_Object::advance()
+{
+    update(dt);
+    time = time + dt;
+    return maxTime < 0 || time < maxTime;
+}
+
+double Sim_Object::get_time() const
+{
+    return time;
 }
 
 void Sim_Object::run()
 
 {
-    set_realtime_priority();
+    if (realtime) set_realtime_priority();
     initialize();
     using clock = chrono::steady_clock;
 
-    cout << "Starting Sim";
+    if (verbose) {
+        cout << "Starting Sim";
 
-    if (maxTime > 0)
-        cout << " for " << maxTime << "seconds \n";
-    else
-        cout << " indefinently \n ";
+        if (maxTime > 0)
+            cout << " for " << maxTime << "seconds \n";
+        else
+            cout << " indefinently \n ";
+    }
 
     //setting up steps
     auto step = chrono::duration<int, ratio<1, 40>>(1);
@@ -59,7 +90,7 @@ void Sim_Object::run()
         auto finish = clock::now();
 
         //busy wait seemed to keep the sim running at 25 hz the most consistantly
-        while (clock::now() < start + step){
+        while (realtime && clock::now() < start + step){
             this_thread::yield();
         }
 
@@ -78,12 +109,12 @@ void Sim_Object::run()
         auto end = chrono::steady_clock::now();
         double elapsed = chrono::duration<double>(end - start).count();
 
-        cout << "Elepst time: " << elapsed << endl;
+        if (verbose) cout << "Elepst time: " << elapsed << endl;
 
         time = time+dt;
     }
 
-    cout << "Simulation complete. \n";
+    if (verbose) cout << "Simulation complete. \n";
 }
 
 void Sim_Object::initialize() {
@@ -7,6 +7,8 @@ class Sim_Object {
         double dt;
         double maxTime;
         double time;
+        bool realtime;  // pace each step to the wall clock at 40 Hz
+        bool verbose;   // print the state of every step
 
         virtual void initialize();
 
@@ -16,5 +18,14 @@ class Sim_Object {
         virtual ~Sim_Object() = default;
 
         void run();
+
+        //Description: headless runs step as fast as possible and print nothing (for batch drivers)
+        void set_realtime(bool);
+        void set_verbose(bool);
+
+        //Description: initializes, then advances one step at a time; advance returns false once maxTime is reached
+        void start();
+        bool advance();
+        double get_time() const;
 };
 #endif
\ No newline at end of file
@@ -5,10 +5,6 @@
 #include <sstream>
 #include <algorithm>
 
-#include "../../Attitude_Control/src/Attitude_Control_System.cpp"
-#include "../../Attitude_Control/src/control_wheels.cpp"
-#include "../../Attitude_Control/src/motor.cpp"
-
 
 #ifdef _WIN32
   #include <ws2tcpip.h>
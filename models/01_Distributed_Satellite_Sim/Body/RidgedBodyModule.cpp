@@ -5,20 +5,12 @@
 #include <sstream>
 #include <algorithm>
 
-#include "../../Ridged_Body/src/Satellite_Box.cpp"
-#include "../../Ridged_Body/src/Ridged_Body.cpp"
-
 #ifdef _WIN32
   #include <ws2tcpip.h>
 #else
   #include <arpa/inet.h>
 #endif
 
-void integrate(double& val, double integ_val, double dt) {
-    double interval = integ_val * dt;
-    val = val + interval;
-}
-
 RidgedBodyModule::RidgedBodyModule(const std::string& timekeeper_ip_, int timekeeper_port_,
                                    const std::string& mission_ip_, int mission_port_,
                                    int listen_port_)
@@ -245,31 +237,14 @@ void RidgedBodyModule::configureBehaviors() {
             Sattelite_Body.update_force(sat_Force[0], sat_Force[1], sat_Force[2]);
             Sattelite_Body.update_torque(sat_Torque[0], sat_Torque[1], sat_Torque[2]);
 
-            //state derivative for translational motion
+            //one Lie group step: the quaternion stays unit length for any tick length
+            Sattelite_Body.propagate_lie(dt);
+
             Sattelite_Body.state_deriv_getAccel(sat_a);
-            for(int i = 0; i < 3; i++) {
-                integrate(sat_x[i], sat_v[i], dt);
-                integrate(sat_v[i], sat_a[i], dt);
-            }
-            Sattelite_Body.update_v(sat_v[0], sat_v[1], sat_v[2]);
-            Sattelite_Body.update_pos(sat_x[0], sat_x[1], sat_x[2]);
-            
-            //state derivatives for rotational motion
+            Sattelite_Body.get_pos(sat_x);
+            Sattelite_Body.get_v(sat_v);
             Sattelite_Body.get_w(sat_w);
             Sattelite_Body.get_Qori(sat_q);
-
-            Sattelite_Body.state_deriv_get_alpha(sat_dw);
-            for (int i = 0; i < 3; i++) {
-                integrate(sat_w[i], sat_dw[i], dt);
-            }
-            Sattelite_Body.update_w(sat_w[0], sat_w[1], sat_w[2]);
-            Sattelite_Body.state_deriv_getQori(sat_dq);
-
-            for(int i = 0; i < 4; i++) {
-                integrate(sat_q[i], sat_dq[i], 0.5*dt); //0.5*dt for quaterniod
-            }
-
-            Sattelite_Body.update_Qori(sat_q);
             Sattelite_Body.get_R(R_matrix);
 
             //Output Everything Positional Wise
@@ -39,8 +39,6 @@ private:
     double sat_w[3];
     double sat_ori[3]; //forward
     double sat_q[4];
-    double sat_dw[3];
-    double sat_dq[4];
     double R_matrix[3][3];
 
     //internal input states
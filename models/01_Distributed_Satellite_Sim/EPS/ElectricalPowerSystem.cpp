@@ -4,6 +4,7 @@
 #include <chrono>
 #include <sstream>
 #include <algorithm>
+#include <cmath>
 
 #ifdef _WIN32
   #include <ws2tcpip.h>
@@ -11,10 +12,49 @@
   #include <arpa/inet.h>
 #endif
 
-#include "../../EPS/src/Battery.cpp"
-#include "../../EPS/src/bus_modified.cpp"
-#include "../../EPS/src/solar_cell.cpp"
-#include "../../EPS/src/Solar_Power_System.cpp"
+//Earth scene, as in the satellite sim: Earth at the origin, Moon on +x, sun on -x (default of panel_illumination)
+const double EARTH_RADIUS = 6378137;
+const double EARTH_MU = 3.986004418e14;
+const double MOON_RADIUS = 1737500;
+const double MOON_POS[3] = {3.8444e8, 0, 0};
+//eclipses are predicted about one orbit ahead, then predicted again from the latest body state
+const double ECLIPSE_HORIZON = 6000.0;
+
+//event driven mode
+//soc levels where the battery selection or its current changes
+const double SOC_LEVELS[4] = {0.2, 0.21, 0.89, 0.9};
+//the feed is solved again until the current the buses take settles
+const int SOLVE_ITERATIONS = 10;
+const double SOLVE_TOL_I = 1e-9;
+//a change of the short circuit current below this fraction of full sun is not an event
+const double ILLUMINATION_TOL = 1e-3;
+//bus state is published when it moved by more than these
+const double PUBLISH_TOL_V = 1e-2;
+const double PUBLISH_TOL_I = 1e-2;
+const double PUBLISH_TOL_SOC = 1e-4;
+
+//reads a comma separated field of n values into out, if the message has it
+static bool read_field(const Message& msg, const char* field, double* out, int n) {
+    if (msg.fields.find(field) == msg.fields.end()) return false;
+    std::stringstream ss(msg.fields.at(field));
+    std::string val;
+    int i = 0;
+    while (getline(ss, val, ',') && i < n) {
+        out[i] = std::stod(val);
+        i++;
+    }
+    return true;
+}
+
+//writes n values as a comma separated field
+static std::string write_field(const double* values, int n) {
+    std::string out;
+    for (int i = 0; i < n; i++) {
+        out += std::to_string(values[i]);
+        if (i < n - 1) out += ",";
+    }
+    return out;
+}
 
 void integrate(double& val, double before, double after, double dt){
     double interval = 0.5*(before+after)*dt;
@@ -23,14 +63,15 @@ void integrate(double& val, double before, double after, double dt){
 
 EPS_Module::EPS_Module(const std::string& tk_ip_, int tk_port_,
                       const std::string& mp_ip_, int mp_port_,
-                      int listen_port_)
+                      int listen_port_, bool event_driven_)
     : Actor("eps_module"),
       tk_ip(tk_ip_),
       tk_port(tk_port_),
       mp_ip(mp_ip_),
       mp_port(mp_port_),
       listen_port(listen_port_),
-      server_fd(INVALID_SOCKET) // We'll add this socket for listening
+      server_fd(INVALID_SOCKET), // We'll add this socket for listening
+      event_driven(event_driven_)
 {
     // Add MissionProcessor connection as outbound
     outboundConnections.emplace_back("MissionProcessor", mp_ip, mp_port);
@@ -76,6 +117,16 @@ EPS_Module::EPS_Module(const std::string& tk_ip_, int tk_port_,
     High_bus.initialize(source_voltage, high_bus_loads, bus_resistance, CURRENT_LIMITED);
     Low_bus.initialize(source_voltage, high_bus_loads, bus_resistance, CURRENT_LIMITED);
 
+    //Bus feed network, solved each tick for the node voltage. Only the source and the two bus
+    //resistances are in it; the bus loads, batteries and arrays are still stepped by their own
+    //models and enter as the current the buses draw
+    int source_node = feed.add_node();
+    feed_node = feed.add_node();
+    feed.add_voltage_source(source_node, circuit_network::GROUND, source_voltage);
+    feed.add_resistor(source_node, feed_node, bus_resistance); //High bus
+    feed.add_resistor(source_node, feed_node, bus_resistance); //Low bus
+    feed_draw = feed.add_current_source(feed_node, circuit_network::GROUND, 0.0);
+
     high_thruster_specs.max_pow = high_thruster_pow;
     high_thruster_specs.req_voltage = req_voltage;
     low_thruster_specs.max_pow = low_thrust_pow;
@@ -97,6 +148,9 @@ EPS_Module::EPS_Module(const std::string& tk_ip_, int tk_port_,
     sol_pow_sys[0].initialize(OC_V_sol, I_SC /*I_SC*/, MAX_V_sol, I_SC /*I_MAX*/, term_V);
     sol_pow_sys[1].initialize(OC_V_sol, I_SC /*I_SC*/, MAX_V_sol, I_SC /*I_MAX*/, term_V);
     sol_cell[0].initialize(I_SC);
+    sol_cell[1].initialize(I_SC);
+    solved_I_sc[0] = I_SC;
+    solved_I_sc[1] = I_SC;
 
     //length is 15 so 7.5 + extra length
     //ppe solar cells are around 75 meters long meaning taht center will be as shown
@@ -115,9 +169,20 @@ EPS_Module::EPS_Module(const std::string& tk_ip_, int tk_port_,
     sol_cell[0].set_refrence_ori(ref_ori_sol);
     sol_cell[1].set_refrence_ori(ref_ori_sol);
 
+    //illumination of both cells, no occulters until a scene is set
+    sol_cell_index[0] = illumination.add_cell(sol_cell[0]);
+    sol_cell_index[1] = illumination.add_cell(sol_cell[1]);
+    sat_R.insert(1, 0, 0,
+                 0, 1, 0,
+                 0, 0, 1);
+
     //Battery Initialization
     for(int i = 0; i < 3; i++) {
         EPS_bat[i].initialize(Q_Bat, R_0_Bat, R_1_Bat, R_2_Bat, C_1_Bat, C_2_Bat, SOC_bat);
+        EPS_bat[i].update_I(0);
+        EPS_bat[i].update_soc(0);
+        EPS_bat[i].update_Vt();
+        Vt[i] = EPS_bat[i].get_Vt();
     }
 
     //turning on default systems
@@ -130,6 +195,25 @@ EPS_Module::~EPS_Module() {
     stop();
 }
 
+int EPS_Module::add_occulter(double radius, const Vector3d& center) {
+    repredict = true;
+    return illumination.add_occulter(radius, center);
+}
+
+void EPS_Module::set_eclipse_prediction(int occulter, double mu) {
+    predicted_occulter = occulter;
+    orbit_mu = mu;
+    repredict = true;
+}
+
+void EPS_Module::set_earth_scene() {
+    Vector3d earth_pos, moon_pos;
+    earth_pos.insert(0, 0, 0);
+    moon_pos.insert(MOON_POS[0], MOON_POS[1], MOON_POS[2]);
+    set_eclipse_prediction(add_occulter(EARTH_RADIUS, earth_pos), EARTH_MU);
+    add_occulter(MOON_RADIUS, moon_pos);
+}
+
 void EPS_Module::initializeNetwork() {
 #ifdef _WIN32
     WSADATA wsa;
@@ -314,96 +398,15 @@ void EPS_Module::configureBehaviors() {
             
         //GETTING DT:
             double dt = stod(msg.fields.at("dt"));
+            sim_time += dt;
 
-        //SOLAR POWER INITIAL HANDLING
-            double total_drawn_I = Low_bus.get_drawn_I() + High_bus.get_drawn_I();
-
-            //getting current I
-
-            //ADD: Controller For Directing I based on cammands
-            //     maybe not here but at anothe behavior
-
-            //use this later
-            //double I_SC_0 = sol_cell[0].get_I_sc(/*light vector*/);
-            //double I_SC_1 = sol_cell[1].get_I_sc(/*light vector*/); 
-            //for now
-            double I_SC_0 = 455.0; //a bit lower than given I_SC;
-            double I_SC_1 = 455.0; //a bit lower than given I_SC;
-            
-            sol_pow_sys[0].set_I_sc(I_SC_0);
-            sol_pow_sys[1].set_I_sc(I_SC_1);
-
-            //Node Voltage
-            double total_incomming_I = High_bus.get_total_I() + Low_bus.get_total_I();
-            //calculating the voltage drop for node voltage. V_s - I*R. here we use resistance in parallel formula
-            double Node_Voltage = source_voltage - total_incomming_I * ((bus_resistance * bus_resistance)/(bus_resistance + bus_resistance));
-
-            sol_pow_sys[0].update_V(Node_Voltage);
-            sol_pow_sys[1].update_V(Node_Voltage);
-
-            //total current from solar power system
-            double total_I_sol = sol_pow_sys[0].get_I() + sol_pow_sys[1].get_I();
-            
-
-        //LOAD CALCULATIONS CALCULATING AMOUNT OF CURRENT NEEDED
-            //use total_drawn_I from above
-
-            High_bus.update_start_voltage(Node_Voltage);
-            Low_bus.update_start_voltage(Node_Voltage);
-
-            //for battery negative value is charge and positive value is take
-            double battery_I = total_drawn_I - total_I_sol; //meaning that is total drawn I is less then charge
-            int bat_i = -1; //index changed takes so we just need to look at the change in one battery
-            double input_I;
-
-            input_I = total_drawn_I; //initially set input to drawn I in most cases this will be the I
-
-            if (battery_I <= 0) //meaning there is enough current to supply
-            {
-                //Here input I is full
-                if (EPS_bat[2].get_soc() >= 0.89) {
-                    EPS_bat[2].update_I(battery_I);
-                    bat_i = 2;
-                }
-                else if (EPS_bat[1].get_soc() >= 0.89) {
-                    EPS_bat[1].update_I(battery_I);
-                    bat_i = 1;
-                }
-                else if (EPS_bat[0].get_soc() >= 0.89) {
-                    EPS_bat[0].update_I(battery_I);
-                    bat_i = 0;
-                }
-                else {
-                    bat_i = -1;
-                    cout << "[EPS Module: ALL BATTERIES ARE CHARGED] \n";
-                }
-            } 
-            else if (battery_I > 0 && EPS_bat[0].get_soc() <= 0.21) {
-                //Here input I is full
-                EPS_bat[0].update_I(battery_I);
-                bat_i = 0;
+            //event driven: solved only when an event is due
+            if (event_driven) {
+                event_step();
+                return;
             }
-            else if (battery_I > 0 && EPS_bat[1].get_soc() <= 0.21) {
-                //Here input I is full
-                EPS_bat[1].update_I(battery_I);
-                bat_i = 1;
-            }
-            else if (battery_I > 0 && EPS_bat[2].get_soc() <= 0.21) {
-                //Here input I is full
-                EPS_bat[2].update_I(battery_I);
-                bat_i = 2;
-            }
-            else {
-                //Here input I is not enough for required I.
-                //Prioritize low bus.
-                input_I = total_I_sol;
-                bat_i = -1;
-                cout << "[EPS Module] ALL BATTERIES ARE EMPTY NOT ENOUGH CURRENT \n";
-            }
-            double low_bus_I = min(input_I, Low_bus.get_drawn_I());
-            
-            Low_bus.state_update(low_bus_I);
-            High_bus.state_update(input_I - Low_bus.get_drawn_I());
+
+            int bat_i = solve_power(High_bus.get_total_I() + Low_bus.get_total_I());
             
         //BATTERY INTEGRATION INTEGRATING ALL BATTERIES
             if (bat_i != -1) {
@@ -573,6 +576,57 @@ void EPS_Module::configureBehaviors() {
                 THRUSTER_message.fields["input_voltage"] = volt_msg;
                 THRUSTER_message.fields["input_mass_flow"] = mass_flow;
             }
+            power_dirty = true;
+        }
+
+    //Body State Handling, for the illumination of the solar cells
+        if (msg.type == "RidgedBody:Update" || msg.type == "init_message") {
+            bool update = msg.type == "RidgedBody:Update";
+            double pos[3], vel[3], R[9];
+            bool has_pos = read_field(msg, update ? "position" : "body_pos", pos, 3);
+            bool has_vel = read_field(msg, update ? "velocity" : "body_vel", vel, 3);
+            if (has_pos && has_vel) {
+                Vector3d new_vel;
+                new_vel.insert(vel[0], vel[1], vel[2]);
+                //a velocity change the prediction did not know of (a burn) starts a new prediction. The
+                //prediction moves the body as the body state source does: in a straight line, or under the
+                //gravity set with set_eclipse_prediction, which changes the velocity by about -mu r / |r|^3 dt
+                Vector3d new_pos;
+                new_pos.insert(pos[0], pos[1], pos[2]);
+                bool valid = std::isfinite(new_vel.norm()) && illumination.is_valid_position(new_pos);
+                if (!have_body_state || valid != orbit_valid) repredict = true;
+                else if (valid) {
+                    Vector3d expected_vel = sat_vel;
+                    if (orbit_mu > 0 && predicted_occulter >= 0) {
+                        Vector3d r_vec;
+                        r_vec = sat_pos - illumination.get_occulter_pos(predicted_occulter);
+                        double r = r_vec.norm();
+                        if (r > 0) expected_vel = sat_vel - r_vec * (orbit_mu * (sim_time - body_time) / (r * r * r));
+                    }
+                    Vector3d dv;
+                    dv = new_vel - expected_vel;
+                    if (dv.norm() > 1e-3 * (1.0 + sat_vel.norm())) repredict = true;
+                }
+                sat_pos = new_pos;
+                sat_vel = new_vel;
+                body_time = sim_time;
+                have_body_state = true;
+                orbit_valid = valid;
+            }
+            if (read_field(msg, "rotation_matrix", R, 9)) {
+                sat_R.insert(R[0], R[1], R[2],
+                             R[3], R[4], R[5],
+                             R[6], R[7], R[8]);
+            }
+            //in event driven mode a burn or a change of the lighting is an event
+            if (event_driven && have_body_state && orbit_valid) {
+                if (repredict) power_dirty = true;
+                else if (illumination.update(sim_time, sat_pos, sat_R)) {
+                    double full_I_sc = std::max(sol_cell[0].get_max_I_sc(), sol_cell[1].get_max_I_sc());
+                    for (int i = 0; i < 2; i++)
+                        if (fabs(illumination.get_I_sc(sol_cell_index[i]) - solved_I_sc[i]) > ILLUMINATION_TOL * full_I_sc) power_dirty = true;
+                }
+            }
         }
 
     //Turn Load Off Handling
@@ -610,6 +664,7 @@ void EPS_Module::configureBehaviors() {
                 THRUSTER_message.fields["input_voltage"] = "0.0";
                 THRUSTER_message.fields["input_mass_flow"] = "0.0";
             }
+            power_dirty = true;
         }
 
         } catch (const std::exception& e) {
@@ -620,6 +675,185 @@ void EPS_Module::configureBehaviors() {
     });
 
 }
+void EPS_Module::update_illumination() {
+    //incidence and shadow from the last body state; until one arrives that is a valid orbit (finite, outside
+    //every occulter) the cells face the sun
+    double I_SC_0 = sol_cell[0].get_max_I_sc();
+    double I_SC_1 = sol_cell[1].get_max_I_sc();
+    if (have_body_state && orbit_valid) {
+        if (repredict || (predicted_occulter >= 0 && sim_time >= illumination.get_prediction_end())) {
+            repredict = false;
+            if (predicted_occulter >= 0)
+                illumination.predict_eclipses(sim_time, sat_pos, sat_vel, orbit_mu, predicted_occulter, ECLIPSE_HORIZON);
+        }
+        //only recomputes when the shadow state or the attitude changed
+        illumination.update(sim_time, sat_pos, sat_R);
+        I_SC_0 = illumination.get_I_sc(sol_cell_index[0]);
+        I_SC_1 = illumination.get_I_sc(sol_cell_index[1]);
+    }
+    
+    sol_pow_sys[0].set_I_sc(I_SC_0);
+    sol_pow_sys[1].set_I_sc(I_SC_1);
+    solved_I_sc[0] = I_SC_0;
+    solved_I_sc[1] = I_SC_1;
+}
+
+int EPS_Module::solve_power(double incoming_I) {
+//SOLAR POWER INITIAL HANDLING
+    double total_drawn_I = Low_bus.get_drawn_I() + High_bus.get_drawn_I();
+
+    //ADD: Controller For Directing I based on cammands
+    //     maybe not here but at anothe behavior
+
+    update_illumination();
+
+    //Node Voltage
+    //voltage drop over the bus resistances in parallel, V_s - I*R, from the feed network
+    feed.set_current(feed_draw, incoming_I);
+    feed.solve();
+    double Node_Voltage = feed.get_node_V(feed_node);
+
+    sol_pow_sys[0].update_V(Node_Voltage);
+    sol_pow_sys[1].update_V(Node_Voltage);
+    sol_pow_sys[0].update_I();
+    sol_pow_sys[1].update_I();
+
+    //total current from solar power system
+    I_sol_out[0] = sol_pow_sys[0].get_I();
+    I_sol_out[1] = sol_pow_sys[1].get_I();
+    double total_I_sol = I_sol_out[0] + I_sol_out[1];
+    
+
+//LOAD CALCULATIONS CALCULATING AMOUNT OF CURRENT NEEDED
+    //use total_drawn_I from above
+
+    High_bus.update_start_voltage(Node_Voltage);
+    Low_bus.update_start_voltage(Node_Voltage);
+
+    //for battery negative value is charge and positive value is take
+    double battery_I = total_drawn_I - total_I_sol; //meaning that is total drawn I is less then charge
+    int bat_i = -1; //index changed takes so we just need to look at the change in one battery
+    double input_I;
+
+    input_I = total_drawn_I; //initially set input to drawn I in most cases this will be the I
+
+    if (battery_I <= 0) //meaning there is enough current to supply
+    {
+        //Here input I is full
+        if (EPS_bat[2].get_soc() >= 0.89) {
+            EPS_bat[2].update_I(battery_I);
+            bat_i = 2;
+        }
+        else if (EPS_bat[1].get_soc() >= 0.89) {
+            EPS_bat[1].update_I(battery_I);
+            bat_i = 1;
+        }
+        else if (EPS_bat[0].get_soc() >= 0.89) {
+            EPS_bat[0].update_I(battery_I);
+            bat_i = 0;
+        }
+        else {
+            bat_i = -1;
+            cout << "[EPS Module: ALL BATTERIES ARE CHARGED] \n";
+        }
+    } 
+    else if (battery_I > 0 && EPS_bat[0].get_soc() <= 0.21) {
+        //Here input I is full
+        EPS_bat[0].update_I(battery_I);
+        bat_i = 0;
+    }
+    else if (battery_I > 0 && EPS_bat[1].get_soc() <= 0.21) {
+        //Here input I is full
+        EPS_bat[1].update_I(battery_I);
+        bat_i = 1;
+    }
+    else if (battery_I > 0 && EPS_bat[2].get_soc() <= 0.21) {
+        //Here input I is full
+        EPS_bat[2].update_I(battery_I);
+        bat_i = 2;
+    }
+    else {
+        //Here input I is not enough for required I.
+        //Prioritize low bus.
+        input_I = total_I_sol;
+        bat_i = -1;
+        cout << "[EPS Module] ALL BATTERIES ARE EMPTY NOT ENOUGH CURRENT \n";
+    }
+    double low_bus_I = min(input_I, Low_bus.get_drawn_I());
+    
+    Low_bus.state_update(low_bus_I);
+    High_bus.state_update(input_I - Low_bus.get_drawn_I());
+    bus_I = High_bus.get_total_I() + Low_bus.get_total_I();
+    node_voltage = Node_Voltage;
+
+    return bat_i;
+}
+
+void EPS_Module::event_step() {
+    //between events the loads, the lighting and the battery selection are held and the battery is exact
+    if (!power_dirty && sim_time < next_event_time) return;
+
+    //the active battery ran at the current of the last solve since then
+    if (active_bat != -1) {
+        EPS_bat[active_bat].propagate(sim_time - last_event_time);
+        Vt[active_bat] = EPS_bat[active_bat].get_Vt();
+    }
+    last_event_time = sim_time;
+    power_dirty = false;
+
+    //the node voltage depends on what the buses take, which depends on the node voltage
+    for (int k = 0; k < SOLVE_ITERATIONS; k++) {
+        double previous_I = bus_I;
+        active_bat = solve_power(bus_I);
+        if (fabs(bus_I - previous_I) <= SOLVE_TOL_I) break;
+    }
+    //a battery at its bound takes no current, as with update_soc
+    if (active_bat != -1) {
+        EPS_bat[active_bat].propagate(0.0);
+        Vt[active_bat] = EPS_bat[active_bat].get_Vt();
+    }
+
+    //next shadow crossing, end of the eclipse prediction, soc level of the active battery or the time its
+    //terminal voltage has settled to within the publishing tolerance
+    next_event_time = INFINITY;
+    if (illumination.get_prediction_end() > sim_time) {
+        next_event_time = std::min({illumination.get_next_entry(sim_time), illumination.get_next_exit(sim_time),
+                                    illumination.get_prediction_end()});
+    }
+    if (active_bat != -1) {
+        for (double level : SOC_LEVELS)
+            next_event_time = std::min(next_event_time, sim_time + EPS_bat[active_bat].time_to_soc(level));
+        double settle = EPS_bat[active_bat].time_to_settle(0.5 * PUBLISH_TOL_V);
+        if (settle > 0) next_event_time = std::min(next_event_time, sim_time + settle);
+    }
+
+    publish_state();
+}
+
+void EPS_Module::publish_state() {
+    double soc[3];
+    for (int i = 0; i < 3; i++) soc[i] = EPS_bat[i].get_soc();
+    std::vector<double> state = {node_voltage, bus_I, I_sol_out[0], I_sol_out[1], soc[0], soc[1], soc[2], Vt[0], Vt[1], Vt[2]};
+    const double tol[10] = {PUBLISH_TOL_V, PUBLISH_TOL_I, PUBLISH_TOL_I, PUBLISH_TOL_I,
+                            PUBLISH_TOL_SOC, PUBLISH_TOL_SOC, PUBLISH_TOL_SOC, PUBLISH_TOL_V, PUBLISH_TOL_V, PUBLISH_TOL_V};
+    bool changed = published.size() != state.size();
+    for (size_t i = 0; i < state.size() && !changed; i++) changed = fabs(state[i] - published[i]) > tol[i];
+    if (!changed) return;
+    published = state;
+
+    Message state_message;
+    state_message.sender = name;
+    state_message.type = "EPS:Update";
+    state_message.fields["time"] = std::to_string(sim_time);
+    state_message.fields["node_voltage"] = std::to_string(node_voltage);
+    state_message.fields["bus_current"] = std::to_string(bus_I);
+    state_message.fields["solar_current"] = write_field(I_sol_out, 2);
+    state_message.fields["battery"] = std::to_string(active_bat);
+    state_message.fields["battery_soc"] = write_field(soc, 3);
+    state_message.fields["battery_voltage"] = write_field(Vt, 3);
+    sendMessage(state_message);
+}
+
 // The run() function stays mostly the same, just keep it as is.
 
 void EPS_Module::run() {
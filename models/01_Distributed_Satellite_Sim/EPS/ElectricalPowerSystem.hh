@@ -10,6 +10,8 @@
 #include "../../EPS/include/bus_modified.hh"
 #include "../../EPS/include/solar_cell.hh"
 #include "../../EPS/include/Solar_Power_System.hh"
+#include "../../EPS/include/circuit_network.hh"
+#include "../../EPS/include/panel_illumination.hh"
 
 struct load_specs {
     double max_pow;
@@ -20,10 +22,22 @@ class EPS_Module : public Actor {
 public:
     EPS_Module(const std::string& tk_ip, int tk_port,
                const std::string& mp_ip, int mp_port,
-               int listen_port);
+               int listen_port, bool event_driven = false);
 
     ~EPS_Module();
 
+    // Scene the solar cells see. Empty by default: the RidgedBodyModule applies no gravity and starts at
+    // the origin, so there is no planet for it to orbit
+    int add_occulter(double /*radius*/, const Vector3d& /*center*/);
+
+    // Occulter whose shadow crossings are predicted, and the gravitational parameter the body moves under
+    // about it (0 for a body moved by its thrusters alone)
+    void set_eclipse_prediction(int /*occulter*/, double /*mu*/);
+
+    // Earth at the origin under its gravity and the Moon on +x, as in the satellite sim, for a body
+    // state source that flies an orbit about the Earth
+    void set_earth_scene();
+
 protected:
     void initializeNetwork() override;
     void run() override;
@@ -64,13 +78,57 @@ private:
     solar_cell sol_cell[2];
     double I_sol_out[2];
 
+    // Incidence and shadow of both solar cells, from the body state of the RidgedBodyModule
+    panel_illumination illumination;
+    int sol_cell_index[2];
+    int predicted_occulter = -1;
+    double orbit_mu = 0.0;
+    bool have_body_state = false;
+    bool orbit_valid = false;  // the last body state is finite and outside every occulter
+    bool repredict = true;
+    double sim_time = 0.0;
+    double body_time = 0.0;  // sim_time of the last body state
+    Vector3d sat_pos;
+    Vector3d sat_vel;
+    Matrix3d sat_R;
+
     double source_voltage = 120;
     double bus_resistance = 0.009; //Estimate Resistance
 
+    // Feed of the two buses: the source through both bus resistances to the node the buses draw from
+    circuit_network feed;
+    int feed_node;
+    int feed_draw;
+
+    // Event driven stepping: the power state is solved only at events (a load switched, an eclipse
+    // entered or left, a battery reaching a soc level) and the battery propagated exactly between them
+    bool event_driven;
+    bool power_dirty = true;
+    double next_event_time = 0.0;
+    double last_event_time = 0.0;
+    int active_bat = -1;
+    double bus_I = 0.0;      // current the buses took at the last solve
+    double node_voltage = 0.0;
+    double solved_I_sc[2];   // short circuit currents at the last solve
+    std::vector<double> published;
+
     // Outbound connection list (name, ip, port)
     std::vector<std::tuple<std::string, std::string, int>> outboundConnections;
 
     void configureBehaviors();
+
+    // Short circuit currents of the solar arrays from the last body state
+    void update_illumination();
+
+    // Node voltage, solar currents, battery selection and bus states for the current the buses draw;
+    // returns the battery supplying or taking the difference, -1 for none
+    int solve_power(double /*bus current*/);
+
+    // Event driven tick: nothing until an event is due, then propagate, solve and publish
+    void event_step();
+
+    // Sends EPS:Update when the bus state moved beyond the tolerances since it was last sent
+    void publish_state();
 };
 
 #endif
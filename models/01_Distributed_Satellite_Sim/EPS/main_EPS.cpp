@@ -1,12 +1,21 @@
 #include "ElectricalPowerSystem.hh"
 #include <iostream>
+#include <string>
 
-int main() {
+int main(int argc, char* argv[]) {
     // Timekeeper at 127.0.0.1:9000
     // MissionProcessor at 127.0.0.1:9101
     // EPS listens on port 9103 for ACS and Propulsion
+    // "EPS event" solves the power state only at events instead of every tick
+    // "EPS earth" shadows the solar cells by the Earth and the Moon, for a body actor in orbit about the Earth
 
-    EPS_Module eps("127.0.0.1", 9000, "127.0.0.1", 9101, 9103);
+    bool event_driven = false, earth = false;
+    for (int i = 1; i < argc; i++) {
+        event_driven = event_driven || std::string(argv[i]) == "event";
+        earth = earth || std::string(argv[i]) == "earth";
+    }
+    EPS_Module eps("127.0.0.1", 9000, "127.0.0.1", 9101, 9103, event_driven);
+    if (earth) eps.set_earth_scene();
     eps.start();
 
     std::cout << "[Main] EPS Module running. Press Enter to stop...\n";
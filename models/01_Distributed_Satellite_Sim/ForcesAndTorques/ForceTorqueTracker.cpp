@@ -5,9 +5,6 @@
 #include <sstream>
 #include <algorithm>
 
-#include "../../Recources/src/force_torque_tracker.cpp"
-#include "../../Recources/src/functions.cpp"
-
 #ifdef _WIN32
   #include <ws2tcpip.h>
 #else
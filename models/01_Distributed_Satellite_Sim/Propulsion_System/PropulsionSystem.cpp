@@ -5,9 +5,6 @@
 #include <sstream>
 #include <algorithm>
 
-#include "../../Propulsion/src/Propulsion_System_PIC2D.cpp"
-#include "../../Propulsion/src/hall_thruster_PIC2D.cpp"
-
 #ifdef _WIN32
   #include <ws2tcpip.h>
 #else
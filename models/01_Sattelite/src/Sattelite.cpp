@@ -13,7 +13,9 @@ LIBRARY DEPENDENCY:
      (GNC/src/accelerometer.o)
      (GNC/src/gyroscope.o)
      (Propulsion/src/Propulsion_System.o)
-     (Recources/src/force_torque_tracker.o))
+     (Recources/src/force_torque_tracker.o)
+     (Recources/src/Linear_Algebra.o)
+     (Recources/src/frame_transforms.o))
 *******************************************************************************/
 
 #include "../include/Sattelite.hh"
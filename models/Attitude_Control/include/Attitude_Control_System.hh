@@ -15,7 +15,7 @@ TERMS USED:
 
 #include "motor.hh"
 #include "h-bridge.hh"
-#include "../../Recources/src/Linear_Algebra.cpp"
+#include "../../Recources/include/Linear_Algebra.hh"
 
 //#include "../../../Lib/eigen-3.4.0/Eigen/Dense"
 //#include "../../../Lib/eigen-3.4.0/Eigen/Geometry"
@@ -76,6 +76,8 @@ class Attitude_Control_System {
         double get_drawn_I();
     private:
         motor motors[3];        // Motors
+        frame_transforms mounts; // Motor mounts, moved to the global frame in one pass
+        int motor_mount[3];     // Handle of each motor in mounts
         double motor_I[3];
         double V[3];
         double motor_Pow[3];    // Power of motors
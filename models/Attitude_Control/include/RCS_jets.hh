@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <array>
+#include <cstdint>
 
 // Represents a single cold gas RCS jet
 struct Thruster {
@@ -12,23 +13,63 @@ struct Thruster {
     bool isFiring = false;          // Commanded on/off
 };
 
+// Bit i set when jet i fires
+typedef std::uint32_t FiringMask;
+
+// Jets are on/off, so a command only selects which jets fire. The torque and
+// force of every jet are computed once at construction, and with them the
+// jets to fire for each of the 27 sign patterns (-, 0, +) of the desired
+// torque: the set whose net torque has that sign pattern with the least net
+// force, then the least fuel (sum of maxForce). With up to 16 jets every set is
+// tried; otherwise, and for patterns no set produces, a pattern fires the jets
+// whose torque points along it. Commanding is then a table lookup.
 class ReactionControlThrusters {
 public:
     ReactionControlThrusters(double width, double height, double depth, double maxThrust);
 
+    // Any layout of up to 32 jets
+    explicit ReactionControlThrusters(const std::vector<Thruster>& jets);
+
     // Command a desired torque vector (Nm)
     void commandTorque(const std::array<double, 3>& desiredTorque);
 
+    // Torque components below this fraction of the largest one are taken as 0,
+    // so a small cross axis error does not fire a pair of jets (default 0)
+    void setDeadband(double fraction);
+
+    // Which thrusters are firing, one bit per jet
+    FiringMask getFiringMask() const;
+
     // Get which thrusters are firing
     std::vector<bool> getFiringStates() const;
 
     // Get total torque currently applied
     std::array<double, 3> getNetTorque() const;
 
+    // Total force currently applied (N)
+    std::array<double, 3> getNetForce() const;
+
+    // Sum of maxForce over the firing jets (N), proportional to the propellant flow
+    double getFiringThrust() const;
+
     const std::vector<Thruster>& getThrusters() const;
 
 private:
+    // Jet torques and forces, and the selection for every sign pattern
+    void buildTable();
+
     std::vector<Thruster> thrusters;
+    std::vector<std::array<double, 3>> jetTorque;
+    std::vector<std::array<double, 3>> jetForce;
+
+    // Indexed by sum over the axes of (sign + 1) * 3^axis
+    std::array<FiringMask, 27> selection;
+    std::array<std::array<double, 3>, 27> selectionTorque;
+    std::array<std::array<double, 3>, 27> selectionForce;
+    std::array<double, 27> selectionThrust;
+
+    int pattern = 13;   // all components zero, nothing firing
+    double deadband = 0.0;
 };
 
 #endif
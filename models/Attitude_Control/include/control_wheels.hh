@@ -8,7 +8,7 @@ PURPOSE:    This is a simplified representation of the control wheels that are a
 #include <iostream>
 
 #include "../../structs.hh"
-#include "../../Recources/src/Linear_Algebra.cpp"
+#include "../../Recources/include/Linear_Algebra.hh"
 
 #ifndef CONTROL_WHEELS_HH
 #define CONTROL_WHEELS_HH
@@ -11,7 +11,8 @@ TERMS USED:
 */
 
 #include "control_wheels.hh"
-#include "../../Recources/src/Linear_Algebra.cpp"
+#include "../../Recources/include/Linear_Algebra.hh"
+#include "../../Recources/include/frame_transforms.hh"
 //#include "../../../Lib/eigen-3.4.0/Eigen/Dense"
 //#include "../../../Lib/eigen-3.4.0/Eigen/Geometry"
 
@@ -81,12 +82,18 @@ class motor {
     	void update_ori(double[3][3]);
     	void update_ori(const Matrix3d&);
     	void update_ori();
+    	void update_ori(const frame_transforms& /*transforms of all mounts*/, int /*mount handle*/);
 
     	//Description: Updates both global position and orientation (more efficient then just doing former functions separatly)
     	void update_pos_ori(double[3], double[3][3]);
     	void update_pos_ori(Vector3d, const Matrix3d&);
     	void update_pos_ori(double[3]);
     	void update_pos_ori(Vector3d);
+    	void update_pos_ori(const frame_transforms& /*transforms of all mounts*/, int /*mount handle*/);
+
+    	//Description: Returns the position and orientation in refrence to satellite (used to register the mount)
+    	Vector3d get_refrence_pos();
+    	Vector3d get_refrence_ori();
 
     	//Description: Returns the global position of the thruster
     	void get_pos(double[3]);
@@ -0,0 +1,148 @@
+/*
+PURPOSE:    Array of N reaction wheels, each a DC motor turning a wheel about
+            its own axis, with the command of the attitude controller
+            allocated over the wheels. For redundant layouts (the 4 wheel
+            pyramid, the NASA standard 3 + 1 skew) and for arrays that have
+            lost a wheel, where three motors fixed to x, y and z do not
+            apply.
+
+NOTE:       The motor state is kept as structure of arrays, so the
+            derivatives of all wheels are two loops the compiler vectorizes:
+                dI/dt = (V - R I - k_t w) / L
+                dw/dt = (k_t I - b w) / J
+            the equations of motor with k_t = k_1 B. J is the inertia of the
+            wheel about its spin axis, m r^2 / 2.
+
+            A command c along the body axes (a torque, or the voltages of
+            three axis controllers) is allocated over the healthy wheels
+            with the minimum norm solution
+                u = A^T (A A^T)^-1 c
+            The pseudo-inverse is kept and only computed again when a wheel
+            fails, is restored or is added, so an allocation costs one dot
+            product per wheel. For three orthogonal wheels it is the
+            identity: each wheel takes its own axis. With fewer than three
+            independent healthy axes it is the least squares allocation over
+            the axes that remain.
+
+            The body frame torque of the wheels is sum (k_t I - b w) a; in
+            the global frame it is R^-1 times that, as motor::get_torque_vec
+            gives for each motor.
+
+            For the integrators in ode_integrator.hh the state is
+                [I_0 .. I_(N-1), w_0 .. w_(N-1)]
+
+            The electrical time constant L / R is far shorter than the
+            attitude dynamics. get_max_step bounds the fastest mode of every
+            motor by its Gershgorin disc, max((R + k_t) / L, (k_t + b) / J),
+            and returns the step with h |lambda| <= 1, well inside the
+            stability of RK4, so a scheduler can subcycle the wheels inside
+            a longer vehicle frame.
+
+TERMS USED:
+    -> a       - unit axis of a wheel in the body frame
+    -> A       - 3 x N matrix of the axes of the healthy wheels
+    -> k_t     - torque constant of a motor, k_1 B
+    -> layout  - placement of the wheel axes
+*/
+
+#ifndef WHEEL_ARRAY_HH
+#define WHEEL_ARRAY_HH
+
+#include <vector>
+#include "../../Recources/include/Linear_Algebra.hh"
+#include "../../Recources/include/ode_integrator.hh"
+
+enum wheel_layout {
+    WHEEL_ORTHOGONAL,   // 3 wheels along x, y and z
+    WHEEL_PYRAMID,      // 4 wheels tilted from z by the tilt angle, 90 deg apart starting at 45 deg
+    WHEEL_NASA_SKEW     // x, y, z and a fourth along (1, 1, 1) / sqrt(3)
+};
+
+// Tilt of the pyramid that gives every body axis the same capacity, acos(1 / sqrt(3))
+const double PYRAMID_TILT = 0.9553166181245093;
+
+class wheel_array : public ode_system {
+    public:
+        // Description: An array with no wheels
+        wheel_array();
+
+        // Description: An array of wheels in a layout, each with the motor and wheel of Attitude_Control_System
+        wheel_array(wheel_layout /*layout*/, double /*tilt*/ = PYRAMID_TILT);
+
+        // Description: Replaces the wheels by those of a layout
+        void set_layout(wheel_layout /*layout*/, double /*tilt*/ = PYRAMID_TILT);
+
+        // Description: Adds a wheel about a body frame axis (normalized); returns its index
+        int add_wheel(const Vector3d& /*axis*/);
+
+        // Description: Electrical and mechanical constants of one motor, as in motor with k_t = k_1 B
+        void set_motor(int /*wheel*/, double /*resistance*/, double /*inductance*/, double /*torque constant*/, double /*damping*/);
+
+        // Description: Mass and dimensions of one wheel, a cylinder
+        void set_wheel(int /*wheel*/, double /*mass*/, double /*radius*/, double /*height*/);
+
+        // Description: Takes a wheel out of the allocation and off its voltage; restore puts it back
+        void fail_wheel(int /*wheel*/);
+        void restore_wheel(int /*wheel*/);
+        bool is_healthy(int /*wheel*/) const;
+
+        // Description: Share of every wheel in a body frame command, 0 for a failed wheel
+        void allocate(const Vector3d& /*command*/, double* /*per wheel*/);
+
+        // Description: Allocates body axis voltages over the wheels and scales them all down if one would exceed V_max
+        void command_voltage(const Vector3d& /*axis voltages*/, double /*V_max*/);
+
+        void set_voltage(int /*wheel*/, double /*voltage*/);
+        double get_voltage(int /*wheel*/) const;
+
+        // Description: Size of the flat state, 2 N
+        int state_size() const override;
+
+        // Description: Copy the currents and speeds into a flat state, and set them from one
+        void get_state(double* /*state*/) const;
+        void set_state(const double* /*state*/);
+
+        // Description: Derivative of a flat state at the present voltages
+        void state_deriv(double /*time*/, const double* /*state*/, double* /*derivative*/) override;
+
+        // Description: Advances the currents and speeds by dt with an integrator
+        void propagate(ode_integrator& /*integrator*/, double /*time*/, double /*time step*/);
+
+        // Description: Largest explicit step the stiffest motor allows, h |lambda| <= 1
+        double get_max_step() const;
+
+        // Description: Torque of all wheels in the body frame, and in the global frame for a rotation matrix
+        Vector3d get_body_torque() const;
+        Vector3d get_total_torque(const Matrix3d& /*rotation matrix*/) const;
+
+        double get_I(int /*wheel*/) const;
+        double get_omega(int /*wheel*/) const;
+        Vector3d get_axis(int /*wheel*/) const;
+
+        // Description: Sum of |V I| over the wheels
+        double get_power() const;
+
+        int size() const;
+
+        // Description: Number of times the pseudo-inverse was computed
+        int get_allocations_computed() const;
+
+    private:
+        // Pseudo-inverse over the healthy wheels
+        void update_allocation();
+
+        // Axes
+        std::vector<double> ax, ay, az;
+        // Motors and wheels
+        std::vector<double> R, inv_L, k_t, b, inv_J;
+        // State and inputs
+        std::vector<double> V, I, w;
+        std::vector<char> healthy;
+
+        // Rows of the pseudo-inverse, one per wheel
+        std::vector<double> px, py, pz;
+        bool allocation_valid;
+        int allocations_computed;
+};
+
+#endif
@@ -4,7 +4,9 @@ LIBRARY DEPENDENCY:
     ((Attitude_Control_System.o)
      (motor.o)
      (h-bridge.o)
-     (control_wheels.o))
+     (control_wheels.o)
+     (Recources/src/Linear_Algebra.o)
+     (Recources/src/frame_transforms.o))
 *******************************************************************************/
 
 
@@ -30,6 +32,10 @@ Attitude_Control_System::Attitude_Control_System()
     motors[0].set_refrence_ori(1, 0, 0); //along x
     motors[1].set_refrence_ori(0, 1, 0); //along y
     motors[2].set_refrence_ori(0, 0, 1); //along z
+
+    for (int i = 0; i < 3; i++){
+        motor_mount[i] = mounts.add_mount(motors[i].get_refrence_pos(), motors[i].get_refrence_ori());
+    }
 }
 
 Attitude_Control_System::Attitude_Control_System(double power)
@@ -52,6 +58,10 @@ Attitude_Control_System::Attitude_Control_System(double power)
     motors[0].set_refrence_ori(1, 0, 0); //along x
     motors[1].set_refrence_ori(0, 1, 0); //along y
     motors[2].set_refrence_ori(0, 0, 1); //along z
+
+    for (int i = 0; i < 3; i++){
+        motor_mount[i] = mounts.add_mount(motors[i].get_refrence_pos(), motors[i].get_refrence_ori());
+    }
 }
 
 void Attitude_Control_System::Initialize_Power(double power)
@@ -136,8 +146,10 @@ void Attitude_Control_System::update_all_ori(double rotation_matrix[3][3])
     //Preconditions: Satellite rotation matrix must be provided.
     //Postconditions: motors orientations are updated.
 {
+    double center[3] = {0, 0, 0};
+    mounts.update(center, rotation_matrix);
     for (int i = 0; i < 3; i++) {
-        motors[i].update_ori(rotation_matrix);
+        motors[i].update_ori(mounts, motor_mount[i]);
     }
 }
 
@@ -146,8 +158,9 @@ void Attitude_Control_System::update_all_ori(const Matrix3d& R)
     //Preconditions: Satellite rotation matrix must be provided.
     //Postconditions: motors orientations are updated.
 {
+    mounts.update(Vector3d(), R);
     for (int i = 0; i < 3; i++) {
-        motors[i].update_ori(R);
+        motors[i].update_ori(mounts, motor_mount[i]);
         motors[i].update_inertia();
     }
 }
@@ -1,5 +1,34 @@
 #include "../include/RCS_jets.hh"
+#include <algorithm>
 #include <cmath>
+#include <stdexcept>
+
+namespace {
+// Largest layout for which every set of jets is tried, 2^16 sets
+const int MAX_ENUMERATED_JETS = 16;
+// Torques and forces below this fraction of the largest jet are zero
+const double ZERO_FRACTION = 1e-9;
+
+std::array<double, 3> cross(const std::array<double, 3>& r, const std::array<double, 3>& F) {
+    return {r[1]*F[2] - r[2]*F[1],
+            r[2]*F[0] - r[0]*F[2],
+            r[0]*F[1] - r[1]*F[0]};
+}
+
+double length(const std::array<double, 3>& v) {
+    return std::sqrt(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
+}
+
+// Index of the sign pattern of a vector, components within tol of 0 being 0
+int signPattern(const std::array<double, 3>& v, double tol) {
+    int index = 0, scale = 1;
+    for (int i = 0; i < 3; i++) {
+        index += (v[i] > tol ? 2 : (v[i] < -tol ? 0 : 1)) * scale;
+        scale *= 3;
+    }
+    return index;
+}
+}
 
 ReactionControlThrusters::ReactionControlThrusters(double width, double height, double depth, double maxThrust) {
     double x = width / 2.0;
@@ -23,30 +52,110 @@ ReactionControlThrusters::ReactionControlThrusters(double width, double height,
     thrusters.push_back({{-x, 0.0, 0.0}, { 0.0, -1.0, 0.0}, maxThrust});
     thrusters.push_back({{ x, 0.0, 0.0}, { 0.0, -1.0, 0.0}, maxThrust});
     thrusters.push_back({{-x, 0.0, 0.0}, { 0.0, 1.0, 0.0}, maxThrust});
+
+    buildTable();
 }
 
-void ReactionControlThrusters::commandTorque(const std::array<double, 3>& desiredTorque) {
-    for (auto& thruster : thrusters) {
-        thruster.isFiring = false;
+ReactionControlThrusters::ReactionControlThrusters(const std::vector<Thruster>& jets)
+    : thrusters(jets) {
+    buildTable();
+}
 
-        // Compute r × F for this thruster
-        const auto& r = thruster.position;
-        const auto& F = thruster.direction;
-        std::array<double, 3> torque = {
-            r[1]*F[2] - r[2]*F[1],
-            r[2]*F[0] - r[0]*F[2],
-            r[0]*F[1] - r[1]*F[0]
-        };
+void ReactionControlThrusters::buildTable() {
+    const int n = static_cast<int>(thrusters.size());
+    if (n > 32) throw std::invalid_argument("ReactionControlThrusters: at most 32 jets");
 
-        // Align torque direction with desired torque
-        double alignment = torque[0]*desiredTorque[0] +
-                           torque[1]*desiredTorque[1] +
-                           torque[2]*desiredTorque[2];
+    jetTorque.clear();
+    jetForce.clear();
+    double largestTorque = 0.0, largestForce = 0.0;
+    for (auto& thruster : thrusters) {
+        thruster.isFiring = false;
+        std::array<double, 3> F = {thruster.direction[0] * thruster.maxForce,
+                                   thruster.direction[1] * thruster.maxForce,
+                                   thruster.direction[2] * thruster.maxForce};
+        jetForce.push_back(F);
+        jetTorque.push_back(cross(thruster.position, F));
+        largestTorque = std::max(largestTorque, length(jetTorque.back()));
+        largestForce = std::max(largestForce, thruster.maxForce);
+    }
+    double torqueTol = ZERO_FRACTION * largestTorque;
+    double forceTol = ZERO_FRACTION * largestForce;
+
+    // Net force of each pattern's best set so far, -1 while none
+    std::array<double, 27> bestForce;
+    bestForce.fill(-1.0);
+    selection.fill(0);
+    selectionThrust.fill(0.0);
+    for (int p = 0; p < 27; p++) {
+        selectionTorque[p] = {0.0, 0.0, 0.0};
+        selectionForce[p] = {0.0, 0.0, 0.0};
+    }
+    bestForce[13] = 0.0;
+
+    if (n <= MAX_ENUMERATED_JETS) {
+        // Sums over every set, each from the set without its lowest jet
+        const std::uint32_t sets = 1u << n;
+        std::vector<std::array<double, 3>> torque(sets), force(sets);
+        std::vector<double> thrust(sets);
+        torque[0] = {0.0, 0.0, 0.0};
+        force[0] = {0.0, 0.0, 0.0};
+        thrust[0] = 0.0;
+        for (std::uint32_t m = 1; m < sets; m++) {
+            std::uint32_t rest = m & (m - 1);
+            int j = __builtin_ctz(m);
+            for (int i = 0; i < 3; i++) {
+                torque[m][i] = torque[rest][i] + jetTorque[j][i];
+                force[m][i] = force[rest][i] + jetForce[j][i];
+            }
+            thrust[m] = thrust[rest] + thrusters[j].maxForce;
+
+            int p = signPattern(torque[m], torqueTol);
+            if (p == 13) continue;
+            double F = length(force[m]);
+            if (F <= forceTol) F = 0.0;
+            bool better = bestForce[p] < 0.0 || F < bestForce[p] - forceTol ||
+                          (F <= bestForce[p] + forceTol && thrust[m] < selectionThrust[p] - forceTol);
+            if (!better) continue;
+            bestForce[p] = F;
+            selection[p] = m;
+            selectionTorque[p] = torque[m];
+            selectionForce[p] = force[m];
+            selectionThrust[p] = thrust[m];
+        }
+    }
 
-        if (alignment > 0.0) {
-            thruster.isFiring = true;
+    // Patterns no set produces: the jets whose torque points along the pattern
+    for (int p = 0; p < 27; p++) {
+        if (bestForce[p] >= 0.0) continue;
+        std::array<double, 3> s = {double(p % 3 - 1), double(p / 3 % 3 - 1), double(p / 9 - 1)};
+        for (int j = 0; j < n; j++) {
+            if (jetTorque[j][0]*s[0] + jetTorque[j][1]*s[1] + jetTorque[j][2]*s[2] <= 0.0) continue;
+            selection[p] |= FiringMask(1) << j;
+            for (int i = 0; i < 3; i++) {
+                selectionTorque[p][i] += jetTorque[j][i];
+                selectionForce[p][i] += jetForce[j][i];
+            }
+            selectionThrust[p] += thrusters[j].maxForce;
         }
     }
+    pattern = 13;
+}
+
+void ReactionControlThrusters::commandTorque(const std::array<double, 3>& desiredTorque) {
+    double largest = std::max({std::fabs(desiredTorque[0]), std::fabs(desiredTorque[1]), std::fabs(desiredTorque[2])});
+    pattern = signPattern(desiredTorque, deadband * largest);
+
+    FiringMask mask = selection[pattern];
+    for (size_t j = 0; j < thrusters.size(); j++)
+        thrusters[j].isFiring = (mask >> j) & 1u;
+}
+
+void ReactionControlThrusters::setDeadband(double fraction) {
+    deadband = fraction;
+}
+
+FiringMask ReactionControlThrusters::getFiringMask() const {
+    return selection[pattern];
 }
 
 std::vector<bool> ReactionControlThrusters::getFiringStates() const {
@@ -57,30 +166,15 @@ std::vector<bool> ReactionControlThrusters::getFiringStates() const {
 }
 
 std::array<double, 3> ReactionControlThrusters::getNetTorque() const {
-    std::array<double, 3> net = {0.0, 0.0, 0.0};
-
-    for (const auto& thruster : thrusters) {
-        if (!thruster.isFiring) continue;
-
-        std::array<double, 3> F = {
-            thruster.direction[0] * thruster.maxForce,
-            thruster.direction[1] * thruster.maxForce,
-            thruster.direction[2] * thruster.maxForce
-        };
-
-        const auto& r = thruster.position;
-        std::array<double, 3> torque = {
-            r[1]*F[2] - r[2]*F[1],
-            r[2]*F[0] - r[0]*F[2],
-            r[0]*F[1] - r[1]*F[0]
-        };
+    return selectionTorque[pattern];
+}
 
-        net[0] += torque[0];
-        net[1] += torque[1];
-        net[2] += torque[2];
-    }
+std::array<double, 3> ReactionControlThrusters::getNetForce() const {
+    return selectionForce[pattern];
+}
 
-    return net;
+double ReactionControlThrusters::getFiringThrust() const {
+    return selectionThrust[pattern];
 }
 
 const std::vector<Thruster>& ReactionControlThrusters::getThrusters() const {
@@ -2,7 +2,8 @@
 PURPOSE: (Simulate A Motor)
 LIBRARY DEPENDENCY:
     ((motor.o)
-     (control_wheels.o))
+     (control_wheels.o)
+     (Recources/src/frame_transforms.o))
 *******************************************************************************/
 
 #include <iostream>
@@ -315,6 +316,19 @@ void motor::update_ori(){
     R_matrix.inverse() * ref_ori;
     ori_set = true;
 }
+
+void motor::update_ori(const frame_transforms& frames, int handle)
+    //Description:      reads global orientation from a frame_transforms pass that moved all mounts at once
+    //Preconditions:    frames updated this cycle, handle returned when this motor's mount was registered
+    //Postconditions:   global orientation updated, same value as update_ori(R)
+{
+    if(R_matrix_set){
+        cerr << ORANGE << "Warning: " << RESET << "Rotation matrix was already set during this cycle. Ensure the values are not being set twice.\n \n";
+    }
+    R_matrix = frames.get_R();
+    ori = frames.get_ori(handle);
+    ori_set = true;
+}
 //-----------------------------------//
 
 //[[Update Position Orientation Funnction]]//
@@ -371,6 +385,31 @@ void motor::update_pos_ori(Vector3d ref){
     pos_set = true;
     ori_set = true;
 }
+
+void motor::update_pos_ori(const frame_transforms& frames, int handle)
+    //Description:      reads global position and orientation from a frame_transforms pass that moved all mounts at once
+    //Preconditions:    frames updated this cycle, handle returned when this motor's mount was registered
+    //Postconditions:   global orientation and position updated, same values as update_pos_ori(ref, R)
+{
+    if(R_matrix_set){
+        cerr << ORANGE << "Warning: " << RESET << "Rotation matrix was already set during this cycle. Ensure the values are not being set twice.\n \n";
+    }
+    R_matrix = frames.get_R();
+
+    pos = frames.get_pos(handle);
+    ori = frames.get_ori(handle);
+    R_matrix_set = true;
+    pos_set = true;
+    ori_set = true;
+}
+
+Vector3d motor::get_refrence_pos(){
+    return ref_pos;
+}
+
+Vector3d motor::get_refrence_ori(){
+    return ref_ori;
+}
 //-----------------------------------//
 
 //[[Get Position Function]]//
@@ -0,0 +1,338 @@
+/*
+PURPOSE:    This is the implementation of file 'wheel_array.hh'
+
+NOTE:       With fewer than three independent healthy axes A A^T is singular
+            and is regularized by 1e-9 of its trace before it is inverted;
+            along the axes that remain the allocation is unchanged to that
+            order. With three or more it is inverted as it is.
+*/
+
+#include "../include/wheel_array.hh"
+#include "../include/control_wheels.hh"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Motor and wheel of Attitude_Control_System: R 1, L 0.1, k_1 0.1, B 1, b 0.1, wheel 3 kg, 0.4 m by 0.4 m
+const double DEFAULT_R = 1.0;
+const double DEFAULT_L = 0.1;
+const double DEFAULT_K_T = 0.1;
+const double DEFAULT_B = 0.1;
+const double DEFAULT_MASS = 3.0;
+const double DEFAULT_RADIUS = 0.4;
+const double DEFAULT_HEIGHT = 0.4;
+const double ALLOCATION_REGULARIZATION = 1e-9;
+const double SINGULAR_DETERMINANT = 1e-12;
+}
+
+wheel_array::wheel_array()
+    //Description:      Creates an array without wheels.
+    //Preconditions:    None
+    //Postconditions:   Wheels are added with add_wheel or set_layout.
+    : allocation_valid(false), allocations_computed(0)
+{
+}
+
+wheel_array::wheel_array(wheel_layout layout, double tilt)
+    //Description:      Creates the wheels of a layout.
+    //Preconditions:    tilt in rad, used by WHEEL_PYRAMID only.
+    //Postconditions:   Every wheel is at rest, off, healthy and has the default motor and wheel.
+    : allocation_valid(false), allocations_computed(0)
+{
+    set_layout(layout, tilt);
+}
+
+void wheel_array::set_layout(wheel_layout layout, double tilt)
+    //Description:      Replaces the wheels by those of a layout.
+    //Preconditions:    tilt in rad, used by WHEEL_PYRAMID only.
+    //Postconditions:   The previous wheels are gone; the new ones are at rest, off and healthy.
+{
+    for (std::vector<double>* v : {&ax, &ay, &az, &R, &inv_L, &k_t, &b, &inv_J, &V, &I, &w}) v->clear();
+    healthy.clear();
+    allocation_valid = false;
+
+    if (layout == WHEEL_PYRAMID) {
+        for (int k = 0; k < 4; k++) {
+            double azimuth = M_PI / 4 + k * M_PI / 2;
+            add_wheel(Vector3d(sin(tilt) * cos(azimuth), sin(tilt) * sin(azimuth), cos(tilt)));
+        }
+        return;
+    }
+    add_wheel(Vector3d(1, 0, 0));
+    add_wheel(Vector3d(0, 1, 0));
+    add_wheel(Vector3d(0, 0, 1));
+    if (layout == WHEEL_NASA_SKEW) add_wheel(Vector3d(1, 1, 1));
+}
+
+int wheel_array::add_wheel(const Vector3d& axis)
+    //Description:      Adds a wheel spinning about an axis of the body.
+    //Preconditions:    axis is not zero.
+    //Postconditions:   The wheel is at rest, off, healthy and has the default motor and wheel. Returns its index.
+{
+    double n = axis.norm();
+    ax.push_back(axis.x / n);
+    ay.push_back(axis.y / n);
+    az.push_back(axis.z / n);
+    R.push_back(0.0);
+    inv_L.push_back(0.0);
+    k_t.push_back(0.0);
+    b.push_back(0.0);
+    inv_J.push_back(0.0);
+    V.push_back(0.0);
+    I.push_back(0.0);
+    w.push_back(0.0);
+    healthy.push_back(1);
+
+    int k = size() - 1;
+    set_motor(k, DEFAULT_R, DEFAULT_L, DEFAULT_K_T, DEFAULT_B);
+    set_wheel(k, DEFAULT_MASS, DEFAULT_RADIUS, DEFAULT_HEIGHT);
+    allocation_valid = false;
+    return k;
+}
+
+void wheel_array::set_motor(int k, double resistance, double inductance, double torque_const, double damping)
+    //Description:      Sets the constants of the motor of a wheel.
+    //Preconditions:    inductance > 0; torque_const is k_1 B of motor.
+    //Postconditions:   Used by the next derivative and torque.
+{
+    R.at(k) = resistance;
+    inv_L.at(k) = 1.0 / inductance;
+    k_t.at(k) = torque_const;
+    b.at(k) = damping;
+}
+
+void wheel_array::set_wheel(int k, double mass, double radius, double height)
+    //Description:      Sets the wheel of a motor from the mass and size of a cylinder.
+    //Preconditions:    mass and radius > 0.
+    //Postconditions:   The inertia about the spin axis is that of control_wheels, m r^2 / 2.
+{
+    control_wheels wheel(mass, radius, height);
+    wheel.calc_I_0();
+    double inertia[3][3];
+    wheel.get_I_0(inertia);
+    inv_J.at(k) = 1.0 / inertia[2][2];
+}
+
+void wheel_array::fail_wheel(int k)
+    //Description:      Marks a wheel as failed.
+    //Preconditions:    None
+    //Postconditions:   Its voltage is 0 and the next allocation leaves it out; it spins down on its own.
+{
+    if (!healthy.at(k)) return;
+    healthy[k] = 0;
+    V[k] = 0.0;
+    allocation_valid = false;
+}
+
+void wheel_array::restore_wheel(int k)
+    //Description:      Puts a failed wheel back.
+    //Preconditions:    None
+    //Postconditions:   The next allocation uses it again.
+{
+    if (healthy.at(k)) return;
+    healthy[k] = 1;
+    allocation_valid = false;
+}
+
+bool wheel_array::is_healthy(int k) const
+{
+    return healthy.at(k);
+}
+
+void wheel_array::update_allocation()
+{
+    int n = size();
+    // A A^T over the healthy wheels
+    double m[3][3] = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}};
+    for (int k = 0; k < n; k++) {
+        if (!healthy[k]) continue;
+        double a[3] = {ax[k], ay[k], az[k]};
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 3; j++) m[i][j] += a[i] * a[j];
+    }
+    double trace = m[0][0] + m[1][1] + m[2][2];
+    px.assign(n, 0.0);
+    py.assign(n, 0.0);
+    pz.assign(n, 0.0);
+    allocation_valid = true;
+    allocations_computed++;
+    // No healthy wheel, nothing to allocate
+    if (trace == 0.0) return;
+
+    Matrix3d M;
+    M.insert(m[0][0], m[0][1], m[0][2],
+             m[1][0], m[1][1], m[1][2],
+             m[2][0], m[2][1], m[2][2]);
+    double eps = 0.0;
+    if (fabs(M.determinant()) <= SINGULAR_DETERMINANT * trace * trace * trace)
+        eps = ALLOCATION_REGULARIZATION * trace;
+    M.insert(m[0][0] + eps, m[0][1], m[0][2],
+             m[1][0], m[1][1] + eps, m[1][2],
+             m[2][0], m[2][1], m[2][2] + eps);
+    Matrix3d M_inv = M.inverse();
+
+    // Row k of A^T (A A^T)^-1 is (M^-1 a_k)^T, M being symmetric
+    for (int k = 0; k < n; k++) {
+        if (!healthy[k]) continue;
+        Vector3d row;
+        row = M_inv * Vector3d(ax[k], ay[k], az[k]);
+        px[k] = row.x;
+        py[k] = row.y;
+        pz[k] = row.z;
+    }
+}
+
+void wheel_array::allocate(const Vector3d& command, double* out)
+    //Description:      Allocates a body frame command over the wheels with the minimum norm solution.
+    //Preconditions:    out holds size() values.
+    //Postconditions:   sum out[k] a_k is the command (its part along the healthy axes); failed wheels get 0.
+{
+    if (!allocation_valid) update_allocation();
+    int n = size();
+    for (int k = 0; k < n; k++) out[k] = px[k] * command.x + py[k] * command.y + pz[k] * command.z;
+}
+
+void wheel_array::command_voltage(const Vector3d& axis_voltage, double V_max)
+    //Description:      Sets the wheel voltages that produce body axis voltages, as three axis controllers command them.
+    //Preconditions:    V_max > 0.
+    //Postconditions:   If a wheel would exceed V_max all voltages are scaled by the same factor, keeping the direction.
+{
+    int n = size();
+    allocate(axis_voltage, V.data());
+    double largest = 0.0;
+    for (int k = 0; k < n; k++) largest = std::max(largest, fabs(V[k]));
+    if (largest > V_max) {
+        double scale = V_max / largest;
+        for (int k = 0; k < n; k++) V[k] *= scale;
+    }
+}
+
+void wheel_array::set_voltage(int k, double voltage)
+    //Description:      Sets the voltage of one motor.
+    //Preconditions:    None
+    //Postconditions:   A failed wheel stays at 0 V.
+{
+    if (healthy.at(k)) V[k] = voltage;
+}
+
+double wheel_array::get_voltage(int k) const
+{
+    return V.at(k);
+}
+
+int wheel_array::state_size() const
+{
+    return 2 * size();
+}
+
+void wheel_array::get_state(double* x) const
+{
+    std::copy(I.begin(), I.end(), x);
+    std::copy(w.begin(), w.end(), x + size());
+}
+
+void wheel_array::set_state(const double* x)
+{
+    std::copy(x, x + size(), I.begin());
+    std::copy(x + size(), x + 2 * size(), w.begin());
+}
+
+void wheel_array::state_deriv(double, const double* x, double* dxdt)
+    //Description:      Electrical and mechanical equations of every motor, dI and then dw.
+    //Preconditions:    x and dxdt hold state_size() values.
+    //Postconditions:   dxdt is the derivative of x at the present voltages.
+{
+    int n = size();
+    const double* __restrict i_a = x;
+    const double* __restrict w_a = x + n;
+    double* __restrict dI = dxdt;
+    double* __restrict dw = dxdt + n;
+    const double* __restrict v = V.data();
+    const double* __restrict r = R.data();
+    const double* __restrict il = inv_L.data();
+    const double* __restrict kt = k_t.data();
+    const double* __restrict d = b.data();
+    const double* __restrict ij = inv_J.data();
+    for (int k = 0; k < n; k++) dI[k] = (v[k] - r[k] * i_a[k] - kt[k] * w_a[k]) * il[k];
+    for (int k = 0; k < n; k++) dw[k] = (kt[k] * i_a[k] - d[k] * w_a[k]) * ij[k];
+}
+
+void wheel_array::propagate(ode_integrator& integrator, double t, double dt)
+    //Description:      Advances all currents and speeds over a step with the voltages held.
+    //Preconditions:    dt > 0.
+    //Postconditions:   Currents and speeds are at t + dt.
+{
+    std::vector<double> x(state_size());
+    get_state(x.data());
+    integrator.integrate(*this, t, x.data(), t + dt);
+    set_state(x.data());
+}
+
+double wheel_array::get_max_step() const
+    //Description:      Returns the step that keeps h |lambda| <= 1 for the fastest mode of every motor.
+    //Preconditions:    None
+    //Postconditions:   0 for an array without wheels.
+{
+    double fastest = 0.0;
+    for (int k = 0; k < size(); k++)
+        fastest = std::max({fastest, (R[k] + k_t[k]) * inv_L[k], (k_t[k] + b[k]) * inv_J[k]});
+    return fastest > 0.0 ? 1.0 / fastest : 0.0;
+}
+
+Vector3d wheel_array::get_body_torque() const
+    //Description:      Returns the torque of all motors in the body frame.
+    //Preconditions:    None
+    //Postconditions:   sum (k_t I - b w) a over the wheels.
+{
+    double tx = 0.0, ty = 0.0, tz = 0.0;
+    int n = size();
+    for (int k = 0; k < n; k++) {
+        double T = k_t[k] * I[k] - b[k] * w[k];
+        tx += T * ax[k];
+        ty += T * ay[k];
+        tz += T * az[k];
+    }
+    return Vector3d(tx, ty, tz);
+}
+
+Vector3d wheel_array::get_total_torque(const Matrix3d& R_matrix) const
+    //Description:      Returns the torque of all motors in the global frame.
+    //Preconditions:    The rotation matrix of the body.
+    //Postconditions:   R^-1 times the body frame torque, the sum of motor::get_torque_vec over the motors.
+{
+    Vector3d torque;
+    torque = R_matrix.inverse() * get_body_torque();
+    return torque;
+}
+
+double wheel_array::get_I(int k) const
+{
+    return I.at(k);
+}
+
+double wheel_array::get_omega(int k) const
+{
+    return w.at(k);
+}
+
+Vector3d wheel_array::get_axis(int k) const
+{
+    return Vector3d(ax.at(k), ay.at(k), az.at(k));
+}
+
+double wheel_array::get_power() const
+{
+    double P = 0.0;
+    for (int k = 0; k < size(); k++) P += fabs(V[k] * I[k]);
+    return P;
+}
+
+int wheel_array::size() const
+{
+    return static_cast<int>(ax.size());
+}
+
+int wheel_array::get_allocations_computed() const
+{
+    return allocations_computed;
+}
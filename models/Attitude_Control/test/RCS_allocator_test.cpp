@@ -0,0 +1,136 @@
+/*
+PURPOSE: (Checks the jet selection of ReactionControlThrusters: on the box
+          layout it fires the same jets as firing every jet aligned with
+          the torque, on a layout of canted corner jets it fires half of
+          them for the same torque direction with no net force, the
+          deadband keeps a small cross axis component from firing a pair,
+          and times a command against recomputing r x F for every jet.)
+COMMANDS:
+    : g++ -O2 src/RCS_jets.cpp test/RCS_allocator_test.cpp -o RCS_allocator_program
+*/
+
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include "../include/RCS_jets.hh"
+#include "../../Recources/include/test_checks.hh"
+
+using namespace std;
+
+// Jets whose r x F has a positive dot product with the torque, computed on every call
+FiringMask aligned_jets(const vector<Thruster>& jets, const array<double, 3>& T) {
+    FiringMask mask = 0;
+    for (size_t j = 0; j < jets.size(); j++) {
+        const auto& r = jets[j].position;
+        const auto& F = jets[j].direction;
+        double alignment = (r[1]*F[2] - r[2]*F[1]) * T[0] + (r[2]*F[0] - r[0]*F[2]) * T[1] + (r[0]*F[1] - r[1]*F[0]) * T[2];
+        if (alignment > 0.0) mask |= FiringMask(1) << j;
+    }
+    return mask;
+}
+
+double thrust_of(const vector<Thruster>& jets, FiringMask mask) {
+    double thrust = 0.0;
+    for (size_t j = 0; j < jets.size(); j++)
+        if ((mask >> j) & 1u) thrust += jets[j].maxForce;
+    return thrust;
+}
+
+double length(const array<double, 3>& v) {
+    return sqrt(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
+}
+
+int main(){
+    bool ok = true;
+    mt19937 gen(3);
+    uniform_real_distribution<double> u(-1.0, 1.0);
+
+    {
+        cout << "=== box layout against the aligned jets ===\n";
+        ReactionControlThrusters rcs(1.0, 1.0, 1.0, 0.1);
+        int differ = 0;
+        double largest_force = 0.0;
+        for (int k = 0; k < 10000; k++) {
+            // Every sign pattern including zero components
+            array<double, 3> T = {u(gen), u(gen), u(gen)};
+            for (double& c : T) if (fabs(c) < 0.3) c = 0.0;
+            rcs.commandTorque(T);
+            if (rcs.getFiringMask() != aligned_jets(rcs.getThrusters(), T)) differ++;
+            largest_force = max(largest_force, length(rcs.getNetForce()));
+        }
+        ok &= check("commands firing other jets", differ, 0, 0);
+        ok &= check_below("largest net force (N)", largest_force, 1e-12);
+
+        rcs.commandTorque({0.05, 0.0, 0.0});
+        auto states = rcs.getFiringStates();
+        ok &= check("firing states agree with the mask", states[0] && states[1] && !states[2] && rcs.getFiringMask() == 3u, 1, 0);
+        ok &= check("roll torque", rcs.getNetTorque()[0], 0.1, 1e-12);
+    }
+
+    {
+        cout << "=== canted corner jets ===\n";
+        // Four corners of the z = 0 plane, each with a +z and a -z jet: roll and pitch only
+        vector<Thruster> jets;
+        for (double x : {0.3, -0.3})
+            for (double y : {0.3, -0.3})
+                for (double dz : {1.0, -1.0})
+                    jets.push_back({{x, y, 0.0}, {0.0, 0.0, dz}, 0.5});
+        ReactionControlThrusters rcs(jets);
+        double thrust_new = 0.0, thrust_aligned = 0.0, largest_force = 0.0;
+        int wrong_sign = 0;
+        for (int k = 0; k < 10000; k++) {
+            array<double, 3> T = {u(gen), u(gen), 0.0};
+            rcs.commandTorque(T);
+            thrust_new += rcs.getFiringThrust();
+            thrust_aligned += thrust_of(jets, aligned_jets(jets, T));
+            largest_force = max(largest_force, length(rcs.getNetForce()));
+            auto net = rcs.getNetTorque();
+            if (net[0] * T[0] <= 0.0 || net[1] * T[1] <= 0.0) wrong_sign++;
+        }
+        ok &= check("propellant against the aligned jets", thrust_new / thrust_aligned, 0.5, 1e-12);
+        ok &= check("torques of the wrong sign", wrong_sign, 0, 0);
+        ok &= check_below("largest net force (N)", largest_force, 1e-12);
+
+        // Pure roll: one +z jet and one -z jet, where the aligned rule fires four
+        rcs.commandTorque({1.0, 0.0, 0.0});
+        ok &= check("jets for pure roll", __builtin_popcount(rcs.getFiringMask()), 2, 0);
+        ok &= check("aligned jets for pure roll", __builtin_popcount(aligned_jets(jets, {1.0, 0.0, 0.0})), 4, 0);
+        ok &= check("roll torque", rcs.getNetTorque()[0], 0.3, 1e-12);
+        ok &= check("pitch torque", rcs.getNetTorque()[1], 0.0, 1e-12);
+    }
+
+    {
+        cout << "=== deadband ===\n";
+        ReactionControlThrusters rcs(1.0, 1.0, 1.0, 0.1);
+        rcs.commandTorque({1.0, 0.02, 0.0});
+        ok &= check("jets without a deadband", __builtin_popcount(rcs.getFiringMask()), 4, 0);
+        rcs.setDeadband(0.05);
+        rcs.commandTorque({1.0, 0.02, 0.0});
+        ok &= check("jets with a 5 % deadband", __builtin_popcount(rcs.getFiringMask()), 2, 0);
+        rcs.commandTorque({0.0, 0.0, 0.0});
+        ok &= check("jets for no torque", rcs.getFiringMask(), 0, 0);
+    }
+
+    {
+        cout << "=== nanoseconds per command ===\n";
+        const int n = 1000000;
+        ReactionControlThrusters rcs(1.0, 1.0, 1.0, 0.1);
+        vector<array<double, 3>> T(1024);
+        for (auto& t : T) t = {u(gen), u(gen), u(gen)};
+        FiringMask sum = 0;
+        auto start = chrono::steady_clock::now();
+        for (int k = 0; k < n; k++) {
+            rcs.commandTorque(T[k & 1023]);
+            sum ^= rcs.getFiringMask();
+        }
+        double t_table = chrono::duration<double>(chrono::steady_clock::now() - start).count() / n;
+        start = chrono::steady_clock::now();
+        for (int k = 0; k < n; k++) sum ^= aligned_jets(rcs.getThrusters(), T[k & 1023]);
+        double t_aligned = chrono::duration<double>(chrono::steady_clock::now() - start).count() / n;
+        printf("  table       %5.1f\n  r x F each  %5.1f  (%u)\n", 1e9 * t_table, 1e9 * t_aligned, sum & 1u);
+    }
+
+    return report(ok);
+}
@@ -0,0 +1,178 @@
+/*
+PURPOSE: (Checks the reaction wheel array: three orthogonal wheels run the
+          motor equations of Attitude_Control_System with an identity
+          allocation, the pyramid and the 3 + 1 skew realize a commanded
+          torque with the minimum norm allocation, a failed wheel costs one
+          new pseudo-inverse and the others still realize the command, and
+          times a step for 3, 4 and more wheels.)
+COMMANDS:
+    : g++ -O2 src/wheel_array.cpp src/Attitude_Control_System.cpp src/motor.cpp src/control_wheels.cpp ../Recources/src/ode_integrator.cpp ../Recources/src/frame_transforms.cpp ../Recources/src/Linear_Algebra.cpp test/wheel_array_test.cpp -o wheel_array_program
+*/
+
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "../include/wheel_array.hh"
+#include "../include/Attitude_Control_System.hh"
+#include "../../Recources/include/test_checks.hh"
+
+using namespace std;
+
+// |sum u_k a_k - c|, the part of a command the allocation does not realize
+double realized_error(const wheel_array& wheels, const double* u, const Vector3d& c) {
+    Vector3d sum(0, 0, 0);
+    for (int k = 0; k < wheels.size(); k++) {
+        Vector3d a = wheels.get_axis(k);
+        sum = sum + a * u[k];
+    }
+    Vector3d diff;
+    diff = sum - c;
+    return diff.norm();
+}
+
+// Nanoseconds per RK4 step of the motors with the allocation of a new command every step
+double time_step(wheel_array& wheels, int steps) {
+    ode_integrator integrator(ODE_RK4);
+    auto start = chrono::steady_clock::now();
+    for (int s = 0; s < steps; s++) {
+        wheels.command_voltage(Vector3d(sin(0.01 * s), cos(0.01 * s), 0.5), 10.0);
+        wheels.propagate(integrator, 0.025 * s, 0.025);
+    }
+    return 1e9 * chrono::duration<double>(chrono::steady_clock::now() - start).count() / steps;
+}
+
+int main(){
+    bool ok = true;
+
+    {
+        cout << "=== three orthogonal wheels against Attitude_Control_System ===\n";
+        wheel_array wheels(WHEEL_ORTHOGONAL);
+        double u[3];
+        wheels.allocate(Vector3d(1.5, -2.0, 0.25), u);
+        ok &= check("allocation x", u[0], 1.5, 1e-12);
+        ok &= check("allocation y", u[1], -2.0, 1e-12);
+        ok &= check("allocation z", u[2], 0.25, 1e-12);
+
+        Attitude_Control_System ACS;
+        double identity[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+        double x[6] = {0.3, -0.2, 0.1, 4.0, -1.0, 2.5}, V[3] = {5.0, -3.0, 1.0};
+        for (int i = 0; i < 3; i++) {
+            ACS.motor_clock(i, V[i]);
+            wheels.set_voltage(i, V[i]);
+        }
+        ACS.update_all_ori(identity);
+        ACS.updateAll_I(x);
+        ACS.updateAll_omega(x + 3);
+        wheels.set_state(x);
+
+        double dI[3], dx[6];
+        ACS.state_deriv_getALL_dI(dI);
+        wheels.state_deriv(0.0, x, dx);
+        for (int i = 0; i < 3; i++) ok &= check("dI", dx[i], dI[i], 1e-12);
+        // J = m r^2 / 2 of the 3 kg, 0.4 m wheel
+        for (int i = 0; i < 3; i++) ok &= check("dw", dx[3 + i], (0.1 * x[i] - 0.1 * x[3 + i]) / 0.24, 1e-12);
+
+        double T[3];
+        ACS.get_total_torque(T);
+        Matrix3d R;
+        R.insert(1, 0, 0, 0, 1, 0, 0, 0, 1);
+        Vector3d torque = wheels.get_total_torque(R);
+        ok &= check("torque x", torque.x, T[0], 1e-12);
+        ok &= check("torque y", torque.y, T[1], 1e-12);
+        ok &= check("torque z", torque.z, T[2], 1e-12);
+
+        // Fastest mode bounded by (R + k_t) / L = 11 1/s
+        ok &= check("largest step", wheels.get_max_step(), 1.0 / 11.0, 1e-12);
+    }
+
+    {
+        cout << "=== redundant layouts ===\n";
+        Vector3d c(0.02, -0.01, 0.03);
+        for (wheel_layout layout : {WHEEL_PYRAMID, WHEEL_NASA_SKEW}) {
+            wheel_array wheels(layout);
+            double u[4];
+            wheels.allocate(c, u);
+            ok &= check_below(layout == WHEEL_PYRAMID ? "pyramid, |A u - c|" : "skew, |A u - c|", realized_error(wheels, u, c), 1e-12);
+
+            // Minimum norm: moving along the null space of A only adds to |u|
+            double null_space[4];
+            if (layout == WHEEL_PYRAMID) {
+                double n[4] = {1, -1, 1, -1};
+                copy(n, n + 4, null_space);
+            } else {
+                double n[4] = {1, 1, 1, -sqrt(3.0)};
+                copy(n, n + 4, null_space);
+            }
+            double along = 0.0;
+            for (int k = 0; k < 4; k++) along += u[k] * null_space[k];
+            ok &= check("component along the null space", along, 0.0, 1e-12);
+        }
+
+        // Equal capacity about every axis at the default tilt
+        wheel_array pyramid(WHEEL_PYRAMID);
+        double ux[4], uz[4];
+        pyramid.allocate(Vector3d(1, 0, 0), ux);
+        pyramid.allocate(Vector3d(0, 0, 1), uz);
+        double nx = 0, nz = 0;
+        for (int k = 0; k < 4; k++) {
+            nx += ux[k] * ux[k];
+            nz += uz[k] * uz[k];
+        }
+        ok &= check("pyramid |u| about x over |u| about z", sqrt(nx / nz), 1.0, 1e-12);
+    }
+
+    {
+        cout << "=== failing a wheel ===\n";
+        wheel_array wheels(WHEEL_NASA_SKEW);
+        Vector3d c(0.5, 0.2, -0.4);
+        double u[4];
+        for (int s = 0; s < 100; s++) wheels.allocate(c, u);
+        ok &= check("pseudo-inverses for 100 commands", wheels.get_allocations_computed(), 1, 0);
+
+        wheels.fail_wheel(0);
+        for (int s = 0; s < 100; s++) wheels.allocate(c, u);
+        ok &= check("after failing x, one more", wheels.get_allocations_computed(), 2, 0);
+        ok &= check("failed wheel gets", u[0], 0.0, 0);
+        ok &= check_below("|A u - c| without x", realized_error(wheels, u, c), 1e-12);
+
+        wheels.restore_wheel(0);
+        wheels.allocate(c, u);
+        ok &= check("after restoring, one more", wheels.get_allocations_computed(), 3, 0);
+
+        // Two wheels left of the orthogonal three: the remaining axes get their share, the lost one nothing
+        wheel_array two(WHEEL_ORTHOGONAL);
+        two.fail_wheel(2);
+        double v[3];
+        two.allocate(c, v);
+        ok &= check("x of two wheels", v[0], 0.5, 1e-9);
+        ok &= check("y of two wheels", v[1], 0.2, 1e-9);
+        ok &= check("z of two wheels", v[2], 0.0, 0);
+
+        // The failed wheel spins down while the others are driven
+        ode_integrator integrator(ODE_RK4);
+        wheels.command_voltage(Vector3d(10, 10, 10), 10.0);
+        for (int s = 0; s < 400; s++) wheels.propagate(integrator, 0.025 * s, 0.025);
+        double spin = wheels.get_omega(0);
+        wheels.fail_wheel(0);
+        for (int s = 0; s < 400; s++) wheels.propagate(integrator, 10.0 + 0.025 * s, 0.025);
+        ok &= check_below("|w| of the failed wheel over its speed when it failed", fabs(wheels.get_omega(0) / spin), 0.5);
+        ok &= check("voltage of the failed wheel", wheels.get_voltage(0), 0.0, 0);
+    }
+
+    {
+        cout << "=== nanoseconds per step ===\n";
+        const int steps = 200000;
+        wheel_array three(WHEEL_ORTHOGONAL), four(WHEEL_NASA_SKEW), six(WHEEL_PYRAMID);
+        six.add_wheel(Vector3d(1, 0, 0));
+        six.add_wheel(Vector3d(0, 1, 0));
+        double t3 = time_step(three, steps);
+        double t4 = time_step(four, steps);
+        double t6 = time_step(six, steps);
+        printf("  3 wheels  %6.1f\n  4 wheels  %6.1f\n  6 wheels  %6.1f\n", t3, t4, t6);
+        ok &= check("pseudo-inverses for the 4 wheels", four.get_allocations_computed(), 1, 0);
+    }
+
+    return report(ok);
+}
@@ -24,6 +24,8 @@ EQUATIONS TO MODEL:
 #ifndef BATTERY_HH
 #define BATTERY_HH
 
+#include "battery_chemistry.hh"
+
 #ifdef __cplusplus
 	extern "C"
 	{
@@ -47,6 +49,13 @@ class battery {
     	double Vt;  // Total voltage output
     	double V_min; // Minimum voltage level
 
+    	double R_0_base, R1_base, R2_base; // Resistances the battery was given, used without resistance tables
+    	const battery_chemistry* chemistry; // Tables of OCV and resistances, null for findOCV
+    	double T;   // Cell temperature in K
+
+    	// Description: Brings OCV (and the resistances of a chemistry) up to date with soc
+    	void update_ocv();
+
 	public:
     	// Description: Default constructor creating a battery object
     	battery();
@@ -72,6 +81,22 @@ class battery {
     	
     	// Description: Updates the state of charge of the battery
     	void update_soc(double /*delta time*/);
+
+    	// Description: Advances soc, V1, V2 and Vt by dt in closed form with the current held
+    	void propagate(double /*delta time*/);
+
+    	// Description: Time until soc reaches a level at the present current, infinity if it is not heading there
+    	double time_to_soc(double /*level*/);
+
+    	// Description: Time until V1 and V2 are within a tolerance of their steady values at the present current
+    	double time_to_settle(double /*tolerance*/);
+
+    	// Description: Takes OCV (and resistances, if it has them) from a chemistry from now on; null goes back to findOCV
+    	void set_chemistry(const battery_chemistry* /*chemistry*/);
+
+    	// Description: Sets the cell temperature the chemistry tables are read at
+    	void set_T(double /*temperature*/);
+    	double get_T();
     	
     	// Description: Updates the voltage across the first component
     	void update_V1(double /*Voltage 1*/);
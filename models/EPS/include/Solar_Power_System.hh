@@ -1,5 +1,11 @@
 /*
 PURPOSE:    Simulate the power generated by a solar array by following the IV curve
+
+NOTE:       The curve is the single diode model
+                I = I_L - I_s e^((V + I Rs - V_oc) / a) - (V + I Rs) / Rsh
+            update_I solves it with Newton's method started from the current
+            of the last call, get_I_at with the Lambert W closed form.
+            solar_iv_table precomputes the curve for batches of strings.
 */
 
 #ifndef SOLAR_POWER_SYSTEM_HH
@@ -21,8 +27,24 @@ class solar_array {
     	// Description: Initializes the solar array with given parameters
     	void initialize(double /*oc_voltage*/, double /*sc_current*/, double /*max_voltage*/, double /*max_current*/, double /*voltage_terminal*/);
     	
-    	// Description: Updates the output current based on the current state
+    	// Description: Updates the output current at the set voltage (Newton, warm started from the last current)
     	void update_I();
+
+    	// Description: Output current at voltage V and short circuit current I_sc, from the Lambert W closed form
+    	double get_I_at(double /*voltage*/, double /*sc_current*/) const;
+
+    	// Description: The same current before it is clamped at zero (negative past open circuit)
+    	double get_I_unclamped(double /*voltage*/, double /*sc_current*/) const;
+
+    	// Description: Sets the cell temperature in K (the curve is given at T_ref = 298.15 K)
+    	void set_T(double /*temperature*/);
+    	double get_T() const;
+
+    	// Description: Open circuit voltage at the set temperature and short circuit current
+    	double get_V_oc() const;
+
+    	// Description: Newton iterations taken by the last update_I
+    	int get_iterations() const;
     	
     	// Description: Updates the terminal voltage of the solar array
     	void update_V(double /*voltage*/);
@@ -62,6 +84,19 @@ class solar_array {
     	double Tc_I; /* Temperature coefficient for current */
 
     	double dI; /* Change in current per change in voltage */
+
+    	double G_sh; /* Shunt conductance, 1 / Rsh (0 when I_sc = I_mp) */
+    	double I_s; /* Diode current at V + I Rs = V_oc */
+    	double T; /* Cell temperature */
+    	int iterations; /* Newton iterations of the last update_I */
+
+    	// Derives Rs, Rsh and I_s from the curve points
+    	void set_parameters();
+
+    	// Light current, diode voltage scale and open circuit voltage at the set temperature
+    	double light_I(double /*sc_current*/) const;
+    	double diode_a() const;
+    	double diode_V_oc() const;
 };
 
 #ifdef __cplusplus
@@ -34,9 +34,14 @@ public:
     // Current-driven mode
     void update_voltage_from_curr(double current, double prev_current, double dt);
 
+    // Implicit steps in voltage-driven mode, stable at any dt (the terminal voltage is held over the step)
+    void step(double Vt, double dt);                     // TR-BDF2, second order
+    void step_backward_euler(double Vt, double dt);      // first order
+
     // Accessors
     double get_current();
     double get_voltage();
+    double get_Vc();
     double get_R();
     double get_L();
     double get_C();
@@ -0,0 +1,59 @@
+/*
+PURPOSE:    Cell data of a battery chemistry: open circuit voltage and the
+            resistances of the equivalent circuit over state of charge and
+            temperature, read from a file at startup so a battery can be
+            given another chemistry without code edits.
+
+NOTE:       A CSV file has the columns
+                soc, T, ocv, R0, R1, R2
+            (T in K, optional; R0, R1 and R2 optional and only together),
+            one row per point, as read by read_tables_csv. Any other file is
+            read as binary tables with the same names (write with save).
+            The points are resampled onto a grid of 101 x 9 points with the
+            monotone cubic along soc, so every lookup is O(1).
+
+            Without an ocv table the open circuit voltage is findOCV; without
+            resistance tables a battery keeps its own resistances.
+
+TERMS USED:
+    -> soc - state of charge
+    -> T   - cell temperature in K
+*/
+
+#ifndef BATTERY_CHEMISTRY_HH
+#define BATTERY_CHEMISTRY_HH
+
+#include <string>
+#include "../../Recources/include/interp_table.hh"
+
+class battery_chemistry {
+    public:
+        // Description: No tables; the open circuit voltage of findOCV
+        battery_chemistry();
+
+        // Description: Reads the tables of a chemistry from a CSV or binary file
+        void load(const std::string& /*path*/, int /*points over soc*/ = 101, int /*points over T*/ = 9,
+                  interp_method /*method*/ = INTERP_MONOTONE_CUBIC);
+
+        // Description: Writes the tables in binary form, which load reads without resampling
+        void save(const std::string& /*path*/) const;
+
+        // Description: Sets the tables directly
+        void set_ocv(const interp_table& /*ocv*/);
+        void set_resistances(const interp_table& /*R0*/, const interp_table& /*R1*/, const interp_table& /*R2*/);
+
+        bool has_ocv() const;
+        bool has_resistances() const;
+
+        // Description: Open circuit voltage at a state of charge and temperature
+        double get_ocv(double /*state of charge*/, double /*temperature*/) const;
+
+        // Description: Resistances at a state of charge and temperature; false (and unchanged) without tables
+        bool get_resistances(double /*state of charge*/, double /*temperature*/,
+                             double& /*R0*/, double& /*R1*/, double& /*R2*/) const;
+
+    private:
+        interp_table ocv, R0, R1, R2;
+};
+
+#endif
@@ -0,0 +1,124 @@
+/*
+PURPOSE:    This class models a battery pack of many cells, each the same
+            equivalent circuit as battery (OCV behind R_0 and two RC
+            branches), wired as series groups of parallel cells. The cells
+            are kept in structure-of-arrays form so a step of the whole
+            pack is a few straight loops over contiguous arrays.
+
+NOTE:       The RC branches are stepped with their exact solution for a
+            current held over the step,
+                V(t+dt) = V(t) e^(-dt/tau) + I R (1 - e^(-dt/tau)),  tau = R C
+            which is stable and exact for any dt, so a pack study can take
+            1 s or longer steps where the explicit integration of battery
+            needs dt well below tau. The decay factors are computed with
+            vexp once per dt and reused while dt does not change.
+
+            The pack current flows through every series group. Inside a
+            group the parallel cells share one terminal voltage, so the
+            current splits by their open circuit voltages (less the RC
+            voltages) over R_0 at the start of each step.
+
+            Cells are numbered group by group: cell = group * parallel + j.
+            The state of charge is limited to SOC_MIN .. SOC_MAX as in
+            battery, and like battery a cell at a limit carries no current
+            that would take it further. Its group shares the pack current
+            among the other cells; a group with every cell cut off passes
+            none.
+
+TERMS USED:
+    -> series   - number of groups in series
+    -> parallel - number of cells in parallel in every group
+    -> E        - OCV - V1 - V2, the voltage of a cell behind R_0
+    -> decay    - e^(-dt/tau) of an RC branch
+*/
+
+#ifndef BATTERY_PACK_HH
+#define BATTERY_PACK_HH
+
+#include <vector>
+
+class battery_pack {
+    public:
+        // Description: Creates an empty pack; initialize sets the topology
+        battery_pack();
+
+        // Description: Creates a series x parallel pack of default cells (the defaults of battery)
+        battery_pack(int /*series*/, int /*parallel*/);
+
+        // Description: Sets the topology and gives every cell the same parameters
+        void initialize(int /*series*/, int /*parallel*/, double /*capacity*/, double /*resistor0*/,
+                        double /*resistor1*/, double /*resistor2*/, double /*capacitor1*/,
+                        double /*capacitor2*/, double /*state of charge*/);
+
+        // Description: Sets the parameters of one cell
+        void set_cell(int /*cell*/, double /*capacity*/, double /*resistor0*/, double /*resistor1*/,
+                      double /*resistor2*/, double /*capacitor1*/, double /*capacitor2*/,
+                      double /*state of charge*/);
+
+        // Description: Scatters capacity, resistances and capacitances of every cell by a relative
+        //              standard deviation (cell to cell variation), repeatable from the seed
+        void vary_cells(double /*relative spread*/, unsigned /*seed*/);
+
+        // Description: Advances every cell by dt with the pack current held (positive discharges)
+        void step(double /*pack current*/, double /*delta time*/);
+
+        // Description: Pack terminal voltage at the current of the last step
+        double get_V() const;
+
+        // Description: State of one cell
+        double get_cell_I(int /*cell*/) const;
+        double get_cell_soc(int /*cell*/) const;
+        double get_cell_V1(int /*cell*/) const;
+        double get_cell_V2(int /*cell*/) const;
+        double get_cell_Vt(int /*cell*/) const;
+
+        // Description: Mean, lowest and highest state of charge over the cells
+        double get_mean_soc() const;
+        double get_min_soc() const;
+        double get_max_soc() const;
+
+        int get_series() const;
+        int get_parallel() const;
+        int size() const;
+
+    private:
+        void resize(int /*series*/, int /*parallel*/);
+
+        // E of every cell and the sums of G_0 and G_0 E of the groups, after the state changes
+        void update_emf();
+        void update_group(int /*group*/);
+
+        // Splits the pack current over the cells of each group and sets the group voltages
+        void split_current(double /*pack current*/);
+
+        // A cell at a state of charge limit that its current would take further
+        bool at_limit(int /*cell*/) const;
+
+        // Splits the current of a group that has cells at a limit over the others; returns the group voltage
+        double split_limited(int /*group*/, double /*pack current*/);
+
+        int n_series;
+        int n_parallel;
+        int n;
+
+        // Parameters per cell
+        std::vector<double> Q, R_0, R1, R2, C1, C2;
+        std::vector<double> G_0;            // 1 / R_0
+
+        // State per cell
+        std::vector<double> soc, V1, V2, I;
+        std::vector<double> E;
+
+        // e^(-dt/tau) of both branches for decay_dt
+        std::vector<double> decay1, decay2;
+        double decay_dt;
+
+        // Per group: terminal voltage, sum of G_0 and of G_0 E
+        std::vector<double> V_group, G_group, GE_group;
+        double I_pack;
+
+        // Cells of the group being split that are cut off at a limit
+        std::vector<char> cut;
+};
+
+#endif
@@ -0,0 +1,181 @@
+/*
+PURPOSE:    Solves the EPS harness as one DC circuit with modified nodal
+            analysis (MNA). Buses, wire segments, batteries, solar arrays
+            and loads are elements between numbered nodes; every solve
+            gives the voltage of each node and the current of each element.
+
+NOTE:       The MNA matrix is factored with a sparse LU in three levels,
+            each redone only when needed:
+                symbolic - fill reducing ordering and the pattern of L and
+                           U, when a node or element is added
+                numeric  - the values of L and U, when a conductance
+                           changes (a load switches, a resistance is set)
+                solve    - forward and back substitution, every call;
+                           source voltages, currents and powers only
+                           change the right hand side
+            A harness is a sparse, mostly tree shaped network, so the
+            factors stay close to the size of the matrix and the cost of a
+            tick grows with the number of elements, not with its cube.
+
+            The pivots are chosen once, in the symbolic step. Each voltage
+            source comes first as a pair: its equation eliminates its
+            positive node and that node's equation eliminates the source
+            current, both with pivot 1, which fixes the node voltage
+            before anything else is eliminated. The remaining nodes are
+            ordered by minimum degree. Every node has a tiny conductance
+            to ground (GMIN), so what is left is positive definite and
+            needs no pivoting, also while part of the harness is
+            switched off.
+
+            Constant power loads draw I = P/V. The matrix carries the slope
+            of P/V at the voltages of the last numeric factorization and
+            the rest of the current is iterated on the right hand side, so
+            a changing load only repeats the solve step (a chord Newton
+            method). The result is exact whatever slope the matrix holds;
+            a fresh slope only makes it converge in fewer steps.
+
+            A battery is its open circuit voltage in series with R_0, a
+            solar array a current source (its I-V curve is applied by the
+            caller). Wires enter with their resistance; L and C do not act
+            at DC.
+
+TERMS USED:
+    -> node    - a point of the harness, circuit_network::GROUND (0) is
+                 the reference
+    -> element - a resistor, load, source or battery between two nodes
+    -> branch  - extra unknown of MNA, the current through a voltage source
+    -> GMIN    - conductance from every node to ground, 1e-12 S
+*/
+
+#ifndef CIRCUIT_NETWORK_HH
+#define CIRCUIT_NETWORK_HH
+
+#include <vector>
+#include "Wire.hh"
+
+enum circuit_element_type {
+    CE_RESISTOR,
+    CE_LOAD,
+    CE_POWER_LOAD,
+    CE_CURRENT_SOURCE,
+    CE_VOLTAGE_SOURCE
+};
+
+class circuit_network {
+    public:
+        // The reference node, present in every network
+        static constexpr int GROUND = 0;
+
+        // Description: An empty network holding only the ground node
+        circuit_network();
+
+        // Description: Adds a node and returns its index
+        int add_node();
+
+        // Description: Adds a resistor between nodes a and b; returns the element index
+        int add_resistor(int /*a*/, int /*b*/, double /*R*/);
+
+        // Description: Adds a wire segment between nodes a and b with the resistance of the wire
+        int add_wire(int /*a*/, int /*b*/, wire& /*segment*/);
+
+        // Description: Adds a resistive load from a to b that can be switched on and off
+        int add_load(int /*a*/, int /*b*/, double /*R*/, bool /*on*/ = true);
+
+        // Description: Adds a load from a to b that draws a constant power
+        int add_power_load(int /*a*/, int /*b*/, double /*P*/, bool /*on*/ = true);
+
+        // Description: Adds a source driving I from node from into node to (a solar array feeds GROUND -> bus)
+        int add_current_source(int /*from*/, int /*to*/, double /*I*/);
+
+        // Description: Adds an ideal voltage source, V(pos) - V(neg) = V
+        int add_voltage_source(int /*pos*/, int /*neg*/, double /*V*/);
+
+        // Description: Adds a battery, its open circuit voltage behind R_0; returns the index of its source
+        int add_battery(int /*pos*/, int /*neg*/, double /*ocv*/, double /*R_0*/);
+
+        // Description: Switches a load or power load (refactors on the next solve)
+        void set_on(int /*element*/, bool /*on*/);
+
+        // Description: Sets the resistance of a resistor or load (refactors on the next solve)
+        void set_resistance(int /*element*/, double /*R*/);
+
+        // Description: Sets the power of a power load, the current of a current source or the voltage of a source
+        void set_power(int /*element*/, double /*P*/);
+        void set_current(int /*element*/, double /*I*/);
+        void set_voltage(int /*element*/, double /*V*/);
+
+        // Description: Solves for every node voltage and element current
+        void solve();
+
+        // Description: Voltage of a node after the last solve
+        double get_node_V(int /*node*/) const;
+
+        // Description: Current of an element after the last solve: a to b for loads and resistors,
+        //              into node to for current sources, out of pos for voltage sources and batteries
+        double get_current(int /*element*/) const;
+
+        // Description: Nodes of an element (pos and neg for sources) and its kind
+        void get_terminals(int /*element*/, int& /*a*/, int& /*b*/) const;
+        circuit_element_type get_type(int /*element*/) const;
+
+        int get_num_nodes() const;
+        int get_num_elements() const;
+
+        // Description: How often each level of the factorization was done, and the entries of L and U
+        int get_symbolic_count() const;
+        int get_numeric_count() const;
+        int get_factor_size() const;
+
+    private:
+        struct element {
+            circuit_element_type type;
+            int a, b;          // nodes; pos and neg for sources
+            double value;      // R, P, I or V
+            bool on;
+            int branch;        // unknown of the source current, -1 otherwise
+            double I;          // power loads: current after the last solve
+            double g;          // power loads: slope of P/V carried by the matrix
+            double rest;       // power loads: P/V - g*V, carried by the right hand side
+            int pos[4];        // entries of the stamp in the factor storage, -1 for ground
+        };
+
+        int add_element(circuit_element_type, int, int, double, bool);
+        void check_node(int) const;
+        void check_element(int) const;
+
+        // Unknown of node n, -1 for ground
+        int node_unknown(int) const;
+
+        void symbolic();
+        void numeric();
+        void substitute();
+        int entry(int /*row*/, int /*col*/) const;
+
+        int num_nodes;      // without ground
+        int num_branches;
+        std::vector<element> elements;
+
+        bool structure_changed;
+        bool values_changed;
+        bool slopes_valid;   // x holds voltages to take the power load slopes at
+
+        // Pivot i takes the equation of unknown row_perm[i] and eliminates unknown col_perm[i];
+        // irow and icol are the inverses
+        std::vector<int> row_perm, col_perm, irow, icol;
+
+        // L (unit, below the diagonal) and U (diagonal and above) by rows, sharing one pattern
+        std::vector<int> row_ptr, cols, diag;
+        std::vector<double> a, lu;
+        std::vector<int> gmin_pos;
+
+        std::vector<double> rhs, x, work;
+        int solved_nodes;   // node entries of x that hold voltages
+
+        // Elements that enter the right hand side
+        std::vector<int> sources, power_loads;
+
+        int symbolic_count;
+        int numeric_count;
+};
+
+#endif
@@ -0,0 +1,137 @@
+/*
+PURPOSE:    Illumination stage of the EPS. Computes the short circuit current
+            of every solar cell on the satellite in one pass from the body
+            rotation matrix, tests whether the satellite is in the shadow of
+            the Earth or Moon, and predicts when it enters and leaves the
+            shadow so ticks with unchanged lighting cost nothing.
+
+NOTE:       The cells are kept as structure of arrays. The sun direction is
+            brought into the body frame once per update; the incidence of
+            every cell is then one dot product with its body frame normal,
+                I_sc = max_I_sc * max(0, n . s_body)
+            which is the projection solar_cell::get_I_sc makes, except that
+            a cell facing away from the sun gives no current. The global
+            normal of a cell is R^-1 n (as in solar_cell::update_pos_ori),
+            so s_body = R^-T s.
+
+            The shadow test casts a ray from the satellite to the sun
+            against every occulting body with collisionRaySphere (umbra
+            only, the sun is a point). The prediction propagates a two body
+            orbit about one occulter with RK4 and records every shadow
+            crossing within the horizon, each refined by bisection. The sun
+            is far enough that its direction is taken as fixed over the
+            horizon. While a prediction is valid the stage takes the
+            shadow state of that occulter from it; the other occulters are
+            still tested each update. A gravitational parameter of 0
+            propagates a straight line, for a body moved without gravity.
+
+            A state that is not finite or lies inside an occulter is no
+            orbit: the prediction rejects it and records no crossings, and
+            update keeps the shadow state and currents it had.
+
+            update recomputes the currents only when the shadow state or
+            the rotation matrix changed, or a cell or the sun moved.
+
+TERMS USED:
+    -> occulter - a body that can shadow the satellite (Earth, Moon)
+    -> s        - unit vector from the satellite to the sun
+    -> horizon  - time span the eclipse prediction covers
+*/
+
+#ifndef PANEL_ILLUMINATION_HH
+#define PANEL_ILLUMINATION_HH
+
+#include <vector>
+#include "../../Recources/include/Linear_Algebra.hh"
+#include "solar_cell.hh"
+
+class panel_illumination {
+    public:
+        // Description: A stage with no cells or occulters, the sun at 1 AU along -x (as in the satellite sim)
+        panel_illumination();
+
+        // Description: Registers a cell by its body frame normal and full sun short circuit current; returns its index
+        int add_cell(const Vector3d& /*reference normal*/, double /*max I_sc*/);
+        int add_cell(solar_cell& /*cell*/);
+
+        // Description: Changes the body frame normal of a cell (a panel drive turned it)
+        void set_cell_normal(int /*cell*/, const Vector3d& /*reference normal*/);
+
+        // Description: Registers a body that can shadow the satellite; returns its index
+        int add_occulter(double /*radius*/, const Vector3d& /*center*/);
+        void set_occulter_pos(int /*occulter*/, const Vector3d& /*center*/);
+        const Vector3d& get_occulter_pos(int /*occulter*/) const;
+
+        // Description: Global position of the sun
+        void set_sun_pos(const Vector3d& /*position*/);
+
+        // Description: True when no occulter blocks the ray from the position to the sun
+        bool in_sunlight(const Vector3d& /*satellite position*/) const;
+
+        // Description: True when the position is finite and outside every occulter
+        bool is_valid_position(const Vector3d& /*satellite position*/) const;
+
+        // Description: Brings the currents up to date at a time; returns true when they changed
+        bool update(double /*time*/, const Vector3d& /*satellite position*/, const Matrix3d& /*rotation matrix*/);
+
+        // Description: Short circuit current of one cell, or of all cells in index order
+        double get_I_sc(int /*cell*/) const;
+        const double* get_I_sc() const;
+
+        // Description: Sum of the short circuit currents of all cells
+        double get_total_I_sc() const;
+
+        // Description: Shadow state of the last update
+        bool is_eclipsed() const;
+
+        // Description: Predicts the shadow crossings of an occulter for a two body orbit about it;
+        //              returns false, with no prediction, for a state that is no orbit
+        bool predict_eclipses(double /*time*/, const Vector3d& /*satellite position*/, const Vector3d& /*satellite velocity*/,
+                              double /*gravitational parameter mu*/, int /*occulter*/, double /*horizon*/);
+
+        // Description: Next predicted entry into and exit from the shadow after a time;
+        //              infinity when there is none within the horizon
+        double get_next_entry(double /*time*/) const;
+        double get_next_exit(double /*time*/) const;
+
+        // Description: End of the predicted span, -infinity without a prediction
+        double get_prediction_end() const;
+
+        int get_num_cells() const;
+
+        // Description: How many updates recomputed the currents and how many were skipped
+        int get_recomputed() const;
+        int get_skipped() const;
+
+    private:
+        struct occulter {
+            double radius;
+            Vector3d center;
+        };
+
+        // Shadow state of the predicted occulter at a time inside the prediction
+        bool predicted_shadow(double /*time*/) const;
+
+        // Cells in the body frame
+        std::vector<double> normal_x, normal_y, normal_z, max_I;
+        std::vector<double> I_sc;
+
+        std::vector<occulter> occulters;
+        Vector3d sun_pos;
+
+        // Prediction: shadow state at its start and the times the state flips
+        int predicted;
+        bool start_shadow;
+        double predict_start, predict_end;
+        std::vector<double> crossings;
+
+        // State of the last recomputation
+        bool eclipsed;
+        bool dirty;
+        Matrix3d last_R;
+
+        int recomputed;
+        int skipped;
+};
+
+#endif
@@ -15,7 +15,8 @@ NOTE:       The solar cell can be oriented in space and will
 #define SOLAR_CELL_HH
 
 //#include "../../../Lib/eigen-3.4.0/Eigen/Dense"
-#include "../../Recources/src/Linear_Algebra.cpp"
+#include "../../Recources/include/Linear_Algebra.hh"
+#include "../../Recources/include/frame_transforms.hh"
 #define PI 3.14159
 
 //using namespace Eigen;
@@ -62,6 +63,16 @@ class solar_cell {
     	void update_pos_ori(double[3] /*reference position*/);
     	void update_pos_ori(Vector3d /*reference position*/);
 
+    	// Description: Reads position and orientation from a batched frame transform of all mounts
+    	void update_pos_ori(const frame_transforms& /*transforms of all mounts*/, int /*mount handle*/);
+
+    	// Description: Returns the reference position and normal vector (used to register the mount)
+    	Vector3d get_refrence_pos();
+    	Vector3d get_refrence_normal();
+
+    	// Description: Returns the short circuit current in full sun at normal incidence
+    	double get_max_I_sc();
+
     	// Description: Rotates the solar cell direction clockwise by theta degrees
     	void rotate_dir_clock(double /*theta*/);
     	
@@ -0,0 +1,57 @@
+/*
+PURPOSE:    Precomputed I-V curve of a solar_array for evaluating many
+            strings every tick. The output current is tabulated over bus
+            voltage and short circuit current and read back by bilinear
+            interpolation.
+
+NOTE:       The table holds the curve at the temperature of the array when
+            it was built; build it again when the temperature changes. It
+            stores the current before clamping at zero, so interpolating
+            across open circuit stays smooth, and clamps after.
+
+            Voltages and short circuit currents outside the table are held
+            at its edges. The error is largest at the knee of the curve,
+            which is a few n Vt wide, so the voltage spacing has to be well
+            below n Vt; the default 2048 x 16 points keep it under half a
+            percent of I_sc for a 130 V array.
+
+TERMS USED:
+    -> V    - bus voltage of a string
+    -> I_sc - short circuit current of a string, from its illumination
+*/
+
+#ifndef SOLAR_IV_TABLE_HH
+#define SOLAR_IV_TABLE_HH
+
+#include <vector>
+#include "Solar_Power_System.hh"
+
+class solar_iv_table {
+    public:
+        // Description: An empty table; build fills it
+        solar_iv_table();
+
+        // Description: Tabulates the curve of an array for 0 <= V <= V_max and 0 <= I_sc <= I_sc_max
+        void build(const solar_array& /*array*/, double /*V_max*/, double /*I_sc_max*/,
+                   int /*voltage points*/ = 2048, int /*I_sc points*/ = 16);
+
+        // Description: Output current of one string
+        double get_I(double /*voltage*/, double /*sc_current*/) const;
+
+        // Description: Output currents of n strings, I[i] at V[i] and I_sc[i]
+        void get_I(const double* /*voltages*/, const double* /*sc_currents*/, double* /*currents*/, int /*n*/) const;
+
+        // Description: Temperature the table was built at
+        double get_T() const;
+
+    private:
+        int n_V, n_I;
+        double dV_inv, dI_inv;
+        double V_top, I_top;
+        double T;
+
+        // Current at V = i / dV_inv and I_sc = j / dI_inv, stored at [j * n_V + i]
+        std::vector<double> table;
+};
+
+#endif
@@ -0,0 +1,96 @@
+/*
+PURPOSE:    Harness run of wire segments in series between a source and a
+            load, with the R, L and C of every segment, stepped implicitly
+            so the run can be advanced at the frame rate of the vehicle.
+
+NOTE:       Each segment is R and L in series followed by its C to ground,
+                L_k dI_k/dt = V_(k-1) - R_k I_k - V_k
+                C_k dV_k/dt = I_k - I_(k+1)
+            where V_(-1) is the source and the last node feeds the load,
+            I_N = V_(N-1) / R_load + I_load. A single segment with an open
+            end is the series RLC of wire.
+
+            With L ~ 10 uH and C ~ 20 pF the segments ring at ~10^8 rad/s,
+            so an explicit step has to stay near a nanosecond. The chain is
+            instead stepped with TR-BDF2 (or backward Euler), which are
+            stable and damp those modes for any dt; the source and load are
+            held over the step. Both TR-BDF2 stages solve the same
+            matrix (I - c dt A).
+
+            With the unknowns ordered I_0, V_0, I_1, V_1, ... that matrix is
+            tridiagonal. Multiplied through by L and C its diagonal is
+            L_k + c dt R_k (or C_k + c dt / R_load) and its off diagonals
+            are +-c dt in opposite signs, so every pivot of the elimination
+            is a diagonal entry plus a positive term: the Thomas algorithm
+            needs no pivoting and no subtraction can cancel. The
+            factorization is kept while dt and the chain do not change; a
+            step is then O(segments).
+
+TERMS USED:
+    -> segment - one wire between two nodes of the run
+    -> node k  - the far end of segment k, where its C sits
+    -> c       - 1 - 1/sqrt(2) for TR-BDF2, 1 for backward Euler
+*/
+
+#ifndef WIRE_CHAIN_HH
+#define WIRE_CHAIN_HH
+
+#include <vector>
+#include "Wire.hh"
+
+class wire_chain {
+    public:
+        // Description: An empty run with an open end
+        wire_chain();
+
+        // Description: Appends a segment with the R, L and C of the wire; returns its index
+        int add_wire(wire& /*segment*/);
+
+        // Description: Load at the end of the run, a resistance (infinity is open) and a current drawn
+        void set_load_resistance(double /*resistance*/);
+        void set_load_current(double /*current*/);
+
+        // Description: Advances the run by dt with the source voltage held (TR-BDF2)
+        void step(double /*source voltage*/, double /*delta time*/);
+
+        // Description: Advances the run by dt with backward Euler (first order)
+        void step_backward_euler(double /*source voltage*/, double /*delta time*/);
+
+        // Description: Current through a segment and voltage at the node after it
+        double get_current(int /*segment*/) const;
+        double get_node_voltage(int /*segment*/) const;
+
+        // Description: Voltage at the load and current into it
+        double get_load_voltage() const;
+        double get_load_current() const;
+
+        int size() const;
+
+    private:
+        // Builds the factors of (I - h A) in the scaled form unless they are for this h already
+        void factor(double /*h*/);
+
+        // Solves (I - h A) x = rhs with the factors; rhs is overwritten
+        void solve(std::vector<double>& /*rhs*/);
+
+        // f = A x at the state, without the source and load terms
+        void derivative(std::vector<double>& /*f*/) const;
+
+        // Adds h b, the source and load terms over h, to a right hand side
+        void add_source(double /*source voltage*/, double /*h*/, std::vector<double>& /*rhs*/) const;
+
+        std::vector<double> R, L, C, inv_L, inv_C;
+        double G_load;
+        double I_load;
+
+        // State, I_k at 2k and V_k at 2k + 1
+        std::vector<double> x;
+
+        // Inverse pivots of the scaled matrix for h = factor_h
+        double factor_h;
+        std::vector<double> inv_pivot;
+
+        std::vector<double> f, stage;
+};
+
+#endif
@@ -5,7 +5,7 @@ PURPOSE:    This class models a battery system using an equivalent circuit model
 
 NOTE:       This code assumes a simple battery model, where SOC is bounded between 0.2 and 0.9, and current flow (I) is
             zero when the SOC is at these limits. The `findOCV` function approximates the Open Circuit Voltage (OCV) based
-            on SOC.
+            on SOC, unless a battery_chemistry supplies OCV and resistances from tables.
 
 TERMS USED:
     -> SOC - State of charge of the battery, between 0.2 and 0.9.
@@ -21,6 +21,7 @@ TERMS USED:
 #include <stdlib.h>
 #include <math.h>
 #include <cmath>
+#include <algorithm>
 #include <iostream>
 
 //Prototypes
@@ -35,12 +36,18 @@ battery::battery()
 	R_0 = 0.001;
 	R1 = 0.02;
 	R2 = 0.01;
+	R_0_base = R_0;
+	R1_base = R1;
+	R2_base = R2;
 	C1 = 1000;
 	C2 = 2000;
 	soc = 0.8;
 
 	V1 = 0;
 	V2 = 0;
+
+	chemistry = nullptr;
+	T = 298.15;
 }
 
 battery::battery(double capacity, double res0, double res1, double res2, double cap1, double cap2, double state_charge)
@@ -52,12 +59,18 @@ battery::battery(double capacity, double res0, double res1, double res2, double
 	R_0 = res0;
 	R1 = res1;
 	R2 = res2;
+	R_0_base = R_0;
+	R1_base = R1;
+	R2_base = R2;
 	C1 = cap1;
 	C2 = cap2;
 	soc = state_charge;
 
 	V1 = 0;
 	V2 = 0;
+
+	chemistry = nullptr;
+	T = 298.15;
 }
 
 void battery::initialize(double capacity, double res0, double res1, double res2, double cap1, double cap2, double state_charge)
@@ -69,6 +82,9 @@ void battery::initialize(double capacity, double res0, double res1, double res2,
 	R_0 = res0;
 	R1 = res1;
 	R2 = res2;
+	R_0_base = R_0;
+	R1_base = R1;
+	R2_base = R2;
 	C1 = cap1;
 	C2 = cap2;
     soc = state_charge;
@@ -116,7 +132,107 @@ void battery::update_soc(double dt)
     	soc = 0.9;
     	I = 0;
 	}
-	ocv = findOCV(soc);
+	update_ocv();
+}
+
+void battery::propagate(double dt)
+    //Description:      Advances the battery by dt with the current (I) held, using the exact solution of the circuit.
+    //Preconditions:    dt >= 0. The current (I) must be updated before calling this function.
+    //Postconditions:   SOC changes linearly until it reaches 0.2 or 0.9, from then on the current (I) is 0. V1 and V2
+    //                  relax exponentially towards I R1 and I R2, and OCV and Vt are updated. The resistances are
+    //                  held at their values at the start of the interval.
+{
+	// Time the current flows before soc reaches a bound; at the bound already it does not flow
+	double t_held = dt;
+	bool at_bound = false;
+	if (I != 0) {
+		double t_bound = (soc - (I > 0 ? 0.2 : 0.9)) * Q / I;
+		if (t_bound < dt || t_bound <= 0) {
+			t_held = std::max(0.0, t_bound);
+			at_bound = true;
+		}
+	}
+	soc = std::min(0.9, std::max(0.2, soc - I * t_held / Q));
+
+	double a1 = exp(-t_held / (R1 * C1));
+	double a2 = exp(-t_held / (R2 * C2));
+	V1 = a1 * V1 + (1.0 - a1) * R1 * I;
+	V2 = a2 * V2 + (1.0 - a2) * R2 * I;
+	if (at_bound) {
+		// At a bound no current flows and the branches discharge
+		I = 0;
+		V1 *= exp(-(dt - t_held) / (R1 * C1));
+		V2 *= exp(-(dt - t_held) / (R2 * C2));
+	}
+
+	update_ocv();
+	update_Vt();
+}
+
+double battery::time_to_soc(double level)
+    //Description:      Returns the time until the SOC reaches a level at the present current (I).
+    //Preconditions:    The current (I) must be updated before calling this function.
+    //Postconditions:   The time in s is returned; infinity if the SOC is at the level already or moving away from it.
+{
+	double rate = -I / Q;
+	if (rate == 0 || (level - soc) * rate <= 0) return INFINITY;
+	return (level - soc) / rate;
+}
+
+double battery::time_to_settle(double tol)
+    //Description:      Returns the time until V1 and V2 are within tol of I R1 and I R2 at the present current (I).
+    //Preconditions:    tol > 0.
+    //Postconditions:   The time in s is returned; 0 if both are within tol already.
+{
+	double t = 0.0;
+	double off1 = fabs(V1 - I * R1);
+	double off2 = fabs(V2 - I * R2);
+	if (off1 > tol) t = std::max(t, R1 * C1 * log(off1 / tol));
+	if (off2 > tol) t = std::max(t, R2 * C2 * log(off2 / tol));
+	return t;
+}
+
+void battery::update_ocv()
+{
+	// The tables overwrite the resistances only while a chemistry with them is set
+	R_0 = R_0_base;
+	R1 = R1_base;
+	R2 = R2_base;
+	if (chemistry) {
+		ocv = chemistry->get_ocv(soc, T);
+		chemistry->get_resistances(soc, T, R_0, R1, R2);
+	}
+	else ocv = findOCV(soc);
+}
+
+void battery::set_chemistry(const battery_chemistry* chem)
+    //Description:      Selects the tables the OCV and resistances are read from.
+    //Preconditions:    The chemistry outlives the battery, or is null.
+    //Postconditions:   From the next update_soc the OCV (and resistances, if the chemistry has them) follow the tables.
+    //                  Null puts the resistances the battery was given back at once.
+{
+	chemistry = chem;
+	if (!chemistry) {
+		R_0 = R_0_base;
+		R1 = R1_base;
+		R2 = R2_base;
+	}
+}
+
+void battery::set_T(double temperature)
+    //Description:      Sets the cell temperature.
+    //Preconditions:    temperature in K.
+    //Postconditions:   The chemistry tables are read at this temperature from the next update_soc.
+{
+	T = temperature;
+}
+
+double battery::get_T()
+    //Description:      Returns the cell temperature.
+    //Preconditions:    None
+    //Postconditions:   The temperature in K is returned.
+{
+	return T;
 }
 
 void battery::update_V1(double Voltage)
@@ -2,6 +2,19 @@
 PURPOSE:    Simulate the power generated by a solar array by following the IV curve.
 
 NOTE:       This implementation uses the Shockley diode equation to model the current output of a solar panel.
+            The single diode model
+                I = I_L - I_s e^((V + I Rs - V_oc) / a) - (V + I Rs) / Rsh,    a = n Vt
+            is implicit in I. Its right hand side falls as I grows and is concave, so Newton's method
+            converges from any start; started from the current of the last tick it takes two or three
+            steps. I_s is chosen so the curve passes through V_oc at I = 0 for the rated I_sc (the -1 of
+            the Shockley term is dropped, it is below 1e-30 A at the operating point). With
+            x = V + I Rs the equation becomes k x + c e^(x/a) = b, which the Lambert W function solves
+            in closed form:
+                I = (I_L - V/Rsh) / (1 + Rs/Rsh) - (a/Rs) W(z)
+            W is evaluated from ln z, so arguments far beyond the range of double are no problem.
+
+            Temperature moves the curve from its rated point at T_ref: V_oc by Tc_V and I_L by Tc_I
+            (relative, per K), and the thermal voltage in proportion to T.
 
 TERMS USED:
     -> V_mp - voltage at maximum power point
@@ -15,10 +28,14 @@ TERMS USED:
     -> I_sc - short-circuit current
     -> I - current output of the solar array
     -> I2 - secondary current output for a different calculation
+    -> I_L - light current, I_sc corrected for temperature
+    -> I_s - diode current at V + I Rs = V_oc
+    -> W - Lambert W function, w e^w = z
 
 EQUATIONS TO MODEL:
-    -> Rs = (V_oc - V_mp) / (16 * I_mp)
-    -> Rsh = (5 * V_mp) / (I_sc - I_mp)
+    -> Rs = (V_oc - V_mp) / (16 * I_mp), not below 0
+    -> Rsh = (5 * V_mp) / (I_sc - I_mp), open when I_sc = I_mp
+    -> I_s = I_sc - V_oc / Rsh
 */
 
 #include "../include/Solar_Power_System.hh"
@@ -33,6 +50,34 @@ using namespace std;
 
 double captureI = 0;
 
+namespace {
+const double T_REF = 298.15;        // K, temperature the curve is given at
+const double EXP_LIMIT = 700.0;     // e^x overflows past ~709
+
+// Newton stops once the step is below this fraction of the current
+const double NEWTON_TOL = 1e-12;
+const int NEWTON_MAX = 50;
+}
+
+static double lambert_w_exp(double y)
+    //Description:    Principal branch of the Lambert W function at z = e^y, w with w + ln w = y.
+    //Preconditions:  None; y may be far outside the range of exp.
+    //Postconditions: Returns W(e^y) to about machine precision.
+{
+    // W(z) = z to double precision for tiny z
+    if (y < -EXP_LIMIT) return exp(y);
+    // Start from W(z) ~ z for small z, from y - ln y for large z
+    double w = (y < 1.0) ? exp(y) : y - log(y);
+    for (int k = 0; k < 30; k++) {
+        // Newton on g(w) = w + ln w - y, g' = 1 + 1/w; g is concave, so the steps approach the root
+        // from below and w stays positive
+        double step = (w + log(w) - y) * w / (w + 1.0);
+        w -= step;
+        if (fabs(step) <= 1e-15 * w) break;
+    }
+    return w;
+}
+
 solar_array::solar_array()
     //Description:    Default constructor initializing solar array parameters to default values.
     //Preconditions:  None
@@ -45,13 +90,13 @@ solar_array::solar_array()
     I_sc_max = 8.947;
     I_o = 1e-10;
 
-    Rs = (V_oc - V_mp) / (16 * I_mp);
-    Rsh = (5 * V_mp) / (I_sc - I_mp);
     I_sc = 8.947;
     I = I_sc;
+    I2 = I_sc;
     n = 2;
     V = 0;
     t = 0;
+    set_parameters();
 }
 
 solar_array::solar_array(double oc_voltage, double sc_current, double max_voltage, double max_current, double terminal_voltage)
@@ -65,13 +110,13 @@ solar_array::solar_array(double oc_voltage, double sc_current, double max_voltag
     I_sc_max = sc_current;
     Vt = terminal_voltage;
 
-    Rs = (V_oc - V_mp) / (16 * I_mp);
-    Rsh = (5 * V_mp) / (I_sc - I_mp);
     I_sc = sc_current;
     I = I_sc;
+    I2 = I_sc;
     n = 2;
     V = 0;
     t = 0;
+    set_parameters();
 }
 
 void solar_array::initialize(double oc_voltage, double sc_current, double max_voltage, double max_current, double terminal_voltage)
@@ -85,14 +130,45 @@ void solar_array::initialize(double oc_voltage, double sc_current, double max_vo
     I_sc_max = sc_current;
     Vt = terminal_voltage;
 
-    Rs = (V_oc - V_mp) / (16 * I_mp);
-    Rsh = (5 * V_mp) / (I_sc - I_mp);
     I_sc = sc_current;
     I = I_sc;
     I2 = I_sc; // Initialize I2 for secondary current output
     n = 2;
     V = 0;
     t = 0;
+    set_parameters();
+}
+
+void solar_array::set_parameters()
+    //Description:    Derives the series and shunt resistance and the diode current from the points of the curve.
+    //Preconditions:  V_oc, V_mp, I_mp and I_sc_max are set.
+    //Postconditions: Rs, Rsh, G_sh and I_s are set, the temperature is T_ref with the default coefficients.
+{
+    // A maximum power point above V_oc would give a negative series resistance
+    Rs = fmax(0.0, (V_oc - V_mp) / (16 * I_mp));
+    G_sh = fmax(0.0, (I_sc_max - I_mp) / (5 * V_mp));
+    Rsh = (G_sh > 0) ? 1.0 / G_sh : INFINITY;
+    I_s = fmax(1e-12 * I_sc_max, I_sc_max - V_oc * G_sh);
+
+    Tc_V = -0.003;
+    Tc_I = 0.0005;
+    T = T_REF;
+    iterations = 0;
+}
+
+double solar_array::light_I(double sc_current) const
+{
+    return sc_current * (1.0 + Tc_I * (T - T_REF));
+}
+
+double solar_array::diode_a() const
+{
+    return n * Vt * T / T_REF;
+}
+
+double solar_array::diode_V_oc() const
+{
+    return V_oc * (1.0 + Tc_V * (T - T_REF));
 }
 
 void solar_array::update_I()
@@ -101,15 +177,21 @@ void solar_array::update_I()
     //Preconditions:  The voltage (V) must be set before calling this function.
     //Postconditions: Current (I) is updated based on the IV curve; I cannot be negative.
 {
-    double e = 2.7183;
-    int count = 1;
-    double I_prev;
+    double a = diode_a(), V_d = diode_V_oc(), I_L = light_I(I_sc);
 
-    do {
-        I_prev = I;
-        I = I_sc - pow(e, ((V - V_mp) + (I - I_sc) * Rs) / (n * Vt)) + ((V + I * Rs) / Rsh);
-        count++;
-    } while (abs(I - I_prev) < 0.001 && count < 5);
+    // Newton on f(I) = I_L - I_s e^((V + I Rs - V_d)/a) - (V + I Rs) G_sh - I, from the last current
+    double current = I;
+    iterations = 0;
+    while (iterations < NEWTON_MAX) {
+        iterations++;
+        double diode = I_s * exp(fmin(EXP_LIMIT, (V + current * Rs - V_d) / a));
+        double f = I_L - diode - (V + current * Rs) * G_sh - current;
+        double df = -diode * Rs / a - Rs * G_sh - 1.0;
+        double step = f / df;
+        current -= step;
+        if (fabs(step) <= NEWTON_TOL * fmax(1.0, fabs(current))) break;
+    }
+    I = current;
 
     if (I < 0) {
         I = 0; // Ensure current is not negative
@@ -120,7 +202,68 @@ void solar_array::update_I()
     }
 }
 
-/*dI = -((1/Vt)*(I_sc - V_oc/Rsh)*pow(e, (V+I*Rs-V_oc)/Vt)-(1/Rsh))/(1+(Rs/Vt)*(I_sc - V_oc/Rsh)*pow(e, (V+I*Rs-V_oc)/Vt)+(Rs/Rsh));*/
+double solar_array::get_I_at(double voltage, double sc_current) const
+    //Description:    Solves the curve at a voltage and short circuit current in closed form with the Lambert W function.
+    //Preconditions:  The array is initialized.
+    //Postconditions: Returns the output current, not below 0; the state of the array is unchanged.
+{
+    return fmax(0.0, get_I_unclamped(voltage, sc_current));
+}
+
+double solar_array::get_I_unclamped(double voltage, double sc_current) const
+    //Description:    Solves the curve at a voltage and short circuit current in closed form with the Lambert W function.
+    //Preconditions:  The array is initialized.
+    //Postconditions: Returns the current of the curve, negative past open circuit.
+{
+    double a = diode_a(), V_d = diode_V_oc(), I_L = light_I(sc_current);
+    double current;
+    if (Rs <= 0) {
+        // Without series resistance the curve is explicit
+        current = I_L - I_s * exp(fmin(EXP_LIMIT, (voltage - V_d) / a)) - voltage * G_sh;
+    } else {
+        double scale = 1.0 + Rs * G_sh;
+        double I_lin = (I_L - voltage * G_sh) / scale;
+        double ln_z = log(I_s * Rs / (a * scale)) + (Rs * I_lin + voltage - V_d) / a;
+        current = I_lin - (a / Rs) * lambert_w_exp(ln_z);
+    }
+    return current;
+}
+
+void solar_array::set_T(double temperature)
+    //Description:    Sets the cell temperature.
+    //Preconditions:  temperature is in K and positive.
+    //Postconditions: The following solves use the curve at this temperature.
+{
+    T = temperature;
+}
+
+double solar_array::get_T() const
+{
+    return T;
+}
+
+double solar_array::get_V_oc() const
+    //Description:    Returns the voltage at which the output current reaches zero.
+    //Preconditions:  The array is initialized.
+    //Postconditions: Returns the open circuit voltage for the set I_sc and temperature.
+{
+    double a = diode_a(), V_d = diode_V_oc(), I_L = light_I(I_sc);
+    if (I_L <= 0) return 0.0;
+    // Without the shunt V_oc is explicit; Newton adds the shunt current from there
+    double voltage = V_d + a * log(I_L / I_s);
+    for (int k = 0; k < NEWTON_MAX; k++) {
+        double diode = I_s * exp(fmin(EXP_LIMIT, (voltage - V_d) / a));
+        double step = (I_L - diode - voltage * G_sh) / (-diode / a - G_sh);
+        voltage -= step;
+        if (fabs(step) <= NEWTON_TOL * fmax(1.0, voltage)) break;
+    }
+    return voltage;
+}
+
+int solar_array::get_iterations() const
+{
+    return iterations;
+}
 
 void solar_array::update_V(double voltage)
     //Description:    Sets the current voltage for the solar array to simulate the IV curve.
@@ -88,6 +88,39 @@ void wire::update_voltage_from_curr(double current, double prev_current, double
     V = L * di_dt + R * I + Vc;
 }
 
+// TR-BDF2 with gamma = 2 - sqrt(2): both stages solve with the same matrix (I - c dt A), c = 1 - 1/sqrt(2)
+static const double TRBDF2_GAMMA = 2.0 - sqrt(2.0);
+static const double TRBDF2_C = 1.0 - 1.0 / sqrt(2.0);
+
+// Solves (I - h A) [I, Vc] = [rI, rV] for A = [[-R/L, -1/L], [1/C, 0]], multiplied through by L and C
+static void solve_implicit(double R, double L, double C, double h, double rI, double rV, double& I, double& Vc) {
+    double a = L + h * R;   // positive, so is the determinant; no cancellation for any h
+    double det = a * C + h * h;
+    I = (C * L * rI - h * C * rV) / det;
+    Vc = (a * C * rV + h * L * rI) / det;
+}
+
+void wire::step(double Vt, double dt) {
+    V = Vt;
+    double h = TRBDF2_C * dt;
+    double dI, dVc;
+    get_state_dirv(dI, dVc, Vt);
+
+    // Trapezoidal stage to t + gamma dt
+    double Ig, Vcg;
+    solve_implicit(R, L, C, h, I + h * dI + h * Vt / L, Vc + h * dVc, Ig, Vcg);
+
+    // BDF2 stage to t + dt
+    double wg = 1.0 / (TRBDF2_GAMMA * (2.0 - TRBDF2_GAMMA));
+    double wn = (1.0 - TRBDF2_GAMMA) * (1.0 - TRBDF2_GAMMA) * wg;
+    solve_implicit(R, L, C, h, wg * Ig - wn * I + h * Vt / L, wg * Vcg - wn * Vc, I, Vc);
+}
+
+void wire::step_backward_euler(double Vt, double dt) {
+    V = Vt;
+    solve_implicit(R, L, C, dt, I + dt * Vt / L, Vc, I, Vc);
+}
+
 double wire::get_current() {
     return I;
 }
@@ -96,6 +129,10 @@ double wire::get_voltage() {
     return V;
 }
 
+double wire::get_Vc() {
+    return Vc;
+}
+
 double wire::get_R() { return R; }
 double wire::get_L() { return L; }
 double wire::get_C() { return C; }
\ No newline at end of file
@@ -0,0 +1,117 @@
+/*
+PURPOSE:    This is the implementation of file 'battery_chemistry.hh'
+*/
+
+#include "../include/battery_chemistry.hh"
+#include <fstream>
+#include <stdexcept>
+
+//Prototypes
+double findOCV(double SOC);
+
+namespace {
+bool ends_with(const std::string& s, const std::string& end)
+{
+    return s.size() >= end.size() && s.compare(s.size() - end.size(), end.size(), end) == 0;
+}
+
+// Number of coordinate columns of a chemistry CSV: soc, and T when the second column is named so
+int csv_coordinates(const std::string& path)
+{
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("battery_chemistry: cannot open " + path);
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+        size_t comma = line.find(',');
+        if (comma == std::string::npos) break;
+        size_t start = line.find_first_not_of(" \t", comma + 1);
+        size_t end = line.find_first_of(", \t\r", start);
+        return line.substr(start, end - start) == "T" ? 2 : 1;
+    }
+    throw std::runtime_error("battery_chemistry: no header in " + path);
+}
+}
+
+battery_chemistry::battery_chemistry()
+    //Description:      Creates a chemistry without tables.
+    //Preconditions:    None
+    //Postconditions:   get_ocv is findOCV and get_resistances reports no tables.
+{
+}
+
+void battery_chemistry::load(const std::string& path, int points_soc, int points_T, interp_method method)
+    //Description:      Reads the tables from a CSV file (by its .csv ending) or from binary tables.
+    //Preconditions:    The file holds an ocv table, and R0, R1 and R2 together if any of them.
+    //Postconditions:   The tables are replaced. Throws std::runtime_error for a missing or malformed file.
+{
+    table_set tables = ends_with(path, ".csv")
+        ? read_tables_csv(path, csv_coordinates(path), points_soc, points_T, method)
+        : read_tables_binary(path);
+    if (tables.count("ocv") == 0) throw std::runtime_error("battery_chemistry: no ocv column in " + path);
+    int resistances = static_cast<int>(tables.count("R0") + tables.count("R1") + tables.count("R2"));
+    if (resistances != 0 && resistances != 3) throw std::runtime_error("battery_chemistry: R0, R1 and R2 go together in " + path);
+
+    ocv = tables["ocv"];
+    R0 = resistances ? tables["R0"] : interp_table();
+    R1 = resistances ? tables["R1"] : interp_table();
+    R2 = resistances ? tables["R2"] : interp_table();
+}
+
+void battery_chemistry::save(const std::string& path) const
+    //Description:      Writes the tables that are set in binary form.
+    //Preconditions:    None
+    //Postconditions:   load of the file gives the same tables.
+{
+    table_set tables;
+    if (!ocv.empty()) tables["ocv"] = ocv;
+    if (has_resistances()) {
+        tables["R0"] = R0;
+        tables["R1"] = R1;
+        tables["R2"] = R2;
+    }
+    write_tables_binary(path, tables);
+}
+
+void battery_chemistry::set_ocv(const interp_table& table)
+{
+    ocv = table;
+}
+
+void battery_chemistry::set_resistances(const interp_table& table0, const interp_table& table1, const interp_table& table2)
+{
+    R0 = table0;
+    R1 = table1;
+    R2 = table2;
+}
+
+bool battery_chemistry::has_ocv() const
+{
+    return !ocv.empty();
+}
+
+bool battery_chemistry::has_resistances() const
+{
+    return !R0.empty() && !R1.empty() && !R2.empty();
+}
+
+double battery_chemistry::get_ocv(double soc, double T) const
+    //Description:      Looks up the open circuit voltage.
+    //Preconditions:    None
+    //Postconditions:   findOCV(soc) without an ocv table.
+{
+    return ocv.empty() ? findOCV(soc) : ocv.get(soc, T);
+}
+
+bool battery_chemistry::get_resistances(double soc, double T, double& res0, double& res1, double& res2) const
+    //Description:      Looks up the resistances of the equivalent circuit.
+    //Preconditions:    None
+    //Postconditions:   Returns false and leaves the arguments unchanged without resistance tables.
+{
+    if (!has_resistances()) return false;
+    res0 = R0.get(soc, T);
+    res1 = R1.get(soc, T);
+    res2 = R2.get(soc, T);
+    return true;
+}
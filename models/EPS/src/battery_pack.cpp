@@ -0,0 +1,330 @@
+/*
+PURPOSE:    Steps a pack of series groups of parallel cells, every cell the
+            equivalent circuit of battery, with the exact solution of its
+            RC branches. See battery_pack.hh.
+
+NOTE:       The state of charge is limited to 0.2 - 0.9 like battery. A
+            cell at a limit that the current would take further carries no
+            current, as battery sets I to 0 there: the other cells of its
+            group share the pack current, and its RC branches relax.
+*/
+
+#include "../include/battery_pack.hh"
+#include "../../Recources/include/vector_math.hh"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+//Prototypes
+double findOCV(double SOC);
+
+namespace {
+const double SOC_MIN = 0.2;
+const double SOC_MAX = 0.9;
+
+// Below this e^x is zero in double precision
+const double EXP_FLOOR = -700.0;
+}
+
+battery_pack::battery_pack()
+    //Description:      Creates an empty pack.
+    //Preconditions:    None
+    //Postconditions:   The pack holds no cells until initialize is called.
+    : n_series(0), n_parallel(0), n(0), decay_dt(-1.0), I_pack(0.0)
+{
+}
+
+battery_pack::battery_pack(int series, int parallel)
+    //Description:      Creates a series x parallel pack of cells with the defaults of battery.
+    //Preconditions:    series and parallel are at least 1.
+    //Postconditions:   Every cell is at soc 0.8 with its RC branches discharged.
+    : battery_pack()
+{
+	initialize(series, parallel, 36000, 0.001, 0.02, 0.01, 1000, 2000, 0.8);
+}
+
+void battery_pack::resize(int series, int parallel)
+{
+	if (series < 1 || parallel < 1) throw std::invalid_argument("battery_pack: series and parallel must be at least 1");
+	n_series = series;
+	n_parallel = parallel;
+	n = series * parallel;
+	for (std::vector<double>* v : {&Q, &R_0, &R1, &R2, &C1, &C2, &G_0, &soc, &V1, &V2, &I, &E, &decay1, &decay2})
+		v->assign(n, 0.0);
+	for (std::vector<double>* v : {&V_group, &G_group, &GE_group})
+		v->assign(n_series, 0.0);
+	cut.assign(n, 0);
+	decay_dt = -1.0;
+	I_pack = 0.0;
+}
+
+void battery_pack::initialize(int series, int parallel, double capacity, double res0, double res1, double res2,
+                              double cap1, double cap2, double state_charge)
+    //Description:      Sets the topology and gives every cell the same parameters.
+    //Preconditions:    series and parallel are at least 1, resistances, capacitances and capacity are positive.
+    //Postconditions:   The RC voltages and currents are zero and the group voltages are the open circuit voltages.
+{
+	resize(series, parallel);
+	for (int c = 0; c < n; c++) set_cell(c, capacity, res0, res1, res2, cap1, cap2, state_charge);
+}
+
+void battery_pack::set_cell(int c, double capacity, double res0, double res1, double res2,
+                            double cap1, double cap2, double state_charge)
+    //Description:      Sets the parameters and state of charge of one cell.
+    //Preconditions:    0 <= c < size(), values positive.
+    //Postconditions:   The cell's RC voltages are reset; the decay factors are recomputed on the next step.
+{
+	if (c < 0 || c >= n) throw std::out_of_range("battery_pack: no such cell");
+	Q[c] = capacity;
+	R_0[c] = res0;
+	G_0[c] = 1.0 / res0;
+	R1[c] = res1;
+	R2[c] = res2;
+	C1[c] = cap1;
+	C2[c] = cap2;
+	soc[c] = state_charge;
+	V1[c] = 0;
+	V2[c] = 0;
+	decay_dt = -1.0;
+	E[c] = findOCV(soc[c]);
+	update_group(c / n_parallel);
+	split_current(I_pack);
+}
+
+void battery_pack::vary_cells(double spread, unsigned seed)
+    //Description:      Scales capacity, resistances and capacitances of each cell by independent factors
+    //                  1 + spread * N(0, 1), limited to 0.5 - 1.5.
+    //Preconditions:    spread >= 0.
+    //Postconditions:   Cells differ as they would from manufacturing spread; the state is kept.
+{
+	std::mt19937 gen(seed);
+	std::normal_distribution<double> normal(0.0, 1.0);
+	auto factor = [&]() { return std::min(1.5, std::max(0.5, 1.0 + spread * normal(gen))); };
+	for (int c = 0; c < n; c++) {
+		Q[c] *= factor();
+		R_0[c] *= factor();
+		G_0[c] = 1.0 / R_0[c];
+		R1[c] *= factor();
+		R2[c] *= factor();
+		C1[c] *= factor();
+		C2[c] *= factor();
+	}
+	decay_dt = -1.0;
+	update_emf();
+	split_current(I_pack);
+}
+
+void battery_pack::update_emf()
+    //Description:      Computes the voltage of every cell behind R_0 and the sums of each group.
+    //Preconditions:    The parameters and state of the cells are set.
+    //Postconditions:   E, G_group and GE_group match the state of charge and RC voltages.
+{
+	for (int c = 0; c < n; c++) E[c] = findOCV(soc[c]) - V1[c] - V2[c];
+	for (int g = 0; g < n_series; g++) update_group(g);
+}
+
+void battery_pack::update_group(int g)
+{
+	int first = g * n_parallel, last = first + n_parallel;
+	double sum_G = 0.0, sum_GE = 0.0;
+	for (int c = first; c < last; c++) {
+		sum_G += G_0[c];
+		sum_GE += G_0[c] * E[c];
+	}
+	G_group[g] = sum_G;
+	GE_group[g] = sum_GE;
+}
+
+void battery_pack::split_current(double current)
+    //Description:      Splits the pack current over the parallel cells of every group.
+    //Preconditions:    update_emf was called since the state last changed.
+    //Postconditions:   I holds the cell currents, V_group the terminal voltage of every group.
+{
+	// The cells of a group share V_group: I_j = (E_j - V_group) G_j and the I_j add up to the pack current
+	I_pack = current;
+	for (int g = 0; g < n_series; g++) {
+		double V = (GE_group[g] - current) / G_group[g];
+		bool limited = false;
+		for (int c = g * n_parallel; c < (g + 1) * n_parallel; c++) {
+			I[c] = (E[c] - V) * G_0[c];
+			limited |= at_limit(c);
+		}
+		V_group[g] = limited ? split_limited(g, current) : V;
+	}
+}
+
+bool battery_pack::at_limit(int c) const
+{
+	return (soc[c] <= SOC_MIN && I[c] > 0.0) || (soc[c] >= SOC_MAX && I[c] < 0.0);
+}
+
+double battery_pack::split_limited(int g, double current)
+    //Description:      Splits the current of a group over its cells that are not driven past a state of charge limit.
+    //Preconditions:    I holds the split of the group over all its cells.
+    //Postconditions:   Cells at a limit the current would take further have I = 0, the rest share the current.
+    //                  The group voltage is returned; with every cell cut it is the open circuit voltage and the
+    //                  group passes no current.
+{
+	int first = g * n_parallel, last = first + n_parallel;
+	for (int c = first; c < last; c++) cut[c] = 0;
+
+	// Cutting cells moves V the way that drives the others further, so a cut cell stays cut
+	double V = GE_group[g] / G_group[g];
+	for (bool changed = true; changed;) {
+		changed = false;
+		for (int c = first; c < last; c++) {
+			if (!cut[c] && at_limit(c)) {
+				cut[c] = 1;
+				changed = true;
+			}
+		}
+		double sum_G = 0.0, sum_GE = 0.0;
+		for (int c = first; c < last; c++) {
+			if (cut[c]) continue;
+			sum_G += G_0[c];
+			sum_GE += G_0[c] * E[c];
+		}
+		if (sum_G == 0.0) {
+			V = GE_group[g] / G_group[g];
+			for (int c = first; c < last; c++) I[c] = 0.0;
+			break;
+		}
+		V = (sum_GE - current) / sum_G;
+		for (int c = first; c < last; c++) I[c] = cut[c] ? 0.0 : (E[c] - V) * G_0[c];
+	}
+	return V;
+}
+
+void battery_pack::step(double current, double dt)
+    //Description:      Advances every cell by dt with the pack current held over the step.
+    //Preconditions:    dt > 0.
+    //Postconditions:   RC voltages and charges are at the end of the step, the cell currents and group
+    //                  voltages are those for the same pack current from the new state.
+{
+	if (dt != decay_dt) {
+		// e^(-dt/(R C)) of every branch, recomputed only when dt changes
+		for (int c = 0; c < n; c++) {
+			decay1[c] = std::max(EXP_FLOOR, -dt / (R1[c] * C1[c]));
+			decay2[c] = std::max(EXP_FLOOR, -dt / (R2[c] * C2[c]));
+		}
+		vexp(decay1.data(), decay1.data(), n);
+		vexp(decay2.data(), decay2.data(), n);
+		decay_dt = dt;
+	}
+
+	// The state is unchanged since the end of the last step, only the current may differ
+	split_current(current);
+
+	double* __restrict v1 = V1.data();
+	double* __restrict v2 = V2.data();
+	double* __restrict s = soc.data();
+	const double* __restrict i = I.data();
+	const double* __restrict d1 = decay1.data();
+	const double* __restrict d2 = decay2.data();
+	const double* __restrict r1 = R1.data();
+	const double* __restrict r2 = R2.data();
+	const double* __restrict q = Q.data();
+	for (int c = 0; c < n; c++) {
+		v1[c] = d1[c] * v1[c] + (1.0 - d1[c]) * r1[c] * i[c];
+		v2[c] = d2[c] * v2[c] + (1.0 - d2[c]) * r2[c] * i[c];
+		s[c] = std::min(SOC_MAX, std::max(SOC_MIN, s[c] - i[c] * dt / q[c]));
+	}
+
+	update_emf();
+	split_current(current);
+}
+
+double battery_pack::get_V() const
+    //Description:      Returns the pack terminal voltage.
+    //Preconditions:    None
+    //Postconditions:   The sum of the group voltages at the current of the last step is returned.
+{
+	double V = 0.0;
+	for (int g = 0; g < n_series; g++) V += V_group[g];
+	return V;
+}
+
+double battery_pack::get_cell_I(int c) const
+    //Description:      Returns the current of one cell (positive discharges).
+    //Preconditions:    0 <= c < size()
+    //Postconditions:   The cell current is returned.
+{
+	return I.at(c);
+}
+
+double battery_pack::get_cell_soc(int c) const
+    //Description:      Returns the state of charge of one cell.
+    //Preconditions:    0 <= c < size()
+    //Postconditions:   The state of charge is returned.
+{
+	return soc.at(c);
+}
+
+double battery_pack::get_cell_V1(int c) const
+    //Description:      Returns the voltage across the first RC branch of one cell.
+    //Preconditions:    0 <= c < size()
+    //Postconditions:   V1 of the cell is returned.
+{
+	return V1.at(c);
+}
+
+double battery_pack::get_cell_V2(int c) const
+    //Description:      Returns the voltage across the second RC branch of one cell.
+    //Preconditions:    0 <= c < size()
+    //Postconditions:   V2 of the cell is returned.
+{
+	return V2.at(c);
+}
+
+double battery_pack::get_cell_Vt(int c) const
+    //Description:      Returns the terminal voltage of one cell, ocv - I R_0 - V1 - V2 as in battery.
+    //Preconditions:    0 <= c < size()
+    //Postconditions:   The terminal voltage is returned.
+{
+	return findOCV(soc.at(c)) - I[c] * R_0[c] - V1[c] - V2[c];
+}
+
+double battery_pack::get_mean_soc() const
+    //Description:      Returns the state of charge averaged over the cells, weighted by capacity.
+    //Preconditions:    The pack holds cells.
+    //Postconditions:   The mean state of charge is returned.
+{
+	double charge = 0.0, capacity = 0.0;
+	for (int c = 0; c < n; c++) {
+		charge += soc[c] * Q[c];
+		capacity += Q[c];
+	}
+	return charge / capacity;
+}
+
+double battery_pack::get_min_soc() const
+    //Description:      Returns the lowest state of charge of any cell.
+    //Preconditions:    The pack holds cells.
+    //Postconditions:   The lowest state of charge is returned.
+{
+	return *std::min_element(soc.begin(), soc.end());
+}
+
+double battery_pack::get_max_soc() const
+    //Description:      Returns the highest state of charge of any cell.
+    //Preconditions:    The pack holds cells.
+    //Postconditions:   The highest state of charge is returned.
+{
+	return *std::max_element(soc.begin(), soc.end());
+}
+
+int battery_pack::get_series() const
+{
+	return n_series;
+}
+
+int battery_pack::get_parallel() const
+{
+	return n_parallel;
+}
+
+int battery_pack::size() const
+{
+	return n;
+}
@@ -127,8 +127,8 @@ void bus::state_update(double input_current) {
         P_tot += n.P;
     }
 
-    I_total += I_tot;
-    P_total += P_tot;
+    I_total = I_tot;
+    P_total = P_tot;
 }
 
 void bus::state_update_power(double input_power) {
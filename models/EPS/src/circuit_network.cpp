@@ -0,0 +1,497 @@
+/*
+PURPOSE:    Implementation of the MNA circuit engine with a reusable sparse
+            LU. See circuit_network.hh for the levels of the factorization.
+*/
+
+#include "../include/circuit_network.hh"
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <stdexcept>
+
+using namespace std;
+
+static const double GMIN = 1e-12;
+
+// Fixed point iteration of the power loads
+static const int POWER_ITERATIONS = 50;
+static const double POWER_TOL = 1e-10;  // relative change of the node voltages
+
+circuit_network::circuit_network()
+    //Description:    Creates a network holding only the ground node
+    //Preconditions:  None
+    //Postconditions: The first solve factors from scratch
+{
+    num_nodes = 0;
+    num_branches = 0;
+    solved_nodes = 0;
+    slopes_valid = false;
+    structure_changed = true;
+    values_changed = true;
+    symbolic_count = 0;
+    numeric_count = 0;
+}
+
+int circuit_network::add_node()
+{
+    num_nodes++;
+    structure_changed = true;
+    return num_nodes;
+}
+
+void circuit_network::check_node(int n) const
+{
+    if (n < 0 || n > num_nodes) throw out_of_range("circuit_network: no node " + to_string(n));
+}
+
+void circuit_network::check_element(int e) const
+{
+    if (e < 0 || e >= static_cast<int>(elements.size())) throw out_of_range("circuit_network: no element " + to_string(e));
+}
+
+int circuit_network::add_element(circuit_element_type type, int a, int b, double value, bool on)
+    //Description:    Appends an element; sources of voltage get a branch unknown
+    //Preconditions:  a and b are nodes
+    //Postconditions: The next solve redoes the symbolic factorization
+{
+    check_node(a);
+    check_node(b);
+    element e;
+    e.type = type;
+    e.a = a;
+    e.b = b;
+    e.value = value;
+    e.on = on;
+    e.branch = (type == CE_VOLTAGE_SOURCE) ? num_branches++ : -1;
+    e.I = 0.0;
+    e.g = 0.0;
+    e.rest = 0.0;
+    for (int i = 0; i < 4; i++) e.pos[i] = -1;
+    elements.push_back(e);
+    structure_changed = true;
+    return static_cast<int>(elements.size()) - 1;
+}
+
+int circuit_network::add_resistor(int a, int b, double R)
+{
+    if (!(R > 0.0)) throw invalid_argument("circuit_network: resistance must be positive");
+    return add_element(CE_RESISTOR, a, b, R, true);
+}
+
+int circuit_network::add_wire(int a, int b, wire& segment)
+{
+    return add_resistor(a, b, segment.get_R());
+}
+
+int circuit_network::add_load(int a, int b, double R, bool on)
+{
+    if (!(R > 0.0)) throw invalid_argument("circuit_network: resistance must be positive");
+    return add_element(CE_LOAD, a, b, R, on);
+}
+
+int circuit_network::add_power_load(int a, int b, double P, bool on)
+{
+    return add_element(CE_POWER_LOAD, a, b, P, on);
+}
+
+int circuit_network::add_current_source(int from, int to, double I)
+{
+    return add_element(CE_CURRENT_SOURCE, from, to, I, true);
+}
+
+int circuit_network::add_voltage_source(int pos, int neg, double V)
+{
+    return add_element(CE_VOLTAGE_SOURCE, pos, neg, V, true);
+}
+
+int circuit_network::add_battery(int pos, int neg, double ocv, double R_0)
+    //Description:    Adds an internal node, the open circuit voltage from it to neg and R_0 from it to pos
+    //Preconditions:  R_0 > 0
+    //Postconditions: The returned source carries the battery current, positive while discharging
+{
+    check_node(pos);
+    check_node(neg);
+    int inner = add_node();
+    add_resistor(inner, pos, R_0);
+    return add_voltage_source(inner, neg, ocv);
+}
+
+void circuit_network::set_on(int e, bool on)
+{
+    check_element(e);
+    element& el = elements[e];
+    if (el.on == on) return;
+    el.on = on;
+    // A power load only acts on the right hand side
+    if (el.type == CE_LOAD) values_changed = true;
+}
+
+void circuit_network::set_resistance(int e, double R)
+{
+    check_element(e);
+    element& el = elements[e];
+    if (el.type != CE_RESISTOR && el.type != CE_LOAD) throw invalid_argument("circuit_network: element has no resistance");
+    if (!(R > 0.0)) throw invalid_argument("circuit_network: resistance must be positive");
+    if (el.value == R) return;
+    el.value = R;
+    values_changed = true;
+}
+
+void circuit_network::set_power(int e, double P)
+{
+    check_element(e);
+    if (elements[e].type != CE_POWER_LOAD) throw invalid_argument("circuit_network: element is not a power load");
+    elements[e].value = P;
+}
+
+void circuit_network::set_current(int e, double I)
+{
+    check_element(e);
+    if (elements[e].type != CE_CURRENT_SOURCE) throw invalid_argument("circuit_network: element is not a current source");
+    elements[e].value = I;
+}
+
+void circuit_network::set_voltage(int e, double V)
+{
+    check_element(e);
+    if (elements[e].type != CE_VOLTAGE_SOURCE) throw invalid_argument("circuit_network: element is not a voltage source");
+    elements[e].value = V;
+}
+
+int circuit_network::node_unknown(int n) const
+{
+    return n - 1;
+}
+
+int circuit_network::entry(int row, int col) const
+    //Description:    Position of (row, col) of the original unknowns in the factor storage
+    //Preconditions:  The entry is part of the pattern; -1 when row or col is ground
+    //Postconditions: None
+{
+    if (row < 0 || col < 0) return -1;
+    int r = irow[row], c = icol[col];
+    auto first = cols.begin() + row_ptr[r], last = cols.begin() + row_ptr[r + 1];
+    return static_cast<int>(lower_bound(first, last, c) - cols.begin());
+}
+
+void circuit_network::symbolic()
+    //Description:    Orders the unknowns and finds the pattern of L and U, then where every stamp lands
+    //Preconditions:  None
+    //Postconditions: a, lu and the stamp positions are sized for the current elements
+{
+    int n = num_nodes + num_branches;
+
+    // Pattern of the matrix (symmetric) on the original unknowns, without the diagonal
+    vector<set<int>> adj(n);
+    auto couple = [&adj](int i, int j) {
+        if (i < 0 || j < 0 || i == j) return;
+        adj[i].insert(j);
+        adj[j].insert(i);
+    };
+    for (const element& el : elements) {
+        int ua = node_unknown(el.a), ub = node_unknown(el.b);
+        if (el.type == CE_RESISTOR || el.type == CE_LOAD || el.type == CE_POWER_LOAD) {
+            couple(ua, ub);
+        } else if (el.type == CE_VOLTAGE_SOURCE) {
+            int k = num_nodes + el.branch;
+            couple(ua, k);
+            couple(ub, k);
+        }
+    }
+
+    // Voltage sources first: the equation of source k pivots on its node p and the equation of p on the
+    // current of k, both with pivot 1. This fixes V(p) relative to the other terminal before any node is
+    // eliminated. A source whose nodes are both taken (a loop of sources) is left for the end.
+    row_perm.clear();
+    col_perm.clear();
+    vector<bool> paired(num_nodes, false);
+    vector<int> partner(num_nodes, -1);
+    vector<int> unpaired;
+    for (const element& el : elements) {
+        if (el.type != CE_VOLTAGE_SOURCE) continue;
+        int k = num_nodes + el.branch;
+        int ua = node_unknown(el.a), ub = node_unknown(el.b);
+        int p = (ua >= 0 && !paired[ua]) ? ua : ((ub >= 0 && !paired[ub]) ? ub : -1);
+        if (p < 0) {
+            unpaired.push_back(k);
+            continue;
+        }
+        paired[p] = true;
+        partner[p] = (p == ua) ? ub : ua;
+        row_perm.push_back(k); col_perm.push_back(p);
+        row_perm.push_back(p); col_perm.push_back(k);
+    }
+
+    // Minimum degree on the other nodes. A paired node is replaced by its partner terminal, which gets its neighbours.
+    {
+        vector<set<int>> g(num_nodes);
+        for (int i = 0; i < num_nodes; i++)
+            for (int j : adj[i]) if (j < num_nodes) g[i].insert(j);
+        for (int p = 0; p < num_nodes; p++) {
+            if (!paired[p]) continue;
+            int q = partner[p];
+            for (int u : g[p]) {
+                g[u].erase(p);
+                if (q >= 0 && u != q) { g[u].insert(q); g[q].insert(u); }
+            }
+            g[p].clear();
+        }
+        vector<bool> done(paired);
+        for (int step = 0; step < num_nodes; step++) {
+            int best = -1;
+            for (int i = 0; i < num_nodes; i++)
+                if (!done[i] && (best < 0 || g[i].size() < g[best].size())) best = i;
+            if (best < 0) break;
+            done[best] = true;
+            row_perm.push_back(best); col_perm.push_back(best);
+            // Eliminating best joins its neighbours into a clique
+            vector<int> nb(g[best].begin(), g[best].end());
+            for (int u : nb) {
+                g[u].erase(best);
+                for (int v : nb) if (v != u) g[u].insert(v);
+            }
+            g[best].clear();
+        }
+    }
+    for (int k : unpaired) { row_perm.push_back(k); col_perm.push_back(k); }
+    irow.assign(n, 0);
+    icol.assign(n, 0);
+    for (int i = 0; i < n; i++) {
+        irow[row_perm[i]] = i;
+        icol[col_perm[i]] = i;
+    }
+
+    // Rows of L and U: row i holds its own pattern and the upper part of every row k < i it meets
+    vector<vector<int>> rows(n);
+    for (int i = 0; i < n; i++) {
+        int r = row_perm[i];
+        set<int> row;
+        row.insert(i);
+        if (r < num_nodes) row.insert(icol[r]);
+        for (int j : adj[r]) row.insert(icol[j]);
+        for (auto it = row.begin(); it != row.end() && *it < i; ++it) {
+            for (int c : rows[*it]) if (c > *it) row.insert(c);
+        }
+        rows[i].assign(row.begin(), row.end());
+    }
+
+    row_ptr.assign(n + 1, 0);
+    for (int i = 0; i < n; i++) row_ptr[i + 1] = row_ptr[i] + static_cast<int>(rows[i].size());
+    cols.resize(row_ptr[n]);
+    diag.resize(n);
+    for (int i = 0; i < n; i++) {
+        copy(rows[i].begin(), rows[i].end(), cols.begin() + row_ptr[i]);
+        diag[i] = static_cast<int>(lower_bound(rows[i].begin(), rows[i].end(), i) - rows[i].begin()) + row_ptr[i];
+    }
+    a.assign(cols.size(), 0.0);
+    lu.assign(cols.size(), 0.0);
+    work.assign(n, 0.0);
+    rhs.assign(n, 0.0);
+
+    // Nodes keep their numbers, so the voltages of the last solve still start the power loads
+    vector<double> old_x(x);
+    x.assign(n, 0.0);
+    copy(old_x.begin(), old_x.begin() + min(solved_nodes, num_nodes), x.begin());
+    solved_nodes = num_nodes;
+
+    sources.clear();
+    power_loads.clear();
+    for (int e = 0; e < static_cast<int>(elements.size()); e++) {
+        circuit_element_type type = elements[e].type;
+        if (type == CE_CURRENT_SOURCE || type == CE_VOLTAGE_SOURCE) sources.push_back(e);
+        if (type == CE_POWER_LOAD) power_loads.push_back(e);
+    }
+
+    gmin_pos.resize(num_nodes);
+    for (int i = 0; i < num_nodes; i++) gmin_pos[i] = entry(i, i);
+    for (element& el : elements) {
+        int ua = node_unknown(el.a), ub = node_unknown(el.b);
+        if (el.type == CE_RESISTOR || el.type == CE_LOAD || el.type == CE_POWER_LOAD) {
+            el.pos[0] = entry(ua, ua);
+            el.pos[1] = entry(ub, ub);
+            el.pos[2] = entry(ua, ub);
+            el.pos[3] = entry(ub, ua);
+        } else if (el.type == CE_VOLTAGE_SOURCE) {
+            int k = num_nodes + el.branch;
+            el.pos[0] = entry(ua, k);
+            el.pos[1] = entry(k, ua);
+            el.pos[2] = entry(ub, k);
+            el.pos[3] = entry(k, ub);
+        }
+    }
+
+    structure_changed = false;
+    values_changed = true;
+    slopes_valid = false;
+    symbolic_count++;
+}
+
+void circuit_network::numeric()
+    //Description:    Stamps the conductances and factors A = LU row by row on the fixed pattern
+    //Preconditions:  symbolic() has run for the current elements
+    //Postconditions: lu holds L below and U on and above the diagonal
+{
+    fill(a.begin(), a.end(), 0.0);
+    for (int p : gmin_pos) a[p] += GMIN;
+    for (element& el : elements) {
+        double s[4];
+        if (el.type == CE_POWER_LOAD) {
+            // Slope of P/V at the present voltage; the iteration in solve() corrects for it changing
+            double V = get_node_V(el.a) - get_node_V(el.b);
+            el.g = (slopes_valid && el.on && V > 0.0) ? -el.value / (V * V) : 0.0;
+        }
+        if (el.type == CE_RESISTOR || (el.type == CE_LOAD && el.on) || el.type == CE_POWER_LOAD) {
+            double g = (el.type == CE_POWER_LOAD) ? el.g : 1.0 / el.value;
+            s[0] = g; s[1] = g; s[2] = -g; s[3] = -g;
+        } else if (el.type == CE_VOLTAGE_SOURCE) {
+            s[0] = 1.0; s[1] = 1.0; s[2] = -1.0; s[3] = -1.0;
+        } else {
+            continue;
+        }
+        for (int i = 0; i < 4; i++) if (el.pos[i] >= 0) a[el.pos[i]] += s[i];
+    }
+
+    lu = a;
+    int n = static_cast<int>(diag.size());
+    for (int i = 0; i < n; i++) {
+        int begin = row_ptr[i], end = row_ptr[i + 1];
+        for (int p = begin; p < end; p++) work[cols[p]] = lu[p];
+        for (int p = begin; p < diag[i]; p++) {
+            int k = cols[p];
+            double l = work[k] / lu[diag[k]];
+            work[k] = l;
+            for (int q = diag[k] + 1; q < row_ptr[k + 1]; q++) work[cols[q]] -= l * lu[q];
+        }
+        for (int p = begin; p < end; p++) {
+            lu[p] = work[cols[p]];
+            work[cols[p]] = 0.0;
+        }
+        if (lu[diag[i]] == 0.0 || !isfinite(lu[diag[i]]))
+            throw runtime_error("circuit_network: singular circuit (a loop of voltage sources?)");
+    }
+
+    values_changed = false;
+    numeric_count++;
+}
+
+void circuit_network::substitute()
+    //Description:    Stamps the sources and solves LU x = b for the node voltages and branch currents
+    //Preconditions:  numeric() has run for the current conductances
+    //Postconditions: x holds the unknowns in their original order
+{
+    int n = static_cast<int>(diag.size());
+    fill(rhs.begin(), rhs.end(), 0.0);
+    for (int e : sources) {
+        const element& el = elements[e];
+        int ua = node_unknown(el.a), ub = node_unknown(el.b);
+        if (el.type == CE_CURRENT_SOURCE) {
+            if (ua >= 0) rhs[ua] -= el.value;
+            if (ub >= 0) rhs[ub] += el.value;
+        } else {
+            rhs[num_nodes + el.branch] = el.value;
+        }
+    }
+    // The part of each power load current the matrix does not carry
+    for (int e : power_loads) {
+        const element& el = elements[e];
+        int ua = node_unknown(el.a), ub = node_unknown(el.b);
+        if (ua >= 0) rhs[ua] -= el.rest;
+        if (ub >= 0) rhs[ub] += el.rest;
+    }
+
+    for (int i = 0; i < n; i++) work[i] = rhs[row_perm[i]];
+    for (int i = 0; i < n; i++) {
+        double s = work[i];
+        for (int p = row_ptr[i]; p < diag[i]; p++) s -= lu[p] * work[cols[p]];
+        work[i] = s;
+    }
+    for (int i = n - 1; i >= 0; i--) {
+        double s = work[i];
+        for (int p = diag[i] + 1; p < row_ptr[i + 1]; p++) s -= lu[p] * work[cols[p]];
+        work[i] = s / lu[diag[i]];
+    }
+    for (int i = 0; i < n; i++) {
+        x[col_perm[i]] = work[i];
+        work[i] = 0.0;
+    }
+}
+
+void circuit_network::solve()
+    //Description:    Factors as far as the changes since the last solve require, then iterates the power loads
+    //Preconditions:  No loop of ideal voltage sources
+    //Postconditions: get_node_V and get_current give the solution
+{
+    if (structure_changed) symbolic();
+    if (!slopes_valid && !power_loads.empty()) {
+        // No voltages to take the slopes at yet: solve once with the power loads drawing nothing
+        numeric();
+        for (int e : power_loads) elements[e].rest = 0.0;
+        substitute();
+        values_changed = true;
+    }
+    slopes_valid = true;
+    if (values_changed) numeric();
+
+    // A power load draws P/V = g*V + rest. The matrix carries g*V with g frozen at the last numeric
+    // factorization, rest is updated from the voltages until the currents stop changing.
+    auto update_power = [this]() {
+        double change = 0.0, scale = 0.0;
+        for (int e : power_loads) {
+            element& el = elements[e];
+            double V = get_node_V(el.a) - get_node_V(el.b);
+            double I = (el.on && V > 0.0) ? el.value / V : 0.0;
+            change = max(change, fabs(I - el.I));
+            scale = max(scale, fabs(I));
+            el.I = I;
+            el.rest = I - el.g * V;
+        }
+        return change <= POWER_TOL * scale;
+    };
+
+    update_power();
+    substitute();
+    for (int it = 1; !power_loads.empty() && it < POWER_ITERATIONS; it++) {
+        if (update_power()) break;
+        substitute();
+    }
+}
+
+double circuit_network::get_node_V(int n) const
+{
+    check_node(n);
+    int u = node_unknown(n);
+    return (u < 0 || u >= static_cast<int>(x.size())) ? 0.0 : x[u];
+}
+
+double circuit_network::get_current(int e) const
+{
+    check_element(e);
+    const element& el = elements[e];
+    switch (el.type) {
+        case CE_RESISTOR:       return (get_node_V(el.a) - get_node_V(el.b)) / el.value;
+        case CE_LOAD:           return el.on ? (get_node_V(el.a) - get_node_V(el.b)) / el.value : 0.0;
+        case CE_POWER_LOAD:     return el.on ? el.I : 0.0;
+        case CE_CURRENT_SOURCE: return el.value;
+        case CE_VOLTAGE_SOURCE: return (num_nodes + el.branch < static_cast<int>(x.size())) ? -x[num_nodes + el.branch] : 0.0;
+    }
+    return 0.0;
+}
+
+void circuit_network::get_terminals(int e, int& a_node, int& b_node) const
+{
+    check_element(e);
+    a_node = elements[e].a;
+    b_node = elements[e].b;
+}
+
+circuit_element_type circuit_network::get_type(int e) const
+{
+    check_element(e);
+    return elements[e].type;
+}
+
+int circuit_network::get_num_nodes() const { return num_nodes; }
+int circuit_network::get_num_elements() const { return static_cast<int>(elements.size()); }
+int circuit_network::get_symbolic_count() const { return symbolic_count; }
+int circuit_network::get_numeric_count() const { return numeric_count; }
+int circuit_network::get_factor_size() const { return static_cast<int>(cols.size()); }
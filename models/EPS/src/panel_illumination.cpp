@@ -0,0 +1,385 @@
+/*
+PURPOSE:    This is the implementation of file 'panel_illumination.hh'
+
+NOTE:       The shadow function of the prediction is the distance of the
+            occulter's center from the ray to the sun, squared, less the
+            radius squared (or the distance from the satellite when the
+            center lies behind the ray). It is negative exactly when
+            collisionRaySphere reports a hit and continuous along the
+            orbit, so its sign changes bracket the crossings.
+
+TERMS USED:
+    -> g - shadow function, negative in shadow
+*/
+
+#include "../include/panel_illumination.hh"
+#include "../../Recources/include/functions.hh"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+const double INF = std::numeric_limits<double>::infinity();
+
+// Largest RK4 step of the prediction; bisection refines every crossing below it
+const double PREDICT_STEP = 10.0;       // s
+const double CROSSING_TOL = 1e-3;       // s
+
+struct orbit_state {
+    Vector3d r, v;
+};
+
+// One RK4 step of the two body problem about the origin
+orbit_state rk4_step(const orbit_state& s, double mu, double h) {
+    auto accel = [mu](const Vector3d& r) {
+        Vector3d a(0, 0, 0);
+        if (mu == 0.0) return a;
+        double d = r.norm();
+        a = r * (-mu / (d * d * d));
+        return a;
+    };
+    Vector3d k1r = s.v, k1v = accel(s.r);
+    Vector3d r2, r3, r4;
+    r2 = s.r + k1r * (h / 2);
+    Vector3d k2r, k2v;
+    k2r = s.v + k1v * (h / 2);
+    k2v = accel(r2);
+    r3 = s.r + k2r * (h / 2);
+    Vector3d k3r, k3v;
+    k3r = s.v + k2v * (h / 2);
+    k3v = accel(r3);
+    r4 = s.r + k3r * h;
+    Vector3d k4r, k4v;
+    k4r = s.v + k3v * h;
+    k4v = accel(r4);
+
+    orbit_state next;
+    next.r = s.r + (k1r + k2r * 2.0 + k3r * 2.0 + k4r) * (h / 6);
+    next.v = s.v + (k1v + k2v * 2.0 + k3v * 2.0 + k4v) * (h / 6);
+    return next;
+}
+
+// Shadow function for a satellite at sat, an occulter of radius R at the origin and the sun at sun
+double shadow_g(const Vector3d& sat, const Vector3d& sun, double R) {
+    Vector3d d;
+    d = sun - sat;
+    d.normalize();
+    Vector3d to_center;
+    to_center = sat * -1.0;
+    double along = to_center.dot(d);
+    double dist2 = sat.dot(sat);
+    if (along > 0) dist2 -= along * along;
+    return dist2 - R * R;
+}
+}
+
+panel_illumination::panel_illumination()
+    //Description:    Creates a stage with no cells or occulters.
+    //Preconditions:  None
+    //Postconditions: The sun is at (-1.5e11, 0, 0), there is no prediction, the first update recomputes.
+{
+    sun_pos.insert(-1.5e11, 0, 0);
+    predicted = -1;
+    start_shadow = false;
+    predict_start = -INF;
+    predict_end = -INF;
+    eclipsed = false;
+    dirty = true;
+    last_R.insert(1, 0, 0,
+                  0, 1, 0,
+                  0, 0, 1);
+    recomputed = 0;
+    skipped = 0;
+}
+
+int panel_illumination::add_cell(const Vector3d& ref_normal, double max_current)
+    //Description:    Registers a cell.
+    //Preconditions:  ref_normal is not zero, max_current >= 0.
+    //Postconditions: Returns the index of the cell; its current is set on the next update.
+{
+    int cell = static_cast<int>(max_I.size());
+    normal_x.push_back(0);
+    normal_y.push_back(0);
+    normal_z.push_back(0);
+    max_I.push_back(max_current);
+    I_sc.push_back(0);
+    set_cell_normal(cell, ref_normal);
+    return cell;
+}
+
+int panel_illumination::add_cell(solar_cell& cell)
+    //Description:    Registers a solar_cell by its reference normal and maximum short circuit current.
+    //Preconditions:  The cell is initialized and its reference orientation set.
+    //Postconditions: Returns the index of the cell in this stage.
+{
+    return add_cell(cell.get_refrence_normal(), cell.get_max_I_sc());
+}
+
+void panel_illumination::set_cell_normal(int cell, const Vector3d& ref_normal)
+    //Description:    Changes the body frame normal of a cell.
+    //Preconditions:  0 <= cell < get_num_cells(), ref_normal not zero.
+    //Postconditions: The normal is stored as a unit vector; the next update recomputes.
+{
+    Vector3d n = ref_normal;
+    n.normalize();
+    normal_x.at(cell) = n[0];
+    normal_y[cell] = n[1];
+    normal_z[cell] = n[2];
+    dirty = true;
+}
+
+int panel_illumination::add_occulter(double radius, const Vector3d& center)
+    //Description:    Registers a body that can shadow the satellite.
+    //Preconditions:  radius > 0.
+    //Postconditions: Returns the index of the occulter.
+{
+    occulters.push_back({radius, center});
+    dirty = true;
+    return static_cast<int>(occulters.size()) - 1;
+}
+
+void panel_illumination::set_occulter_pos(int index, const Vector3d& center)
+    //Description:    Moves an occulter.
+    //Preconditions:  index is a registered occulter.
+    //Postconditions: A prediction made for this occulter is dropped.
+{
+    occulters.at(index).center = center;
+    if (index == predicted) {
+        predicted = -1;
+        predict_end = -INF;
+    }
+    dirty = true;
+}
+
+const Vector3d& panel_illumination::get_occulter_pos(int index) const
+{
+    return occulters.at(index).center;
+}
+
+void panel_illumination::set_sun_pos(const Vector3d& position)
+    //Description:    Sets the global position of the sun.
+    //Preconditions:  None
+    //Postconditions: The prediction is dropped and the next update recomputes.
+{
+    sun_pos = position;
+    predicted = -1;
+    predict_end = -INF;
+    dirty = true;
+}
+
+bool panel_illumination::in_sunlight(const Vector3d& sat_pos) const
+    //Description:    Casts a ray from the satellite to the sun against every occulter.
+    //Preconditions:  None
+    //Postconditions: Returns false when any occulter blocks the sun.
+{
+    Vector3d to_sun;
+    to_sun = sun_pos - sat_pos;
+    for (const occulter& o : occulters) {
+        if (collisionRaySphere(o.radius, o.center, sat_pos, to_sun)) return false;
+    }
+    return true;
+}
+
+bool panel_illumination::is_valid_position(const Vector3d& sat_pos) const
+    //Description:    Tells a position the satellite can be at from one that is no orbit.
+    //Preconditions:  None
+    //Postconditions: Returns false for a position that is not finite or lies inside (or on) an occulter.
+{
+    if (!std::isfinite(sat_pos[0]) || !std::isfinite(sat_pos[1]) || !std::isfinite(sat_pos[2])) return false;
+    for (const occulter& o : occulters) {
+        Vector3d d;
+        d = sat_pos - o.center;
+        if (d.dot(d) <= o.radius * o.radius) return false;
+    }
+    return true;
+}
+
+bool panel_illumination::predicted_shadow(double time) const
+{
+    // Every crossing up to time flips the state once
+    int flips = static_cast<int>(std::upper_bound(crossings.begin(), crossings.end(), time) - crossings.begin());
+    return start_shadow != (flips % 2 == 1);
+}
+
+bool panel_illumination::update(double time, const Vector3d& sat_pos, const Matrix3d& R)
+    //Description:    Updates the shadow state and, when the lighting changed, the current of every cell.
+    //Preconditions:  None
+    //Postconditions: get_I_sc holds the currents at this time. Returns true when they were recomputed.
+    //                A position that is no orbit changes nothing and returns false.
+{
+    if (!is_valid_position(sat_pos)) return false;
+
+    bool shadow = false;
+    Vector3d to_sun;
+    to_sun = sun_pos - sat_pos;
+    bool use_prediction = predicted >= 0 && time >= predict_start && time <= predict_end;
+    for (int k = 0; k < static_cast<int>(occulters.size()) && !shadow; k++) {
+        if (use_prediction && k == predicted) shadow = predicted_shadow(time);
+        else shadow = collisionRaySphere(occulters[k].radius, occulters[k].center, sat_pos, to_sun);
+    }
+
+    bool same_R = true;
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++) same_R = same_R && R(i, j) == last_R(i, j);
+
+    // In shadow the currents stay zero whatever the attitude does
+    if (!dirty && shadow == eclipsed && (shadow || same_R)) {
+        skipped++;
+        return false;
+    }
+
+    eclipsed = shadow;
+    last_R = R;
+    dirty = false;
+    recomputed++;
+
+    int n = get_num_cells();
+    if (shadow) {
+        std::fill(I_sc.begin(), I_sc.end(), 0.0);
+        return true;
+    }
+
+    // The sun in the body frame, s_body = R^-T s
+    to_sun.normalize();
+    Matrix3d R_inv = R.inverse();
+    double sx = R_inv(0, 0) * to_sun[0] + R_inv(1, 0) * to_sun[1] + R_inv(2, 0) * to_sun[2];
+    double sy = R_inv(0, 1) * to_sun[0] + R_inv(1, 1) * to_sun[1] + R_inv(2, 1) * to_sun[2];
+    double sz = R_inv(0, 2) * to_sun[0] + R_inv(1, 2) * to_sun[1] + R_inv(2, 2) * to_sun[2];
+
+    const double* nx = normal_x.data();
+    const double* ny = normal_y.data();
+    const double* nz = normal_z.data();
+    const double* m = max_I.data();
+    double* out = I_sc.data();
+    for (int c = 0; c < n; c++) out[c] = m[c] * std::max(0.0, nx[c] * sx + ny[c] * sy + nz[c] * sz);
+    return true;
+}
+
+double panel_illumination::get_I_sc(int cell) const
+    //Description:    Returns the short circuit current of one cell.
+    //Preconditions:  0 <= cell < get_num_cells(), update was called.
+    //Postconditions: None
+{
+    return I_sc.at(cell);
+}
+
+const double* panel_illumination::get_I_sc() const
+    //Description:    Returns the short circuit currents of all cells in index order.
+    //Preconditions:  update was called.
+    //Postconditions: The pointer stays valid until a cell is added.
+{
+    return I_sc.data();
+}
+
+double panel_illumination::get_total_I_sc() const
+    //Description:    Returns the sum of the short circuit currents.
+    //Preconditions:  update was called.
+    //Postconditions: None
+{
+    double total = 0.0;
+    for (double I : I_sc) total += I;
+    return total;
+}
+
+bool panel_illumination::is_eclipsed() const
+{
+    return eclipsed;
+}
+
+bool panel_illumination::predict_eclipses(double time, const Vector3d& sat_pos, const Vector3d& sat_vel,
+                                          double mu, int index, double horizon)
+    //Description:    Propagates a two body orbit about an occulter and records the times the satellite
+    //                enters and leaves its shadow.
+    //Preconditions:  index is a registered occulter, mu >= 0, horizon > 0. Position and velocity are global;
+    //                the occulter is taken as not moving over the horizon.
+    //Postconditions: update takes the shadow state of this occulter from the prediction up to time + horizon.
+    //                A state that is not finite or inside an occulter drops the prediction and returns false.
+{
+    const occulter& o = occulters.at(index);
+    predicted = -1;
+    predict_end = -INF;
+    crossings.clear();
+    bool finite = std::isfinite(time) && std::isfinite(mu) && std::isfinite(horizon);
+    for (int i = 0; i < 3; i++) finite = finite && std::isfinite(sat_vel[i]);
+    if (!finite || !is_valid_position(sat_pos)) return false;
+
+    orbit_state s;
+    s.r = sat_pos - o.center;
+    s.v = sat_vel;
+    Vector3d sun;
+    sun = sun_pos - o.center;
+
+    predicted = index;
+    predict_start = time;
+    predict_end = time + horizon;
+
+    double g = shadow_g(s.r, sun, o.radius);
+    start_shadow = g < 0;
+    double t = 0.0;
+    while (t < horizon) {
+        double h = std::min(PREDICT_STEP, horizon - t);
+        orbit_state next = rk4_step(s, mu, h);
+        double g_next = shadow_g(next.r, sun, o.radius);
+        if ((g < 0) != (g_next < 0)) {
+            // Bisect on the length of a single step from s; the crossing lies between lo and hi
+            double lo = 0.0, hi = h;
+            while (hi - lo > CROSSING_TOL) {
+                double mid = 0.5 * (lo + hi);
+                double g_mid = shadow_g(rk4_step(s, mu, mid).r, sun, o.radius);
+                if ((g_mid < 0) == (g < 0)) lo = mid;
+                else hi = mid;
+            }
+            crossings.push_back(time + t + hi);
+        }
+        s = next;
+        g = g_next;
+        t += h;
+    }
+    return true;
+}
+
+double panel_illumination::get_next_entry(double time) const
+    //Description:    Returns the first predicted entry into the shadow after time.
+    //Preconditions:  predict_eclipses was called.
+    //Postconditions: Infinity when no entry is predicted within the horizon.
+{
+    for (size_t k = 0; k < crossings.size(); k++) {
+        // Crossings alternate, entries are the even ones when the prediction started lit
+        bool entry = (k % 2 == 0) != start_shadow;
+        if (entry && crossings[k] > time) return crossings[k];
+    }
+    return INF;
+}
+
+double panel_illumination::get_next_exit(double time) const
+    //Description:    Returns the first predicted exit from the shadow after time.
+    //Preconditions:  predict_eclipses was called.
+    //Postconditions: Infinity when no exit is predicted within the horizon.
+{
+    for (size_t k = 0; k < crossings.size(); k++) {
+        bool exit = (k % 2 == 0) == start_shadow;
+        if (exit && crossings[k] > time) return crossings[k];
+    }
+    return INF;
+}
+
+double panel_illumination::get_prediction_end() const
+{
+    return predict_end;
+}
+
+int panel_illumination::get_num_cells() const
+{
+    return static_cast<int>(max_I.size());
+}
+
+int panel_illumination::get_recomputed() const
+{
+    return recomputed;
+}
+
+int panel_illumination::get_skipped() const
+{
+    return skipped;
+}
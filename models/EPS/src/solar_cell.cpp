@@ -1,3 +1,10 @@
+/********************************* TRICK HEADER *******************************
+PURPOSE: (Simulate A Solar Cell)
+LIBRARY DEPENDENCY:
+    ((solar_cell.o)
+     (Recources/src/frame_transforms.o))
+*******************************************************************************/
+
 /*
 PURPOSE:    This is the implementation of file 'solar_cell.hh'
 
@@ -184,6 +191,41 @@ void solar_cell::update_pos_ori(Vector3d ref)
     normal_vec = R_matrix.inverse() * ref_normal_vec;
 }
 
+void solar_cell::update_pos_ori(const frame_transforms& frames, int handle)
+    //Description:    Reads the position and normal vector from a frame_transforms pass that moved all mounts at once.
+    //Preconditions:  frames updated this cycle, handle returned when this cell's mount was registered.
+    //Postconditions: pos and normal_vec are updated, same values as update_pos_ori(ref, R).
+{
+    R_matrix = frames.get_R();
+
+    pos = frames.get_pos(handle);
+    normal_vec = frames.get_ori(handle);
+}
+
+Vector3d solar_cell::get_refrence_pos()
+    //Description:    Returns the reference position of the solar cell.
+    //Preconditions:  None.
+    //Postconditions: None.
+{
+    return ref_pos;
+}
+
+Vector3d solar_cell::get_refrence_normal()
+    //Description:    Returns the reference normal vector of the solar cell.
+    //Preconditions:  None.
+    //Postconditions: None.
+{
+    return ref_normal_vec;
+}
+
+double solar_cell::get_max_I_sc()
+    //Description:    Returns the maximum short-circuit current of the solar cell.
+    //Preconditions:  None.
+    //Postconditions: None.
+{
+    return max_I_sc;
+}
+
 void solar_cell::rotate_dir_clock(double theta)
     //Description:    Rotates the reference normal vector clockwise by an angle theta.
     //Preconditions:  theta must be a valid angle in degrees.
@@ -0,0 +1,176 @@
+/*
+PURPOSE:    This is the implementation of file 'wire_chain.hh'
+
+NOTE:       In the scaled matrix every sub diagonal entry is -h and every
+            super diagonal entry +h, so the elimination only needs the
+            pivots, p_i = d_i + h^2 / p_(i-1), kept as their inverses.
+
+            A stiff mode is damped by about 1 / (dt |lambda|) per step, not
+            removed: after a jump of the source the step leaves that part
+            of the jump, ~1e-5 for a harness at 25 ms, and the next step
+            the square of it.
+*/
+
+#include "../include/wire_chain.hh"
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+// TR-BDF2 with gamma = 2 - sqrt(2); both stages solve with (I - c dt A)
+const double GAMMA = 2.0 - std::sqrt(2.0);
+const double TRBDF2_C = 1.0 - 1.0 / std::sqrt(2.0);
+}
+
+wire_chain::wire_chain()
+    //Description:      Creates a run with no segments.
+    //Preconditions:    None
+    //Postconditions:   The end is open and no current is drawn.
+    : G_load(0.0), I_load(0.0), factor_h(-1.0)
+{
+}
+
+int wire_chain::add_wire(wire& segment)
+    //Description:      Appends a segment after the last one.
+    //Preconditions:    The R, L and C of the wire are positive.
+    //Postconditions:   The new segment carries no current and its node is at 0 V. Returns its index.
+{
+    R.push_back(segment.get_R());
+    L.push_back(segment.get_L());
+    C.push_back(segment.get_C());
+    inv_L.push_back(1.0 / L.back());
+    inv_C.push_back(1.0 / C.back());
+    x.push_back(0.0);
+    x.push_back(0.0);
+    factor_h = -1.0;
+    return size() - 1;
+}
+
+void wire_chain::set_load_resistance(double resistance)
+    //Description:      Sets the resistance of the load at the end of the run.
+    //Preconditions:    resistance > 0; infinity leaves the end open.
+    //Postconditions:   The factors are rebuilt on the next step.
+{
+    if (!(resistance > 0)) throw std::invalid_argument("wire_chain: load resistance must be positive");
+    G_load = 1.0 / resistance;
+    factor_h = -1.0;
+}
+
+void wire_chain::set_load_current(double current)
+    //Description:      Sets a current drawn at the end of the run on top of the load resistance.
+    //Preconditions:    None
+    //Postconditions:   Only the right hand side changes; the factors are kept.
+{
+    I_load = current;
+}
+
+void wire_chain::factor(double h)
+{
+    if (h == factor_h) return;
+    int n = static_cast<int>(x.size());
+    inv_pivot.resize(n);
+    for (int i = 0; i < n; i++) {
+        int k = i / 2;
+        double d = (i % 2 == 0) ? L[k] + h * R[k] : C[k];
+        if (i == n - 1) d += h * G_load;
+        if (i > 0) d += h * h * inv_pivot[i - 1];
+        inv_pivot[i] = 1.0 / d;
+    }
+    factor_h = h;
+}
+
+void wire_chain::solve(std::vector<double>& rhs)
+{
+    int n = static_cast<int>(x.size());
+    double h = factor_h;
+    const double* p = inv_pivot.data();
+    double* r = rhs.data();
+    // Scale by L and C, then forward elimination
+    r[0] *= L[0];
+    r[1] = r[1] * C[0] + h * r[0] * p[0];
+    for (int k = 1; 2 * k < n; k++) {
+        r[2 * k] = r[2 * k] * L[k] + h * r[2 * k - 1] * p[2 * k - 1];
+        r[2 * k + 1] = r[2 * k + 1] * C[k] + h * r[2 * k] * p[2 * k];
+    }
+    // Back substitution
+    r[n - 1] *= p[n - 1];
+    for (int i = n - 2; i >= 0; i--) r[i] = (r[i] - h * r[i + 1]) * p[i];
+}
+
+void wire_chain::derivative(std::vector<double>& out) const
+{
+    int N = size();
+    for (int k = 0; k < N; k++) {
+        double V_before = (k > 0) ? x[2 * k - 1] : 0.0;
+        double I_after = (k < N - 1) ? x[2 * k + 2] : x[2 * k + 1] * G_load;
+        out[2 * k] = (V_before - R[k] * x[2 * k] - x[2 * k + 1]) * inv_L[k];
+        out[2 * k + 1] = (x[2 * k] - I_after) * inv_C[k];
+    }
+}
+
+void wire_chain::add_source(double V_source, double h, std::vector<double>& rhs) const
+{
+    rhs.front() += h * V_source * inv_L.front();
+    rhs.back() -= h * I_load * inv_C.back();
+}
+
+void wire_chain::step(double V_source, double dt)
+    //Description:      Advances the run by dt with TR-BDF2.
+    //Preconditions:    At least one segment, dt > 0.
+    //Postconditions:   Currents and node voltages are at the end of the step; stable for any dt.
+{
+    if (x.empty()) throw std::logic_error("wire_chain: no segments");
+    int n = static_cast<int>(x.size());
+    double h = TRBDF2_C * dt;
+    factor(h);
+    f.resize(n);
+    stage.resize(n);
+
+    // Trapezoidal stage to t + gamma dt
+    derivative(f);
+    for (int i = 0; i < n; i++) stage[i] = x[i] + h * f[i];
+    add_source(V_source, 2.0 * h, stage);
+    solve(stage);
+
+    // BDF2 stage to t + dt
+    double wg = 1.0 / (GAMMA * (2.0 - GAMMA));
+    double wn = (1.0 - GAMMA) * (1.0 - GAMMA) * wg;
+    for (int i = 0; i < n; i++) x[i] = wg * stage[i] - wn * x[i];
+    add_source(V_source, h, x);
+    solve(x);
+}
+
+void wire_chain::step_backward_euler(double V_source, double dt)
+    //Description:      Advances the run by dt with backward Euler.
+    //Preconditions:    At least one segment, dt > 0.
+    //Postconditions:   Currents and node voltages are at the end of the step; stable for any dt.
+{
+    if (x.empty()) throw std::logic_error("wire_chain: no segments");
+    factor(dt);
+    add_source(V_source, dt, x);
+    solve(x);
+}
+
+double wire_chain::get_current(int segment) const
+{
+    return x.at(2 * segment);
+}
+
+double wire_chain::get_node_voltage(int segment) const
+{
+    return x.at(2 * segment + 1);
+}
+
+double wire_chain::get_load_voltage() const
+{
+    return x.at(x.size() - 1);
+}
+
+double wire_chain::get_load_current() const
+{
+    return get_load_voltage() * G_load + I_load;
+}
+
+int wire_chain::size() const
+{
+    return static_cast<int>(R.size());
+}
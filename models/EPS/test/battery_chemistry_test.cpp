@@ -0,0 +1,165 @@
+/*
+PURPOSE: (Checks battery chemistry tables: a battery without a chemistry
+          and with an empty one run the same as before, a chemistry read
+          from CSV gives the battery its OCV and resistances over state of
+          charge and temperature, another file swaps the chemistry, the
+          binary form gives the same battery, clearing the chemistry puts
+          the resistances the battery was built with back, and times an
+          OCV lookup.)
+COMMANDS:
+    : g++ -O2 src/Battery.cpp src/battery_chemistry.cpp ../Recources/src/interp_table.cpp test/battery_chemistry_test.cpp -o battery_chemistry_program
+*/
+
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <vector>
+#include "../include/Battery.hh"
+#include "../include/battery_chemistry.hh"
+#include "../../Recources/include/test_checks.hh"
+
+using namespace std;
+
+double findOCV(double SOC);
+
+// Three lithium ion cells in series: a knee near empty, lower voltage and higher resistance when cold
+double ocv_3s(double soc, double T) {
+    return 3 * (3.3 + 0.8 * soc - 0.35 * exp(-20 * soc) + 0.0004 * (T - 298.15));
+}
+double R0_3s(double soc, double T) {
+    return 0.003 * (1 + 0.5 * exp(-10 * soc)) * exp(0.03 * (298.15 - T));
+}
+
+// Writes the chemistry as points on uneven soc breakpoints and 9 temperatures over -10 to 60 C
+void write_chemistry(const char* path, double scale) {
+    ofstream out(path);
+    out << "# 3S lithium ion pack\nsoc, T, ocv, R0, R1, R2\n";
+    for (int k = 0; k < 9; k++)
+        for (double soc : {0.0, 0.03, 0.07, 0.12, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1.0})
+            out << soc << ", " << 263.15 + 8.75 * k << ", " << scale * ocv_3s(soc, 263.15 + 8.75 * k) << ", " << R0_3s(soc, 263.15 + 8.75 * k) << ", "
+                << 2 * R0_3s(soc, 263.15 + 8.75 * k) << ", " << 3 * R0_3s(soc, 263.15 + 8.75 * k) << "\n";
+}
+
+// Discharges at 50 A with the RC branches integrated by Euler, as battery_test does; returns Vt after each step
+vector<double> discharge(battery& bat, int steps, double dt) {
+    vector<double> Vt;
+    double V1 = 0, V2 = 0;
+    bat.update_I(50);
+    for (int k = 0; k < steps; k++) {
+        double dV1, dV2;
+        bat.state_deriv_getVolteges(dV1, dV2);
+        V1 += dV1 * dt;
+        V2 += dV2 * dt;
+        bat.update_V1(V1);
+        bat.update_V2(V2);
+        bat.update_soc(dt);
+        bat.update_Vt();
+        Vt.push_back(bat.get_Vt());
+    }
+    return Vt;
+}
+
+int main(){
+    bool ok = true;
+
+    {
+        cout << "=== no tables ===\n";
+        battery plain, empty_chem;
+        battery_chemistry none;
+        empty_chem.set_chemistry(&none);
+        ok &= check("same terminal voltages as findOCV", discharge(plain, 2000, 0.1) == discharge(empty_chem, 2000, 0.1), 1, 0);
+    }
+
+    write_chemistry("battery_chemistry_test_a.csv", 1.0);
+    write_chemistry("battery_chemistry_test_b.csv", 1.1);
+
+    {
+        cout << "=== chemistry from CSV ===\n";
+        battery_chemistry chem;
+        chem.load("battery_chemistry_test_a.csv");
+        double worst = 0.0;
+        for (double soc = 0.2; soc <= 0.9; soc += 0.001)
+            for (double T : {263.15, 280.0, 298.15, 320.0})
+                worst = max(worst, fabs(chem.get_ocv(soc, T) - ocv_3s(soc, T)));
+        // Set by the spacing of the points in the file, not by the table
+        ok &= check_below("largest OCV error, 0.2 - 0.9 soc, 263 - 333 K (V)", worst, 5e-3);
+
+        battery bat(36000, 0.001, 0.02, 0.01, 1000, 2000, 0.5);
+        bat.set_chemistry(&chem);
+        bat.set_T(273.15);
+        bat.update_I(10);
+        bat.update_soc(0);
+        bat.update_Vt();
+        double R0 = 0, R1 = 0, R2 = 0;
+        chem.get_resistances(0.5, 273.15, R0, R1, R2);
+        ok &= check("terminal voltage at 0.5 soc, 0 C, 10 A", bat.get_Vt(), ocv_3s(0.5, 273.15) - 10 * R0_3s(0.5, 273.15), 1e-3);
+        ok &= check("R1 from its table", R1, 2 * R0_3s(0.5, 273.15), 1e-4);
+
+        // Another chemistry, the same code
+        battery_chemistry other;
+        other.load("battery_chemistry_test_b.csv");
+        bat.set_chemistry(&other);
+        bat.update_soc(0);
+        bat.update_Vt();
+        ok &= check("after swapping the file", bat.get_Vt(), 1.1 * ocv_3s(0.5, 273.15) - 10 * R0_3s(0.5, 273.15), 1e-3);
+
+        // Clearing the chemistry goes back to findOCV and the resistances the battery was built with
+        battery built(36000, 0.001, 0.02, 0.01, 1000, 2000, 0.5);
+        built.update_I(10);
+        built.update_soc(0);
+        built.update_Vt();
+        bat.set_chemistry(nullptr);
+        bat.update_soc(0);
+        bat.update_Vt();
+        ok &= check("after clearing the chemistry", bat.get_Vt(), built.get_Vt(), 1e-12);
+
+        // The binary form runs the battery the same
+        chem.save("battery_chemistry_test.bin");
+        battery_chemistry back;
+        back.load("battery_chemistry_test.bin");
+        battery a(36000, 0.001, 0.02, 0.01, 1000, 2000, 0.85), b = a;
+        a.set_chemistry(&chem);
+        b.set_chemistry(&back);
+        ok &= check("binary tables give the same discharge", discharge(a, 3000, 1.0) == discharge(b, 3000, 1.0), 1, 0);
+    }
+    remove("battery_chemistry_test_a.csv");
+    remove("battery_chemistry_test_b.csv");
+    remove("battery_chemistry_test.bin");
+
+    {
+        cout << "=== nanoseconds per OCV ===\n";
+        const int n = 1000000;
+        mt19937 gen(8);
+        uniform_real_distribution<double> u(0.2, 0.9);
+        vector<double> soc(n);
+        for (double& s : soc) s = u(gen);
+        interp_table ocv_table;
+        vector<double> xs, ys = {263.15, 298.15, 333.15}, v;
+        for (int i = 0; i <= 100; i++) xs.push_back(i / 100.0);
+        for (double T : ys)
+            for (double s : xs) v.push_back(ocv_3s(s, T));
+        ocv_table.set_breakpoints(xs, ys, v, 101, 9, INTERP_MONOTONE_CUBIC);
+        battery_chemistry chem;
+        chem.set_ocv(ocv_table);
+
+        double sum = 0.0;
+        auto start = chrono::steady_clock::now();
+        for (double s : soc) sum += ocv_3s(s, 300.0);
+        double t_formula = chrono::duration<double>(chrono::steady_clock::now() - start).count() / n;
+        start = chrono::steady_clock::now();
+        for (double s : soc) sum += chem.get_ocv(s, 300.0);
+        double t_table = chrono::duration<double>(chrono::steady_clock::now() - start).count() / n;
+        start = chrono::steady_clock::now();
+        for (double s : soc) sum += findOCV(s);
+        double t_linear = chrono::duration<double>(chrono::steady_clock::now() - start).count() / n;
+        bool finite = isfinite(sum);
+        ok &= finite;
+        printf("  closed form with exp  %5.1f\n  table                 %5.1f\n  findOCV (linear)      %5.1f%s\n",
+               1e9 * t_formula, 1e9 * t_table, 1e9 * t_linear, finite ? "" : "  FAIL");
+    }
+
+    return report(ok);
+}
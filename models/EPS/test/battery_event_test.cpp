@@ -0,0 +1,119 @@
+/*
+PURPOSE: (Checks the closed form stepping of battery used between events:
+          one long step is the same as many short ones, it agrees with the
+          battery integrated with a fine Euler step, it stops the current
+          where soc reaches its bound, it predicts when soc reaches a level
+          and when the RC voltages settle,
+          and counts the battery updates an event driven loop makes against
+          a ticked one.)
+COMMANDS:
+    : g++ -O2 src/Battery.cpp src/battery_chemistry.cpp ../Recources/src/interp_table.cpp test/battery_event_test.cpp -o battery_event_program
+*/
+
+#include <iostream>
+#include <cmath>
+#include "../include/Battery.hh"
+#include "../../Recources/include/test_checks.hh"
+
+using namespace std;
+
+// Load profile: the current changes only at these times, positive discharges
+const double CHANGE_T[] = {0.0, 600.0, 1500.0, 2400.0, 3000.0};
+const double CHANGE_I[] = {20.0, -15.0, 40.0, 0.0, 10.0};
+
+double profile(double t) {
+    int k = 0;
+    while (k < 4 && t >= CHANGE_T[k + 1]) k++;
+    return CHANGE_I[k];
+}
+
+int main(){
+    bool ok = true;
+
+    {
+        cout << "=== one step against many ===\n";
+        battery one, many;
+        one.update_I(30);
+        many.update_I(30);
+        one.propagate(600);
+        for (int k = 0; k < 600; k++) many.propagate(1.0);
+        ok &= check("soc", one.get_soc(), many.get_soc(), 1e-12);
+        ok &= check("V1", one.get_V1(), many.get_V1(), 1e-12);
+        ok &= check("V2", one.get_V2(), many.get_V2(), 1e-12);
+        ok &= check("terminal voltage", one.get_Vt(), many.get_Vt(), 1e-12);
+    }
+
+    {
+        cout << "=== against battery, Euler with dt 1 ms ===\n";
+        battery cell, exact;
+        double h = 1e-3, dV1, dV2, T = 60.0;
+        for (long k = 0; k < static_cast<long>(T / h + 0.5); k++) {
+            cell.update_I(k * h < 20.0 ? 50.0 : -20.0);
+            cell.state_deriv_getVolteges(dV1, dV2);
+            cell.update_V1(cell.get_V1() + dV1 * h);
+            cell.update_V2(cell.get_V2() + dV2 * h);
+            cell.update_soc(h);
+        }
+        cell.update_Vt();
+        exact.update_I(50.0);
+        exact.propagate(20.0);
+        exact.update_I(-20.0);
+        exact.propagate(40.0);
+        ok &= check("V1", exact.get_V1(), cell.get_V1(), 1e-4);
+        ok &= check("V2", exact.get_V2(), cell.get_V2(), 1e-4);
+        ok &= check("soc", exact.get_soc(), cell.get_soc(), 1e-9);
+        ok &= check("terminal voltage", exact.get_Vt(), cell.get_Vt(), 1e-4);
+    }
+
+    {
+        cout << "=== reaching the bound within a step ===\n";
+        // 10 A out of 36000 As takes 0.25 to 0.2 in 180 s; the branches then discharge for 20 s
+        battery bat(36000, 0.001, 0.02, 0.01, 1000, 2000, 0.25);
+        bat.update_I(10);
+        ok &= check("time to 0.2 soc", bat.time_to_soc(0.2), 180.0, 1e-12);
+        ok &= check_flag("never reaches 0.9", isinf(bat.time_to_soc(0.9)));
+        bat.propagate(200);
+        ok &= check("soc", bat.get_soc(), 0.2, 0);
+        ok &= check("current", bat.state_deriv_getI(), 0.0, 0);
+        ok &= check("V1", bat.get_V1(), 10 * 0.02 * (1 - exp(-180.0 / 20)) * exp(-20.0 / 20), 1e-12);
+        ok &= check("V2", bat.get_V2(), 10 * 0.01 * (1 - exp(-180.0 / 20)) * exp(-20.0 / 20), 1e-12);
+        ok &= check_flag("at the bound, no level ahead", isinf(bat.time_to_soc(0.2)));
+        double settle = bat.time_to_settle(1e-3);
+        ok &= check("time for V1 and V2 to settle within 1 mV", settle, 20 * log(bat.get_V1() / 1e-3), 1e-12);
+        bat.propagate(settle);
+        ok &= check("V1 then", bat.get_V1(), 1e-3, 1e-12);
+        ok &= check("settled", bat.time_to_settle(1e-3 * (1 + 1e-9)), 0.0, 0);
+    }
+
+    {
+        cout << "=== event driven against ticked, 1 h, ticks of 1 s ===\n";
+        // Ticked as EPS_Module does it, trapezoid on the RC derivatives
+        battery ticked(360000, 0.001, 0.02, 0.01, 1000, 2000, 0.8), evented = ticked;
+        double dV1 = 0, dV2 = 0, dV1_prev, dV2_prev;
+        int tick_updates = 0;
+        for (int k = 0; k < 3600; k++) {
+            ticked.update_I(profile(k));
+            dV1_prev = dV1;
+            dV2_prev = dV2;
+            ticked.update_soc(1.0);
+            ticked.state_deriv_getVolteges(dV1, dV2);
+            ticked.update_V1(ticked.get_V1() + 0.5 * (dV1_prev + dV1));
+            ticked.update_V2(ticked.get_V2() + 0.5 * (dV2_prev + dV2));
+            ticked.update_Vt();
+            tick_updates++;
+        }
+
+        // Only at the load changes
+        int event_updates = 0;
+        for (int k = 0; k < 5; k++) {
+            evented.update_I(CHANGE_I[k]);
+            evented.propagate((k < 4 ? CHANGE_T[k + 1] : 3600.0) - CHANGE_T[k]);
+            event_updates++;
+        }
+        ok &= check("soc", evented.get_soc(), ticked.get_soc(), 1e-9);
+        ok &= check("terminal voltage", evented.get_Vt(), ticked.get_Vt(), 1e-3);
+        cout << "  battery updates: ticked " << tick_updates << ", event driven " << event_updates << "\n";
+    }
+
+    return report(ok);
+}
@@ -0,0 +1,204 @@
+/*
+PURPOSE: (Checks battery_pack against the exact RC response of a cell under
+          a current profile, against battery integrated with a fine Euler
+          step, at steps far above the RC time constants, splits current
+          in parallel groups with cell to cell variation, cuts off cells at
+          their state of charge limits, and times a step
+          of a pack of hundreds of cells.)
+COMMANDS:
+    : g++ -O2 src/battery_pack.cpp src/Battery.cpp src/battery_chemistry.cpp ../Recources/src/interp_table.cpp test/battery_pack_test.cpp -o battery_pack_program
+*/
+
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "../include/battery_pack.hh"
+#include "../include/Battery.hh"
+#include "../../Recources/include/test_checks.hh"
+
+using namespace std;
+
+// Current profile: 10 s segments, positive discharges
+double profile(double t) {
+    static const double I[] = {50.0, -20.0, -50.0, 200.0, 0.0, 80.0};
+    int k = static_cast<int>(t / 10.0);
+    return I[min(k, 5)];
+}
+
+// RC voltage after t seconds of the profile, from the closed form of every segment
+double exact_rc(double R, double C, double t) {
+    double V = 0.0, tau = R * C;
+    for (double t0 = 0.0; t0 < t - 1e-12; t0 += 10.0) {
+        double h = min(10.0, t - t0), a = exp(-h / tau);
+        V = a * V + (1.0 - a) * R * profile(t0);
+    }
+    return V;
+}
+
+int main(){
+    bool ok = true;
+    const double T = 60.0;
+
+    // One cell: the RC voltages are exact for any step that lands on the profile's changes
+    {
+        cout << "=== one cell, exact RC response ===\n";
+        for (double dt : {1.0, 5.0, 10.0}) {
+            battery_pack pack(1, 1);
+            for (double t = 0.0; t < T - 1e-9; t += dt) pack.step(profile(t), dt);
+            char what[64];
+            snprintf(what, sizeof(what), "V1 after %g s, dt %g s", T, dt);
+            ok &= check(what, pack.get_cell_V1(0), exact_rc(0.02, 1000, T), 1e-12);
+            snprintf(what, sizeof(what), "V2 after %g s, dt %g s", T, dt);
+            ok &= check(what, pack.get_cell_V2(0), exact_rc(0.01, 2000, T), 1e-12);
+        }
+    }
+
+    // Against battery stepped the way EPS_Module does it, with a step far below the time constants
+    {
+        cout << "=== one cell against battery, Euler with dt 1 ms ===\n";
+        battery cell;
+        double h = 1e-3, dV1, dV2;
+        for (long k = 0; k < static_cast<long>(T / h + 0.5); k++) {
+            cell.update_I(profile(k * h));
+            cell.state_deriv_getVolteges(dV1, dV2);
+            cell.update_V1(cell.get_V1() + dV1 * h);
+            cell.update_V2(cell.get_V2() + dV2 * h);
+            cell.update_soc(h);
+        }
+        cell.update_Vt();
+
+        battery_pack pack(1, 1);
+        for (double t = 0.0; t < T - 1e-9; t += 10.0) pack.step(profile(t), 10.0);
+        ok &= check("V1", pack.get_cell_V1(0), cell.get_V1(), 1e-4);
+        ok &= check("V2", pack.get_cell_V2(0), cell.get_V2(), 1e-4);
+        ok &= check("soc", pack.get_cell_soc(0), cell.get_soc(), 1e-9);
+        ok &= check("terminal voltage", pack.get_cell_Vt(0), cell.get_Vt(), 1e-4);
+    }
+
+    // Steps of 1000 s, 50 time constants: explicit integration blows up, the exact step settles
+    {
+        cout << "=== steps far above the time constants ===\n";
+        battery_pack pack(1, 1);
+        for (int k = 0; k < 10; k++) pack.step(1.0, 1000.0);
+        ok &= check("V1 settles to I R1", pack.get_cell_V1(0), 1.0 * 0.02, 1e-12);
+        ok &= check("V2 settles to I R2", pack.get_cell_V2(0), 1.0 * 0.01, 1e-12);
+        ok &= check("soc", pack.get_cell_soc(0), 0.8 - 1.0 * 10000.0 / 36000, 1e-12);
+    }
+
+    // Series and parallel: groups add up, parallel cells share the current by their resistance
+    {
+        cout << "=== 4S2P, one cell of each pair with twice R_0 ===\n";
+        battery_pack pack(4, 2);
+        for (int g = 0; g < 4; g++) pack.set_cell(2 * g + 1, 36000, 0.002, 0.02, 0.01, 1000, 2000, 0.8);
+        pack.step(30.0, 1e-9);
+        ok &= check("current of the low R_0 cell", pack.get_cell_I(0), 20.0, 1e-6);
+        ok &= check("current of the high R_0 cell", pack.get_cell_I(1), 10.0, 1e-6);
+        ok &= check("pack voltage", pack.get_V(), 4 * (10.7 + 0.4 * 0.8 - 20.0 * 0.001), 1e-6);
+    }
+
+    // Cell to cell variation: the parallel currents still add up and the charge spreads
+    {
+        cout << "=== 96S4P with 5% cell to cell variation, 1 h at 10 A, dt 1 s ===\n";
+        battery_pack pack(96, 4);
+        pack.vary_cells(0.05, 11);
+        for (int k = 0; k < 3600; k++) pack.step(10.0, 1.0);
+
+        double worst = 0.0, V = 0.0;
+        for (int g = 0; g < pack.get_series(); g++) {
+            double sum = 0.0;
+            for (int j = 0; j < pack.get_parallel(); j++) {
+                int c = g * pack.get_parallel() + j;
+                sum += pack.get_cell_I(c);
+                // Every cell of a group is at the group voltage
+                if (j == 0) V += pack.get_cell_Vt(c);
+                worst = max(worst, fabs(pack.get_cell_Vt(c) - pack.get_cell_Vt(g * pack.get_parallel())));
+            }
+            worst = max(worst, fabs(sum - 10.0));
+        }
+        bool kirchhoff = worst < 1e-9;
+        ok &= kirchhoff;
+        cout << "  worst current or voltage mismatch in a group: " << worst << (kirchhoff ? "" : "  FAIL") << "\n";
+        ok &= check("pack voltage is the sum of the groups", pack.get_V(), V, 1e-12);
+        // 10 A for an hour out of four cells of nominally 36000 As each
+        ok &= check("mean soc", pack.get_mean_soc(), 0.8 - 10.0 * 3600 / (4 * 36000.0), 0.01);
+        bool spread = pack.get_max_soc() - pack.get_min_soc() > 0.005;
+        ok &= spread;
+        cout << "  soc of the cells from " << pack.get_min_soc() << " to " << pack.get_max_soc()
+             << (spread ? "" : "  FAIL (no spread)") << "\n";
+    }
+
+    // A cell at a limit carries no current past it, as battery sets I to 0: the other cell takes the pack current
+    {
+        cout << "=== 1S2P, one cell run down to the lower limit ===\n";
+        battery_pack pack(1, 2);
+        pack.set_cell(0, 36000, 0.001, 0.02, 0.01, 1000, 2000, 0.205);
+        pack.set_cell(1, 36000, 0.001, 0.02, 0.01, 1000, 2000, 0.25);
+        for (int k = 0; k < 60; k++) pack.step(20.0, 1.0);
+        ok &= check("soc of the emptied cell", pack.get_cell_soc(0), 0.2, 1e-12);
+        ok &= check("current of the emptied cell", pack.get_cell_I(0), 0.0, 1e-12);
+        ok &= check("current of the other cell", pack.get_cell_I(1), 20.0, 1e-12);
+        ok &= check("pack voltage is the other cell's", pack.get_V(), pack.get_cell_Vt(1), 1e-12);
+
+        // Its RC branches are no longer driven and only relax
+        double V1 = pack.get_cell_V1(0), V2 = pack.get_cell_V2(0);
+        pack.step(20.0, 1.0);
+        ok &= check("V1 of the emptied cell decays", pack.get_cell_V1(0), V1 * exp(-1.0 / 20.0), 1e-12);
+        ok &= check("V2 of the emptied cell decays", pack.get_cell_V2(0), V2 * exp(-1.0 / 20.0), 1e-12);
+
+        // Under charge the emptied cell is not discharged further
+        pack.step(-20.0, 1.0);
+        ok &= check_flag("emptied cell not discharged", pack.get_cell_I(0) <= 0.0);
+        ok &= check("charge of both cells", pack.get_cell_I(0) + pack.get_cell_I(1), -20.0, 1e-12);
+
+        cout << "=== 1S1P at the limits ===\n";
+        battery_pack empty(1, 1);
+        empty.set_cell(0, 36000, 0.001, 0.02, 0.01, 1000, 2000, 0.2);
+        empty.step(10.0, 1.0);
+        ok &= check("current of an empty cell", empty.get_cell_I(0), 0.0, 1e-12);
+        ok &= check("its voltage is open circuit", empty.get_V(), 10.7 + 0.4 * 0.2, 1e-12);
+        battery_pack full(1, 1);
+        full.set_cell(0, 36000, 0.001, 0.02, 0.01, 1000, 2000, 0.9);
+        full.step(-10.0, 1.0);
+        ok &= check("charging current of a full cell", full.get_cell_I(0), 0.0, 1e-12);
+        ok &= check("soc of the full cell", full.get_cell_soc(0), 0.9, 1e-12);
+        full.step(10.0, 1.0);
+        ok &= check("a full cell discharges", full.get_cell_I(0), 10.0, 1e-12);
+    }
+
+    // Cost of a step
+    {
+        cout << "=== microseconds per step ===\n"
+             << "   cells  battery_pack  battery objects, Euler\n";
+        for (int parallel : {1, 4, 10}) {
+            int reps = 20000;
+            battery_pack pack(96, parallel);
+            pack.vary_cells(0.05, 3);
+            auto start = chrono::steady_clock::now();
+            for (int r = 0; r < reps; r++) pack.step(20.0 + (r % 5), 1.0);
+            double t_pack = chrono::duration<double>(chrono::steady_clock::now() - start).count() / reps;
+
+            // The same cells as separate objects, each given its share of the current
+            vector<battery> cells(pack.size());
+            start = chrono::steady_clock::now();
+            for (int r = 0; r < reps; r++) {
+                for (battery& cell : cells) {
+                    double dV1, dV2;
+                    cell.update_I((20.0 + (r % 5)) / parallel);
+                    cell.state_deriv_getVolteges(dV1, dV2);
+                    cell.update_V1(cell.get_V1() + dV1 * 1.0);
+                    cell.update_V2(cell.get_V2() + dV2 * 1.0);
+                    cell.update_soc(1.0);
+                    cell.update_Vt();
+                }
+            }
+            double t_cells = chrono::duration<double>(chrono::steady_clock::now() - start).count() / reps;
+            bool finite = isfinite(pack.get_V());
+            ok &= finite;
+            printf("  %6d  %12.2f  %22.2f%s\n", pack.size(), 1e6 * t_pack, 1e6 * t_cells, finite ? "" : "  FAIL");
+        }
+    }
+
+    return report(ok);
+}
@@ -7,7 +7,7 @@ PURPOSE: (This testing script checks if an
           )
 COMMANDS:
     USE this G++ command until the make file is created
-    : g++ src/Battery.cpp test/battery_test.cpp -o batttest_program
+    : g++ src/Battery.cpp src/battery_chemistry.cpp ../Recources/src/interp_table.cpp test/battery_test.cpp -o batttest_program
 */
 
 #include <iostream>
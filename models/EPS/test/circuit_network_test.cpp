@@ -0,0 +1,184 @@
+/*
+PURPOSE: (Checks the MNA circuit engine against hand solved circuits (the
+          two bus feed of EPS_Module, a battery on a load, a constant power
+          load), checks Kirchhoff's current law on a harness of hundreds of
+          nodes, checks that only load switching refactors, and times a
+          tick for growing harnesses.)
+COMMANDS:
+    : g++ -O2 src/circuit_network.cpp src/Wire.cpp test/circuit_network_test.cpp -o circuit_network_program
+*/
+
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "../include/circuit_network.hh"
+#include "../../Recources/include/test_checks.hh"
+
+using namespace std;
+
+// A harness: a main bus fed by batteries and solar arrays, branch buses on wires, loads on every bus
+struct harness {
+    circuit_network net;
+    vector<int> nodes;
+    vector<int> loads;
+    vector<int> arrays;
+
+    harness(int buses, int loads_per_bus, unsigned seed) {
+        mt19937 gen(seed);
+        uniform_real_distribution<double> u(0.0, 1.0);
+
+        int main_bus = net.add_node();
+        nodes.push_back(main_bus);
+        net.add_battery(main_bus, circuit_network::GROUND, 120.0, 0.05);
+        net.add_battery(main_bus, circuit_network::GROUND, 119.0, 0.08);
+        for (int s = 0; s < 2; s++) arrays.push_back(net.add_current_source(circuit_network::GROUND, main_bus, 200.0));
+
+        // Each bus hangs off an earlier one, so the harness is a tree with a few cross ties
+        for (int b = 1; b < buses; b++) {
+            int bus_node = net.add_node();
+            int parent = nodes[static_cast<int>(u(gen) * nodes.size())];
+            wire segment(1.0 + 4.0 * u(gen), 0.002);
+            net.add_resistor(parent, bus_node, segment.get_R() * 1e-3);
+            if (b % 25 == 0) net.add_resistor(nodes[b / 2], bus_node, 0.05);
+            nodes.push_back(bus_node);
+        }
+        // Loads scaled so the whole harness draws about 20 A whatever its size
+        double scale = buses / 30.0;
+        for (int node : nodes) {
+            for (int l = 0; l < loads_per_bus; l++) {
+                if (l % 3 == 2) loads.push_back(net.add_power_load(node, circuit_network::GROUND, (5.0 + 20.0 * u(gen)) / scale));
+                else loads.push_back(net.add_load(node, circuit_network::GROUND, (500.0 + 2000.0 * u(gen)) * scale, u(gen) < 0.7));
+            }
+        }
+    }
+};
+
+// Largest current imbalance at any node, relative to the largest element current
+double kcl_residual(const circuit_network& net) {
+    vector<double> net_in(net.get_num_nodes() + 1, 0.0);
+    double biggest = 0.0;
+    for (int e = 0; e < net.get_num_elements(); e++) {
+        int a, b;
+        net.get_terminals(e, a, b);
+        double I = net.get_current(e);
+        biggest = max(biggest, fabs(I));
+        // Current passes from a to b, except through voltage sources which drive it out of pos (a)
+        if (net.get_type(e) == CE_VOLTAGE_SOURCE) I = -I;
+        net_in[a] -= I;
+        net_in[b] += I;
+    }
+    double worst = 0.0;
+    for (int n = 1; n <= net.get_num_nodes(); n++) worst = max(worst, fabs(net_in[n]));
+    return worst / biggest;
+}
+
+// Average time of one call of f over reps calls
+template <class F>
+double time_per_call(int reps, F f) {
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++) f(r);
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count() / reps;
+}
+
+int main(){
+    bool ok = true;
+
+    // EPS_Module: 120 V source feeding the node through the two bus resistances in parallel
+    {
+        cout << "=== two bus feed ===\n";
+        double source_voltage = 120, bus_resistance = 0.009, I_total = 180.0;
+        circuit_network net;
+        int src = net.add_node(), node = net.add_node();
+        net.add_voltage_source(src, circuit_network::GROUND, source_voltage);
+        net.add_resistor(src, node, bus_resistance);
+        net.add_resistor(src, node, bus_resistance);
+        int draw = net.add_current_source(node, circuit_network::GROUND, I_total);
+        net.solve();
+        double by_hand = source_voltage - I_total * ((bus_resistance * bus_resistance) / (bus_resistance + bus_resistance));
+        ok &= check("node voltage", net.get_node_V(node), by_hand, 1e-9);
+        net.set_current(draw, 2 * I_total);
+        net.solve();
+        by_hand = source_voltage - 2 * I_total * (bus_resistance / 2);
+        ok &= check("node voltage, doubled draw", net.get_node_V(node), by_hand, 1e-9);
+    }
+
+    // Battery on a resistive load, then on a constant power load
+    {
+        cout << "=== battery and loads ===\n";
+        circuit_network net;
+        int bus_node = net.add_node();
+        int bat = net.add_battery(bus_node, circuit_network::GROUND, 28.0, 0.1);
+        int load = net.add_load(bus_node, circuit_network::GROUND, 2.7);
+        net.solve();
+        ok &= check("bus voltage", net.get_node_V(bus_node), 27.0, 1e-9);
+        ok &= check("battery current", net.get_current(bat), 10.0, 1e-9);
+        ok &= check("load current", net.get_current(load), 10.0, 1e-9);
+
+        net.set_on(load, false);
+        int power = net.add_power_load(bus_node, circuit_network::GROUND, 100.0);
+        net.solve();
+        double V = (28.0 + sqrt(28.0 * 28.0 - 4 * 0.1 * 100.0)) / 2;
+        ok &= check("bus voltage, 100 W load", net.get_node_V(bus_node), V, 1e-9);
+        ok &= check("power drawn", net.get_current(power) * net.get_node_V(bus_node), 100.0, 1e-9);
+        ok &= check("battery current", net.get_current(bat), 100.0 / V, 1e-9);
+    }
+
+    // Harness of 300 buses: Kirchhoff at every node, factor reuse
+    {
+        cout << "=== harness of 300 buses, 6 loads each ===\n";
+        harness h(300, 6, 3);
+        circuit_network& net = h.net;
+        net.solve();
+
+        double residual = kcl_residual(net);
+        bool kcl = residual < 1e-9;
+        ok &= kcl;
+        cout << "  worst current imbalance at a node (relative): " << residual << (kcl ? "" : "  FAIL") << "\n";
+
+        int sym = net.get_symbolic_count(), num = net.get_numeric_count();
+        for (int a : h.arrays) net.set_current(a, 150.0);
+        net.solve();
+        bool rhs_only = net.get_symbolic_count() == sym && net.get_numeric_count() == num;
+        net.set_on(h.loads[0], false);
+        net.set_on(h.loads[3], true);
+        net.solve();
+        bool refactor = net.get_symbolic_count() == sym && net.get_numeric_count() == num + 1;
+        ok &= rhs_only && refactor;
+        cout << "  source change solved without refactoring: " << (rhs_only ? "yes" : "NO") << "\n"
+             << "  load switch refactored numerically only: " << (refactor ? "yes" : "NO") << "\n"
+             << "  unknowns " << net.get_num_nodes() << ", entries of L and U " << net.get_factor_size() << "\n";
+    }
+
+    // Cost of a tick as the harness grows: the solar arrays change every tick, or a load switches every tick
+    {
+        cout << "=== microseconds per tick ===\n"
+             << "   buses  unknowns  L+U entries  solve only  with a load switch  build and first solve\n";
+        for (int buses : {30, 300, 3000}) {
+            harness h(buses, 6, 7);
+            circuit_network& net = h.net;
+            net.solve();
+            int reps = 30000 / buses;
+            double t_solve = time_per_call(reps, [&](int r) {
+                for (int a : h.arrays) net.set_current(a, 150.0 + (r % 7));
+                net.solve();
+            });
+            double t_switch = time_per_call(reps, [&](int r) {
+                net.set_on(h.loads[r % h.loads.size()], r % 2 == 0);
+                net.solve();
+            });
+            double t_full = time_per_call(max(1, reps / 10), [&](int) {
+                harness fresh(buses, 6, 7);
+                fresh.net.solve();
+            });
+            double residual = kcl_residual(net);
+            ok &= residual < 1e-9;
+            printf("  %6d  %8d  %11d  %10.1f  %18.1f  %21.1f\n", buses, net.get_num_nodes(), net.get_factor_size(),
+                   1e6 * t_solve, 1e6 * t_switch, 1e6 * t_full);
+        }
+    }
+
+    return report(ok);
+}
@@ -0,0 +1,258 @@
+/*
+PURPOSE: (Checks the illumination stage: incidence of every cell against the
+          per cell projection with the rotated normal, the shadow test of
+          the Earth and the Moon, predicted eclipse entry and exit of a
+          circular orbit against their closed form and of a straight line
+          against the ray test, that a state inside the Earth or not finite
+          changes nothing, that ticks with constant
+          lighting are skipped without changing the currents, and times an
+          update for many cells.)
+COMMANDS:
+    : g++ -O2 src/panel_illumination.cpp src/solar_cell.cpp ../Recources/src/functions.cpp ../Recources/src/frame_transforms.cpp ../Recources/src/Linear_Algebra.cpp test/panel_illumination_test.cpp -o panel_illumination_program
+*/
+
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "../include/panel_illumination.hh"
+#include "../../Recources/include/test_checks.hh"
+
+using namespace std;
+
+const double EARTH_R = 6378137;
+const double EARTH_MU = 3.986004418e14;
+const double MOON_R = 1737500;
+
+Matrix3d rotation_z(double angle) {
+    Matrix3d R;
+    R.insert(cos(angle), -sin(angle), 0,
+             sin(angle), cos(angle), 0,
+             0, 0, 1);
+    return R;
+}
+
+int main(){
+    bool ok = true;
+
+    // Incidence: I_sc = max * (R^-1 n) . s for every cell, zero when facing away
+    {
+        cout << "=== incidence ===\n";
+        panel_illumination stage;
+        Vector3d normals[4];
+        normals[0].insert(-1, 0, 0);
+        normals[1].insert(1, 0, 0);
+        normals[2].insert(0, 1, 0);
+        normals[3].insert(-1, 1, 0);
+        for (Vector3d& n : normals) stage.add_cell(n, 100.0);
+
+        // Sun along -x from the satellite
+        Vector3d sat;
+        sat.insert(-EARTH_R - 1e6, 0, 0);
+        double worst = 0.0;
+        for (double angle : {0.0, 0.3, M_PI / 2, 2.5}) {
+            Matrix3d R = rotation_z(angle);
+            stage.update(angle, sat, R);
+            Vector3d s;
+            s.insert(-1, 0, 0);
+            for (int c = 0; c < 4; c++) {
+                Vector3d n = normals[c];
+                n.normalize();
+                Vector3d global;
+                global = R.inverse() * n;
+                double want = 100.0 * max(0.0, global.dot(s));
+                worst = max(worst, fabs(stage.get_I_sc(c) - want));
+            }
+        }
+        ok &= check("largest difference to the rotated normal (A)", worst, 0.0, 1e-9);
+        ok &= check("facing the sun, unrotated", (stage.update(10, sat, rotation_z(0)), stage.get_I_sc(0)), 100.0, 1e-12);
+        ok &= check("facing away", stage.get_I_sc(1), 0.0, 1e-12);
+        ok &= check("at 45 degrees", stage.get_I_sc(3), 100.0 / sqrt(2.0), 1e-12);
+
+        // The same cell through solar_cell registration
+        solar_cell cell(50.0);
+        double ori[2] = {-1, 0};
+        cell.lock_axis_y();
+        cell.set_refrence_ori(ori);
+        int c = stage.add_cell(cell);
+        stage.update(11, sat, rotation_z(0));
+        ok &= check("solar_cell registered", stage.get_I_sc(c), 50.0, 1e-12);
+    }
+
+    // Shadow of the Earth and the Moon, sun along -x
+    {
+        cout << "=== shadow test ===\n";
+        panel_illumination stage;
+        Vector3d origin, moon, p;
+        origin.insert(0, 0, 0);
+        moon.insert(3.8444e8, 0, 0);
+        stage.add_occulter(EARTH_R, origin);
+        stage.add_occulter(MOON_R, moon);
+        p.insert(7e6, 0, 0);
+        ok &= check_flag("behind the Earth is lit", stage.in_sunlight(p), false);
+        p.insert(-7e6, 0, 0);
+        ok &= check_flag("between the Earth and the sun is lit", stage.in_sunlight(p), true);
+        p.insert(7e6, 7e6, 0);
+        ok &= check_flag("beside the Earth's shadow is lit", stage.in_sunlight(p), true);
+        p.insert(3.9e8, 1e6, 0);
+        ok &= check_flag("behind the Moon is lit", stage.in_sunlight(p), false);
+    }
+
+    // Circular orbit in the x-y plane starting on the sun side: the shadow is |y| < R on the far side
+    const double r = EARTH_R + 400e3;
+    const double n = sqrt(EARTH_MU / (r * r * r));
+    auto orbit_pos = [&](double t) {
+        Vector3d p;
+        p.insert(r * cos(M_PI + n * t), r * sin(M_PI + n * t), 0);
+        return p;
+    };
+    auto orbit_vel = [&](double t) {
+        Vector3d v;
+        v.insert(-r * n * sin(M_PI + n * t), r * n * cos(M_PI + n * t), 0);
+        return v;
+    };
+    double half_width = asin(EARTH_R / r);
+    double period = 2 * M_PI / n;
+    double entry = (M_PI - half_width) / n, exit = (M_PI + half_width) / n;
+
+    {
+        cout << "=== eclipse prediction, 400 km circular orbit ===\n";
+        panel_illumination stage;
+        Vector3d origin;
+        origin.insert(0, 0, 0);
+        int earth = stage.add_occulter(EARTH_R, origin);
+        stage.predict_eclipses(0.0, orbit_pos(0), orbit_vel(0), EARTH_MU, earth, 2 * period);
+        ok &= check("entry (s)", stage.get_next_entry(0), entry, 1e-4);
+        ok &= check("exit (s)", stage.get_next_exit(0), exit, 1e-4);
+        ok &= check("second entry (s)", stage.get_next_entry(exit), entry + period, 1e-4);
+        ok &= check("second exit (s)", stage.get_next_exit(entry + period), exit + period, 1e-4);
+    }
+
+    // Without gravity (mu = 0) the prediction is a straight line through the shadow
+    {
+        cout << "=== eclipse prediction, straight line ===\n";
+        panel_illumination stage;
+        Vector3d origin, p0, v;
+        origin.insert(0, 0, 0);
+        int earth = stage.add_occulter(EARTH_R, origin);
+        p0.insert(2 * EARTH_R, -2 * EARTH_R, 0);
+        v.insert(0, 7000, 0);
+        auto line = [&](double t) {
+            Vector3d p;
+            p = p0 + v * t;
+            return p;
+        };
+        ok &= check_flag("accepted", stage.predict_eclipses(0.0, p0, v, 0.0, earth, 6000), true);
+        double in = stage.get_next_entry(0), out = stage.get_next_exit(0);
+        ok &= check_flag("lit just before the entry", stage.in_sunlight(line(in - 0.01)), true);
+        ok &= check_flag("lit just after it", stage.in_sunlight(line(in + 0.01)), false);
+        ok &= check_flag("lit just before the exit", stage.in_sunlight(line(out - 0.01)), false);
+        ok &= check_flag("lit just after it", stage.in_sunlight(line(out + 0.01)), true);
+    }
+
+    // A body actor without gravity starts at the origin, inside the Earth: no crossings, no change of lighting
+    {
+        cout << "=== states that are no orbit ===\n";
+        panel_illumination stage;
+        Vector3d origin, normal, zero, nan_vel;
+        origin.insert(0, 0, 0);
+        normal.insert(-1, 0, 0);
+        zero.insert(0, 0, 0);
+        nan_vel.insert(NAN, 0, 0);
+        int earth = stage.add_occulter(EARTH_R, origin);
+        stage.add_cell(normal, 100.0);
+        Matrix3d R = rotation_z(0);
+        stage.update(0.0, orbit_pos(0), R);
+
+        ok &= check_flag("at the center of the Earth, accepted", stage.predict_eclipses(0.0, origin, zero, EARTH_MU, earth, 6000), false);
+        ok &= check_flag("entry predicted", stage.get_next_entry(0) != INFINITY, false);
+        ok &= check_flag("exit predicted", stage.get_next_exit(0) != INFINITY, false);
+        ok &= check_flag("prediction left", stage.get_prediction_end() != -INFINITY, false);
+        ok &= check_flag("recomputed at the center", stage.update(1.0, origin, R), false);
+        ok &= check_flag("eclipsed", stage.is_eclipsed(), false);
+        ok &= check("current kept", stage.get_I_sc(0), 100.0, 1e-12);
+        ok &= check_flag("valid position", stage.is_valid_position(origin), false);
+
+        ok &= check_flag("velocity not finite, accepted", stage.predict_eclipses(0.0, orbit_pos(0), nan_vel, EARTH_MU, earth, 6000), false);
+        ok &= check_flag("in orbit, accepted", stage.predict_eclipses(0.0, orbit_pos(0), orbit_vel(0), EARTH_MU, earth, 6000), true);
+        ok &= check("entry (s)", stage.get_next_entry(0), entry, 1e-4);
+    }
+
+    // Ticks of 1 s over two orbits: the predicted stage matches a ray test every tick and skips
+    {
+        cout << "=== ticks with constant lighting are skipped ===\n";
+        panel_illumination stage, reference;
+        Vector3d origin, normal;
+        origin.insert(0, 0, 0);
+        normal.insert(-1, 0.2, 0);
+        int earth = stage.add_occulter(EARTH_R, origin);
+        reference.add_occulter(EARTH_R, origin);
+        for (int c = 0; c < 8; c++) {
+            stage.add_cell(normal, 10.0 + c);
+            reference.add_cell(normal, 10.0 + c);
+        }
+        stage.predict_eclipses(0.0, orbit_pos(0), orbit_vel(0), EARTH_MU, earth, 2 * period);
+
+        Matrix3d R = rotation_z(0.1);
+        int mismatches = 0, ticks = 0;
+        for (double t = 0; t < 2 * period - 1; t += 1.0, ticks++) {
+            stage.update(t, orbit_pos(t), R);
+            reference.update(t, orbit_pos(t), R);
+            for (int c = 0; c < 8; c++) mismatches += stage.get_I_sc(c) != reference.get_I_sc(c);
+            mismatches += stage.is_eclipsed() != reference.is_eclipsed();
+        }
+        ok &= check("cells or shadow states differing from the ray test", mismatches, 0, 0);
+        // One recomputation to start and one per crossing
+        ok &= check("recomputations", stage.get_recomputed(), 5, 0);
+        cout << "  skipped " << stage.get_skipped() << " of " << ticks << " ticks\n";
+    }
+
+    // Cost of an update with a new attitude every tick
+    {
+        cout << "=== nanoseconds per cell, new attitude every update ===\n"
+             << "    cells  stage  solar_cell objects\n";
+        mt19937 gen(4);
+        normal_distribution<double> g(0.0, 1.0);
+        for (int cells : {100, 10000}) {
+            panel_illumination stage;
+            vector<solar_cell> each(cells, solar_cell(10.0));
+            for (int c = 0; c < cells; c++) {
+                Vector3d nrm;
+                nrm.insert(g(gen), g(gen), g(gen));
+                stage.add_cell(nrm, 10.0);
+                double ori[2] = {nrm[0], nrm[2]};
+                each[c].set_refrence_ori(ori);
+            }
+            Vector3d sat = orbit_pos(0);
+            int reps = 1000000 / cells;
+            double sum = 0.0;
+            auto start = chrono::steady_clock::now();
+            for (int k = 0; k < reps; k++) {
+                stage.update(k, sat, rotation_z(1e-3 * k));
+                sum += stage.get_I_sc(k % cells);
+            }
+            double t_stage = chrono::duration<double>(chrono::steady_clock::now() - start).count() / (reps * cells);
+
+            start = chrono::steady_clock::now();
+            for (int k = 0; k < reps; k++) {
+                Matrix3d R = rotation_z(1e-3 * k);
+                Vector3d s;
+                s.insert(-1, 0, 0);
+                s = R * s;
+                double light[3] = {s[0], s[1], s[2]};
+                for (solar_cell& cell : each) {
+                    cell.update_pos_ori(sat, R);
+                    sum += cell.get_I_sc(light);
+                }
+            }
+            double t_cells = chrono::duration<double>(chrono::steady_clock::now() - start).count() / (reps * cells);
+            bool finite = isfinite(sum);
+            ok &= finite;
+            printf("  %7d  %5.2f  %18.2f%s\n", cells, 1e9 * t_stage, 1e9 * t_cells, finite ? "" : "  FAIL");
+        }
+    }
+
+    return report(ok);
+}
@@ -0,0 +1,148 @@
+/*
+PURPOSE: (Checks the solar array I-V solvers: the Newton solve of update_I
+          and the Lambert W closed form satisfy the diode equation and
+          agree, the curve passes through its rated points, warm starts
+          take few iterations, the lookup table stays close to the curve,
+          and times each way of evaluating many strings.)
+COMMANDS:
+    : g++ -O2 src/Solar_Power_System.cpp src/solar_iv_table.cpp test/solar_iv_test.cpp -o solar_iv_program
+*/
+
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "../include/Solar_Power_System.hh"
+#include "../include/solar_iv_table.hh"
+#include "../../Recources/include/test_checks.hh"
+
+using namespace std;
+
+int main(){
+    bool ok = true;
+
+    // The default array (series and shunt resistance) and the one of the satellite sims (neither)
+    solar_array arrays[2];
+    arrays[1].initialize(130/*OC V*/, 265/*I_CO*/, 140/*Max V*/, 265/*Max I*/, 0.2586 /*terminalV*/);
+    const double V_oc[2] = {40.71, 130}, I_sc[2] = {8.947, 265};
+
+    for (int a = 0; a < 2; a++) {
+        solar_array& sol = arrays[a];
+        cout << "=== array " << a << ": V_oc " << V_oc[a] << " V, I_sc " << I_sc[a] << " A ===\n";
+        ok &= check("open circuit voltage", sol.get_V_oc(), V_oc[a], 1e-9);
+
+        sol.update_V(0);
+        sol.update_I();
+        ok &= check("short circuit current", sol.get_I(), I_sc[a], 1e-3);
+
+        // Sweep the bus voltage as update_I sees it tick by tick
+        double worst_gap = 0.0;
+        int total_iterations = 0, steps = 0;
+        for (double V = 0; V <= 1.02 * V_oc[a]; V += 0.01 * V_oc[a], steps++) {
+            sol.update_V(V);
+            sol.update_I();
+            total_iterations += sol.get_iterations();
+            worst_gap = max(worst_gap, fabs(sol.get_I() - sol.get_I_at(V, I_sc[a])));
+        }
+        ok &= check_below("largest gap between Newton and Lambert W (A)", worst_gap, 1e-9 * I_sc[a]);
+        ok &= check_below("mean Newton iterations, warm started", double(total_iterations) / steps, 4.0);
+
+        // A tick with the array coming out of eclipse: I_sc jumps, Newton starts from the old current
+        sol.update_V(0.95 * V_oc[a]);
+        sol.set_I_sc(0.1 * I_sc[a]);
+        sol.update_I();
+        sol.set_I_sc(I_sc[a]);
+        sol.update_I();
+        ok &= check("after a jump in I_sc", sol.get_I(), sol.get_I_at(0.95 * V_oc[a], I_sc[a]), 1e-9);
+        ok &= check_below("iterations for the jump", sol.get_iterations(), 12);
+    }
+
+    // Residual of the diode equation for the closed form of the default array
+    {
+        cout << "=== diode equation residual, default array ===\n";
+        // Parameters as derived by solar_array from its default curve points
+        double Rs = (40.71 - 37.23) / (16 * 8.06), G = (8.947 - 8.06) / (5 * 37.23);
+        double I_s = 8.947 - 40.71 * G, a = 2 * 0.2586;
+        double worst = 0.0;
+        for (double V = 0; V < 40.0; V += 0.5) {
+            double I = arrays[0].get_I_at(V, 8.947);
+            double rhs = 8.947 - I_s * exp((V + I * Rs - 40.71) / a) - (V + I * Rs) * G;
+            worst = max(worst, fabs(rhs - I));
+        }
+        ok &= check_below("largest residual (A)", worst, 1e-10);
+    }
+
+    // Temperature: a hotter array loses voltage and gains a little current
+    {
+        cout << "=== temperature ===\n";
+        solar_array hot;
+        hot.set_T(348.15);
+        bool lower = hot.get_V_oc() < 40.71 && hot.get_V_oc() > 0.8 * 40.71;
+        ok &= lower;
+        cout << "  V_oc at 75 C: " << hot.get_V_oc() << (lower ? "" : "  FAIL") << "\n";
+        ok &= check("I_sc at 75 C", hot.get_I_at(0, 8.947), 8.947 * (1 + 0.0005 * 50), 1e-3);
+    }
+
+    // Lookup table against the closed form at random points
+    solar_iv_table table;
+    table.build(arrays[1], 1.1 * 130, 1.2 * 265);
+    {
+        cout << "=== lookup table, 2048 x 16 points ===\n";
+        mt19937 gen(5);
+        uniform_real_distribution<double> uV(0.0, 1.1 * 130), uI(0.0, 1.2 * 265);
+        double worst = 0.0;
+        for (int k = 0; k < 100000; k++) {
+            double V = uV(gen), sc = uI(gen);
+            worst = max(worst, fabs(table.get_I(V, sc) - arrays[1].get_I_at(V, sc)));
+        }
+        ok &= check_below("largest error relative to I_sc", worst / 265, 5e-3);
+    }
+
+    // Many strings every tick
+    {
+        cout << "=== nanoseconds per string, 10000 strings ===\n";
+        const int strings = 10000, reps = 100;
+        mt19937 gen(9);
+        uniform_real_distribution<double> uV(100.0, 125.0), uI(200.0, 265.0);
+        vector<double> V(strings), sc(strings), I(strings);
+        for (int k = 0; k < strings; k++) {
+            V[k] = uV(gen);
+            sc[k] = uI(gen);
+        }
+        vector<solar_array> each(strings, arrays[1]);
+        double sum = 0.0;
+
+        auto start = chrono::steady_clock::now();
+        for (int r = 0; r < reps; r++) {
+            for (int k = 0; k < strings; k++) {
+                each[k].set_I_sc(sc[k]);
+                each[k].update_V(V[k] + 0.01 * r);
+                each[k].update_I();
+                sum += each[k].get_I();
+            }
+        }
+        double t_newton = chrono::duration<double>(chrono::steady_clock::now() - start).count() / (reps * strings);
+
+        start = chrono::steady_clock::now();
+        for (int r = 0; r < reps; r++)
+            for (int k = 0; k < strings; k++) sum += arrays[1].get_I_at(V[k] + 0.01 * r, sc[k]);
+        double t_lambert = chrono::duration<double>(chrono::steady_clock::now() - start).count() / (reps * strings);
+
+        start = chrono::steady_clock::now();
+        for (int r = 0; r < reps; r++) {
+            V[r % strings] += 0.01;
+            table.get_I(V.data(), sc.data(), I.data(), strings);
+            sum += I[r % strings];
+        }
+        double t_table = chrono::duration<double>(chrono::steady_clock::now() - start).count() / (reps * strings);
+
+        bool finite = isfinite(sum);
+        ok &= finite;
+        printf("  Newton, warm started  %8.1f\n  Lambert W             %8.1f\n  table, batched        %8.1f%s\n",
+               1e9 * t_newton, 1e9 * t_lambert, 1e9 * t_table, finite ? "" : "  FAIL");
+    }
+
+    return report(ok);
+}
@@ -1,9 +1,28 @@
+/*
+PURPOSE: (Runs the explicit RK4 references of a wire driven by a voltage and
+          by a current, then checks the implicit steppers: a wire and a
+          chain of wires stepped at the 25 ms vehicle frame match an RK4
+          reference stepped at 10 ns, TR-BDF2 converges with second order
+          and backward Euler with first, and times a step of a long chain.)
+COMMANDS:
+    : g++ -O2 src/Wire.cpp src/wire_chain.cpp test/wire_test.cpp -o wire_program
+*/
+
 #include "../include/Wire.hh"
+#include "../include/wire_chain.hh"
+#include "../../Recources/include/test_checks.hh"
 #include <iostream>
 #include <fstream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
 
 using namespace std;
 
+const double FRAME_DT = 0.025;
+const double FINE_DT = 1e-8;
+
 // RK4 integration for voltage-driven test
 void test_voltage_source(wire& w, double V_step, double dt, double total_time) {
     cout << "=== Voltage Source Test (RK4) ===" << endl;
@@ -75,6 +94,52 @@ void test_current_source(wire& w, double I_step, double dt, double total_time) {
     cout << "Current test complete. Output written to current_source_output.csv\n";
 }
 
+// RK4 step of a wire with the terminal voltage held
+void rk4_wire(wire& w, double& I, double& Vc, double Vt, double dt) {
+    double dI1, dVc1, dI2, dVc2, dI3, dVc3, dI4, dVc4;
+    w.update_states(I, Vc);
+    w.get_state_dirv(dI1, dVc1, Vt);
+    w.update_states(I + 0.5 * dt * dI1, Vc + 0.5 * dt * dVc1);
+    w.get_state_dirv(dI2, dVc2, Vt);
+    w.update_states(I + 0.5 * dt * dI2, Vc + 0.5 * dt * dVc2);
+    w.get_state_dirv(dI3, dVc3, Vt);
+    w.update_states(I + dt * dI3, Vc + dt * dVc3);
+    w.get_state_dirv(dI4, dVc4, Vt);
+    I  += dt / 6.0 * (dI1 + 2*dI2 + 2*dI3 + dI4);
+    Vc += dt / 6.0 * (dVc1 + 2*dVc2 + 2*dVc3 + dVc4);
+    w.update_states(I, Vc);
+}
+
+// Ladder of series R L segments with C to ground at each node and a load at the end,
+// written out here independently of wire_chain
+struct ladder {
+    vector<double> R, L, C;
+    double G_load, I_load;
+
+    void derivative(const vector<double>& x, double Vs, vector<double>& f) const {
+        int N = R.size();
+        for (int k = 0; k < N; k++) {
+            double V_before = k > 0 ? x[2 * k - 1] : Vs;
+            double I_after = k < N - 1 ? x[2 * k + 2] : x[2 * k + 1] * G_load + I_load;
+            f[2 * k] = (V_before - R[k] * x[2 * k] - x[2 * k + 1]) / L[k];
+            f[2 * k + 1] = (x[2 * k] - I_after) / C[k];
+        }
+    }
+
+    void rk4(vector<double>& x, double Vs, double dt) const {
+        int n = x.size();
+        vector<double> k1(n), k2(n), k3(n), k4(n), y(n);
+        derivative(x, Vs, k1);
+        for (int i = 0; i < n; i++) y[i] = x[i] + 0.5 * dt * k1[i];
+        derivative(y, Vs, k2);
+        for (int i = 0; i < n; i++) y[i] = x[i] + 0.5 * dt * k2[i];
+        derivative(y, Vs, k3);
+        for (int i = 0; i < n; i++) y[i] = x[i] + dt * k3[i];
+        derivative(y, Vs, k4);
+        for (int i = 0; i < n; i++) x[i] += dt / 6.0 * (k1[i] + 2 * k2[i] + 2 * k3[i] + k4[i]);
+    }
+};
+
 int main() {
     wire test_wire(1.0, 0.001);
 
@@ -87,5 +152,123 @@ int main() {
 
     test_current_source(test_wire2, 0.01, dt, total_time);
 
-    return 0;
+    bool ok = true;
+
+    // Source voltage held over each frame, as the bus gives it
+    const double levels[4] = {5.0, 3.0, 7.0, 0.5};
+
+    // One wire at the vehicle frame against RK4 at 10 ns
+    {
+        cout << "\n=== wire at 25 ms against RK4 at 10 ns ===\n";
+        wire ref_wire(1.0, 0.001), trbdf2(1.0, 0.001), euler(1.0, 0.001);
+        double I = 0.0, Vc = 0.0;
+        double worst_I = 0.0, worst_V = 0.0;
+        for (double Vt : levels) {
+            int fine_steps = static_cast<int>(round(FRAME_DT / FINE_DT));
+            for (int k = 0; k < fine_steps; k++) rk4_wire(ref_wire, I, Vc, Vt, FINE_DT);
+            trbdf2.step(Vt, FRAME_DT);
+            euler.step_backward_euler(Vt, FRAME_DT);
+            for (wire* w : {&trbdf2, &euler}) {
+                worst_I = max(worst_I, fabs(w->get_current() - I));
+                worst_V = max(worst_V, fabs(w->get_Vc() - Vc));
+            }
+        }
+        // What is left of the ringing after a jump is about 1 / (dt |lambda|) of it
+        ok &= check_below("largest current difference (A)", worst_I, 1e-7);
+        ok &= check_below("largest capacitor voltage difference (V)", worst_V, 1e-6);
+        ok &= check("capacitor voltage after the last frame", trbdf2.get_Vc(), 0.5, 1e-6);
+
+        // The explicit integrator at the same step
+        wire explicit_wire(1.0, 0.001);
+        double Ie = 0.0, Vce = 0.0;
+        for (double Vt : levels) rk4_wire(explicit_wire, Ie, Vce, Vt, FRAME_DT);
+        cout << "  RK4 at 25 ms for comparison: capacitor voltage " << Vce << "\n";
+    }
+
+    // Chain of four wires feeding a 1 kOhm load that starts drawing 2 mA more in the third frame
+    {
+        cout << "=== chain of 4 wires at 25 ms against RK4 at 10 ns ===\n";
+        wire segment(1.5, 0.002);
+        ladder ref;
+        ref.G_load = 1.0 / 1000.0;
+        ref.I_load = 0.0;
+        wire_chain trbdf2, euler;
+        for (int k = 0; k < 4; k++) {
+            ref.R.push_back(segment.get_R());
+            ref.L.push_back(segment.get_L());
+            ref.C.push_back(segment.get_C());
+            trbdf2.add_wire(segment);
+            euler.add_wire(segment);
+        }
+        trbdf2.set_load_resistance(1000.0);
+        euler.set_load_resistance(1000.0);
+
+        vector<double> x(8, 0.0);
+        double worst = 0.0;
+        for (int frame = 0; frame < 4; frame++) {
+            double Vs = 5.0 * levels[frame];
+            double I_load = frame >= 2 ? 0.002 : 0.0;
+            ref.I_load = I_load;
+            trbdf2.set_load_current(I_load);
+            euler.set_load_current(I_load);
+            int fine_steps = static_cast<int>(round(FRAME_DT / FINE_DT));
+            for (int k = 0; k < fine_steps; k++) ref.rk4(x, Vs, FINE_DT);
+            trbdf2.step(Vs, FRAME_DT);
+            euler.step_backward_euler(Vs, FRAME_DT);
+            for (wire_chain* c : {&trbdf2, &euler}) {
+                for (int k = 0; k < 4; k++) {
+                    // Relative to the load current and voltage
+                    worst = max(worst, fabs(c->get_current(k) - x[2 * k]) / 0.035);
+                    worst = max(worst, fabs(c->get_node_voltage(k) - x[2 * k + 1]) / 35.0);
+                }
+            }
+        }
+        ok &= check_below("largest relative difference over currents and node voltages", worst, 1e-4);
+        double R_total = 4 * segment.get_R() + 1000.0;
+        double I_dc = (2.5 + 0.002 * 1000.0) / R_total;
+        ok &= check("load current after the last frame (A)", trbdf2.get_load_current(), I_dc, 1e-4 * I_dc);
+        ok &= check("load voltage after the last frame (V)", trbdf2.get_load_voltage(), 2.5 - I_dc * 4 * segment.get_R(), 1e-3);
+    }
+
+    // Order of accuracy on the ringing of a 5 V step, against RK4 at 10 ps
+    {
+        cout << "=== convergence over the first 40 ns of a 5 V step ===\n";
+        const double t_end = 40e-9;
+        wire ref_wire(1.0, 0.001);
+        double I = 0.0, Vc = 0.0;
+        for (int k = 0; k < 4000; k++) rk4_wire(ref_wire, I, Vc, 5.0, t_end / 4000);
+
+        double err_tr[2], err_be[2];
+        for (int level = 0; level < 2; level++) {
+            int steps = 40 << level;
+            wire a(1.0, 0.001), b(1.0, 0.001);
+            for (int k = 0; k < steps; k++) {
+                a.step(5.0, t_end / steps);
+                b.step_backward_euler(5.0, t_end / steps);
+            }
+            err_tr[level] = fabs(a.get_Vc() - Vc);
+            err_be[level] = fabs(b.get_Vc() - Vc);
+        }
+        double rate_tr = log2(err_tr[0] / err_tr[1]), rate_be = log2(err_be[0] / err_be[1]);
+        ok &= check("TR-BDF2 order", rate_tr, 2.0, 0.15);
+        ok &= check("backward Euler order", rate_be, 1.0, 0.15);
+    }
+
+    // A long run stepped at the frame
+    {
+        cout << "=== step of a chain of 1000 wires ===\n";
+        wire segment(0.5, 0.002);
+        wire_chain chain;
+        for (int k = 0; k < 1000; k++) chain.add_wire(segment);
+        chain.set_load_resistance(10.0);
+        const int reps = 2000;
+        auto start = chrono::steady_clock::now();
+        for (int r = 0; r < reps; r++) chain.step(28.0 + 0.01 * (r % 7), FRAME_DT);
+        double t = chrono::duration<double>(chrono::steady_clock::now() - start).count() / reps;
+        bool finite = isfinite(chain.get_load_voltage());
+        ok &= finite;
+        printf("  %.1f us per step, %.1f ns per wire%s\n", 1e6 * t, 1e9 * t / 1000, finite ? "" : "  FAIL");
+    }
+
+    return report(ok);
 }
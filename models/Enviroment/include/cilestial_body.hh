@@ -15,7 +15,7 @@ NOTE:       The celestial body can interact with external forces and
 #ifndef CILESTIAL_BODY_HH
 #define CILESTIAL_BODY_HH
 
-#include "../../Recources/src/Linear_Algebra.cpp"
+#include "../../Recources/include/Linear_Algebra.hh"
 //#include "../../../Lib/eigen-3.4.0/Eigen/Dense"
 
 //using namespace Eigen;
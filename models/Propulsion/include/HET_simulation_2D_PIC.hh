@@ -4,6 +4,9 @@
 #include <vector>
 #include <random>
 #include <fstream>
+#include <functional>
+#include <string>
+#include "../../Recources/include/vector_math.hh"
 
 // ============================
 // Simulation Domain
@@ -18,33 +21,49 @@ public:
     void initializeGrid();
 };
 
+// ============================
+// Scalar Precision
+// ============================
+// The PIC engine is templated on the scalar used to store and advance
+// particles and grid fields. Reductions (the thrust momentum sum, the
+// statistics below, performance counters) and the batched transcendentals
+// are always carried in double. The original class names are the double
+// instantiations; the float ones are declared at the end of this file.
+template <typename Real>
+using Grid = std::vector<std::vector<Real>>;
+
 // ============================
 // Electron Fluid
 // ============================
-class ElectronFluid {
+template <typename Real>
+class BasicElectronFluid {
 public:
-    std::vector<std::vector<double>> Te, ne, ue;
-    std::vector<std::vector<double>> ue_x, ue_z;
-    std::vector<std::vector<double>> Te_temp;
+    Grid<Real> Te, ne, ue;
+    Grid<Real> ue_x, ue_z;
+    Grid<Real> Te_temp;
     double alphaBohm = 1.0 / 16.0;
+    std::vector<double> rowScratch;     // one row in double for the batched sqrt
 
     void initialize(const SimulationDomain& domain);
     void updateElectronTemperature(double dt);
-    void updateElectronVelocity(const std::vector<std::vector<double>>& Ex,
-                                 const std::vector<std::vector<double>>& Ez,
-                                 const std::vector<std::vector<double>>& Bz);
+    void updateElectronVelocity(const Grid<Real>& Ex,
+                                const Grid<Real>& Ez,
+                                const Grid<Real>& Bz);
 };
 
 // ============================
 // Electric Field and Magnetic Field
 // ============================
-class ElectricField {
+template <typename Real>
+class BasicElectricField {
 public:
-    std::vector<std::vector<double>> phi, Ex, Ez;
-    std::vector<std::vector<double>> Bz;
+    Grid<Real> phi, Ex, Ez;
+    Grid<Real> Bz;
+    MathAccuracy mathAccuracy = MATH_HIGH;  // accuracy of the batched log in computePotentialFromBoltzmann
+    std::vector<double> rowScratch;         // one row in double for the batched log
 
-    void computePotentialFromBoltzmann(const std::vector<std::vector<double>>& Te,
-                                       const std::vector<std::vector<double>>& ne);
+    void computePotentialFromBoltzmann(const Grid<Real>& Te,
+                                       const Grid<Real>& ne);
     void computeElectricField(double dx, double dz);
     void initializeMagneticField(const SimulationDomain& domain);
 };
@@ -52,16 +71,18 @@ public:
 // ============================
 // Ion Particle-In-Cell
 // ============================
-struct Ion {
-    double x, z, vx, vz, weight;
+template <typename Real>
+struct BasicIon {
+    Real x, z, vx, vz, weight;
 };
 
-class IonPIC {
+template <typename Real>
+class BasicIonPIC {
 public:
-    std::vector<Ion> ions;
+    std::vector<BasicIon<Real>> ions;
 
     void initialize(const SimulationDomain& domain);
-    void pushParticles(const std::vector<std::vector<double>>& Ez,
+    void pushParticles(const Grid<Real>& Ez,
                        const SimulationDomain& domain, double dt);
     void applyDomainBounds(const SimulationDomain& domain);
 };
@@ -69,18 +90,20 @@ public:
 // ============================
 // Neutral Particle-In-Cell
 // ============================
-struct Neutral {
-    double x, z, vx, vz;
+template <typename Real>
+struct BasicNeutral {
+    Real x, z, vx, vz;
 };
 
-class NeutralPIC {
+template <typename Real>
+class BasicNeutralPIC {
 public:
-    std::vector<Neutral> neutrals;
+    std::vector<BasicNeutral<Real>> neutrals;
     std::default_random_engine rng;
 
     static const int MAX_NEUTRALS = 100000;
 
-    NeutralPIC();
+    BasicNeutralPIC();
     void injectNeutrals(double rate, double Tgas, const SimulationDomain& domain);
     void moveNeutrals(double dt);
 };
@@ -88,62 +111,202 @@ public:
 // ============================
 // Ionization Module
 // ============================
-class Ionization {
+template <typename Real>
+class BasicIonization {
 public:
     double Ei = 12.1;
     std::default_random_engine rng;
     std::uniform_real_distribution<double> rand;
+    MathAccuracy mathAccuracy = MATH_HIGH;  // accuracy of the batched exponentials
+    std::vector<double> sigmaScratch, probScratch;  // per-neutral work arrays reused across steps
 
-    Ionization();
+    BasicIonization();
     double crossSection(double Te);
-    void performIonization(const std::vector<std::vector<double>>& Te,
-                           const std::vector<std::vector<double>>& ne,
-                           NeutralPIC& neutrals, IonPIC& ions,
+    void crossSections(const double* Te, double* sigma, size_t n);
+    void performIonization(const Grid<Real>& Te,
+                           const Grid<Real>& ne,
+                           BasicNeutralPIC<Real>& neutrals, BasicIonPIC<Real>& ions,
                            const SimulationDomain& domain, double dt);
 };
 
 // ============================
 // Boundary Conditions
 // ============================
-class BoundaryConditions {
+template <typename Real>
+class BasicBoundaryConditions {
+public:
+    double TeWall = 5.0;    // Dirichlet electron temperature at the x boundaries (eV)
+    std::default_random_engine rng;
+
+    BasicBoundaryConditions();
+    void applyToTe(Grid<Real>& Te);
+    void applyToPhi(Grid<Real>& phi, double);
+    void injectNeutralsAtInlet(BasicNeutralPIC<Real>& neutrals, const SimulationDomain& domain);
+};
+
+// ============================
+// Fused Field Kernel
+// ============================
+// Replaces the separate per-step grid passes (updateElectronTemperature,
+// applyToPhi, computeElectricField, applyToTe) with one cache-blocked sweep
+// that produces identical Te, phi, Ex and Ez.
+template <typename Real>
+class BasicFusedFieldKernel {
 public:
-    void applyToTe(std::vector<std::vector<double>>& Te);
-    void applyToPhi(std::vector<std::vector<double>>& phi, double);
-    void injectNeutralsAtInlet(NeutralPIC& neutrals, const SimulationDomain& domain);
+    int tileRows = 16;      // rows (x) per block
+    int tileCols = 512;     // columns (z) per block, rows are contiguous in z
+
+    void update(BasicElectronFluid<Real>& electrons, BasicElectricField<Real>& field,
+                BasicBoundaryConditions<Real>& boundaries,
+                double volt, double dt, double dx, double dz);
+};
+
+// ============================
+// Streaming Statistics
+// ============================
+// Bounded-memory summary of a scalar series: running mean/variance (Welford),
+// EWMA, min/max and a fixed-size ring of the most recent samples. Every Nth
+// sample can optionally be streamed to disk.
+class StreamingStats {
+public:
+    StreamingStats(std::size_t ringSize = 256, double ewmaAlpha = 0.05);
+
+    void add(double sample);
+    void reset();
+
+    long long count() const;
+    double last() const;
+    double mean() const;
+    double variance() const;        // unbiased sample variance
+    double stddev() const;
+    double ewma() const;
+    double min() const;
+    double max() const;
+
+    // Most recent samples, index 0 is the oldest one still held
+    std::size_t recentCount() const;
+    double recent(std::size_t index) const;
+
+    void setEwmaAlpha(double alpha);
+
+    // Writes "sample_index<TAB>value" for every Nth sample
+    void openStream(const std::string& path, int every);
+    void closeStream();
+
+private:
+    std::vector<double> ring;
+    std::size_t head = 0;           // next write position
+    std::size_t filled = 0;
+
+    long long n = 0;
+    double lastValue = 0.0;
+    double meanValue = 0.0;
+    double m2 = 0.0;                // sum of squared deviations from the mean
+    double ewmaValue = 0.0;
+    double ewmaAlpha;
+    double minValue = 0.0;
+    double maxValue = 0.0;
+
+    std::ofstream stream;
+    int streamEvery = 0;
 };
 
 // ============================
 // Thrust Calculator
 // ============================
-class ThrustCalculator {
+template <typename Real>
+class BasicThrustCalculator {
 public:
-    std::vector<double> thrustHistory;
+    StreamingStats thrustStats;
 
-    void computeThrust(const IonPIC& ions, double& thrustOut, int& countOut);
+    void computeThrust(const BasicIonPIC<Real>& ions, double& thrustOut, int& countOut);
 };
 
 // ============================
 // Hall Thruster Simulator
 // ============================
-class HallThrusterSimulator {
+
+// Wall clock statistics gathered over one call to runSimulation()
+struct SimulationPerformance {
+    int steps = 0;
+    double wallSeconds = 0.0;
+    long long particlesPushed = 0;   // ions + neutrals advanced, summed over all steps
+    double stepsPerSecond = 0.0;
+    double particlesPerSecond = 0.0;
+};
+
+// Called every progressInterval steps with (completed steps, total steps, simulated time)
+using ProgressCallback = std::function<void(int, int, double)>;
+
+template <typename Real>
+class BasicHallThrusterSimulator {
 private:
     SimulationDomain domain;
-    ElectronFluid electrons;
-    ElectricField field;
-    IonPIC ions;
-    NeutralPIC neutrals;
-    Ionization ionizer;
-    BoundaryConditions boundaries;
-    ThrustCalculator thrustCalc;
+    BasicElectronFluid<Real> electrons;
+    BasicElectricField<Real> field;
+    BasicIonPIC<Real> ions;
+    BasicNeutralPIC<Real> neutrals;
+    BasicIonization<Real> ionizer;
+    BasicBoundaryConditions<Real> boundaries;
+    BasicFusedFieldKernel<Real> fieldKernel;
+    BasicThrustCalculator<Real> thrustCalc;
     double currentTime = 0.0;
     double dt = 1e-8;
     int maxSteps = 100000;
 
+    //run control
+    bool batchMode = false;          // true -> no 40 Hz pacing
+    int outputInterval = 1;          // print/write every N steps, 0 disables output
+    int progressInterval = 0;        // call progressCallback every N steps, 0 disables
+    ProgressCallback progressCallback;
+    SimulationPerformance performance;
+
 public:
-    HallThrusterSimulator();
+    BasicHallThrusterSimulator();
     void initialize();
     void runSimulation();
     void outputResults();
+
+    //Description: batch mode runs as fast as possible instead of pacing each step at 40 Hz
+    void setBatchMode(bool enabled);
+    void setMaxSteps(int steps);
+    void setOutputInterval(int steps);
+    void setProgressCallback(ProgressCallback callback, int interval);
+
+    //Description: writes every Nth thrust sample to file (history is otherwise not kept)
+    void streamThrust(const std::string& path, int every);
+    const StreamingStats& getThrustStats() const;
+
+    const SimulationPerformance& getPerformance() const;
+    void printPerformanceSummary() const;
+
+    //Description: reseeds every random stream so two runs can be compared draw for draw
+    void setSeed(unsigned seed);
+
+    const BasicElectronFluid<Real>& getElectrons() const;
+    const BasicIonPIC<Real>& getIons() const;
+    std::size_t getNeutralCount() const;
 };
 
+// ============================
+// Precision Instantiations
+// ============================
+// Double precision, the original engine
+typedef BasicElectronFluid<double>         ElectronFluid;
+typedef BasicElectricField<double>         ElectricField;
+typedef BasicIon<double>                   Ion;
+typedef BasicIonPIC<double>                IonPIC;
+typedef BasicNeutral<double>               Neutral;
+typedef BasicNeutralPIC<double>            NeutralPIC;
+typedef BasicIonization<double>            Ionization;
+typedef BasicBoundaryConditions<double>    BoundaryConditions;
+typedef BasicFusedFieldKernel<double>      FusedFieldKernel;
+typedef BasicThrustCalculator<double>      ThrustCalculator;
+typedef BasicHallThrusterSimulator<double> HallThrusterSimulator;
+
+// Single precision particles and fields for throughput runs (half the particle memory)
+typedef BasicIonPIC<float>                 IonPICF;
+typedef BasicNeutralPIC<float>             NeutralPICF;
+typedef BasicHallThrusterSimulator<float>  HallThrusterSimulatorF;
+
 #endif // FERNANDEZ_HET_SIM_HH
@@ -28,7 +28,7 @@ TERMS USED:
 
 #include "hall_thruster.hh"
 #include "xenon_tank.hh"
-#include "../../Recources/src/Linear_Algebra.cpp"
+#include "../../Recources/include/Linear_Algebra.hh"
 //#include "../../../Lib/eigen-3.4.0/Eigen/Dense" //include Eigen Library directory here
 
 //using namespace Eigen;
@@ -81,10 +81,15 @@ class Propulsion_System {
         void update_tankmass(double /*inputed tank mass*/);
 
     private:
+        //Description: registers or refreshes the thruster mounts after a refrence position or orientation changed
+        void sync_mounts();
+
         double total_massflow;
         double available_mass;
         xenon_tank tanks[3];
         hall_thruster thrusters[7];
+        frame_transforms mounts;    // thruster mounts, moved to the global frame in one pass
+        int thruster_mount[7];      // handle of each thruster in mounts
 
 };
 
@@ -28,7 +28,7 @@ TERMS USED:
 
 #include "hall_thruster_PIC2D.hh"
 #include "xenon_tank.hh"
-#include "../../Recources/src/Linear_Algebra.cpp"
+#include "../../Recources/include/Linear_Algebra.hh"
 //#include "../../../Lib/eigen-3.4.0/Eigen/Dense" //include Eigen Library directory here
 
 //using namespace Eigen;
@@ -59,6 +59,12 @@ class Propulsion_System_PIC2D {
         void initialize_HET_sim(int /*thruster number*/);
         void initialize_all_HET_sim();
 
+        //Description: seeds the HET sim of every thruster from one seed; see HET_PIC2D::set_seed
+        void set_seed(unsigned /*seed*/);
+
+        //Description: reports thruster orientations and the HET sim initialization on cout when on (the default)
+        void set_verbose(bool);
+
         void run_step_HET_sim(int /*thruster index*/, double /*mass flow*/, double /*Discharge Voltage*/);
 
         //Description: gets force created by one thruster
@@ -81,11 +87,17 @@ class Propulsion_System_PIC2D {
         void update_tankmass();
 
     private:
+        //Description: registers or refreshes the thruster mounts after a refrence position or orientation changed
+        void sync_mounts();
+
         double total_massflow;
         double available_mass;
         xenon_tank tanks[3];
         HET_PIC2D thrusters[7];
+        frame_transforms mounts;    // thruster mounts, moved to the global frame in one pass
+        int thruster_mount[7];      // handle of each thruster in mounts
         double tank_mass_flow[7];
+        bool verbose;               // report orientations and HET sim initialization
 
 };
 
@@ -10,7 +10,8 @@ NOTE:       This file gives a summary of each group of functions. See hall_thrus
 #ifndef HALL_THRUSTER_HH
 #define HALL_THRUSTER_HH
 
-#include "../../Recources/src/Linear_Algebra.cpp"
+#include "../../Recources/include/Linear_Algebra.hh"
+#include "../../Recources/include/frame_transforms.hh"
 //#include "../../../Lib/eigen-3.4.0/Eigen/Dense" //include Eigen Library directory here
 
 //using namespace Eigen;
@@ -59,6 +60,11 @@ class hall_thruster {
         void update_pos_ori(Vector3d /*satellite center*/, const Matrix3d& /*rotation matrix*/);
         void update_pos_ori(double[3] /*satellite center*/);
         void update_pos_ori(Vector3d /*satellite center*/);
+        void update_pos_ori(const frame_transforms& /*transforms of all mounts*/, int /*mount handle*/);
+
+        //Description: returns the position and orientation in refrence to satellite (used to register the mount)
+        Vector3d get_refrence_pos();
+        Vector3d get_refrence_ori();
 
         //Description: returns the global position of the thruster
         void get_pos(double[3] /*position*/);
@@ -1,7 +1,8 @@
 #ifndef HET_THRUSTER
 #define HET_THRUSTER
 
-#include "../../Recources/src/Linear_Algebra.cpp"
+#include "../../Recources/include/Linear_Algebra.hh"
+#include "../../Recources/include/frame_transforms.hh"
 #include "HET_simulation_2D_PIC.hh"
 
 class HET_PIC2D {
@@ -42,6 +43,11 @@ class HET_PIC2D {
         void update_pos_ori(Vector3d /*satellite center*/, const Matrix3d& /*rotation matrix*/);
         void update_pos_ori(double[3] /*satellite center*/);
         void update_pos_ori(Vector3d /*satellite center*/);
+        void update_pos_ori(const frame_transforms& /*transforms of all mounts*/, int /*mount handle*/);
+
+        //Description: returns the position and orientation in refrence to satellite (used to register the mount)
+        Vector3d get_refrence_pos();
+        Vector3d get_refrence_ori();
 
         //Description: returns the global position of the thruster
         void get_pos(double[3] /*position*/);
@@ -56,6 +62,12 @@ class HET_PIC2D {
         // ======================
         void initialize_HET_sim();
         void run_step_HET_sim(double /*mass flow*/, double /*Discharge Voltage*/);
+
+        //Description: reseeds the random streams of the HET sim so a run can be repeated; call before initialize_HET_sim
+        void set_seed(unsigned /*seed*/);
+
+        //Description: initialize_HET_sim reports its stages on cout when on (the default); off for headless runs
+        void set_verbose(bool);
         void get_force(double available_mass, double F[3], double F_pos[3]);
         void get_force(double available_mass, Vector3d& F, Vector3d& F_pos);
 
@@ -85,6 +97,8 @@ class HET_PIC2D {
         //on and off behavior
         bool state_on;
 
+        bool verbose;   // report the stages of initialize_HET_sim
+
         //HET Sim Variables
         SimulationDomain domain;
         ElectronFluid electrons;
@@ -93,6 +107,7 @@ class HET_PIC2D {
         NeutralPIC neutrals;
         Ionization ionizer;
         BoundaryConditions boundaries;
+        FusedFieldKernel fieldKernel;
         ThrustCalculator thrustCalc;
         double dt = 1e-8;
         double thrust = 0.0;
@@ -11,6 +11,7 @@
 #include <thread>
 #include <cstdlib>  // for rand()
 #include <algorithm>
+#include <limits>
 
 // ----------------------------
 // SimulationDomain 
@@ -47,9 +48,10 @@ void SimulationDomain::initializeGrid() {
 // ----------------------------
 
 // Initialize electron temperature, density, and velocity across the grid
-void ElectronFluid::initialize(const SimulationDomain& domain) {
-    Te.resize(domain.Nx, std::vector<double>(domain.Nz, 5.0));
-    ne.resize(domain.Nx, std::vector<double>(domain.Nz, 1e17));
+template <typename Real>
+void BasicElectronFluid<Real>::initialize(const SimulationDomain& domain) {
+    Te.resize(domain.Nx, std::vector<Real>(domain.Nz, 5.0));
+    ne.resize(domain.Nx, std::vector<Real>(domain.Nz, 1e17));
 
     for (int i = 0; i < domain.Nx; ++i) {
         for (int j = 0; j < domain.Nz; ++j) {
@@ -65,21 +67,25 @@ void ElectronFluid::initialize(const SimulationDomain& domain) {
 
 
 // Update Te using a simplified RK4-like diffusion approximation
-void ElectronFluid::updateElectronTemperature(double dt) {
+template <typename Real>
+void BasicElectronFluid<Real>::updateElectronTemperature(double dt) {
     int Nx = Te.size();
     int Nz = Te[0].size();
     if (Te_temp.size() != Nx) {
-        Te_temp.resize(Nx, std::vector<double>(Nz, 0.0));
+        Te_temp.resize(Nx, std::vector<Real>(Nz, 0.0));
     }
 
+    // Stencil arithmetic runs in the storage precision
+    const Real rdt = static_cast<Real>(dt);
+
     for (int i = 1; i < Nx - 1; ++i) {
         for (int j = 1; j < Nz - 1; ++j) {
-            double laplacian =
+            Real laplacian =
                 Te[i + 1][j] + Te[i - 1][j] +
                 Te[i][j + 1] + Te[i][j - 1] -
-                4.0 * Te[i][j];
+                Real(4.0) * Te[i][j];
 
-            Te_temp[i][j] = Te[i][j] + dt * (0.01 * laplacian - 0.05 * Te[i][j]);
+            Te_temp[i][j] = Te[i][j] + rdt * (Real(0.01) * laplacian - Real(0.05) * Te[i][j]);
         }
     }
 
@@ -88,23 +94,24 @@ void ElectronFluid::updateElectronTemperature(double dt) {
 
 // Calculate electron drift velocity using Ex, Ez, and Bz components
 // Here ue_x and ue_z are computed, so ue needs to store 2D vector velocities
-void ElectronFluid::updateElectronVelocity(const std::vector<std::vector<double>>& Ex,
-                                           const std::vector<std::vector<double>>& Ez,
-                                           const std::vector<std::vector<double>>& Bz) {
+template <typename Real>
+void BasicElectronFluid<Real>::updateElectronVelocity(const Grid<Real>& Ex,
+                                                      const Grid<Real>& Ez,
+                                                      const Grid<Real>& Bz) {
     int Nx = Ex.size();
     int Nz = Ex[0].size();
 
     // We'll create temporary ue_x and ue_z
-    std::vector<std::vector<double>> ue_x(Nx, std::vector<double>(Nz, 0.0));
-    std::vector<std::vector<double>> ue_z(Nx, std::vector<double>(Nz, 0.0));
+    Grid<Real> ue_x(Nx, std::vector<Real>(Nz, 0.0));
+    Grid<Real> ue_z(Nx, std::vector<Real>(Nz, 0.0));
 
     for (int i = 0; i < Nx; ++i) {
         for (int j = 0; j < Nz; ++j) {
-            double Bz_local = Bz[i][j];
-            if (fabs(Bz_local) < 1e-9) Bz_local = 1e-9;  // avoid divide by zero
+            Real Bz_local = Bz[i][j];
+            if (std::fabs(Bz_local) < Real(1e-9)) Bz_local = Real(1e-9);  // avoid divide by zero
 
             // Effective mobility from Bohm diffusion coefficient
-            double mu_eff = alphaBohm / Bz_local;
+            Real mu_eff = static_cast<Real>(alphaBohm) / Bz_local;
 
             // Electron velocity components from E and B:
             // For simplicity, assume drift only along E-field direction divided by Bz
@@ -121,11 +128,16 @@ void ElectronFluid::updateElectronVelocity(const std::vector<std::vector<double>
 
     // Store magnitude or split ue into components - depends on your data structure
     // If ue is just one vector, store magnitude for now:
-    ue.resize(Nx, std::vector<double>(Nz, 0.0));
+    ue.resize(Nx, std::vector<Real>(Nz, 0.0));
+    rowScratch.resize(Nz);
     for (int i = 0; i < Nx; ++i) {
         for (int j = 0; j < Nz; ++j) {
-            ue[i][j] = std::sqrt(ue_x[i][j]*ue_x[i][j] + ue_z[i][j]*ue_z[i][j]);
+            double ux = ue_x[i][j];
+            double uz = ue_z[i][j];
+            rowScratch[j] = ux*ux + uz*uz;
         }
+        vsqrt(rowScratch.data(), rowScratch.data(), Nz);
+        std::copy(rowScratch.begin(), rowScratch.end(), ue[i].begin());
     }
 }
 
@@ -136,16 +148,24 @@ void ElectronFluid::updateElectronVelocity(const std::vector<std::vector<double>
 const double kTe_over_e = 1.0;  // Use 1.0 for normalized units or replace with (k_B / e)
 
 // Compute electric potential using Boltzmann relation: φ = (kTe/e) * ln(ne)
-void ElectricField::computePotentialFromBoltzmann(const std::vector<std::vector<double>>& Te,
-                                                  const std::vector<std::vector<double>>& ne) {
+template <typename Real>
+void BasicElectricField<Real>::computePotentialFromBoltzmann(const Grid<Real>& Te,
+                                                             const Grid<Real>& ne) {
     int Nx = Te.size();
     int Nz = Te[0].size();
-    phi.resize(Nx, std::vector<double>(Nz, 0.0));
+    phi.resize(Nx, std::vector<Real>(Nz, 0.0));
+    rowScratch.resize(Nz);
 
+    // ln(ne) is evaluated a row at a time in double, then scaled by the local Te
     for (int i = 0; i < Nx; ++i) {
         for (int j = 0; j < Nz; ++j) {
-            // Use local Te for more accuracy; add small value to ne to avoid log(0)
-            phi[i][j] = (Te[i][j]) * std::log(ne[i][j] + 1e-10);
+            // Add small value to ne to avoid log(0)
+            rowScratch[j] = ne[i][j] + 1e-10;
+        }
+        vlog(rowScratch.data(), rowScratch.data(), Nz, mathAccuracy);
+        for (int j = 0; j < Nz; ++j) {
+            // Use local Te for more accuracy
+            phi[i][j] = (Te[i][j]) * rowScratch[j];
         }
     }
 
@@ -154,34 +174,40 @@ void ElectricField::computePotentialFromBoltzmann(const std::vector<std::vector<
 
 }
 
-void ElectricField::computeElectricField(double dx, double dz) {
+template <typename Real>
+void BasicElectricField<Real>::computeElectricField(double dx, double dz) {
     int Nx = phi.size();
     int Nz = phi[0].size();
 
-    Ex.resize(Nx, std::vector<double>(Nz, 0.0));
-    Ez.resize(Nx, std::vector<double>(Nz, 0.0));
+    Ex.resize(Nx, std::vector<Real>(Nz, 0.0));
+    Ez.resize(Nx, std::vector<Real>(Nz, 0.0));
 
     //Debug
     //std::cout << "dx = " << dx << ", dz = " << dz << std::endl;
 
+    const Real rdx = static_cast<Real>(dx);
+    const Real rdz = static_cast<Real>(dz);
+    const Real twoDx = static_cast<Real>(2.0 * dx);
+    const Real twoDz = static_cast<Real>(2.0 * dz);
+
     // Central differences for interior points
     for (int i = 1; i < Nx - 1; ++i) {
         for (int j = 1; j < Nz - 1; ++j) {
-            Ex[i][j] = -(phi[i + 1][j] - phi[i - 1][j]) / (2.0 * dx);
-            Ez[i][j] = -(phi[i][j + 1] - phi[i][j - 1]) / (2.0 * dz);
+            Ex[i][j] = -(phi[i + 1][j] - phi[i - 1][j]) / twoDx;
+            Ez[i][j] = -(phi[i][j + 1] - phi[i][j - 1]) / twoDz;
         }
     }
 
     // Forward/backward difference for Ez at z-boundaries
     for (int i = 0; i < Nx; ++i) {
-        Ez[i][0] = -(phi[i][1] - phi[i][0]) / dz;               // forward diff at bottom boundary
-        Ez[i][Nz - 1] = -(phi[i][Nz - 1] - phi[i][Nz - 2]) / dz; // backward diff at top boundary
+        Ez[i][0] = -(phi[i][1] - phi[i][0]) / rdz;               // forward diff at bottom boundary
+        Ez[i][Nz - 1] = -(phi[i][Nz - 1] - phi[i][Nz - 2]) / rdz; // backward diff at top boundary
     }
 
     // Forward/backward difference for Ex at x-boundaries
     for (int j = 0; j < Nz; ++j) {
-        Ex[0][j] = -(phi[1][j] - phi[0][j]) / dx;               // forward diff at left boundary
-        Ex[Nx - 1][j] = -(phi[Nx - 1][j] - phi[Nx - 2][j]) / dx; // backward diff at right boundary
+        Ex[0][j] = -(phi[1][j] - phi[0][j]) / rdx;               // forward diff at left boundary
+        Ex[Nx - 1][j] = -(phi[Nx - 1][j] - phi[Nx - 2][j]) / rdx; // backward diff at right boundary
     }
 
     // Debug prints near center grid point
@@ -197,8 +223,9 @@ void ElectricField::computeElectricField(double dx, double dz) {
 }
 
 
-void ElectricField::initializeMagneticField(const SimulationDomain& domain) {
-    Bz.resize(domain.Nx, std::vector<double>(domain.Nz, 0.0));
+template <typename Real>
+void BasicElectricField<Real>::initializeMagneticField(const SimulationDomain& domain) {
+    Bz.resize(domain.Nx, std::vector<Real>(domain.Nz, 0.0));
     for (int i = 0; i < domain.Nx; ++i) {
         for (int j = 0; j < domain.Nz; ++j) {
             double x = domain.xGrid[i][j];
@@ -213,12 +240,13 @@ void ElectricField::initializeMagneticField(const SimulationDomain& domain) {
 // ----------------------------
 
 // Initialize a uniform population of ions near the inlet (z = 0)
-void IonPIC::initialize(const SimulationDomain& domain) {
+template <typename Real>
+void BasicIonPIC<Real>::initialize(const SimulationDomain& domain) {
     ions.clear();
 
     int num_ions = 1000;  // Adjust for simulation resolution
     for (int i = 0; i < num_ions; ++i) {
-        Ion ion;
+        BasicIon<Real> ion;
 
         ion.x = domain.x_min + (domain.x_max - domain.x_min) * (std::rand() / (double)RAND_MAX);
         ion.z = domain.z_min;  // Inject from bottom of the domain
@@ -231,30 +259,39 @@ void IonPIC::initialize(const SimulationDomain& domain) {
 }
 
 // Push ions using Ez field: F = qE -> a = qE/m -> update vz and z
-void IonPIC::pushParticles(const std::vector<std::vector<double>>& Ez,
-                           const SimulationDomain& domain, double dt) {
+template <typename Real>
+void BasicIonPIC<Real>::pushParticles(const Grid<Real>& Ez,
+                                      const SimulationDomain& domain, double dt) {
     int Nx = Ez.size();
     int Nz = Ez[0].size();
 
+    // Particle arithmetic runs in the storage precision
+    const Real rdt = static_cast<Real>(dt);
+    const Real qm = static_cast<Real>(7.3e5); // q/m for Xe+
+    const Real xMin = static_cast<Real>(domain.x_min);
+    const Real zMin = static_cast<Real>(domain.z_min);
+    const Real dx = static_cast<Real>(domain.dx);
+    const Real dz = static_cast<Real>(domain.dz);
+
     for (auto& ion : ions) {
-        int i = static_cast<int>((ion.x - domain.x_min) / domain.dx);
-        int j = static_cast<int>((ion.z - domain.z_min) / domain.dz);
+        int i = static_cast<int>((ion.x - xMin) / dx);
+        int j = static_cast<int>((ion.z - zMin) / dz);
 
         if (i >= 0 && i < Nx && j >= 0 && j < Nz) {
-            double Ez_local = Ez[i][j];
-            const double qm = 7.3e5; // q/m for Xe+
-            ion.vz += qm * Ez_local * dt;
+            Real Ez_local = Ez[i][j];
+            ion.vz += qm * Ez_local * rdt;
         }
 
-        ion.z += ion.vz * dt;
+        ion.z += ion.vz * rdt;
     }
 
     // No bounce back – let ions exit at z > z_max
 }
 
 
-void IonPIC::applyDomainBounds(const SimulationDomain& domain) {
-    ions.erase(std::remove_if(ions.begin(), ions.end(), [&](const Ion& ion) {
+template <typename Real>
+void BasicIonPIC<Real>::applyDomainBounds(const SimulationDomain& domain) {
+    ions.erase(std::remove_if(ions.begin(), ions.end(), [&](const BasicIon<Real>& ion) {
         return (ion.z > domain.z_max ||  // allow exit
                 ion.z < domain.z_min || ion.x < domain.x_min || ion.x > domain.x_max);
     }), ions.end());
@@ -266,15 +303,17 @@ void IonPIC::applyDomainBounds(const SimulationDomain& domain) {
 // ----------------------------
 
 // Inject neutrals from the bottom boundary (z = z_min) with thermal spread
-NeutralPIC::NeutralPIC() : rng(std::random_device{}()) {}
+template <typename Real>
+BasicNeutralPIC<Real>::BasicNeutralPIC() : rng(std::random_device{}()) {}
 
-void NeutralPIC::injectNeutrals(double rate, double Tgas, const SimulationDomain& domain) {
+template <typename Real>
+void BasicNeutralPIC<Real>::injectNeutrals(double rate, double Tgas, const SimulationDomain& domain) {
     int N_inject = static_cast<int>(rate);
     std::uniform_real_distribution<double> pos_dist(0.0, 1.0);
     std::normal_distribution<double> vel_dist(0.0, std::sqrt(Tgas));
 
     for (int i = 0; i < N_inject && neutrals.size() < MAX_NEUTRALS; ++i) {
-        Neutral n;
+        BasicNeutral<Real> n;
         n.x = domain.x_min + pos_dist(rng) * (domain.x_max - domain.x_min);
         n.z = domain.z_min;
         n.vx = vel_dist(rng);
@@ -283,14 +322,16 @@ void NeutralPIC::injectNeutrals(double rate, double Tgas, const SimulationDomain
     }
 }
 
-void NeutralPIC::moveNeutrals(double dt) {
+template <typename Real>
+void BasicNeutralPIC<Real>::moveNeutrals(double dt) {
+    const Real rdt = static_cast<Real>(dt);
     for (auto& n : neutrals) {
-        n.x += n.vx * dt;
-        n.z += n.vz * dt;
+        n.x += n.vx * rdt;
+        n.z += n.vz * rdt;
     }
 
     // Remove neutrals that leave the domain
-    neutrals.erase(std::remove_if(neutrals.begin(), neutrals.end(), [&](const Neutral& n) {
+    neutrals.erase(std::remove_if(neutrals.begin(), neutrals.end(), [&](const BasicNeutral<Real>& n) {
         return (n.z > 0.05 || n.z < 0.0 || n.x > 0.1 || n.x < 0.0);
     }), neutrals.end());
 
@@ -307,37 +348,70 @@ void NeutralPIC::moveNeutrals(double dt) {
 
 // Empirical ionization cross-section as a function of electron temperature (eV)
 // Here we use a placeholder exponential decay model
-Ionization::Ionization() : rng(std::random_device{}()), rand(0.0, 1.0) {}
+template <typename Real>
+BasicIonization<Real>::BasicIonization() : rng(std::random_device{}()), rand(0.0, 1.0) {}
 
-double Ionization::crossSection(double Te) {
+template <typename Real>
+double BasicIonization<Real>::crossSection(double Te) {
     if (Te <= 0.0) return 0.0;
     double base_sigma = 1e-20 * std::exp(-Ei / Te);
     return base_sigma * 1e10;  // artificially boost by 10,000 for testing
 }
 
+// Batch form of crossSection for n electron temperatures; sigma may alias Te
+template <typename Real>
+void BasicIonization<Real>::crossSections(const double* Te, double* sigma, size_t n) {
+    for (size_t k = 0; k < n; ++k) {
+        // exp(-inf) = 0 reproduces the Te <= 0 case of crossSection
+        sigma[k] = (Te[k] > 0.0) ? -Ei / Te[k] : -std::numeric_limits<double>::infinity();
+    }
+    vexp(sigma, sigma, n, mathAccuracy);
+    for (size_t k = 0; k < n; ++k) {
+        double base_sigma = 1e-20 * sigma[k];
+        sigma[k] = base_sigma * 1e10;
+    }
+}
+
 // Perform stochastic ionization using local electron properties and Monte Carlo sampling
-void Ionization::performIonization(const std::vector<std::vector<double>>& Te,
-    const std::vector<std::vector<double>>& ne,
-    NeutralPIC& neutrals, IonPIC& ions,
+template <typename Real>
+void BasicIonization<Real>::performIonization(const Grid<Real>& Te,
+    const Grid<Real>& ne,
+    BasicNeutralPIC<Real>& neutrals, BasicIonPIC<Real>& ions,
     const SimulationDomain& domain, double dt) {
 
     int Nx = Te.size();
     int Nz = Te[0].size();
+    size_t n = neutrals.neutrals.size();
 
-    for (auto it = neutrals.neutrals.begin(); it != neutrals.neutrals.end();) {
-        int i = static_cast<int>((it->x - domain.x_min) / domain.dx);
-        int j = static_cast<int>((it->z - domain.z_min) / domain.dz);
+    // Pass 1: gather the local electron state of every neutral so the
+    // exponentials can be evaluated as two batches instead of per neutral
+    sigmaScratch.resize(n);
+    probScratch.resize(n);
+    for (size_t k = 0; k < n; ++k) {
+        const BasicNeutral<Real>& p = neutrals.neutrals[k];
+        int i = static_cast<int>((p.x - domain.x_min) / domain.dx);
+        int j = static_cast<int>((p.z - domain.z_min) / domain.dz);
 
         i = std::max(0, std::min(i, Nx - 1));
         j = std::max(0, std::min(j, Nz - 1));
 
-        double Te_local = Te[i][j];
-        double ne_local = ne[i][j];
+        sigmaScratch[k] = Te[i][j];
+        probScratch[k] = ne[i][j];
+    }
 
-        double sigma = crossSection(Te_local);
+    crossSections(sigmaScratch.data(), sigmaScratch.data(), n);
 
-        // Original ionization probability
-        double P_ionize = 1.0 - std::exp(-sigma * ne_local * dt);
+    // Original ionization probability: P = 1 - exp(-sigma * ne * dt)
+    for (size_t k = 0; k < n; ++k) {
+        probScratch[k] = -sigmaScratch[k] * probScratch[k] * dt;
+    }
+    vexp(probScratch.data(), probScratch.data(), n, mathAccuracy);
+
+    // Pass 2: Monte Carlo sampling in the same order as before, so the
+    // random number sequence is consumed identically
+    size_t k = 0;
+    for (auto it = neutrals.neutrals.begin(); it != neutrals.neutrals.end();) {
+        double P_ionize = 1.0 - probScratch[k];
 
         // Enforce a small minimum ionization probability to ensure some ions form
         const double minIonProb = 1e-6;  // ~1 in a million chance per neutral per step
@@ -348,12 +422,15 @@ void Ionization::performIonization(const std::vector<std::vector<double>>& Te,
         if (rand(rng) < P_ionize) {
             //std::cout << "Ionizing neutral at (" << it->x << "," << it->z << "), Te=" << Te_local
             //  << ", ne=" << ne_local << ", sigma=" << sigma << ", P_ionize=" << P_ionize << "\n";
-            ions.ions.push_back(Ion{it->x, it->z, 0.0, 0.0, 1.0});
+            ions.ions.push_back(BasicIon<Real>{it->x, it->z, 0, 0, 1});
+            // The last neutral moves into this slot and is tested next, so its probability moves with it
             *it = neutrals.neutrals.back();
+            probScratch[k] = probScratch[neutrals.neutrals.size() - 1];
             neutrals.neutrals.pop_back();
         }
         else {
             ++it;
+            ++k;
         }
     }
 }
@@ -364,19 +441,25 @@ void Ionization::performIonization(const std::vector<std::vector<double>>& Te,
 // BoundaryConditions
 // ----------------------------
 
+// Seeded like the other random streams; setSeed() makes inlet injection repeatable
+template <typename Real>
+BasicBoundaryConditions<Real>::BasicBoundaryConditions() : rng(std::random_device{}()) {}
+
 // Apply Dirichlet boundary conditions for electron temperature
-void BoundaryConditions::applyToTe(std::vector<std::vector<double>>& Te) {
+template <typename Real>
+void BasicBoundaryConditions<Real>::applyToTe(Grid<Real>& Te) {
     int Nx = Te.size();
     int Nz = Te[0].size();
 
     for (int j = 0; j < Nz; ++j) {
-        Te[0][j]      = 5.0; // Left boundary (anode)
-        Te[Nx - 1][j] = 5.0; // Right boundary (exit or wall)
+        Te[0][j]      = TeWall; // Left boundary (anode)
+        Te[Nx - 1][j] = TeWall; // Right boundary (exit or wall)
     }
 }
 
 // Apply Dirichlet boundary conditions for electrostatic potential (phi)
-void BoundaryConditions::applyToPhi(std::vector<std::vector<double>>& phi, double volt) {
+template <typename Real>
+void BasicBoundaryConditions<Real>::applyToPhi(Grid<Real>& phi, double volt) {
     int Nx = phi.size();
     int Nz = phi[0].size();
 
@@ -395,15 +478,15 @@ void BoundaryConditions::applyToPhi(std::vector<std::vector<double>>& phi, doubl
 
 
 // Inject neutrals at the anode/inlet (z = 0 plane)
-void BoundaryConditions::injectNeutralsAtInlet(NeutralPIC& neutrals, const SimulationDomain& domain) {
-    std::default_random_engine rng(std::random_device{}());
+template <typename Real>
+void BasicBoundaryConditions<Real>::injectNeutralsAtInlet(BasicNeutralPIC<Real>& neutrals, const SimulationDomain& domain) {
     std::uniform_real_distribution<double> x_dist(domain.x_min, domain.x_max);
     std::normal_distribution<double> vz_dist(0.0, 300.0);  // Maxwellian approx.
 
     const int N_inject = 100;  // number of neutrals per step
 
     for (int i = 0; i < N_inject; ++i) {
-        Neutral n;
+        BasicNeutral<Real> n;
         n.x  = x_dist(rng);      // Spread across inlet width
         n.z  = domain.z_min;     // Always start at z = 0
         n.vx = 0.0;
@@ -413,11 +496,178 @@ void BoundaryConditions::injectNeutralsAtInlet(NeutralPIC& neutrals, const Simul
 }
 
 
+// ----------------------------
+// FusedFieldKernel
+// ----------------------------
+
+// One tiled sweep computing the Te diffusion stencil, both E-field components and
+// the Dirichlet Te rows. The phi boundary is applied first (perimeter only) so the
+// sweep reads final phi values. Expressions match the separate passes term for term.
+template <typename Real>
+void BasicFusedFieldKernel<Real>::update(BasicElectronFluid<Real>& electrons, BasicElectricField<Real>& field,
+                                         BasicBoundaryConditions<Real>& boundaries,
+                                         double volt, double dt, double dx, double dz) {
+    Grid<Real>& phi = field.phi;
+    Grid<Real>& Te = electrons.Te;
+    Grid<Real>& Te_new = electrons.Te_temp;
+    int Nx = phi.size();
+    int Nz = phi[0].size();
+
+    if (Te_new.size() != Nx) {
+        Te_new.resize(Nx, std::vector<Real>(Nz, 0.0));
+    }
+    field.Ex.resize(Nx, std::vector<Real>(Nz, 0.0));
+    field.Ez.resize(Nx, std::vector<Real>(Nz, 0.0));
+
+    boundaries.applyToPhi(phi, volt);
+
+    // Stencil arithmetic runs in the storage precision
+    const Real TeWall = static_cast<Real>(boundaries.TeWall);
+    const Real rdt = static_cast<Real>(dt);
+    const Real rdx = static_cast<Real>(dx);
+    const Real rdz = static_cast<Real>(dz);
+    const Real twoDx = static_cast<Real>(2.0 * dx);
+    const Real twoDz = static_cast<Real>(2.0 * dz);
+    const int rowsPerTile = std::max(1, tileRows);
+    const int colsPerTile = std::max(1, tileCols);
+
+    for (int j0 = 0; j0 < Nz; j0 += colsPerTile) {
+        int j1 = std::min(j0 + colsPerTile, Nz);
+        int jIn0 = std::max(j0, 1);         // interior column range inside this tile
+        int jIn1 = std::min(j1, Nz - 1);
+
+        for (int i0 = 0; i0 < Nx; i0 += rowsPerTile) {
+            int i1 = std::min(i0 + rowsPerTile, Nx);
+
+            for (int i = i0; i < i1; ++i) {
+                const Real* p = phi[i].data();
+                Real* Ex = field.Ex[i].data();
+                Real* Ez = field.Ez[i].data();
+
+                // z boundaries: one-sided Ez on every row
+                if (j0 == 0) {
+                    Ez[0] = -(p[1] - p[0]) / rdz;
+                }
+                if (j1 == Nz) {
+                    Ez[Nz - 1] = -(p[Nz - 1] - p[Nz - 2]) / rdz;
+                }
+
+                if (i == 0 || i == Nx - 1) {
+                    // x boundaries: one-sided Ex, Dirichlet Te
+                    const Real* pIn = (i == 0) ? phi[1].data() : phi[Nx - 2].data();
+                    Real* T_out = Te_new[i].data();
+                    for (int j = j0; j < j1; ++j) {
+                        Ex[j] = (i == 0) ? -(pIn[j] - p[j]) / rdx : -(p[j] - pIn[j]) / rdx;
+                        T_out[j] = TeWall;
+                    }
+                    continue;
+                }
+
+                const Real* pUp = phi[i + 1].data();
+                const Real* pDn = phi[i - 1].data();
+                const Real* T = Te[i].data();
+                const Real* TUp = Te[i + 1].data();
+                const Real* TDn = Te[i - 1].data();
+                Real* T_out = Te_new[i].data();
+
+                for (int j = jIn0; j < jIn1; ++j) {
+                    Ex[j] = -(pUp[j] - pDn[j]) / twoDx;
+                    Ez[j] = -(p[j + 1] - p[j - 1]) / twoDz;
+
+                    Real laplacian =
+                        TUp[j] + TDn[j] +
+                        T[j + 1] + T[j - 1] -
+                        Real(4.0) * T[j];
+                    T_out[j] = T[j] + rdt * (Real(0.01) * laplacian - Real(0.05) * T[j]);
+                }
+            }
+        }
+    }
+
+    std::swap(electrons.Te, electrons.Te_temp);
+}
+
+
+// ----------------------------
+// StreamingStats
+// ----------------------------
+
+StreamingStats::StreamingStats(std::size_t ringSize, double alpha)
+    : ring(ringSize > 0 ? ringSize : 1, 0.0), ewmaAlpha(alpha) {}
+
+// Welford update keeps mean/variance exact without storing the series
+void StreamingStats::add(double sample) {
+    n++;
+    lastValue = sample;
+
+    double delta = sample - meanValue;
+    meanValue += delta / n;
+    m2 += delta * (sample - meanValue);
+
+    if (n == 1) {
+        ewmaValue = sample;
+        minValue = sample;
+        maxValue = sample;
+    } else {
+        ewmaValue += ewmaAlpha * (sample - ewmaValue);
+        minValue = std::min(minValue, sample);
+        maxValue = std::max(maxValue, sample);
+    }
+
+    ring[head] = sample;
+    head = (head + 1) % ring.size();
+    if (filled < ring.size()) filled++;
+
+    if (streamEvery > 0 && stream.is_open() && (n - 1) % streamEvery == 0) {
+        stream << (n - 1) << "\t" << sample << "\n";
+    }
+}
+
+void StreamingStats::reset() {
+    head = 0;
+    filled = 0;
+    n = 0;
+    lastValue = meanValue = m2 = ewmaValue = minValue = maxValue = 0.0;
+}
+
+long long StreamingStats::count() const { return n; }
+double StreamingStats::last() const { return lastValue; }
+double StreamingStats::mean() const { return meanValue; }
+double StreamingStats::variance() const { return n > 1 ? m2 / (n - 1) : 0.0; }
+double StreamingStats::stddev() const { return std::sqrt(variance()); }
+double StreamingStats::ewma() const { return ewmaValue; }
+double StreamingStats::min() const { return minValue; }
+double StreamingStats::max() const { return maxValue; }
+
+std::size_t StreamingStats::recentCount() const { return filled; }
+
+double StreamingStats::recent(std::size_t index) const {
+    std::size_t oldest = (head + ring.size() - filled) % ring.size();
+    return ring[(oldest + index) % ring.size()];
+}
+
+void StreamingStats::setEwmaAlpha(double alpha) {
+    ewmaAlpha = alpha;
+}
+
+void StreamingStats::openStream(const std::string& path, int every) {
+    closeStream();
+    stream.open(path, std::ios::out | std::ios::trunc);
+    streamEvery = every;
+}
+
+void StreamingStats::closeStream() {
+    if (stream.is_open()) stream.close();
+    streamEvery = 0;
+}
+
+
 // ----------------------------
 // ThrustCalculator
 // ----------------------------
 // Compute total thrust from all ions using 1D momentum summation
-void ThrustCalculator::computeThrust(const IonPIC& ions, double& thrustOut, int& countOut) {
+template <typename Real>
+void BasicThrustCalculator<Real>::computeThrust(const BasicIonPIC<Real>& ions, double& thrustOut, int& countOut) {
     thrustOut = 0.0;
     countOut = 0;
 
@@ -433,7 +683,7 @@ void ThrustCalculator::computeThrust(const IonPIC& ions, double& thrustOut, int&
     }
 
     thrustOut *= scalingFactor;
-    thrustHistory.push_back(thrustOut);
+    thrustStats.add(thrustOut);
 }
 
 // ----------------------------
@@ -441,7 +691,8 @@ void ThrustCalculator::computeThrust(const IonPIC& ions, double& thrustOut, int&
 // ----------------------------
 
 // Constructor - set defaults (could be adjusted later)
-HallThrusterSimulator::HallThrusterSimulator()
+template <typename Real>
+BasicHallThrusterSimulator<Real>::BasicHallThrusterSimulator()
     : domain(100, 50, 0.0, 0.1, 0.0, 0.05),  // example grid sizes and domain extents
       currentTime(0.0),
       dt(5e-7),
@@ -451,7 +702,8 @@ HallThrusterSimulator::HallThrusterSimulator()
 }
 
 // Initialize all modules and simulation state
-void HallThrusterSimulator::initialize() {
+template <typename Real>
+void BasicHallThrusterSimulator<Real>::initialize() {
     std::cout << "Initializing domain...\n";
     domain.initializeGrid();
 
@@ -479,42 +731,46 @@ void HallThrusterSimulator::initialize() {
 }
 
 // Main simulation loop
-void HallThrusterSimulator::runSimulation() {
+template <typename Real>
+void BasicHallThrusterSimulator<Real>::runSimulation() {
     std::cout << "Running debug simulation with fixed Ez and phi boundaries...\n";
+    if (batchMode) {
+        std::cout << "Batch mode: pacing disabled, output every " << outputInterval << " steps\n";
+    }
+
     using clock = std::chrono::steady_clock;
-    auto next_step = clock::now();
+    auto start = clock::now();
+    auto next_step = start;
+
+    performance = SimulationPerformance();
 
     for (int step = 0; step < maxSteps; ++step) {
         next_step += std::chrono::milliseconds(25);  // 40 Hz loop
 
-        // Electron fluid updates (not affecting Ez in this test)
-        electrons.updateElectronTemperature(dt);
+        // Electron drift uses the previous step's field
         electrons.updateElectronVelocity(field.Ex, field.Ez, field.Bz);
 
-        if (step < 1000) {
-            boundaries.applyToPhi(field.phi, 300);
-        } else {
-            boundaries.applyToPhi(field.phi, 0);
-        }
-
-        field.computeElectricField(domain.dx, domain.dz);
+        // Te diffusion, phi/Te boundaries and E-field in one sweep
+        double volt = (step < 1000) ? 300.0 : 0.0;
+        fieldKernel.update(electrons, field, boundaries, volt, dt, domain.dx, domain.dz);
 
         neutrals.injectNeutrals(500, 900.0, domain);
+        performance.particlesPushed += neutrals.neutrals.size();
         neutrals.moveNeutrals(dt);
 
         ionizer.performIonization(electrons.Te, electrons.ne, neutrals, ions, domain, dt);
+        performance.particlesPushed += ions.ions.size();
         ions.pushParticles(field.Ez, domain, dt);
         ions.applyDomainBounds(domain);
 
-        boundaries.applyToTe(electrons.Te);
-
         double thrust = 0.0;
         int count = 0;
         thrustCalc.computeThrust(ions, thrust, count);
 
         currentTime += dt;
+        performance.steps = step + 1;
 
-        if (step % 1 == 0) {
+        if (outputInterval > 0 && step % outputInterval == 0) {
             std::cout << "Step " << step 
                       << ", Time " << currentTime 
                       << ", Thrusting Ions: " << count 
@@ -522,14 +778,126 @@ void HallThrusterSimulator::runSimulation() {
             outputResults();
         }
 
-        std::this_thread::sleep_until(next_step);
+        if (progressCallback && progressInterval > 0 && (step + 1) % progressInterval == 0) {
+            progressCallback(step + 1, maxSteps, currentTime);
+        }
+
+        if (!batchMode) {
+            std::this_thread::sleep_until(next_step);
+        }
+    }
+
+    performance.wallSeconds = std::chrono::duration<double>(clock::now() - start).count();
+    if (performance.wallSeconds > 0.0) {
+        performance.stepsPerSecond = performance.steps / performance.wallSeconds;
+        performance.particlesPerSecond = performance.particlesPushed / performance.wallSeconds;
     }
 
     std::cout << "Simulation complete.\n";
+    printPerformanceSummary();
+}
+
+template <typename Real>
+void BasicHallThrusterSimulator<Real>::setBatchMode(bool enabled) {
+    batchMode = enabled;
+}
+
+template <typename Real>
+void BasicHallThrusterSimulator<Real>::setMaxSteps(int steps) {
+    maxSteps = steps;
+}
+
+template <typename Real>
+void BasicHallThrusterSimulator<Real>::setOutputInterval(int steps) {
+    outputInterval = steps;
 }
 
+template <typename Real>
+void BasicHallThrusterSimulator<Real>::setProgressCallback(ProgressCallback callback, int interval) {
+    progressCallback = callback;
+    progressInterval = interval;
+}
+
+template <typename Real>
+void BasicHallThrusterSimulator<Real>::streamThrust(const std::string& path, int every) {
+    thrustCalc.thrustStats.openStream(path, every);
+}
 
-void HallThrusterSimulator::outputResults() {
+template <typename Real>
+const StreamingStats& BasicHallThrusterSimulator<Real>::getThrustStats() const {
+    return thrustCalc.thrustStats;
+}
+
+template <typename Real>
+const SimulationPerformance& BasicHallThrusterSimulator<Real>::getPerformance() const {
+    return performance;
+}
+
+template <typename Real>
+void BasicHallThrusterSimulator<Real>::printPerformanceSummary() const {
+    std::cout << "=== Performance Summary ===\n"
+              << "Steps:              " << performance.steps << "\n"
+              << "Wall time:          " << performance.wallSeconds << " s\n"
+              << "Steps/s:            " << performance.stepsPerSecond << "\n"
+              << "Particles pushed:   " << performance.particlesPushed << "\n"
+              << "Particles pushed/s: " << performance.particlesPerSecond << "\n";
+
+    const StreamingStats& thrust = thrustCalc.thrustStats;
+    std::cout << "=== Thrust Statistics ===\n"
+              << "Mean:    " << thrust.mean() << " N (std " << thrust.stddev() << ")\n"
+              << "EWMA:    " << thrust.ewma() << " N\n"
+              << "Min/Max: " << thrust.min() << " / " << thrust.max() << " N\n";
+}
+
+
+template <typename Real>
+void BasicHallThrusterSimulator<Real>::outputResults() {
     static std::ofstream thrustFile("thrust_history.txt", std::ios::app);
-    thrustFile << currentTime << "\t" << thrustCalc.thrustHistory.back() << "\n";
-}
\ No newline at end of file
+    thrustFile << currentTime << "\t" << thrustCalc.thrustStats.last() << "\n";
+}
+template <typename Real>
+void BasicHallThrusterSimulator<Real>::setSeed(unsigned seed) {
+    neutrals.rng.seed(seed);
+    ionizer.rng.seed(seed + 1);
+    boundaries.rng.seed(seed + 2);
+    std::srand(seed);               // IonPIC::initialize draws from rand()
+}
+
+template <typename Real>
+const BasicElectronFluid<Real>& BasicHallThrusterSimulator<Real>::getElectrons() const {
+    return electrons;
+}
+
+template <typename Real>
+const BasicIonPIC<Real>& BasicHallThrusterSimulator<Real>::getIons() const {
+    return ions;
+}
+
+template <typename Real>
+std::size_t BasicHallThrusterSimulator<Real>::getNeutralCount() const {
+    return neutrals.neutrals.size();
+}
+
+
+// ----------------------------
+// Precision instantiations
+// ----------------------------
+template class BasicElectronFluid<double>;
+template class BasicElectricField<double>;
+template class BasicIonPIC<double>;
+template class BasicNeutralPIC<double>;
+template class BasicIonization<double>;
+template class BasicBoundaryConditions<double>;
+template class BasicFusedFieldKernel<double>;
+template class BasicThrustCalculator<double>;
+template class BasicHallThrusterSimulator<double>;
+
+template class BasicElectronFluid<float>;
+template class BasicElectricField<float>;
+template class BasicIonPIC<float>;
+template class BasicNeutralPIC<float>;
+template class BasicIonization<float>;
+template class BasicBoundaryConditions<float>;
+template class BasicFusedFieldKernel<float>;
+template class BasicThrustCalculator<float>;
+template class BasicHallThrusterSimulator<float>;
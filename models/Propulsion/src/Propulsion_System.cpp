@@ -3,7 +3,9 @@ PURPOSE: (Simulate A Motor)
 LIBRARY DEPENDENCY:
     ((Propulsion_System.o)
      (hall_thruster.o)
-     (xenon_tank.o))
+     (xenon_tank.o)
+     (Recources/src/Linear_Algebra.o)
+     (Recources/src/frame_transforms.o))
 *******************************************************************************/
 
 /*
@@ -42,6 +44,7 @@ Propulsion_System::Propulsion_System()
         thrusters[i].set_refrence_ori(0, 0, -1);
     }
     available_mass = tanks[0].getmass() + tanks[1].getmass() + tanks[2].getmass();
+    sync_mounts();
 }
 
 Propulsion_System::Propulsion_System(double length, double hight, double depth, double D1, double D2)
@@ -64,6 +67,7 @@ Propulsion_System::Propulsion_System(double length, double hight, double depth,
     }
 
     available_mass = tanks[0].getmass() + tanks[1].getmass() + tanks[2].getmass();
+    sync_mounts();
 }
 
 void Propulsion_System::set_all_thruster_ref_pos(double length, double hight, double depth, double D1, double D2)
@@ -78,6 +82,7 @@ void Propulsion_System::set_all_thruster_ref_pos(double length, double hight, do
     thrusters[4].set_refrence_pos(length / 2 + D2, 0, -depth / 2);
     thrusters[5].set_refrence_pos(-length / 2 - D1, 0, -depth / 2);
     thrusters[6].set_refrence_pos(-length / 2 - D2, 0, -depth / 2);
+    sync_mounts();
 }
 
 void Propulsion_System::set_all_thruster_ref_ori(double orientation[3])
@@ -88,6 +93,7 @@ void Propulsion_System::set_all_thruster_ref_ori(double orientation[3])
     for (int i = 0; i < 7; i++) {
         thrusters[i].set_refrence_ori(orientation);
     }
+    sync_mounts();
 }
 
 void Propulsion_System::set_all_thruster_ref_ori(double x, double y, double z)
@@ -98,6 +104,7 @@ void Propulsion_System::set_all_thruster_ref_ori(double x, double y, double z)
     for (int i = 0; i < 7; i++) {
         thrusters[i].set_refrence_ori(x, y, z);
     }
+    sync_mounts();
 }
 
 void Propulsion_System::set_all_thruster_ref_ori(Vector3d orientation)
@@ -108,6 +115,7 @@ void Propulsion_System::set_all_thruster_ref_ori(Vector3d orientation)
     for (int i = 0; i < 7; i++) {
         thrusters[i].set_refrence_ori(orientation);
     }
+    sync_mounts();
 }
 
 void Propulsion_System::set_all_thruster_specs(double power, double discharge_voltage, double efficiency)
@@ -134,8 +142,9 @@ void Propulsion_System::update_all_pos_ori(double satellite_position[3], double
     //Preconditions: Satellite position and rotation matrix must be provided.
     //Postconditions: Thruster positions and orientations are updated.
 {
+    mounts.update(satellite_position, rotation_matrix);
     for (int i = 0; i < 7; i++) {
-        thrusters[i].update_pos_ori(satellite_position, rotation_matrix);
+        thrusters[i].update_pos_ori(mounts, thruster_mount[i]);
     }
 }
 
@@ -144,8 +153,9 @@ void Propulsion_System::update_all_pos_ori(Vector3d satellite_position, Matrix3d
     //Preconditions: Satellite position and rotation matrix must be provided.
     //Postconditions: Thruster positions and orientations are updated.
 {
+    mounts.update(satellite_position, rotation_matrix);
     for (int i = 0; i < 7; i++) {
-        thrusters[i].update_pos_ori(satellite_position, rotation_matrix);
+        thrusters[i].update_pos_ori(mounts, thruster_mount[i]);
     }
 }
 
@@ -309,4 +319,18 @@ void Propulsion_System::update_tankmass(double current_mass)
     }
 }
 
-
+void Propulsion_System::sync_mounts()
+    //Description:   Registers the thruster mounts with the frame transform service, or refreshes them after a refrence position or orientation changed.
+    //Preconditions: None
+    //Postconditions: mounts holds the refrence position and orientation of every thruster, so update_all_pos_ori can move them all in one pass.
+{
+    for (int i = 0; i < 7; i++) {
+        if (i < mounts.size()) {
+            mounts.set_mount_pos(thruster_mount[i], thrusters[i].get_refrence_pos());
+            mounts.set_mount_ori(thruster_mount[i], thrusters[i].get_refrence_ori());
+        }
+        else {
+            thruster_mount[i] = mounts.add_mount(thrusters[i].get_refrence_pos(), thrusters[i].get_refrence_ori());
+        }
+    }
+}
@@ -3,7 +3,9 @@ PURPOSE: (Simulate A Motor)
 LIBRARY DEPENDENCY:
     ((Propulsion_System_PIC2D.o)
      (hall_thruster.o)
-     (xenon_tank.o))
+     (xenon_tank.o)
+     (Recources/src/Linear_Algebra.o)
+     (Recources/src/frame_transforms.o))
 *******************************************************************************/
 
 /*
@@ -30,10 +32,6 @@ TERMS USED:
 #include "../include/Propulsion_System_PIC2D.hh"
 //#include "../../../Lib/eigen-3.4.0/Eigen/Dense" //include Eigen Library directory here
 
-//#include "HET_simulation_2D_PIC.cpp"
-//#include "hall_thruster_PIC2D.cpp"
-#include "xenon_tank.cpp"
-
 using namespace std;
 
 Propulsion_System_PIC2D::Propulsion_System_PIC2D()
@@ -42,11 +40,13 @@ Propulsion_System_PIC2D::Propulsion_System_PIC2D()
     //Postconditions: Total massflow is set to zero, and thruster orientations are initialized. Available mass is calculated from the xenon tanks.
 {
     total_massflow = 0.0;
+    verbose = true;
     for (int i = 0; i < 7; i++) {
         double ori[3] = {0, 0, -1};
         thrusters[i].set_refrence_ori(ori);
     }
     available_mass = tanks[0].getmass() + tanks[1].getmass() + tanks[2].getmass();
+    sync_mounts();
 }
 
 Propulsion_System_PIC2D::Propulsion_System_PIC2D(double length, double hight, double depth, double D1, double D2)
@@ -55,6 +55,7 @@ Propulsion_System_PIC2D::Propulsion_System_PIC2D(double length, double hight, do
     //Postconditions: Thruster positions and orientations are set, and available mass is calculated.
 {
     total_massflow = 0.0;
+    verbose = true;
 
     thrusters[0].set_refrence_pos(0, 0, -depth / 2);
     thrusters[1].set_refrence_pos(length / 2, 0, -depth / 2);
@@ -69,6 +70,7 @@ Propulsion_System_PIC2D::Propulsion_System_PIC2D(double length, double hight, do
     }
 
     available_mass = tanks[0].getmass() + tanks[1].getmass() + tanks[2].getmass();
+    sync_mounts();
 }
 
 void Propulsion_System_PIC2D::set_all_thruster_ref_pos(double length, double hight, double depth, double D1, double D2)
@@ -83,6 +85,7 @@ void Propulsion_System_PIC2D::set_all_thruster_ref_pos(double length, double hig
     thrusters[4].set_refrence_pos(length / 2 + D2, 0, -depth / 2);
     thrusters[5].set_refrence_pos(-length / 2 - D1, 0, -depth / 2);
     thrusters[6].set_refrence_pos(-length / 2 - D2, 0, -depth / 2);
+    sync_mounts();
 }
 
 void Propulsion_System_PIC2D::set_all_thruster_ref_ori(double orientation[3])
@@ -93,6 +96,7 @@ void Propulsion_System_PIC2D::set_all_thruster_ref_ori(double orientation[3])
     for (int i = 0; i < 7; i++) {
         thrusters[i].set_refrence_ori(orientation);
     }
+    sync_mounts();
 }
 
 void Propulsion_System_PIC2D::set_all_thruster_ref_ori(double x, double y, double z)
@@ -103,6 +107,7 @@ void Propulsion_System_PIC2D::set_all_thruster_ref_ori(double x, double y, doubl
     for (int i = 0; i < 7; i++) {
         thrusters[i].set_refrence_ori(x, y, z);
     }
+    sync_mounts();
 }
 
 void Propulsion_System_PIC2D::set_all_thruster_ref_ori(Vector3d orientation)
@@ -114,8 +119,9 @@ void Propulsion_System_PIC2D::set_all_thruster_ref_ori(Vector3d orientation)
         thrusters[i].set_refrence_ori(orientation);
         double orien[3];
         thrusters[i].get_ori(orien);
-        std::cout << "Ori: " <<orien[0] << ", " << orien[1] << ", " << orien[2] << "\n";
+        if (verbose) std::cout << "Ori: " <<orien[0] << ", " << orien[1] << ", " << orien[2] << "\n";
     }
+    sync_mounts();
 }
 
 void Propulsion_System_PIC2D::update_all_pos_ori(double satellite_position[3], double rotation_matrix[3][3])
@@ -123,8 +129,9 @@ void Propulsion_System_PIC2D::update_all_pos_ori(double satellite_position[3], d
     //Preconditions: Satellite position and rotation matrix must be provided.
     //Postconditions: Thruster positions and orientations are updated.
 {
+    mounts.update(satellite_position, rotation_matrix);
     for (int i = 0; i < 7; i++) {
-        thrusters[i].update_pos_ori(satellite_position, rotation_matrix);
+        thrusters[i].update_pos_ori(mounts, thruster_mount[i]);
         double orien[3];
         thrusters[i].get_ori(orien);
         //std::cout << "Ori: " <<orien[0] << ", " << orien[1] << ", " << orien[2] << "\n";
@@ -136,14 +143,24 @@ void Propulsion_System_PIC2D::update_all_pos_ori(Vector3d satellite_position, Ma
     //Preconditions: Satellite position and rotation matrix must be provided.
     //Postconditions: Thruster positions and orientations are updated.
 {
+    mounts.update(satellite_position, rotation_matrix);
     for (int i = 0; i < 7; i++) {
-        thrusters[i].update_pos_ori(satellite_position, rotation_matrix);
+        thrusters[i].update_pos_ori(mounts, thruster_mount[i]);
         double orien[3];
         thrusters[i].get_ori(orien);
-        std::cout << "Ori: " <<orien[0] << ", " << orien[1] << ", " << orien[2] << "\n";
+        if (verbose) std::cout << "Ori: " <<orien[0] << ", " << orien[1] << ", " << orien[2] << "\n";
     }
 }
 
+void Propulsion_System_PIC2D::set_verbose(bool enabled)
+    //Description:   Turns the reports on cout of the system and of every thruster on or off.
+    //Preconditions: None
+    //Postconditions: Silent when off; the models run the same either way.
+{
+    verbose = enabled;
+    for (int i = 0; i < 7; i++) thrusters[i].set_verbose(enabled);
+}
+
 void Propulsion_System_PIC2D::initialize_HET_sim(int index)
 {
     thrusters[index].initialize_HET_sim();
@@ -154,6 +171,12 @@ void Propulsion_System_PIC2D::initialize_all_HET_sim()
         thrusters[i].initialize_HET_sim();
     }
 }
+void Propulsion_System_PIC2D::set_seed(unsigned seed)
+{
+    for (int i = 0; i < 7; i++) {
+        thrusters[i].set_seed(seed + 3 * i);
+    }
+}
 void Propulsion_System_PIC2D::run_step_HET_sim(int index, double mass_flow, double discharge_voltage)
 {
     thrusters[index].run_step_HET_sim(mass_flow, discharge_voltage);
@@ -327,4 +350,18 @@ void Propulsion_System_PIC2D::update_tankmass()
     total_massflow = 0;
 }
 
-
+void Propulsion_System_PIC2D::sync_mounts()
+    //Description:   Registers the thruster mounts with the frame transform service, or refreshes them after a refrence position or orientation changed.
+    //Preconditions: None
+    //Postconditions: mounts holds the refrence position and orientation of every thruster, so update_all_pos_ori can move them all in one pass.
+{
+    for (int i = 0; i < 7; i++) {
+        if (i < mounts.size()) {
+            mounts.set_mount_pos(thruster_mount[i], thrusters[i].get_refrence_pos());
+            mounts.set_mount_ori(thruster_mount[i], thrusters[i].get_refrence_ori());
+        }
+        else {
+            thruster_mount[i] = mounts.add_mount(thrusters[i].get_refrence_pos(), thrusters[i].get_refrence_ori());
+        }
+    }
+}
@@ -1,3 +1,10 @@
+/********************************* TRICK HEADER *******************************
+PURPOSE: (Simulate A Hall Thruster)
+LIBRARY DEPENDENCY:
+    ((hall_thruster.o)
+     (Recources/src/frame_transforms.o))
+*******************************************************************************/
+
 /*
 PURPOSE:    This is the implementation of the thruster class moduel.
             provides a simplified model for the popular Hall-Effect Thruster.
@@ -320,6 +327,32 @@ void hall_thruster::update_pos_ori(Vector3d ref)
     pos_set = true;
     ori_set = true;
 }
+void hall_thruster::update_pos_ori(const frame_transforms& frames, int handle)
+    //Description:      reads global position and orientation from a frame_transforms pass that moved all mounts at once
+    //Preconditions:    frames updated this cycle, handle returned when this thruster's mount was registered
+    //Postconditions:   global orientation and position updated, same values as update_pos_ori(ref, R)
+{
+    if(R_matrix_set && WARN){
+        cerr << ORANGE << "Warning: " << RESET << "Rotation matrix was already set during this cycle. Ensure the values are not being set twice.\n \n";
+    }
+    R_matrix = frames.get_R();
+
+    pos = frames.get_pos(handle);
+    ori = frames.get_ori(handle);
+    R_matrix_set = true;
+    pos_set = true;
+    ori_set = true;
+}
+
+Vector3d hall_thruster::get_refrence_pos()
+{
+    return ref_pos;
+}
+
+Vector3d hall_thruster::get_refrence_ori()
+{
+    return ref_ori;
+}
 //-----------------------------------//
 
 //[[Get Position Function]]//
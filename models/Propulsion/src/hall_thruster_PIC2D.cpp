@@ -1,10 +1,15 @@
+/********************************* TRICK HEADER *******************************
+PURPOSE: (Simulate A Hall Thruster)
+LIBRARY DEPENDENCY:
+    ((hall_thruster_PIC2D.o)
+     (Recources/src/frame_transforms.o))
+*******************************************************************************/
+
+#include <cstdlib>
 #include <cmath>
 #include <iostream>
 #include "../include/hall_thruster_PIC2D.hh"
 
-//other files for linking
-#include "HET_simulation_2D_PIC.cpp"
-
 #define ORANGE "\033[38;5;208m" //orange color
 #define RESET "\033[0m"
 #define WARN false
@@ -27,6 +32,8 @@ HET_PIC2D::HET_PIC2D()
     R_matrix_set = false;
     pos_set = false;
     ori_set = false;
+
+    verbose = true;
 }
 
 //[[Set Refrence Position Function]]//
@@ -243,6 +250,32 @@ void HET_PIC2D::update_pos_ori(Vector3d ref)
     pos_set = true;
     ori_set = true;
 }
+void HET_PIC2D::update_pos_ori(const frame_transforms& frames, int handle)
+    //Description:      reads global position and orientation from a frame_transforms pass that moved all mounts at once
+    //Preconditions:    frames updated this cycle, handle returned when this thruster's mount was registered
+    //Postconditions:   global orientation and position updated, same values as update_pos_ori(ref, R)
+{
+    if(R_matrix_set && WARN){
+        cerr << ORANGE << "Warning: " << RESET << "Rotation matrix was already set during this cycle. Ensure the values are not being set twice.\n \n";
+    }
+    R_matrix = frames.get_R();
+
+    pos = frames.get_pos(handle);
+    ori = frames.get_ori(handle);
+    R_matrix_set = true;
+    pos_set = true;
+    ori_set = true;
+}
+
+Vector3d HET_PIC2D::get_refrence_pos()
+{
+    return ref_pos;
+}
+
+Vector3d HET_PIC2D::get_refrence_ori()
+{
+    return ref_ori;
+}
 //-----------------------------------//
 
 //[[Get Position Function]]//
@@ -279,45 +312,59 @@ Vector3d HET_PIC2D::get_ori()
 
 void HET_PIC2D::initialize_HET_sim()
 {
-    std::cout << "Initializing domain...\n";
+    if (verbose) std::cout << "Initializing domain...\n";
     domain.initializeGrid();
 
-    std::cout << "Initializing electrons...\n";
+    if (verbose) std::cout << "Initializing electrons...\n";
     electrons.initialize(domain);
 
-    std::cout << "Initializing ions...\n";
+    if (verbose) std::cout << "Initializing ions...\n";
     ions.initialize(domain);
 
-    std::cout << "Initializing magnetic field...\n";
+    if (verbose) std::cout << "Initializing magnetic field...\n";
     field.initializeMagneticField(domain);
 
-    std::cout << "Computing electric potential and applying boundary conditions...\n";
+    if (verbose) std::cout << "Computing electric potential and applying boundary conditions...\n";
     field.computePotentialFromBoltzmann(electrons.Te, electrons.ne);
     boundaries.applyToPhi(field.phi, 0);          // <-- apply BC here BEFORE computing E field
     field.computeElectricField(domain.dx, domain.dz);
 
-    std::cout << "Applying boundary conditions (Te)...\n";
+    if (verbose) std::cout << "Applying boundary conditions (Te)...\n";
     boundaries.applyToTe(electrons.Te);
 
-    std::cout << "Injecting initial neutrals...\n";
+    if (verbose) std::cout << "Injecting initial neutrals...\n";
     boundaries.injectNeutralsAtInlet(neutrals, domain);
 
-    std::cout << "Initialization complete.\n";
+    if (verbose) std::cout << "Initialization complete.\n";
+}
+
+void HET_PIC2D::set_verbose(bool enabled)
+{
+    verbose = enabled;
+}
+
+void HET_PIC2D::set_seed(unsigned seed)
+    //Description:   Reseeds the neutral, ionization and boundary streams and the std::rand stream of the ion initialization.
+    //Preconditions: std::rand is shared by the whole process; callers on several threads must serialize seeding and initialization.
+    //Postconditions: The next initialize_HET_sim and every step after it draw the same numbers for the same seed.
+{
+    neutrals.rng.seed(seed);
+    ionizer.rng.seed(seed + 1);
+    boundaries.rng.seed(seed + 2);
+    std::srand(seed);
 }
 
 void HET_PIC2D::run_step_HET_sim(double mass_flow, double discharge_volt) 
 {
-    // Electron fluid updates (not affecting Ez in this test)
-    electrons.updateElectronTemperature(dt);
+    // Electron drift uses the previous step's field
     electrons.updateElectronVelocity(field.Ex, field.Ez, field.Bz);
 
     // --- Debug: Comment out Boltzmann overwrite of phi ---
     // field.computePotentialFromBoltzmann(electrons.Te, electrons.ne);
 
-    // --- Apply fixed BC and electric field ---
-    boundaries.applyToPhi(field.phi, discharge_volt);
-    // phi: 300 at left, 0 at right
-    field.computeElectricField(domain.dx, domain.dz);
+    // --- Te diffusion, fixed phi/Te BC and electric field in one sweep ---
+    // phi: discharge_volt at left, 0 at right
+    fieldKernel.update(electrons, field, boundaries, discharge_volt, dt, domain.dx, domain.dz);
 
     // --- Optional: override Ez with fixed 1kV/m in z-direction ---
     int Nx = domain.Nx;
@@ -335,9 +382,6 @@ void HET_PIC2D::run_step_HET_sim(double mass_flow, double discharge_volt)
     ions.pushParticles(field.Ez, domain, dt);
     ions.applyDomainBounds(domain);
 
-    // Apply boundary conditions again to Te
-    boundaries.applyToTe(electrons.Te);
-
     // --- Compute thrust and log ion count ---
     thrust = 0.0;
     int count = 0;
@@ -0,0 +1,77 @@
+/*
+PURPOSE: (Benchmark the fused field kernel against the separate
+          per-step grid passes it replaces and check that both
+          produce the same Te, phi, Ex and Ez.)
+COMMANDS:
+    : g++ -O2 src/HET_simulation_2D_PIC.cpp test/field_kernel_benchmark.cpp -o field_kernel_benchmark
+*/
+
+#include "../include/HET_simulation_2D_PIC.hh"
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+double max_diff(const vector<vector<double>>& a, const vector<vector<double>>& b) {
+    double diff = 0.0;
+    for (size_t i = 0; i < a.size(); ++i)
+        for (size_t j = 0; j < a[i].size(); ++j)
+            diff = max(diff, fabs(a[i][j] - b[i][j]));
+    return diff;
+}
+
+void run_case(int Nx, int Nz, int steps) {
+    SimulationDomain domain(Nx, Nz, 0.0, 0.1, 0.0, 0.05);
+    const double dt = 5e-7;
+    const double volt = 300.0;
+
+    ElectronFluid electrons_sep, electrons_fused;
+    ElectricField field_sep, field_fused;
+    BoundaryConditions boundaries;
+    FusedFieldKernel kernel;
+
+    electrons_sep.initialize(domain);
+    field_sep.computePotentialFromBoltzmann(electrons_sep.Te, electrons_sep.ne);
+    electrons_fused = electrons_sep;
+    field_fused = field_sep;
+
+    using clock = chrono::steady_clock;
+
+    auto start = clock::now();
+    for (int s = 0; s < steps; ++s) {
+        electrons_sep.updateElectronTemperature(dt);
+        boundaries.applyToPhi(field_sep.phi, volt);
+        field_sep.computeElectricField(domain.dx, domain.dz);
+        boundaries.applyToTe(electrons_sep.Te);
+    }
+    double t_sep = chrono::duration<double>(clock::now() - start).count();
+
+    start = clock::now();
+    for (int s = 0; s < steps; ++s) {
+        kernel.update(electrons_fused, field_fused, boundaries, volt, dt, domain.dx, domain.dz);
+    }
+    double t_fused = chrono::duration<double>(clock::now() - start).count();
+
+    double err = max(max(max_diff(electrons_sep.Te, electrons_fused.Te),
+                         max_diff(field_sep.phi, field_fused.phi)),
+                     max(max_diff(field_sep.Ex, field_fused.Ex),
+                         max_diff(field_sep.Ez, field_fused.Ez)));
+
+    cout << Nx << "x" << Nz << " (" << steps << " steps)"
+         << " | separate: " << 1e3 * t_sep / steps << " ms/step"
+         << " | fused: " << 1e3 * t_fused / steps << " ms/step"
+         << " | speedup: " << t_sep / t_fused
+         << " | max diff: " << err
+         << (err == 0.0 ? "  [OK]" : "  [MISMATCH]") << "\n";
+}
+
+int main() {
+    cout << "=== Fused Field Kernel Benchmark ===\n";
+    run_case(100, 50, 2000);     // grid used by HET_PIC2D
+    run_case(500, 500, 200);
+    run_case(2000, 1000, 20);
+    run_case(4000, 4000, 5);
+    return 0;
+}
@@ -1,12 +1,42 @@
 #include "../include/HET_simulation_2D_PIC.hh"
 #include <iostream>
+#include <string>
+#include <cstdlib>
 
 //g++ src/HET_simulation_2D_PIC.cpp test/hall_thruster_2test.cpp -o het_sim
+//
+//USAGE:
+//  ./het_sim                                   real time (40 Hz) run, output every step
+//  ./het_sim --batch [--steps N] [--output-every N] [--progress-every N]
+//                   [--thrust-stream FILE N] [--float]
+//                                              unpaced run for thruster characterization
+//  --float runs the single precision engine (float particles and fields, double accumulators)
 
-int main() {
-    std::cout << "Starting Hall Thruster Simulation...\n";
+struct HetOptions {
+    bool batch = false;
+    int steps = -1;
+    int outputEvery = -1;
+    int progressEvery = 0;
+    std::string thrustPath;
+    int thrustEvery = 0;
+    bool singlePrecision = false;
+};
+
+template <typename Simulator>
+int runHet(const HetOptions& opt) {
+    Simulator sim;
 
-    HallThrusterSimulator sim;
+    sim.setBatchMode(opt.batch);
+    if (opt.steps >= 0) sim.setMaxSteps(opt.steps);
+    if (opt.outputEvery >= 0) sim.setOutputInterval(opt.outputEvery);
+    if (!opt.thrustPath.empty()) sim.streamThrust(opt.thrustPath, opt.thrustEvery);
+
+    if (opt.progressEvery > 0) {
+        sim.setProgressCallback([](int step, int total, double time) {
+            std::cerr << "[progress] " << step << "/" << total
+                      << " (" << (100.0 * step) / total << "%), t = " << time << " s\n";
+        }, opt.progressEvery);
+    }
 
     sim.initialize();
 
@@ -21,4 +51,35 @@ int main() {
     std::cout << "Done.\n";
 
     return 0;
-}
\ No newline at end of file
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "Starting Hall Thruster Simulation...\n";
+
+    HetOptions opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--batch") {
+            opt.batch = true;
+        } else if (arg == "--steps" && i + 1 < argc) {
+            opt.steps = std::atoi(argv[++i]);
+        } else if (arg == "--output-every" && i + 1 < argc) {
+            opt.outputEvery = std::atoi(argv[++i]);
+        } else if (arg == "--progress-every" && i + 1 < argc) {
+            opt.progressEvery = std::atoi(argv[++i]);
+        } else if (arg == "--thrust-stream" && i + 2 < argc) {
+            opt.thrustPath = argv[++i];
+            opt.thrustEvery = std::atoi(argv[++i]);
+        } else if (arg == "--float") {
+            opt.singlePrecision = true;
+        } else {
+            std::cerr << "Unknown argument: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    if (opt.singlePrecision) {
+        return runHet<HallThrusterSimulatorF>(opt);
+    }
+    return runHet<HallThrusterSimulator>(opt);
+}
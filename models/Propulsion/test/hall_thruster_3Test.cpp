@@ -1,4 +1,4 @@
-////g++ src/hall_thruster_PIC2D.cpp test/hall_thruster_3Test.cpp -o het_implementation_sim
+////g++ src/hall_thruster_PIC2D.cpp src/HET_simulation_2D_PIC.cpp test/hall_thruster_3Test.cpp -o het_implementation_sim
 #include "../include/hall_thruster_PIC2D.hh"
 
 using namespace std;
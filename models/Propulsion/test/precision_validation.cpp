@@ -0,0 +1,175 @@
+/*
+PURPOSE: (Validate the single precision PIC engine against the double
+          precision build: field sweep and ion push on identical inputs,
+          double accumulation of thrust, and a full seeded run compared
+          through its thrust statistics. Also reports throughput and
+          particle memory for both precisions.)
+COMMANDS:
+    : g++ -O2 src/HET_simulation_2D_PIC.cpp test/precision_validation.cpp -o precision_validation
+*/
+
+#include "../include/HET_simulation_2D_PIC.hh"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+
+template <typename A, typename B>
+double max_rel_diff(const Grid<A>& a, const Grid<B>& b) {
+    double scale = 0.0;
+    double diff = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        for (size_t j = 0; j < a[i].size(); ++j) {
+            scale = max(scale, fabs(static_cast<double>(a[i][j])));
+            diff = max(diff, fabs(static_cast<double>(a[i][j]) - static_cast<double>(b[i][j])));
+        }
+    }
+    return scale > 0.0 ? diff / scale : diff;
+}
+
+bool check(const char* name, double value, double tol) {
+    bool ok = value <= tol;
+    cout << "  " << name << ": " << value << " (tol " << tol << ")" << (ok ? "  [OK]" : "  [FAIL]") << "\n";
+    return ok;
+}
+
+// Field sweep from the same initial state in both precisions
+bool check_fields() {
+    SimulationDomain domain(100, 50, 0.0, 0.1, 0.0, 0.05);
+    BasicElectronFluid<double> ed;
+    BasicElectronFluid<float> ef;
+    BasicElectricField<double> fd;
+    BasicElectricField<float> ff;
+    BasicBoundaryConditions<double> bd;
+    BasicBoundaryConditions<float> bf;
+    BasicFusedFieldKernel<double> kd;
+    BasicFusedFieldKernel<float> kf;
+
+    ed.initialize(domain);
+    ef.initialize(domain);
+    fd.computePotentialFromBoltzmann(ed.Te, ed.ne);
+    ff.computePotentialFromBoltzmann(ef.Te, ef.ne);
+
+    for (int s = 0; s < 500; ++s) {
+        kd.update(ed, fd, bd, 300.0, 5e-7, domain.dx, domain.dz);
+        kf.update(ef, ff, bf, 300.0, 5e-7, domain.dx, domain.dz);
+    }
+
+    bool ok = true;
+    ok &= check("Te  max rel diff (500 sweeps)", max_rel_diff(ed.Te, ef.Te), 1e-4);
+    ok &= check("phi max rel diff", max_rel_diff(fd.phi, ff.phi), 1e-6);
+    ok &= check("Ex  max rel diff", max_rel_diff(fd.Ex, ff.Ex), 1e-4);
+    ok &= check("Ez  max rel diff", max_rel_diff(fd.Ez, ff.Ez), 1e-4);
+    return ok;
+}
+
+// Ion push on identical particles and field, then thrust from each population
+bool check_push_and_thrust() {
+    SimulationDomain domain(100, 50, 0.0, 0.1, 0.0, 0.05);
+    Grid<double> Ezd(domain.Nx, vector<double>(domain.Nz));
+    Grid<float> Ezf(domain.Nx, vector<float>(domain.Nz));
+    for (int i = 0; i < domain.Nx; ++i) {
+        for (int j = 0; j < domain.Nz; ++j) {
+            Ezd[i][j] = Ezf[i][j] = static_cast<float>(2000.0 * sin(0.1 * i) + 500.0 * j / domain.Nz);
+        }
+    }
+
+    BasicIonPIC<double> id;
+    BasicIonPIC<float> iff;
+    for (int k = 0; k < 20000; ++k) {
+        float x = static_cast<float>(domain.x_max * (k + 0.5) / 20000);
+        float z = static_cast<float>(domain.z_max * ((k * 7919) % 20000) / 20000.0 * 0.5);
+        id.ions.push_back(BasicIon<double>{x, z, 0.0, 100.0, 1.0});
+        iff.ions.push_back(BasicIon<float>{x, z, 0.0f, 100.0f, 1.0f});
+    }
+
+    for (int s = 0; s < 400; ++s) {
+        id.pushParticles(Ezd, domain, 5e-7);
+        iff.pushParticles(Ezf, domain, 5e-7);
+    }
+
+    // Particles near a cell edge can land in a neighbouring cell in float, so compare the bulk
+    double worst = 0.0;
+    size_t far = 0;
+    for (size_t k = 0; k < id.ions.size(); ++k) {
+        double rel = fabs(id.ions[k].vz - iff.ions[k].vz) / max(1.0, fabs(id.ions[k].vz));
+        worst = max(worst, rel);
+        if (rel > 1e-3) far++;
+    }
+
+    // Thrust from the float population equals thrust from its exact double copy:
+    // the momentum sum itself is accumulated in double
+    BasicIonPIC<double> copy;
+    for (const auto& ion : iff.ions) {
+        copy.ions.push_back(BasicIon<double>{ion.x, ion.z, ion.vx, ion.vz, ion.weight});
+    }
+    BasicThrustCalculator<float> tf;
+    BasicThrustCalculator<double> tc;
+    double thrustF, thrustC;
+    int countF, countC;
+    tf.computeThrust(iff, thrustF, countF);
+    tc.computeThrust(copy, thrustC, countC);
+
+    bool ok = true;
+    ok &= check("ion vz fraction off by > 1e-3 (400 pushes)", static_cast<double>(far) / id.ions.size(), 0.01);
+    cout << "  (worst single ion: " << worst << ")\n";
+    ok &= check("thrust float vs exact double copy", fabs(thrustF - thrustC) + abs(countF - countC), 0.0);
+    return ok;
+}
+
+// Full seeded runs; trajectories diverge at the first ionization draw that lands
+// between the two probabilities, so the comparison is statistical
+bool check_full_run(int steps) {
+    HallThrusterSimulator simD;
+    HallThrusterSimulatorF simF;
+
+    simD.setSeed(1234);
+    simF.setSeed(1234);
+    simD.setBatchMode(true);
+    simF.setBatchMode(true);
+    simD.setMaxSteps(steps);
+    simF.setMaxSteps(steps);
+    simD.setOutputInterval(0);
+    simF.setOutputInterval(0);
+
+    simD.initialize();
+    simD.runSimulation();
+    simF.initialize();
+    simF.runSimulation();
+
+    const StreamingStats& td = simD.getThrustStats();
+    const StreamingStats& tf = simF.getThrustStats();
+    double meanDiff = fabs(td.mean() - tf.mean()) / max(fabs(td.mean()), 1e-30);
+    double neutralDiff = fabs(static_cast<double>(simD.getNeutralCount()) - simF.getNeutralCount())
+                         / max<double>(1.0, simD.getNeutralCount());
+
+    cout << "=== Full run (" << steps << " steps, seed 1234) ===\n";
+    cout << "  double: mean thrust " << td.mean() << " N, ions " << simD.getIons().ions.size()
+         << ", " << simD.getPerformance().particlesPerSecond << " particles/s\n";
+    cout << "  float:  mean thrust " << tf.mean() << " N, ions " << simF.getIons().ions.size()
+         << ", " << simF.getPerformance().particlesPerSecond << " particles/s\n";
+    cout << "  speedup: " << simD.getPerformance().wallSeconds / simF.getPerformance().wallSeconds << "\n";
+
+    bool ok = true;
+    // Measured 8.6e-5 over 3000 steps; 1e-3 leaves room for the platform and still catches a real drift
+    ok &= check("mean thrust rel diff", meanDiff, 1e-3);
+    ok &= check("neutral count rel diff", neutralDiff, 0.05);
+    return ok;
+}
+
+int main() {
+    cout << "=== Particle memory ===\n"
+         << "  Ion:     double " << sizeof(BasicIon<double>) << " B, float " << sizeof(BasicIon<float>) << " B\n"
+         << "  Neutral: double " << sizeof(BasicNeutral<double>) << " B, float " << sizeof(BasicNeutral<float>) << " B\n";
+
+    bool ok = true;
+    cout << "=== Field sweep ===\n";
+    ok &= check_fields();
+    cout << "=== Ion push and thrust ===\n";
+    ok &= check_push_and_thrust();
+    ok &= check_full_run(3000);
+
+    cout << (ok ? "Float build matches the double build.\n" : "Float build does NOT match the double build.\n");
+    return ok ? 0 : 1;
+}
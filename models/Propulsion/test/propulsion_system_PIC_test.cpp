@@ -1,4 +1,4 @@
-//g++ -Iinclude src/Propulsion_System_PIC2D.cpp src/hall_thruster_PIC2D.cpp test/propulsion_system_PIC_test.cpp -o propulsion_test_PIC -std=c++17 -O2
+//g++ -Iinclude src/Propulsion_System_PIC2D.cpp src/hall_thruster_PIC2D.cpp src/HET_simulation_2D_PIC.cpp src/xenon_tank.cpp ../Recources/src/frame_transforms.cpp ../Recources/src/Linear_Algebra.cpp test/propulsion_system_PIC_test.cpp -o propulsion_test_PIC -std=c++17 -O2
 
 
 #include "../include/Propulsion_System_PIC2D.hh"
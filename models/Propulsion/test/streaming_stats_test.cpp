@@ -0,0 +1,111 @@
+/*
+PURPOSE: (Checks StreamingStats, the bounded-memory summary the PIC engine
+          keeps of its thrust: the Welford mean and variance against the
+          closed form, also on a large offset where the sum of squares
+          loses every digit, the EWMA, min/max, the ring of recent samples
+          before and after it wraps, reset, and the sample stream.)
+COMMANDS:
+    : g++ -O2 src/HET_simulation_2D_PIC.cpp test/streaming_stats_test.cpp -o streaming_stats_program
+*/
+
+#include "../include/HET_simulation_2D_PIC.hh"
+#include "../../Recources/include/test_checks.hh"
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+
+using namespace std;
+
+int main(){
+    bool ok = true;
+
+    {
+        cout << "=== empty and one sample ===\n";
+        StreamingStats stats(4, 0.5);
+        ok &= check("count", stats.count(), 0, 0);
+        ok &= check("variance", stats.variance(), 0.0, 0);
+        ok &= check("recent samples", stats.recentCount(), 0, 0);
+        stats.add(-3.0);
+        ok &= check("mean", stats.mean(), -3.0, 0);
+        ok &= check("variance of one sample", stats.variance(), 0.0, 0);
+        ok &= check("ewma starts at the sample", stats.ewma(), -3.0, 0);
+        ok &= check("min", stats.min(), -3.0, 0);
+        ok &= check("max", stats.max(), -3.0, 0);
+    }
+
+    // 1..10 has mean 5.5 and sample variance 55/6; shifted by 1e9 the squares of the samples
+    // are 1e18 and a sum of squares keeps none of the spread
+    for (double offset : {0.0, 1e9}) {
+        cout << "=== Welford, 1..10 shifted by " << offset << " ===\n";
+        StreamingStats stats;
+        for (int k = 1; k <= 10; k++) stats.add(offset + k);
+        ok &= check("count", stats.count(), 10, 0);
+        ok &= check("mean", stats.mean(), offset + 5.5, 1e-15);
+        ok &= check("variance", stats.variance(), 55.0 / 6.0, 1e-9);
+        ok &= check("stddev", stats.stddev(), sqrt(55.0 / 6.0), 1e-9);
+        ok &= check("last", stats.last(), offset + 10.0, 0);
+    }
+
+    {
+        cout << "=== EWMA, min and max ===\n";
+        StreamingStats stats(8, 0.5);
+        for (double x : {0.0, 1.0, 1.0, -2.0}) stats.add(x);
+        // 0, 0.5, 0.75, then 0.75 + 0.5 (-2 - 0.75)
+        ok &= check("ewma", stats.ewma(), -0.625, 1e-15);
+        ok &= check("min", stats.min(), -2.0, 0);
+        ok &= check("max", stats.max(), 1.0, 0);
+        stats.setEwmaAlpha(0.25);
+        stats.add(1.0);
+        ok &= check("ewma after the weight changes", stats.ewma(), -0.625 + 0.25 * 1.625, 1e-15);
+    }
+
+    {
+        cout << "=== ring of recent samples ===\n";
+        StreamingStats stats(4);
+        stats.add(1.0);
+        stats.add(2.0);
+        ok &= check("held before it fills", stats.recentCount(), 2, 0);
+        ok &= check("oldest", stats.recent(0), 1.0, 0);
+        ok &= check("newest", stats.recent(1), 2.0, 0);
+        for (int k = 3; k <= 6; k++) stats.add(k);
+        ok &= check("held after it wraps", stats.recentCount(), 4, 0);
+        bool window = true;
+        for (int i = 0; i < 4; i++) window &= stats.recent(i) == 3.0 + i;
+        ok &= check_flag("last four samples, oldest first", window);
+        // the summary still covers every sample
+        ok &= check("mean of all six", stats.mean(), 3.5, 1e-15);
+
+        stats.reset();
+        ok &= check("count after reset", stats.count(), 0, 0);
+        ok &= check("held after reset", stats.recentCount(), 0, 0);
+        stats.add(7.0);
+        ok &= check("first sample after reset, mean", stats.mean(), 7.0, 0);
+        ok &= check("first sample after reset, min", stats.min(), 7.0, 0);
+        ok &= check("first sample after reset, recent", stats.recent(0), 7.0, 0);
+    }
+
+    {
+        cout << "=== stream of every third sample ===\n";
+        const char* path = "streaming_stats_test.txt";
+        StreamingStats stats;
+        stats.openStream(path, 3);
+        for (int k = 0; k < 7; k++) stats.add(10.0 * k);
+        stats.closeStream();
+        stats.add(70.0);
+
+        ifstream in(path);
+        long long index;
+        double value;
+        int lines = 0;
+        bool samples = true;
+        while (in >> index >> value) {
+            samples &= index == 3 * lines && value == 30.0 * lines;
+            lines++;
+        }
+        ok &= check("lines written", lines, 3, 0);
+        ok &= check_flag("samples 0, 3 and 6", samples);
+        remove(path);
+    }
+
+    return report(ok);
+}
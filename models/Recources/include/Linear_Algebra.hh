@@ -0,0 +1,848 @@
+/*
+PURPOSE:    This header file defines the small fixed-size vector, matrix
+            and quaternion types used by every model (Vector3d, Matrix3d,
+            Quaterniond, Vector2d, Matrix2d). Everything on the hot path
+            is defined inline here so each model can inline it into its
+            own loops; printing lives in src/Linear_Algebra.cpp, which is
+            built into the Recources library (libresources.a).
+*/
+
+#ifndef LINEAR_ALGEBRA_HH
+#define LINEAR_ALGEBRA_HH
+
+
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <array>
+#include <string>
+#include <type_traits>
+
+// The 3D types below are trivially copyable value types with no padding
+// (24, 72 and 32 bytes) so they can be kept in arrays and moved with plain
+// memory copies. They keep the natural alignment of double: a 32-byte
+// alignment would change how GCC passes them by value and make it note the
+// ABI change at every such call in a portable build. Element
+// access is branch-free; define LINEAR_ALGEBRA_CHECKED to get the old range
+// checks (std::out_of_range) back while debugging.
+//
+// When the target has AVX (e.g. -march=native) matrix expressions are
+// evaluated a row per AVX register, and with AVX2 quaternion expressions one
+// quaternion per register. Operations are done in the same order as the
+// scalar code, so both paths give identical results. Define
+// LINEAR_ALGEBRA_SCALAR to force the scalar code.
+#if defined(__AVX__) && !defined(LINEAR_ALGEBRA_SCALAR)
+#define LINEAR_ALGEBRA_AVX
+#include <immintrin.h>
+#endif
+#if defined(__AVX2__) && !defined(LINEAR_ALGEBRA_SCALAR)
+#define LINEAR_ALGEBRA_AVX2
+#endif
+
+#ifdef LINEAR_ALGEBRA_CHECKED
+#define LINEAR_ALGEBRA_CHECK_INDEX(i, n) \
+    if ((i) < 0 || (i) >= (n)) throw std::out_of_range("Index out of range")
+#else
+#define LINEAR_ALGEBRA_CHECK_INDEX(i, n)
+#endif
+
+#define ORANGE "\033[38;5;208m" //orange color
+#define RESET "\033[0m"
+
+
+using namespace std;
+
+
+//=========================================
+// Expression templates
+//
+// +, -, scalar * and /, matrix-vector and matrix and quaternion products do
+// not compute anything when they are called. They return a small node that
+// refers to its operands, and the whole expression is evaluated element by
+// element when it is assigned to a Vector3d, Matrix3d or Quaterniond. So
+//     pos = refrence + R_matrix*ref_pos;
+// is one loop over x, y, z with no temporary vector in between.
+//
+// Concrete operands are held by reference and nested nodes by value. An
+// operand that a node reads more than once per element (the vector in a
+// matrix-vector product, both sides of a matrix or quaternion product) is
+// evaluated once into a concrete value when the node is built, so nothing is
+// computed twice. Every element is summed in the same order as the old eager
+// operators, so results are bit-identical to them (unless the compiler is
+// allowed to contract a*b + c into a fused multiply-add, see -ffp-contract).
+//
+// Nodes hold references to their operands: assign them to a concrete type
+// (never to auto) before the operands go out of scope.
+
+class Vector3d;
+class Matrix3d;
+class Quaterniond;
+
+template <typename E> class VectorExpr;
+template <typename E> class MatrixExpr;
+template <typename E> class QuaternionExpr;
+template <typename M, typename V> class MatrixVectorProduct;
+template <typename A, typename B> class MatrixProduct;
+template <typename E> class MatrixTranspose;
+template <typename A, typename B> class QuaternionProduct;
+
+// How a node stores an operand it reads once per element
+template <typename E, typename Concrete>
+using ExprRef = typename std::conditional<std::is_same<E, Concrete>::value, const Concrete&, const E>::type;
+
+// How a node stores an operand it reads several times per element
+template <typename E, typename Concrete>
+using ExprValue = typename std::conditional<std::is_same<E, Concrete>::value, const Concrete&, const Concrete>::type;
+
+template <typename E>
+class VectorExpr {
+public:
+    constexpr const E& self() const { return static_cast<const E&>(*this); }
+
+    // Members of Vector3d that also work on an unevaluated expression
+    Vector3d eval() const;
+    double dot(const Vector3d& other) const;
+    Vector3d cross(const Vector3d& other) const;
+    double norm() const;
+    double mag() const;
+    Vector3d normalized() const;
+    double operator()(int index) const { return self()[index]; }
+};
+
+template <typename E>
+class MatrixExpr {
+public:
+    constexpr const E& self() const { return static_cast<const E&>(*this); }
+
+    // Members of Matrix3d that also work on an unevaluated expression
+    Matrix3d eval() const;
+    MatrixTranspose<E> transpose() const;
+    Matrix3d inverse() const;
+    double determinant() const;
+    Vector3d col(int index) const;
+};
+
+template <typename E>
+class QuaternionExpr {
+public:
+    constexpr const E& self() const { return static_cast<const E&>(*this); }
+
+    Quaterniond eval() const;
+    Matrix3d toRotationMatrix() const;
+    Vector3d rotate(const Vector3d& v) const;
+};
+
+
+//=========================================
+class Vector3d : public VectorExpr<Vector3d> {
+public:
+    double x, y, z;
+    // Constructor to initialize the vector
+    constexpr Vector3d(double x = 0.0, double y = 0.0, double z = 0.0) : x(x), y(y), z(z) {}
+
+    // Evaluate a vector expression, one pass over x, y, z. Three lanes are too few to gain from packing
+    // them into an AVX register; the compiler vectorizes the pass itself where that pays off.
+    template <typename E>
+    constexpr Vector3d(const VectorExpr<E>& expr)
+        : x(expr.self()[0]), y(expr.self()[1]), z(expr.self()[2]) {}
+
+    // Overload the << operator for setting vector elements
+    Vector3d& operator<<(const Vector3d& other) {
+        x = other.x;
+        y = other.y;
+        z = other.z;
+        return *this;
+    }
+
+    // Function to insert values for x, y, z
+    void insert(double x_val, double y_val, double z_val) {
+        x = x_val;
+        y = y_val;
+        z = z_val;
+    }
+
+    // Overload the * operator for dot product
+    constexpr double dot(const Vector3d& other) const {
+        return x * other.x + y * other.y + z * other.z;
+    }
+
+    // Cross product
+    // (kept scalar: on a single vector the lane shuffles cost more than the six products)
+    constexpr Vector3d cross(const Vector3d& other) const {
+        return Vector3d(
+            y * other.z - z * other.y,
+            z * other.x - x * other.z,
+            x * other.y - y * other.x
+        );
+    }
+
+    // Magnitude of the vector (Norm)
+    double norm() const {
+        return std::sqrt(x * x + y * y + z * z);
+    }
+
+    // Alternative name for norm() -> magnitude
+    double mag() const {
+        return norm();
+    }
+
+    // Normalize the vector (make the magnitude 1)
+    void normalize() {
+        double len = norm();
+        if (len != 0) {
+            x /= len;
+            y /= len;
+            z /= len;
+        }
+    }
+
+    Vector3d normalized() const {
+        double len = norm();
+        if (len != 0){
+            return Vector3d(x/len, y/len, z/len);
+        }
+        else
+            cerr << ORANGE << "Length Is Zero!!!";
+            return Vector3d(1, 0, 0);
+    }
+
+    // Overload the [] operator for element access
+    // Indexed through a member pointer table, so there is no branch per access
+    double& operator[](int index) {
+        LINEAR_ALGEBRA_CHECK_INDEX(index, 3);
+        return this->*components[index];
+    }
+
+    // Const version of the [] operator for element access
+    constexpr const double& operator[](int index) const {
+        LINEAR_ALGEBRA_CHECK_INDEX(index, 3);
+        return this->*components[index];
+    }
+
+    // Access using () operator
+    constexpr double operator()(int index) const {
+        LINEAR_ALGEBRA_CHECK_INDEX(index, 3);
+        return this->*components[index];
+    }
+
+#ifdef LINEAR_ALGEBRA_AVX
+    // x, y, z in lanes 0-2 and 0 in lane 3. Built from the components rather than one 32-byte load: vectors
+    // are often written by scalar code just before, and a wide load of narrow stores stalls store forwarding.
+    __m256d load() const {
+        return _mm256_set_pd(0.0, z, y, x);
+    }
+
+    static Vector3d store(__m256d v) {
+        alignas(32) double out[4];
+        _mm256_store_pd(out, v);
+        return Vector3d(out[0], out[1], out[2]);
+    }
+#endif
+
+private:
+    static constexpr double Vector3d::* components[3] = {&Vector3d::x, &Vector3d::y, &Vector3d::z};
+};
+
+// Rows of three doubles; with AVX a row is loaded into one register with a zero fourth lane
+class Matrix3d : public MatrixExpr<Matrix3d> {
+private:
+    double mat[3][3];
+
+public:
+    // Constructor to initialize the matrix (default to zero)
+    constexpr Matrix3d(double val = 0.0)
+        : mat{{val, val, val}, {val, val, val}, {val, val, val}} {}
+
+    // Evaluate a matrix expression element by element, or row by row with AVX
+    template <typename E>
+    Matrix3d(const MatrixExpr<E>& expr) : mat{} {
+        for (int i = 0; i < 3; ++i) {
+#ifdef LINEAR_ALGEBRA_AVX
+            store_row(mat[i], expr.self().row(i));
+#else
+            for (int j = 0; j < 3; ++j)
+                mat[i][j] = expr.self()(i, j);
+#endif
+        }
+    }
+
+    // Function to insert values for a 3x3 matrix
+    void insert(double m11, double m12, double m13, 
+                double m21, double m22, double m23, 
+                double m31, double m32, double m33) {
+        mat[0][0] = m11; mat[0][1] = m12; mat[0][2] = m13;
+        mat[1][0] = m21; mat[1][1] = m22; mat[1][2] = m23;
+        mat[2][0] = m31; mat[2][1] = m32; mat[2][2] = m33;
+    }
+
+    // Overload the << operator for copying another matrix
+    Matrix3d& operator<<(const Matrix3d& other) {
+        *this = other;
+        return *this;
+    }
+
+    // Product kernels: result = a * b and this * vec. Both sum in the same order as the element formulas
+    // of MatrixProduct and MatrixVectorProduct, so the AVX and scalar builds agree bit for bit.
+    static void multiply(const Matrix3d& a, const Matrix3d& b, Matrix3d& result) {
+        for (int i = 0; i < 3; ++i) {
+#ifdef LINEAR_ALGEBRA_AVX
+            store_row(result.mat[i], product_row(a, i, b));
+#else
+            for (int j = 0; j < 3; ++j) {
+                result.mat[i][j] = 0;
+                for (int k = 0; k < 3; ++k)
+                    result.mat[i][j] += a.mat[i][k] * b.mat[k][j];
+            }
+#endif
+        }
+    }
+
+    Vector3d multiply(const Vector3d& vec) const {
+#ifdef LINEAR_ALGEBRA_AVX
+        return Vector3d::store(product(row(0), row(1), row(2), vec.load()));
+#else
+        double x = mat[0][0] * vec.x + mat[0][1] * vec.y + mat[0][2] * vec.z;
+        double y = mat[1][0] * vec.x + mat[1][1] * vec.y + mat[1][2] * vec.z;
+        double z = mat[2][0] * vec.x + mat[2][1] * vec.y + mat[2][2] * vec.z;
+        return Vector3d(x, y, z);
+#endif
+    }
+
+#ifdef LINEAR_ALGEBRA_AVX
+    // Row i as one register, lane 3 is zero. Two loads that stay inside the row, so the last row does not
+    // read past the matrix.
+    __m256d row(int i) const {
+        return _mm256_insertf128_pd(_mm256_castpd128_pd256(_mm_loadu_pd(mat[i])), _mm_load_sd(&mat[i][2]), 1);
+    }
+
+    // Lanes 0-2 of v into a row. Split stores rather than a masked one, which is slow on some CPUs.
+    static void store_row(double* out, __m256d v) {
+        _mm_storeu_pd(out, _mm256_castpd256_pd128(v));
+        _mm_store_sd(out + 2, _mm256_extractf128_pd(v, 1));
+    }
+
+    // Row i of a * b is sum_k a[i][k] * (row k of b), accumulated in the scalar order
+    static __m256d product_row(const Matrix3d& a, int i, const Matrix3d& b) {
+        __m256d acc = _mm256_setzero_pd();
+        acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_broadcast_sd(&a.mat[i][0]), b.row(0)));
+        acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_broadcast_sd(&a.mat[i][1]), b.row(1)));
+        acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_broadcast_sd(&a.mat[i][2]), b.row(2)));
+        return acc;
+    }
+
+    // Rows r0..r2 times v: per-row products, then pairwise sums arranged as (m0*x + m1*y) + m2*z
+    static __m256d product(__m256d r0, __m256d r1, __m256d r2, __m256d v) {
+        __m256d a = _mm256_mul_pd(r0, v);
+        __m256d b = _mm256_mul_pd(r1, v);
+        __m256d c = _mm256_mul_pd(r2, v);
+        __m256d ab = _mm256_hadd_pd(a, b);                         // a0+a1, b0+b1, a2+a3, b2+b3
+        __m256d cz = _mm256_hadd_pd(c, _mm256_setzero_pd());       // c0+c1, 0,     c2+c3, 0
+        __m256d lo = _mm256_permute2f128_pd(ab, cz, 0x20);
+        __m256d hi = _mm256_permute2f128_pd(ab, cz, 0x31);
+        return _mm256_add_pd(lo, hi);
+    }
+#endif
+
+    // Matrix inverse (for 3x3 matrix)
+    Matrix3d inverse() const {
+        Matrix3d result;
+        double det = determinant();
+        if (det == 0)
+            throw std::invalid_argument("Matrix is singular and cannot be inverted.");
+
+        result.mat[0][0] = (mat[1][1] * mat[2][2] - mat[1][2] * mat[2][1]) / det;
+        result.mat[0][1] = (mat[0][2] * mat[2][1] - mat[0][1] * mat[2][2]) / det;
+        result.mat[0][2] = (mat[0][1] * mat[1][2] - mat[0][2] * mat[1][1]) / det;
+        result.mat[1][0] = (mat[1][2] * mat[2][0] - mat[1][0] * mat[2][2]) / det;
+        result.mat[1][1] = (mat[0][0] * mat[2][2] - mat[0][2] * mat[2][0]) / det;
+        result.mat[1][2] = (mat[0][2] * mat[1][0] - mat[0][0] * mat[1][2]) / det;
+        result.mat[2][0] = (mat[1][0] * mat[2][1] - mat[1][1] * mat[2][0]) / det;
+        result.mat[2][1] = (mat[0][1] * mat[2][0] - mat[0][0] * mat[2][1]) / det;
+        result.mat[2][2] = (mat[0][0] * mat[1][1] - mat[0][1] * mat[1][0]) / det;
+
+        return result;
+    }
+
+    // Get the determinant of the matrix
+    constexpr double determinant() const {
+        return mat[0][0] * (mat[1][1] * mat[2][2] - mat[1][2] * mat[2][1]) -
+               mat[0][1] * (mat[1][0] * mat[2][2] - mat[1][2] * mat[2][0]) +
+               mat[0][2] * (mat[1][0] * mat[2][1] - mat[1][1] * mat[2][0]);
+    }
+
+    // Extract a specific column
+    constexpr Vector3d col(int index) const {
+        LINEAR_ALGEBRA_CHECK_INDEX(index, 3);
+        return Vector3d(mat[0][index], mat[1][index], mat[2][index]);
+    }
+
+    // Access an element of the matrix
+    constexpr double operator()(int i, int j) const {
+        LINEAR_ALGEBRA_CHECK_INDEX(i, 3);
+        LINEAR_ALGEBRA_CHECK_INDEX(j, 3);
+        return mat[i][j];
+    }
+
+};
+
+class Quaterniond : public QuaternionExpr<Quaterniond> {
+    
+public:
+    // Default constructor
+    double _w, _x, _y, _z;
+
+    constexpr Quaterniond() : _w(1), _x(0), _y(0), _z(0) {}
+
+    // Parameterized constructor to set values
+    constexpr Quaterniond(double w, double x, double y, double z) : _w(w), _x(x), _y(y), _z(z) {}
+
+    // Evaluate a quaternion expression component by component, or as one AVX2 register
+    template <typename E>
+    constexpr Quaterniond(const QuaternionExpr<E>& expr) : _w(1), _x(0), _y(0), _z(0) {
+#ifdef LINEAR_ALGEBRA_AVX2
+        if (!__builtin_is_constant_evaluated()) {
+            _mm256_storeu_pd(&_w, expr.self().load());
+            return;
+        }
+#endif
+        _w = expr.self().w();
+        _x = expr.self().x();
+        _y = expr.self().y();
+        _z = expr.self().z();
+    }
+
+    // Set values together
+    void set(double w_val, double x_val, double y_val, double z_val) {
+        _w = w_val;
+        _x = x_val;
+        _y = y_val;
+        _z = z_val;
+    }
+
+    // Getter functions (const because we don't modify them)
+    constexpr double w() const { return _w; }
+    constexpr double x() const { return _x; }
+    constexpr double y() const { return _y; }
+    constexpr double z() const { return _z; }
+
+    // Setter functions (non-const to allow modification)
+    void w(double w_val) { _w = w_val; }
+    void x(double x_val) { _x = x_val; }
+    void y(double y_val) { _y = y_val; }
+    void z(double z_val) { _z = z_val; }
+
+    // Normalize the quaternion
+    void normalize() {
+        double norm = std::sqrt(_w*_w + _x*_x + _y*_y + _z*_z);
+        if (norm > 0.0) {
+            _w /= norm;
+            _x /= norm;
+            _y /= norm;
+            _z /= norm;
+        } else {
+            throw std::invalid_argument("Cannot normalize a zero quaternion");
+        }
+    }
+
+    // Convert quaternion to rotation matrix
+    Matrix3d toRotationMatrix() const {
+        Matrix3d mat;
+
+        mat.insert(1 - 2*(_y*_y + _z*_z), 2*(_x*_y - _w*_z), 2*(_x*_z + _w*_y),
+              2*(_x*_y + _w*_z), 1 - 2*(_x*_x + _z*_z), 2*(_y*_z - _w*_x),
+              2*(_x*_z - _w*_y), 2*(_y*_z + _w*_x), 1 - 2*(_x*_x + _y*_y));
+
+        return mat;
+    }
+
+    // Rotate a vector by this (unit) quaternion, same result as toRotationMatrix() * v
+    Vector3d rotate(const Vector3d& v) const {
+        return toRotationMatrix().multiply(v);
+    }
+
+    // Hamilton product kernel: returns this * other
+    Quaterniond multiply(const Quaterniond& other) const {
+#ifdef LINEAR_ALGEBRA_AVX2
+        Quaterniond q;
+        _mm256_storeu_pd(&q._w, multiply(other.load()));
+        return q;
+#else
+        return Quaterniond(
+            _w*other._w - _x*other._x - _y*other._y - _z*other._z,
+            _w*other._x + _x*other._w + _y*other._z - _z*other._y,
+            _w*other._y - _x*other._z + _y*other._w + _z*other._x,
+            _w*other._z + _x*other._y - _y*other._x + _z*other._w
+        );
+#endif
+    }
+
+#ifdef LINEAR_ALGEBRA_AVX2
+    __m256d load() const {
+        return _mm256_loadu_pd(&_w);
+    }
+
+    // Column form of the Hamilton product with o = (ow, ox, oy, oz), summed term by term in the scalar order
+    __m256d multiply(__m256d o) const {
+        __m256d t0 = _mm256_mul_pd(_mm256_set1_pd(_w), o);                  // w*(ow, ox, oy, oz)
+        __m256d t1 = _mm256_mul_pd(_mm256_set1_pd(_x),
+                                   _mm256_permute4x64_pd(o, _MM_SHUFFLE(2, 3, 0, 1)));   // x*(ox, ow, oz, oy)
+        __m256d t2 = _mm256_mul_pd(_mm256_set1_pd(_y),
+                                   _mm256_permute4x64_pd(o, _MM_SHUFFLE(1, 0, 3, 2)));   // y*(oy, oz, ow, ox)
+        __m256d t3 = _mm256_mul_pd(_mm256_set1_pd(_z),
+                                   _mm256_permute4x64_pd(o, _MM_SHUFFLE(0, 1, 2, 3)));   // z*(oz, oy, ox, ow)
+        // Sign of each term per output lane; _mm256_set_pd lists the lanes as z, y, x, w
+        const __m256d s1 = _mm256_set_pd(0.0, -0.0, 0.0, -0.0);
+        const __m256d s2 = _mm256_set_pd(-0.0, 0.0, 0.0, -0.0);
+        const __m256d s3 = _mm256_set_pd(0.0, 0.0, -0.0, -0.0);
+        __m256d r = _mm256_add_pd(t0, _mm256_xor_pd(t1, s1));
+        r = _mm256_add_pd(r, _mm256_xor_pd(t2, s2));
+        return _mm256_add_pd(r, _mm256_xor_pd(t3, s3));
+    }
+#endif
+
+    // Print the quaternion for debugging
+    void print() const;
+};
+
+//=========================================
+// Expression nodes
+
+template <typename A, typename B>
+class VectorSum : public VectorExpr<VectorSum<A, B>> {
+    ExprRef<A, Vector3d> a;
+    ExprRef<B, Vector3d> b;
+public:
+    constexpr VectorSum(const A& a, const B& b) : a(a), b(b) {}
+    constexpr double operator[](int i) const { return a[i] + b[i]; }
+};
+
+template <typename A, typename B>
+class VectorDifference : public VectorExpr<VectorDifference<A, B>> {
+    ExprRef<A, Vector3d> a;
+    ExprRef<B, Vector3d> b;
+public:
+    constexpr VectorDifference(const A& a, const B& b) : a(a), b(b) {}
+    constexpr double operator[](int i) const { return a[i] - b[i]; }
+};
+
+template <typename E>
+class VectorScaled : public VectorExpr<VectorScaled<E>> {
+    ExprRef<E, Vector3d> e;
+    double s;
+public:
+    constexpr VectorScaled(const E& e, double s) : e(e), s(s) {}
+    constexpr double operator[](int i) const { return e[i] * s; }
+};
+
+template <typename E>
+class VectorQuotient : public VectorExpr<VectorQuotient<E>> {
+    ExprRef<E, Vector3d> e;
+    double s;
+public:
+    constexpr VectorQuotient(const E& e, double s) : e(e), s(s) {}
+    constexpr double operator[](int i) const { return e[i] / s; }
+};
+
+template <typename M, typename V>
+class MatrixVectorProduct : public VectorExpr<MatrixVectorProduct<M, V>> {
+    ExprRef<M, Matrix3d> m;
+    ExprValue<V, Vector3d> v;
+public:
+    MatrixVectorProduct(const M& m, const V& v) : m(m), v(v) {}
+    double operator[](int i) const { return m(i, 0) * v.x + m(i, 1) * v.y + m(i, 2) * v.z; }
+};
+
+template <typename A, typename B>
+class MatrixSum : public MatrixExpr<MatrixSum<A, B>> {
+    ExprRef<A, Matrix3d> a;
+    ExprRef<B, Matrix3d> b;
+public:
+    MatrixSum(const A& a, const B& b) : a(a), b(b) {}
+    double operator()(int i, int j) const { return a(i, j) + b(i, j); }
+#ifdef LINEAR_ALGEBRA_AVX
+    __m256d row(int i) const { return _mm256_add_pd(a.row(i), b.row(i)); }
+#endif
+};
+
+template <typename A, typename B>
+class MatrixDifference : public MatrixExpr<MatrixDifference<A, B>> {
+    ExprRef<A, Matrix3d> a;
+    ExprRef<B, Matrix3d> b;
+public:
+    MatrixDifference(const A& a, const B& b) : a(a), b(b) {}
+    double operator()(int i, int j) const { return a(i, j) - b(i, j); }
+#ifdef LINEAR_ALGEBRA_AVX
+    __m256d row(int i) const { return _mm256_sub_pd(a.row(i), b.row(i)); }
+#endif
+};
+
+template <typename E>
+class MatrixTranspose : public MatrixExpr<MatrixTranspose<E>> {
+    ExprRef<E, Matrix3d> e;
+public:
+    MatrixTranspose(const E& e) : e(e) {}
+    double operator()(int i, int j) const { return e(j, i); }
+#ifdef LINEAR_ALGEBRA_AVX
+    __m256d row(int i) const { return _mm256_set_pd(0.0, e(2, i), e(1, i), e(0, i)); }
+#endif
+};
+
+template <typename A, typename B>
+class MatrixProduct : public MatrixExpr<MatrixProduct<A, B>> {
+    ExprValue<A, Matrix3d> a;
+    ExprValue<B, Matrix3d> b;
+public:
+    MatrixProduct(const A& a, const B& b) : a(a), b(b) {}
+    double operator()(int i, int j) const {
+        double sum = 0;
+        for (int k = 0; k < 3; ++k)
+            sum += a(i, k) * b(k, j);
+        return sum;
+    }
+#ifdef LINEAR_ALGEBRA_AVX
+    __m256d row(int i) const { return Matrix3d::product_row(a, i, b); }
+#endif
+};
+
+template <typename A, typename B>
+class QuaternionSum : public QuaternionExpr<QuaternionSum<A, B>> {
+    ExprRef<A, Quaterniond> a;
+    ExprRef<B, Quaterniond> b;
+public:
+    constexpr QuaternionSum(const A& a, const B& b) : a(a), b(b) {}
+    constexpr double w() const { return a.w() + b.w(); }
+    constexpr double x() const { return a.x() + b.x(); }
+    constexpr double y() const { return a.y() + b.y(); }
+    constexpr double z() const { return a.z() + b.z(); }
+#ifdef LINEAR_ALGEBRA_AVX2
+    __m256d load() const { return _mm256_add_pd(a.load(), b.load()); }
+#endif
+};
+
+template <typename A, typename B>
+class QuaternionDifference : public QuaternionExpr<QuaternionDifference<A, B>> {
+    ExprRef<A, Quaterniond> a;
+    ExprRef<B, Quaterniond> b;
+public:
+    constexpr QuaternionDifference(const A& a, const B& b) : a(a), b(b) {}
+    constexpr double w() const { return a.w() - b.w(); }
+    constexpr double x() const { return a.x() - b.x(); }
+    constexpr double y() const { return a.y() - b.y(); }
+    constexpr double z() const { return a.z() - b.z(); }
+#ifdef LINEAR_ALGEBRA_AVX2
+    __m256d load() const { return _mm256_sub_pd(a.load(), b.load()); }
+#endif
+};
+
+template <typename E>
+class QuaternionQuotient : public QuaternionExpr<QuaternionQuotient<E>> {
+    ExprRef<E, Quaterniond> e;
+    double s;
+public:
+    constexpr QuaternionQuotient(const E& e, double s) : e(e), s(s) {}
+    constexpr double w() const { return e.w() / s; }
+    constexpr double x() const { return e.x() / s; }
+    constexpr double y() const { return e.y() / s; }
+    constexpr double z() const { return e.z() / s; }
+#ifdef LINEAR_ALGEBRA_AVX2
+    __m256d load() const { return _mm256_div_pd(e.load(), _mm256_set1_pd(s)); }
+#endif
+};
+
+template <typename A, typename B>
+class QuaternionProduct : public QuaternionExpr<QuaternionProduct<A, B>> {
+    ExprValue<A, Quaterniond> p;
+    ExprValue<B, Quaterniond> q;
+public:
+    QuaternionProduct(const A& p, const B& q) : p(p), q(q) {}
+    double w() const { return p._w*q._w - p._x*q._x - p._y*q._y - p._z*q._z; }
+    double x() const { return p._w*q._x + p._x*q._w + p._y*q._z - p._z*q._y; }
+    double y() const { return p._w*q._y - p._x*q._z + p._y*q._w + p._z*q._x; }
+    double z() const { return p._w*q._z + p._x*q._y - p._y*q._x + p._z*q._w; }
+#ifdef LINEAR_ALGEBRA_AVX2
+    __m256d load() const { return p.multiply(q.load()); }
+#endif
+};
+
+
+//=========================================
+// Operators (they only build nodes)
+
+template <typename A, typename B>
+constexpr VectorSum<A, B> operator+(const VectorExpr<A>& a, const VectorExpr<B>& b) {
+    return VectorSum<A, B>(a.self(), b.self());
+}
+
+template <typename A, typename B>
+constexpr VectorDifference<A, B> operator-(const VectorExpr<A>& a, const VectorExpr<B>& b) {
+    return VectorDifference<A, B>(a.self(), b.self());
+}
+
+template <typename E>
+constexpr VectorScaled<E> operator*(const VectorExpr<E>& e, double scalar) {
+    return VectorScaled<E>(e.self(), scalar);
+}
+
+template <typename E>
+constexpr VectorScaled<E> operator*(double scalar, const VectorExpr<E>& e) {
+    return VectorScaled<E>(e.self(), scalar);
+}
+
+template <typename E>
+VectorQuotient<E> operator/(const VectorExpr<E>& e, double scalar) {
+    if (scalar == 0) {
+        throw std::invalid_argument("Division by zero in file " + std::string(__FILE__) + "at line " + std::to_string(__LINE__) + "!!!");
+    }
+    return VectorQuotient<E>(e.self(), scalar);
+}
+
+template <typename M, typename V>
+MatrixVectorProduct<M, V> operator*(const MatrixExpr<M>& m, const VectorExpr<V>& v) {
+    return MatrixVectorProduct<M, V>(m.self(), v.self());
+}
+
+template <typename A, typename B>
+MatrixSum<A, B> operator+(const MatrixExpr<A>& a, const MatrixExpr<B>& b) {
+    return MatrixSum<A, B>(a.self(), b.self());
+}
+
+template <typename A, typename B>
+MatrixDifference<A, B> operator-(const MatrixExpr<A>& a, const MatrixExpr<B>& b) {
+    return MatrixDifference<A, B>(a.self(), b.self());
+}
+
+template <typename A, typename B>
+MatrixProduct<A, B> operator*(const MatrixExpr<A>& a, const MatrixExpr<B>& b) {
+    return MatrixProduct<A, B>(a.self(), b.self());
+}
+
+template <typename A, typename B>
+constexpr QuaternionSum<A, B> operator+(const QuaternionExpr<A>& a, const QuaternionExpr<B>& b) {
+    return QuaternionSum<A, B>(a.self(), b.self());
+}
+
+template <typename A, typename B>
+constexpr QuaternionDifference<A, B> operator-(const QuaternionExpr<A>& a, const QuaternionExpr<B>& b) {
+    return QuaternionDifference<A, B>(a.self(), b.self());
+}
+
+template <typename A, typename B>
+QuaternionProduct<A, B> operator*(const QuaternionExpr<A>& a, const QuaternionExpr<B>& b) {
+    return QuaternionProduct<A, B>(a.self(), b.self());
+}
+
+template <typename E>
+QuaternionQuotient<E> operator/(const QuaternionExpr<E>& e, double scalar) {
+    if (scalar == 0) {
+        throw std::invalid_argument("Cannot divide by zero");
+    }
+    return QuaternionQuotient<E>(e.self(), scalar);
+}
+
+
+//=========================================
+// Out-of-line members that need the complete types
+
+template <typename E> Vector3d VectorExpr<E>::eval() const { return Vector3d(*this); }
+template <typename E> double VectorExpr<E>::dot(const Vector3d& other) const { return eval().dot(other); }
+template <typename E> Vector3d VectorExpr<E>::cross(const Vector3d& other) const { return eval().cross(other); }
+template <typename E> double VectorExpr<E>::norm() const { return eval().norm(); }
+template <typename E> double VectorExpr<E>::mag() const { return eval().norm(); }
+template <typename E> Vector3d VectorExpr<E>::normalized() const { return eval().normalized(); }
+
+template <typename E> Matrix3d MatrixExpr<E>::eval() const { return Matrix3d(*this); }
+template <typename E> MatrixTranspose<E> MatrixExpr<E>::transpose() const { return MatrixTranspose<E>(self()); }
+template <typename E> Matrix3d MatrixExpr<E>::inverse() const { return eval().inverse(); }
+template <typename E> double MatrixExpr<E>::determinant() const { return eval().determinant(); }
+template <typename E> Vector3d MatrixExpr<E>::col(int index) const { return eval().col(index); }
+
+template <typename E> Quaterniond QuaternionExpr<E>::eval() const { return Quaterniond(*this); }
+template <typename E> Matrix3d QuaternionExpr<E>::toRotationMatrix() const { return eval().toRotationMatrix(); }
+template <typename E> Vector3d QuaternionExpr<E>::rotate(const Vector3d& v) const { return eval().rotate(v); }
+
+// Output a vector or matrix using the << operator (defined in Linear_Algebra.cpp)
+std::ostream& operator<<(std::ostream& os, const Vector3d& vec);
+std::ostream& operator<<(std::ostream& os, const Matrix3d& mat);
+
+template <typename E>
+std::ostream& operator<<(std::ostream& os, const VectorExpr<E>& vec) {
+    return os << vec.eval();
+}
+
+template <typename E>
+std::ostream& operator<<(std::ostream& os, const MatrixExpr<E>& mat) {
+    return os << mat.eval();
+}
+
+
+class Vector2d {
+private:
+    std::array<double, 2> values;
+
+public:
+    // Default constructor
+    constexpr Vector2d() : values{0, 0} {}
+
+    // Insert method
+    void insert(double x, double y) {
+        values[0] = x;
+        values[1] = y;
+    }
+
+    // Overload [] operator for element access
+    double& operator[](size_t index) {
+        LINEAR_ALGEBRA_CHECK_INDEX(index, 2u);
+        return values[index];
+    }
+
+    constexpr const double& operator[](size_t index) const {
+        LINEAR_ALGEBRA_CHECK_INDEX(index, 2u);
+        return values[index];
+    }
+
+    // Print method for debugging
+    void print() const;
+};
+
+class Matrix2d {
+private:
+    std::array<std::array<double, 2>, 2> values;
+
+public:
+    // Default constructor
+    constexpr Matrix2d() : values{{{0, 0}, {0, 0}}} {}
+
+    // Insert method
+    void insert(double a11, double a12, double a21, double a22) {
+        values[0][0] = a11;
+        values[0][1] = a12;
+        values[1][0] = a21;
+        values[1][1] = a22;
+    }
+
+    // Overload * operator for Matrix2D * Vector2D
+    Vector2d operator*(const Vector2d& vec) const {
+        Vector2d result;
+        result.insert(
+            values[0][0] * vec[0] + values[0][1] * vec[1],
+            values[1][0] * vec[0] + values[1][1] * vec[1]
+        );
+        return result;
+    }
+
+    // Overload * operator for Vector2D * Matrix2D
+    friend Vector2d operator*(const Vector2d& vec, const Matrix2d& mat) {
+        Vector2d result;
+        result.insert(
+            vec[0] * mat.values[0][0] + vec[1] * mat.values[1][0],
+            vec[0] * mat.values[0][1] + vec[1] * mat.values[1][1]
+        );
+        return result;
+    }
+
+    // Print method for debugging
+    void print() const;
+};
+
+
+#endif
@@ -14,7 +14,7 @@ TERMS USED:
 #ifndef FORCE_TORQUE_TRACKER_HH
 #define FORCE_TORQUE_TRACKER_HH
 
-#include "../src/Linear_Algebra.cpp"
+#include "Linear_Algebra.hh"
 
 //#include "../../../Lib/eigen-3.4.0/Eigen/Dense"
 
@@ -0,0 +1,80 @@
+/*
+PURPOSE:    Central service that moves the mount points of every component
+            attached to the satellite body (thrusters, motors, solar cells)
+            into the global frame. Components used to do this one call at a
+            time, each inverting the rotation matrix again. Here the mounts
+            are registered once and kept as structure of arrays, and one
+            pass per frame transforms all of them.
+
+NOTE:       The results are the same as the per component functions:
+                pos = ref + R * ref_pos
+                ori = R.inverse() * ref_ori
+            evaluated in the same order, only with the inverse computed once.
+            The arrays are padded to a whole number of SIMD blocks, so the
+            pass runs on full vectors with no scalar tail.
+
+TERMS USED:
+    -> mount  - body frame position and direction of one component
+    -> handle - index of a mount, returned when it is registered
+    -> ref    - global position of the satellite center
+*/
+
+#ifndef FRAME_TRANSFORMS_HH
+#define FRAME_TRANSFORMS_HH
+
+#include "Linear_Algebra.hh"
+#include <vector>
+
+#ifdef __cplusplus
+    extern "C"
+    {
+#endif
+
+class frame_transforms {
+    public:
+        //Description: Creates a service with no mounts
+        frame_transforms();
+
+        //Description: Registers a mount and returns its handle
+        int add_mount(const Vector3d& /*reference position*/, const Vector3d& /*reference orientation*/);
+
+        //Description: Changes the body frame position or orientation of a registered mount
+        void set_mount_pos(int /*handle*/, const Vector3d& /*reference position*/);
+        void set_mount_ori(int /*handle*/, const Vector3d& /*reference orientation*/);
+
+        //Description: Moves every mount to the global frame for the new satellite position and rotation matrix
+        void update(const Vector3d& /*satellite position*/, const Matrix3d& /*rotation matrix*/);
+        void update(double[3] /*satellite position*/, double[3][3] /*rotation matrix*/);
+
+        //Description: Global position and orientation of a mount from the last update
+        Vector3d get_pos(int /*handle*/) const;
+        Vector3d get_ori(int /*handle*/) const;
+
+        //Description: Rotation matrix of the last update
+        const Matrix3d& get_R() const;
+
+        //Description: Number of registered mounts
+        int size() const;
+
+    private:
+        //Description: Grows every array to hold the mount count, rounded up to whole SIMD blocks
+        void resize(int /*mount count*/);
+
+        int count;
+
+        //mounts in the body frame
+        std::vector<double> ref_pos_x, ref_pos_y, ref_pos_z;
+        std::vector<double> ref_ori_x, ref_ori_y, ref_ori_z;
+
+        //mounts in the global frame
+        std::vector<double> pos_x, pos_y, pos_z;
+        std::vector<double> ori_x, ori_y, ori_z;
+
+        Matrix3d R_matrix;
+};
+
+#ifdef __cplusplus
+    }
+#endif
+
+#endif
@@ -9,7 +9,7 @@ PURPOSE:    This header file defines a collection of mathematical functions
 #ifndef FUNCTIONS_HH
 #define FUNCTIONS_HH
 
-#include "../src/Linear_Algebra.cpp"
+#include "Linear_Algebra.hh"
 
 //#include "../../../Lib/eigen-3.4.0/Eigen/Dense"
 
@@ -24,6 +24,7 @@ void getUnitDir(const double[3] /*position 1*/, const double[3] /*position 2*/,
 
 // Description: Determines whether a ray intersects with a sphere using 
 //              the sphere's radius, center, ray origin, and direction.
+//              The ray starts at its origin; a sphere behind it is not hit.
 bool collisionRaySphere(double /*radius*/, Vector3d /*sphere center*/, Vector3d /*ray origin*/, Vector3d /*ray direction*/);
 
 // Description: Calculates the unit direction vector between two given vectors.
@@ -0,0 +1,117 @@
+/*
+PURPOSE:    Lookup tables of a quantity over one or two variables, for model
+            data that comes as measured points (battery OCV and resistance
+            over state of charge and temperature, thruster or sensor
+            curves). Tables are read from CSV or binary files at startup so
+            data can be swapped without code edits.
+
+NOTE:       A table is kept on a uniform grid, so a lookup finds its cell
+            with one multiply and is O(1) however many points it holds.
+            Data on uneven breakpoints is resampled onto the grid when the
+            table is set, with the same interpolation the lookups use.
+
+            Methods:
+                INTERP_LINEAR          - linear along x (bilinear with y)
+                INTERP_MONOTONE_CUBIC  - piecewise cubic Hermite along x with
+                                         Fritsch-Carlson slopes (PCHIP),
+                                         linear along y
+            The monotone cubic is smooth and never overshoots the data: a
+            monotone curve stays monotone, flat parts stay flat. Its slopes
+            are computed once when the table is set.
+
+            Lookups outside the grid are clamped to its edges.
+
+            CSV files hold one row per point, after a header row naming the
+            columns. The first one or two columns are the coordinates x (and
+            y); every further column is a table of its own. The points must
+            cover every combination of the x and y values present, in any
+            order. Lines starting with '#' are comments.
+
+            Binary files hold tables as written by write_tables_binary, in
+            the byte order of the machine that wrote them.
+
+TERMS USED:
+    -> x, y      - the variables of the table, y only in two dimensions
+    -> grid      - nx points evenly spaced over x (times ny over y)
+    -> breakpoint - a coordinate value of the data before resampling
+*/
+
+#ifndef INTERP_TABLE_HH
+#define INTERP_TABLE_HH
+
+#include <map>
+#include <string>
+#include <vector>
+
+enum interp_method {
+    INTERP_LINEAR,
+    INTERP_MONOTONE_CUBIC
+};
+
+class interp_table {
+    public:
+        //Description: an empty table; it must be set before it is read
+        interp_table();
+
+        //Description: one dimensional table of values evenly spaced over x0..x1
+        void set_uniform(double /*x0*/, double /*x1*/, const std::vector<double>& /*values*/,
+                         interp_method /*method*/ = INTERP_LINEAR);
+
+        //Description: two dimensional table, values[j * nx + i] at (x_i, y_j), evenly spaced over x0..x1 and y0..y1
+        void set_uniform(double /*x0*/, double /*x1*/, int /*nx*/, double /*y0*/, double /*y1*/, int /*ny*/,
+                         const std::vector<double>& /*values*/, interp_method /*method*/ = INTERP_LINEAR);
+
+        //Description: table from increasing breakpoints (ys may hold one value for one dimension), values[j * xs.size() + i],
+        //             resampled onto nx x ny grid points
+        void set_breakpoints(const std::vector<double>& /*xs*/, const std::vector<double>& /*ys*/,
+                             const std::vector<double>& /*values*/, int /*nx*/, int /*ny*/,
+                             interp_method /*method*/ = INTERP_LINEAR);
+
+        //Description: value at x, and at (x, y); the first form reads the first row of a two dimensional table
+        double get(double /*x*/) const;
+        double get(double /*x*/, double /*y*/) const;
+
+        //Description: n values at once, y may be null for the first row
+        void get(const double* /*x*/, const double* /*y*/, double* /*out*/, int /*n*/) const;
+
+        bool empty() const;
+        int get_nx() const;
+        int get_ny() const;
+        double get_x_min() const;
+        double get_x_max() const;
+        double get_y_min() const;
+        double get_y_max() const;
+        interp_method get_method() const;
+
+        //Description: the grid values, row by row
+        const std::vector<double>& get_values() const;
+
+    private:
+        // Slopes of the cubic along x, per grid step
+        void update_slopes();
+
+        double value_at(double /*x*/, double /*y*/) const;
+
+        double x_min, x_max, y_min, y_max;
+        double dx_inv, dy_inv;
+        int nx, ny;
+        interp_method method;
+        std::vector<double> values;
+        std::vector<double> slopes;
+};
+
+typedef std::map<std::string, interp_table> table_set;
+
+//Description: reads a CSV of points, one table per column after the coordinates (1 or 2 columns),
+//             each resampled onto points_x x points_y grid points (points_y is ignored with one coordinate)
+table_set read_tables_csv(const std::string& /*path*/, int /*coordinates*/, int /*points_x*/, int /*points_y*/,
+                          interp_method /*method*/ = INTERP_LINEAR);
+
+//Description: reads and writes tables in binary form, grid and values as they are
+table_set read_tables_binary(const std::string& /*path*/);
+void write_tables_binary(const std::string& /*path*/, const table_set& /*tables*/);
+
+//Description: slopes of a monotone cubic through (x[k], y[k]), k < n, x increasing; x may be null for x[k] = k
+void pchip_slopes(const double* /*x*/, const double* /*y*/, int /*n*/, double* /*slopes*/);
+
+#endif
@@ -0,0 +1,65 @@
+/*
+PURPOSE:    Runs the models of a vehicle at their own rates inside one
+            frame of the simulation. Each model is a task that advances
+            itself from t by h with its inputs held, and declares how
+            often it runs (every frame or every few frames) and the
+            largest step it can take. Stiff models (motor electrics) are
+            subcycled inside the frame; slow models (body dynamics,
+            propulsion) run every few frames over the whole interval, so
+            neither pays for the rate of the other.
+
+NOTE:       Tasks run in the order they were added, which is the order in
+            which their outputs feed the next one.
+
+            A task with divisor k runs on frames 0, k, 2k, ... and steps
+            over k frames at once, with the inputs it sees at the start of
+            that interval (zero order hold). A task with a largest step
+            splits its step into the fewest equal substeps no longer than
+            it. A largest step of 0 means the task takes its whole step at
+            once.
+
+            The largest step can be changed between frames, for example
+            when a model's stiffness changes.
+
+TERMS USED:
+    -> frame    - one call of run_frame, the step of the vehicle
+    -> divisor  - number of frames a task covers with one step
+    -> substep  - one call of a task inside its step
+*/
+
+#ifndef MULTI_RATE_HH
+#define MULTI_RATE_HH
+
+#include <functional>
+#include <vector>
+
+class multi_rate_scheduler {
+    public:
+        multi_rate_scheduler();
+
+        //Description: adds a task run every divisor frames with steps no longer than max_step (0 for one step); returns its handle
+        int add_task(const std::function<void(double /*t*/, double /*h*/)>& /*step*/, int /*divisor*/ = 1, double /*max_step*/ = 0.0);
+
+        //Description: changes the largest step of a task
+        void set_max_step(int /*task*/, double /*max_step*/);
+
+        //Description: runs every task due in the frame starting at t
+        void run_frame(double /*t*/, double /*frame_dt*/);
+
+        //Description: substeps a task has taken, and frames run
+        long get_substeps(int /*task*/) const;
+        long get_frames() const;
+
+    private:
+        struct task {
+            std::function<void(double, double)> step;
+            int divisor;
+            double max_step;
+            long substeps;
+        };
+
+        std::vector<task> tasks;
+        long frames;
+};
+
+#endif
@@ -0,0 +1,133 @@
+/*
+PURPOSE:    Integrators for models written as dx/dt = f(t, x) on one flat
+            state vector. A model exposes its state as a contiguous array
+            of doubles and its derivative as a function of that array; the
+            integrator owns the work arrays and never needs to know what
+            the entries mean.
+
+NOTE:       Methods:
+                ODE_EULER  - explicit Euler, fixed step (what the sims did by hand)
+                ODE_RK4    - classic fourth order Runge-Kutta, fixed step
+                ODE_RKF45  - Runge-Kutta-Fehlberg 4(5), adaptive
+                ODE_DOPRI5 - Dormand-Prince 5(4), adaptive, the default
+
+            The adaptive methods advance with the fifth order solution and
+            use the embedded fourth order one to estimate the error. The
+            step grows while the estimate is below the tolerance (quiet
+            coast phases) and shrinks when it is not (burns, slews).
+
+            Dense output gives the state at any time inside the last
+            accepted step without extra derivative calls: Dormand-Prince
+            uses its own fourth order interpolant, Fehlberg a cubic Hermite
+            interpolant.
+
+            The derivative of a model must only depend on t and x while a
+            step is taken. Inputs such as forces and torques are held
+            constant over the call to integrate().
+
+TERMS USED:
+    -> n     - number of entries in the state vector
+    -> h     - step size
+    -> rtol  - relative tolerance per entry
+    -> atol  - absolute tolerance per entry
+*/
+
+#ifndef ODE_INTEGRATOR_HH
+#define ODE_INTEGRATOR_HH
+
+#include <vector>
+
+enum ode_method {
+    ODE_EULER,
+    ODE_RK4,
+    ODE_RKF45,
+    ODE_DOPRI5
+};
+
+// A model that can be integrated: a flat state of state_size() doubles and its derivative
+class ode_system {
+    public:
+        virtual ~ode_system() = default;
+
+        //Description: number of doubles in the state vector
+        virtual int state_size() const = 0;
+
+        //Description: writes dx/dt at time t for the state x
+        virtual void state_deriv(double /*t*/, const double* /*x*/, double* /*dxdt*/) = 0;
+};
+
+class ode_integrator {
+    public:
+        //Description: creates an integrator for the chosen method with rtol = 1e-6, atol = 1e-9
+        ode_integrator(ode_method /*method*/ = ODE_DOPRI5);
+
+        //Description: selects the method; the step size estimate is kept
+        void set_method(ode_method /*method*/);
+
+        //Description: error tolerances of the adaptive methods
+        void set_tolerance(double /*rtol*/, double /*atol*/);
+
+        //Description: smallest and largest step; the fixed step methods take steps of h_max in integrate()
+        void set_step_limits(double /*h_min*/, double /*h_max*/);
+
+        //Description: one step of size h with the chosen method, no error control
+        void step(ode_system& /*system*/, double /*t*/, double* /*x*/, double /*h*/);
+
+        //Description: advances x from t to t_end, taking as many steps as the method and tolerance require
+        void integrate(ode_system& /*system*/, double /*t*/, double* /*x*/, double /*t_end*/);
+
+        //Description: advances x from t to t_out[n_out - 1] and writes the state at each output time to x_out (n_out rows)
+        void integrate(ode_system& /*system*/, double /*t*/, double* /*x*/, const double* /*t_out*/, int /*n_out*/, double* /*x_out*/);
+
+        //Description: state at time t inside the last accepted adaptive step (dense output)
+        void interpolate(double /*t*/, double* /*x*/) const;
+
+        //Description: step statistics since construction or the last reset_stats
+        int get_steps_accepted() const;
+        int get_steps_rejected() const;
+        long get_evaluations() const;
+        void reset_stats();
+
+        //Description: step size the adaptive methods will try next
+        double get_step_size() const;
+
+    private:
+        //Description: sizes the work arrays for an n entry state
+        void resize(int /*n*/);
+
+        //Description: one trial step of an adaptive method from (t, x) with derivative k1 already in place; returns the error norm
+        double adaptive_trial(ode_system& /*system*/, double /*t*/, const double* /*x*/, double /*h*/, double* /*x_new*/);
+
+        //Description: first step size guess from the size of the state and its derivative
+        double initial_step(double /*t*/, const double* /*x*/, double /*t_end*/) const;
+
+        //Description: one accepted or rejected adaptive step; returns the time reached
+        double adaptive_step(ode_system& /*system*/, double /*t*/, double* /*x*/, double /*t_end*/);
+
+        //Description: keeps the coefficients of the dense output for the step just accepted
+        void store_dense(double /*t*/, double /*h*/, const double* /*x*/, const double* /*x_new*/);
+
+        ode_method method;
+        double rtol;
+        double atol;
+        double h_min;
+        double h_max;
+        double h_next;      // next adaptive step size, 0 until the first step
+
+        int n;
+        std::vector<double> work;
+        double* k[7];       // stage derivatives
+        double* x_stage;    // state at the current stage
+        double* x_trial;    // state at the end of a trial step
+        double* dense[5];   // dense output coefficients of the last accepted step
+
+        bool k1_valid;      // k[0] holds f(t, x) for the current state (first same as last)
+        double dense_t;     // start of the last accepted step
+        double dense_h;     // size of the last accepted step, 0 if none
+
+        int steps_accepted;
+        int steps_rejected;
+        long evaluations;
+};
+
+#endif
@@ -0,0 +1,48 @@
+/*
+PURPOSE:    Checks shared by the test programs of the models. Each check
+            prints one line, what was checked, the value and what it was
+            held to, marked FAIL when it does not hold, and returns whether
+            it held so a test can collect them in one flag.
+
+NOTE:       A test ends with return report(ok); which prints ALL PASSED or
+            FAILED and gives the exit code.
+
+TERMS USED:
+    -> tol  - tolerance relative to the expected value, absolute below 1
+*/
+
+#ifndef TEST_CHECKS_HH
+#define TEST_CHECKS_HH
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// Description: got is want to within tol
+inline bool check(const char* what, double got, double want, double tol) {
+    bool ok = std::fabs(got - want) <= tol * std::max(1.0, std::fabs(want));
+    std::cout << "  " << what << ": " << got << " (expected " << want << ")" << (ok ? "" : "  FAIL") << "\n";
+    return ok;
+}
+
+// Description: got is no more than limit
+inline bool check_below(const char* what, double got, double limit) {
+    bool ok = got <= limit;
+    std::cout << "  " << what << ": " << got << " (limit " << limit << ")" << (ok ? "" : "  FAIL") << "\n";
+    return ok;
+}
+
+// Description: a yes or no is what it should be
+inline bool check_flag(const char* what, bool got, bool want = true) {
+    bool ok = got == want;
+    std::cout << "  " << what << ": " << (got ? "yes" : "no") << (ok ? "" : "  FAIL") << "\n";
+    return ok;
+}
+
+// Description: prints the outcome of a test; returns its exit code
+inline int report(bool ok) {
+    std::cout << (ok ? "ALL PASSED" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
+
+#endif
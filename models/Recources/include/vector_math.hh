@@ -0,0 +1,253 @@
+/*
+PURPOSE:    This header file defines batch versions of exp, log and sqrt
+            that operate on whole arrays at once. The per-element loops
+            in the plasma and power models call libm one value at a
+            time, which the compiler cannot vectorize. These kernels use
+            range reduction and fixed polynomials written as straight-line
+            arithmetic on fixed-width blocks, so the compiler turns them
+            into SIMD code at the default optimization level.
+
+NOTE:       Header only so that every model that includes it gets the
+            kernels inlined into its own loops. The accuracy is chosen
+            per call:
+                MATH_EXACT - calls the standard library element by element
+                MATH_HIGH  - within a few ulp of libm (about 1e-15 relative)
+                MATH_FAST  - about 1e-7 relative, roughly half the work
+
+            Special values are handled on every accuracy level: exp
+            saturates to 0 and +inf outside the double range, log returns
+            -inf for 0 and NaN for negative input, and NaN propagates.
+            exp flushes results below the smallest normal double to 0.
+
+TERMS USED:
+    -> n - number of elements in the batch
+    -> k - integer power of two removed by range reduction
+    -> r - reduced argument the polynomial is evaluated on
+*/
+
+#ifndef VECTOR_MATH_HH
+#define VECTOR_MATH_HH
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+enum MathAccuracy {
+    MATH_EXACT,
+    MATH_HIGH,
+    MATH_FAST
+};
+
+namespace vector_math {
+
+// One SIMD register of doubles: four lanes when the target has AVX, two (SSE2, always present on x86-64)
+// otherwise. GCC and Clang generate the vector instructions directly, so the kernels below vectorize without
+// intrinsics or -ffast-math. The width never changes the results.
+#ifdef __AVX__
+const std::size_t LANES = 4;
+#else
+const std::size_t LANES = 2;
+#endif
+typedef double        vdouble __attribute__((vector_size(LANES * 8)));
+typedef std::int64_t  vint64  __attribute__((vector_size(LANES * 8)));
+typedef std::uint64_t vuint64 __attribute__((vector_size(LANES * 8)));
+
+// The kernels must inline into the block loop or the vector constants are rebuilt on every call
+#define VECTOR_MATH_INLINE inline __attribute__((always_inline))
+
+const double LOG2E  = 1.4426950408889634;
+const double LN2_HI = 6.93147180369123816490e-01;
+const double LN2_LO = 1.90821492927058770002e-10;
+const double SQRT2  = 1.4142135623730951;
+const double ROUND_MAGIC = 6755399441055744.0;  // 1.5 * 2^52, adding it rounds to the nearest integer
+const double EXP_MAX = 709.782712893384;        // log(DBL_MAX)
+const double EXP_MIN = -708.3964185322641;      // log(DBL_MIN), below it e^x is subnormal
+const double EXP_UNDERFLOW = -745.1332191019412; // below it e^x rounds to 0
+const double DBL_MIN_NORMAL = 2.2250738585072014e-308;
+const double TWO_52 = 4503599627370496.0;
+
+VECTOR_MATH_INLINE vdouble splat(double a) {
+    return a - vdouble{};
+}
+
+VECTOR_MATH_INLINE vuint64 as_bits(vdouble x) {
+    vuint64 u;
+    std::memcpy(&u, &x, sizeof(u));
+    return u;
+}
+
+VECTOR_MATH_INLINE vdouble from_bits(vuint64 u) {
+    vdouble x;
+    std::memcpy(&x, &u, sizeof(x));
+    return x;
+}
+
+VECTOR_MATH_INLINE vdouble select(vint64 mask, vdouble a, vdouble b) {
+    return from_bits((as_bits(a) & (vuint64)mask) | (as_bits(b) & ~(vuint64)mask));
+}
+
+template <bool High>
+VECTOR_MATH_INLINE vdouble exp_kernel(vdouble x)
+    //Description:    Computes e^x for one block with range reduction x = k*ln2 + r and a Taylor polynomial on r.
+    //Preconditions:  None
+    //Postconditions: Returns e^x (subnormal below EXP_MIN), 0 below EXP_UNDERFLOW, +inf above EXP_MAX and NaN for NaN input.
+{
+    vdouble xc = select(x < EXP_UNDERFLOW, splat(EXP_UNDERFLOW), x);
+    xc = select(xc > EXP_MAX, splat(EXP_MAX), xc);
+
+    vdouble t = xc * LOG2E + ROUND_MAGIC;
+    vdouble k = t - ROUND_MAGIC;
+    vint64 ki = (vint64)(as_bits(t) - as_bits(splat(ROUND_MAGIC)));
+
+    vdouble r = (xc - k * LN2_HI) - k * LN2_LO;     // |r| <= ln2 / 2
+
+    vdouble p;
+    if (High) {
+        p = splat(1.0 / 479001600.0);
+        p = p * r + 1.0 / 39916800.0;
+        p = p * r + 1.0 / 3628800.0;
+        p = p * r + 1.0 / 362880.0;
+        p = p * r + 1.0 / 40320.0;
+        p = p * r + 1.0 / 5040.0;
+        p = p * r + 1.0 / 720.0;
+        p = p * r + 1.0 / 120.0;
+        p = p * r + 1.0 / 24.0;
+        p = p * r + 1.0 / 6.0;
+        p = p * r + 0.5;
+    } else {
+        p = splat(1.0 / 720.0);
+        p = p * r + 1.0 / 120.0;
+        p = p * r + 1.0 / 24.0;
+        p = p * r + 1.0 / 6.0;
+        p = p * r + 0.5;
+    }
+    p = p * r * r + r + 1.0;
+
+    // The clamps keep k in [-1075, 1024], outside the normal exponents at both ends, so 2^k is
+    // applied as 2^(k/2) * 2^(k - k/2), both factors normal; the product rounds into the subnormals
+    vint64 k1 = ki >> 1;
+    vdouble y = p * from_bits((vuint64)(k1 + 1023) << 52) * from_bits((vuint64)(ki - k1 + 1023) << 52);
+
+    y = select(x < EXP_UNDERFLOW, splat(0.0), y);
+    y = select(x > EXP_MAX, splat(std::numeric_limits<double>::infinity()), y);
+    return select(x != x, x, y);
+}
+
+template <bool High>
+VECTOR_MATH_INLINE vdouble log_kernel(vdouble x)
+    //Description:    Computes ln(x) for one block by splitting x = m * 2^e with m in [sqrt(2)/2, sqrt(2)) and
+    //                evaluating ln(m) = 2*atanh(f) with f = (m - 1)/(m + 1).
+    //Preconditions:  None
+    //Postconditions: Returns ln(x), -inf for 0, NaN for negative or NaN input and +inf for +inf.
+{
+    // Subnormals are scaled into the normal range first
+    vint64 tiny = x < DBL_MIN_NORMAL;
+    vdouble xs = select(tiny, x * 18014398509481984.0, x);     // 2^54
+
+    vuint64 u = as_bits(xs);
+    vdouble e = from_bits((u >> 52) | as_bits(splat(TWO_52))) - (TWO_52 + 1023.0);   // biased exponent to double
+    e = select(tiny, e - 54.0, e);
+    vdouble m = from_bits((u & 0x000FFFFFFFFFFFFFULL) | 0x3FF0000000000000ULL);
+
+    vint64 big = m > SQRT2;
+    m = select(big, m * 0.5, m);
+    e = select(big, e + 1.0, e);
+
+    vdouble f = (m - 1.0) / (m + 1.0);
+    vdouble s = f * f;
+
+    vdouble p;
+    if (High) {
+        p = splat(1.0 / 19.0);
+        p = p * s + 1.0 / 17.0;
+        p = p * s + 1.0 / 15.0;
+        p = p * s + 1.0 / 13.0;
+        p = p * s + 1.0 / 11.0;
+        p = p * s + 1.0 / 9.0;
+        p = p * s + 1.0 / 7.0;
+        p = p * s + 1.0 / 5.0;
+        p = p * s + 1.0 / 3.0;
+    } else {
+        p = splat(1.0 / 7.0);
+        p = p * s + 1.0 / 5.0;
+        p = p * s + 1.0 / 3.0;
+    }
+
+    vdouble y = e * LN2_HI + (2.0 * f + (2.0 * f * s * p + e * LN2_LO));
+
+    y = select(x == 0.0, splat(-std::numeric_limits<double>::infinity()), y);
+    y = select(x < 0.0, splat(std::numeric_limits<double>::quiet_NaN()), y);
+    y = select(x == std::numeric_limits<double>::infinity(), x, y);
+    return select(x != x, x, y);
+}
+
+template <vdouble (*kernel)(vdouble)>
+inline void apply_blocks(const double* x, double* y, std::size_t n, double pad)
+    //Description:    Runs a block kernel over n values. The last partial block is padded with a harmless value.
+    //Preconditions:  x and y point to at least n doubles. They may be the same array.
+    //Postconditions: y[i] = kernel(x[i]) for every i < n.
+{
+    vdouble v;
+    std::size_t i = 0;
+    for (; i + LANES <= n; i += LANES) {
+        std::memcpy(&v, x + i, sizeof(v));
+        v = kernel(v);
+        std::memcpy(y + i, &v, sizeof(v));
+    }
+    if (i < n) {
+        v = splat(pad);
+        std::memcpy(&v, x + i, (n - i) * sizeof(double));
+        v = kernel(v);
+        std::memcpy(y + i, &v, (n - i) * sizeof(double));
+    }
+}
+
+} // namespace vector_math
+
+inline void vexp(const double* x, double* y, std::size_t n, MathAccuracy acc = MATH_HIGH)
+    //Description:    Computes y[i] = e^x[i] for a batch of n values.
+    //Preconditions:  x and y point to at least n doubles. They may be the same array.
+    //Postconditions: y holds the exponentials at the requested accuracy.
+{
+    using namespace vector_math;
+    if (acc == MATH_EXACT) {
+        for (std::size_t i = 0; i < n; ++i) y[i] = std::exp(x[i]);
+    } else if (acc == MATH_HIGH) {
+        apply_blocks<exp_kernel<true>>(x, y, n, 0.0);
+    } else {
+        apply_blocks<exp_kernel<false>>(x, y, n, 0.0);
+    }
+}
+
+inline void vlog(const double* x, double* y, std::size_t n, MathAccuracy acc = MATH_HIGH)
+    //Description:    Computes y[i] = ln(x[i]) for a batch of n values.
+    //Preconditions:  x and y point to at least n doubles. They may be the same array.
+    //Postconditions: y holds the natural logarithms at the requested accuracy.
+{
+    using namespace vector_math;
+    if (acc == MATH_EXACT) {
+        for (std::size_t i = 0; i < n; ++i) y[i] = std::log(x[i]);
+    } else if (acc == MATH_HIGH) {
+        apply_blocks<log_kernel<true>>(x, y, n, 1.0);
+    } else {
+        apply_blocks<log_kernel<false>>(x, y, n, 1.0);
+    }
+}
+
+inline void vsqrt(const double* x, double* y, std::size_t n, MathAccuracy acc = MATH_HIGH)
+    //Description:    Computes y[i] = sqrt(x[i]) for a batch of n values. Square root is correctly rounded in
+    //                hardware, so every accuracy level returns the libm result; the batch form only removes the
+    //                per-element errno check so the loop can vectorize.
+    //Preconditions:  x and y point to at least n doubles. They may be the same array.
+    //Postconditions: y holds the square roots, NaN for negative input.
+{
+    for (std::size_t i = 0; i < n; ++i) {
+        double v = x[i];
+        y[i] = v >= 0.0 ? __builtin_sqrt(v >= 0.0 ? v : 0.0) : std::numeric_limits<double>::quiet_NaN();
+    }
+    (void)acc;
+}
+
+#endif
@@ -0,0 +1,62 @@
+/*
+PURPOSE:    Runs a batch of independent tasks (simulation cases, sweep
+            points) on every core. Each worker has its own queue of task
+            indices; it takes work from the back of its own queue and,
+            when that is empty, steals from the front of another worker's
+            queue. Long and short cases therefore even out without a
+            central queue every worker contends on.
+
+NOTE:       Tasks are numbered 0 .. n-1 and handed out in contiguous
+            blocks, so neighbouring cases start on the same worker. The
+            task function receives the task index and the index of the
+            worker running it; per-worker scratch data can be kept in an
+            array indexed by the worker.
+
+            A task must not throw. Results are written by the task itself,
+            usually into a slot per task or under a lock.
+
+TERMS USED:
+    -> task   - one independent unit of work, identified by its index
+    -> worker - one thread of the pool
+    -> steal  - taking a task from another worker's queue
+*/
+
+#ifndef WORK_POOL_HH
+#define WORK_POOL_HH
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class work_pool {
+    public:
+        //Description: a pool of the given number of workers; 0 uses every hardware thread
+        explicit work_pool(int /*workers*/ = 0);
+
+        //Description: runs task(index, worker) for every index in [0, n) and returns when all are done
+        void run(int /*n*/, const std::function<void(int /*task*/, int /*worker*/)>& /*task*/);
+
+        //Description: number of worker threads
+        int size() const;
+
+        //Description: tasks taken from another worker's queue during the last run
+        long get_steals() const;
+
+    private:
+        struct queue {
+            std::mutex lock;
+            std::deque<int> tasks;
+        };
+
+        //Description: next task for a worker, its own first and stolen otherwise; false when every queue is empty
+        bool next_task(int /*worker*/, int& /*task*/);
+
+        int workers;
+        std::vector<std::unique_ptr<queue>> queues;
+        long steals;
+        std::mutex steals_lock;
+};
+
+#endif
@@ -0,0 +1,147 @@
+/*
+PURPOSE:    Implementation of the batched frame transform service. See
+            frame_transforms.hh for the formulas and terms.
+*/
+
+#include "../include/frame_transforms.hh"
+#include "../include/vector_math.hh"
+#include <cstring>
+
+using vector_math::LANES;
+using vector_math::vdouble;
+using vector_math::splat;
+
+static inline vdouble load(const double* p) {
+    vdouble v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void store(double* p, vdouble v) {
+    std::memcpy(p, &v, sizeof(v));
+}
+
+frame_transforms::frame_transforms()
+    //Description:    Creates an empty service
+    //Preconditions:  None
+    //Postconditions: No mounts, identity rotation matrix
+{
+    count = 0;
+    R_matrix.insert(1, 0, 0,
+                    0, 1, 0,
+                    0, 0, 1);
+}
+
+void frame_transforms::resize(int n)
+    //Description:    Grows every array to hold n mounts, rounded up to whole SIMD blocks
+    //Preconditions:  n >= count
+    //Postconditions: Padding lanes are zero, so they transform to finite values that are never read
+{
+    size_t padded = (static_cast<size_t>(n) + LANES - 1) / LANES * LANES;
+    for (std::vector<double>* a : {&ref_pos_x, &ref_pos_y, &ref_pos_z, &ref_ori_x, &ref_ori_y, &ref_ori_z,
+                                   &pos_x, &pos_y, &pos_z, &ori_x, &ori_y, &ori_z}) {
+        a->resize(padded, 0.0);
+    }
+    count = n;
+}
+
+int frame_transforms::add_mount(const Vector3d& r_pos, const Vector3d& r_ori)
+    //Description:    Registers a mount; until the next update its global position and orientation are the body frame ones
+    //Preconditions:  None
+    //Postconditions: Returns the handle used to read the mount back
+{
+    int handle = count;
+    resize(count + 1);
+    set_mount_pos(handle, r_pos);
+    set_mount_ori(handle, r_ori);
+    return handle;
+}
+
+void frame_transforms::set_mount_pos(int handle, const Vector3d& r_pos)
+    //Description:    Changes the body frame position of a mount
+    //Preconditions:  handle returned by add_mount
+    //Postconditions: Global position reset to the body frame position until the next update
+{
+    ref_pos_x[handle] = pos_x[handle] = r_pos.x;
+    ref_pos_y[handle] = pos_y[handle] = r_pos.y;
+    ref_pos_z[handle] = pos_z[handle] = r_pos.z;
+}
+
+void frame_transforms::set_mount_ori(int handle, const Vector3d& r_ori)
+    //Description:    Changes the body frame orientation of a mount
+    //Preconditions:  handle returned by add_mount
+    //Postconditions: Global orientation reset to the body frame orientation until the next update
+{
+    ref_ori_x[handle] = ori_x[handle] = r_ori.x;
+    ref_ori_y[handle] = ori_y[handle] = r_ori.y;
+    ref_ori_z[handle] = ori_z[handle] = r_ori.z;
+}
+
+void frame_transforms::update(const Vector3d& ref, const Matrix3d& R)
+    //Description:    Moves every mount to the global frame, one SIMD block of mounts at a time
+    //Preconditions:  R must be invertible
+    //Postconditions: pos = ref + R * ref_pos and ori = R.inverse() * ref_ori for every mount
+{
+    R_matrix = R;
+    Matrix3d R_inv = R.inverse();
+
+    const vdouble cx = splat(ref.x), cy = splat(ref.y), cz = splat(ref.z);
+    const vdouble r00 = splat(R(0, 0)), r01 = splat(R(0, 1)), r02 = splat(R(0, 2));
+    const vdouble r10 = splat(R(1, 0)), r11 = splat(R(1, 1)), r12 = splat(R(1, 2));
+    const vdouble r20 = splat(R(2, 0)), r21 = splat(R(2, 1)), r22 = splat(R(2, 2));
+    const vdouble i00 = splat(R_inv(0, 0)), i01 = splat(R_inv(0, 1)), i02 = splat(R_inv(0, 2));
+    const vdouble i10 = splat(R_inv(1, 0)), i11 = splat(R_inv(1, 1)), i12 = splat(R_inv(1, 2));
+    const vdouble i20 = splat(R_inv(2, 0)), i21 = splat(R_inv(2, 1)), i22 = splat(R_inv(2, 2));
+
+    size_t n = ref_pos_x.size();
+    for (size_t i = 0; i < n; i += LANES) {
+        vdouble px = load(&ref_pos_x[i]), py = load(&ref_pos_y[i]), pz = load(&ref_pos_z[i]);
+        vdouble ox = load(&ref_ori_x[i]), oy = load(&ref_ori_y[i]), oz = load(&ref_ori_z[i]);
+
+        store(&pos_x[i], cx + (r00 * px + r01 * py + r02 * pz));
+        store(&pos_y[i], cy + (r10 * px + r11 * py + r12 * pz));
+        store(&pos_z[i], cz + (r20 * px + r21 * py + r22 * pz));
+
+        store(&ori_x[i], i00 * ox + i01 * oy + i02 * oz);
+        store(&ori_y[i], i10 * ox + i11 * oy + i12 * oz);
+        store(&ori_z[i], i20 * ox + i21 * oy + i22 * oz);
+    }
+}
+
+void frame_transforms::update(double ref[3], double R[3][3])
+    //Description:    Array version of update
+    //Preconditions:  R must be invertible
+    //Postconditions: Same as update(Vector3d, Matrix3d)
+{
+    Matrix3d R_m;
+    R_m.insert(R[0][0], R[0][1], R[0][2],
+               R[1][0], R[1][1], R[1][2],
+               R[2][0], R[2][1], R[2][2]);
+    update(Vector3d(ref[0], ref[1], ref[2]), R_m);
+}
+
+Vector3d frame_transforms::get_pos(int handle) const
+    //Description:    Global position of a mount
+    //Preconditions:  handle returned by add_mount
+    //Postconditions: None
+{
+    return Vector3d(pos_x[handle], pos_y[handle], pos_z[handle]);
+}
+
+Vector3d frame_transforms::get_ori(int handle) const
+    //Description:    Global orientation of a mount
+    //Preconditions:  handle returned by add_mount
+    //Postconditions: None
+{
+    return Vector3d(ori_x[handle], ori_y[handle], ori_z[handle]);
+}
+
+const Matrix3d& frame_transforms::get_R() const
+{
+    return R_matrix;
+}
+
+int frame_transforms::size() const
+{
+    return count;
+}
@@ -0,0 +1,101 @@
+/*
+PURPOSE: (Checks that the batched frame transform gives exactly the values
+          of the per component update_pos_ori formulas for every mount
+          count around the SIMD block size, and times one frame of the
+          batched pass against one call per component.)
+COMMANDS:
+    : g++ -O2 src/frame_transforms.cpp src/Linear_Algebra.cpp src/frame_transforms_test.cpp -o frame_transforms_program
+*/
+
+#include <iostream>
+#include <random>
+#include <chrono>
+#include <vector>
+#include "../include/frame_transforms.hh"
+
+using namespace std;
+
+// What every component did on its own before
+struct component {
+    Vector3d ref_pos, ref_ori, pos, ori;
+    Matrix3d R_matrix;
+
+    void update_pos_ori(Vector3d ref, const Matrix3d& R) {
+        R_matrix = R;
+        pos = ref + R_matrix * ref_pos;
+        ori = R_matrix.inverse() * ref_ori;
+    }
+};
+
+bool same(const Vector3d& a, const Vector3d& b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+int main(){
+    mt19937 gen(11);
+    uniform_real_distribution<double> u(-3.0, 3.0);
+
+    bool ok = true;
+    for (int n = 1; n <= 9; n++) {
+        frame_transforms frames;
+        vector<component> parts(n);
+        vector<int> handle(n);
+        for (int i = 0; i < n; i++) {
+            parts[i].ref_pos = Vector3d(u(gen), u(gen), u(gen));
+            parts[i].ref_ori = Vector3d(u(gen), u(gen), u(gen));
+            handle[i] = frames.add_mount(parts[i].ref_pos, parts[i].ref_ori);
+        }
+        for (int frame = 0; frame < 50; frame++) {
+            Quaterniond q(u(gen), u(gen), u(gen), u(gen));
+            q.normalize();
+            Matrix3d R = q.toRotationMatrix();
+            Vector3d ref(u(gen), u(gen), u(gen));
+
+            frames.update(ref, R);
+            for (int i = 0; i < n; i++) {
+                parts[i].update_pos_ori(ref, R);
+                ok &= same(frames.get_pos(handle[i]), parts[i].pos) && same(frames.get_ori(handle[i]), parts[i].ori);
+            }
+        }
+    }
+    cout << "Batched transform matches update_pos_ori for 1..9 mounts" << (ok ? "  [OK]" : "  [FAIL]") << endl;
+
+    // One frame of a satellite with a few dozen attached components
+    const int n = 48;
+    const int frames_count = 200000;
+    frame_transforms frames;
+    vector<component> parts(n);
+    for (int i = 0; i < n; i++) {
+        parts[i].ref_pos = Vector3d(u(gen), u(gen), u(gen));
+        parts[i].ref_ori = Vector3d(u(gen), u(gen), u(gen));
+        frames.add_mount(parts[i].ref_pos, parts[i].ref_ori);
+    }
+    Quaterniond q(0.9, 0.1, -0.3, 0.2);
+    q.normalize();
+    Matrix3d R = q.toRotationMatrix();
+    Vector3d ref(1.0, 2.0, 3.0);
+    double sink = 0.0;
+
+    auto start = chrono::steady_clock::now();
+    for (int f = 0; f < frames_count; f++) {
+        ref.x += 1e-6;
+        for (int i = 0; i < n; i++) parts[i].update_pos_ori(ref, R);
+        sink += parts[f % n].pos.x;
+    }
+    double t_each = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    for (int f = 0; f < frames_count; f++) {
+        ref.x += 1e-6;
+        frames.update(ref, R);
+        sink += frames.get_pos(f % n).x;
+    }
+    double t_batch = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "=== " << n << " components, ns per frame ===\n"
+         << "  one call per component: " << 1e9 * t_each / frames_count << "\n"
+         << "  batched pass:           " << 1e9 * t_batch / frames_count << "\n"
+         << "  speedup:                " << t_each / t_batch << "\n"
+         << "  (checksum " << sink << ")\n";
+    return ok ? 0 : 1;
+}
@@ -34,14 +34,15 @@ bool collisionRaySphere(double r, Vector3d sphere_cent, Vector3d ray_origin, Vec
     L = ray_origin - sphere_cent;
     double A = ray_dir.dot(ray_dir);
     double B = 2 * L.dot(ray_dir);
-    double C = L.dot(L) - r;
+    double C = L.dot(L) - r * r;
 
     double descriminant = (B*B) - 4*A*C;
 
     bool collide = false;
 
+    //the ray only starts at its origin, so the sphere must not lie wholly behind it
     if(descriminant >= 0.0)
-        collide = true;
+        collide = (-B + sqrt(descriminant)) >= 0.0;
     else
         collide = false;
 
@@ -0,0 +1,419 @@
+/*
+PURPOSE:    This is the implementation of file 'interp_table.hh'
+
+NOTE:       The cubic between grid points k and k + 1 is the Hermite form
+                v = h00 v_k + h10 m_k + h01 v_k+1 + h11 m_k+1
+            with t the position inside the step and the slopes m per grid
+            step, so a lookup needs no division.
+*/
+
+#include "../include/interp_table.hh"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+const char BINARY_MAGIC[4] = {'I', 'T', 'A', 'B'};
+const uint32_t BINARY_VERSION = 1;
+
+// Cubic Hermite on one step of length h with end values and slopes per unit x
+double hermite(double t, double h, double v0, double m0, double v1, double m1)
+{
+    double t2 = t * t, t3 = t2 * t;
+    return (2 * t3 - 3 * t2 + 1) * v0 + (t3 - 2 * t2 + t) * h * m0
+         + (3 * t2 - 2 * t3) * v1 + (t3 - t2) * h * m1;
+}
+
+// Value of the curve through (xs, ys) at x, with slopes for the cubic
+double curve_at(const std::vector<double>& xs, const double* ys, const double* slopes, double x, interp_method method)
+{
+    int n = static_cast<int>(xs.size());
+    int k = static_cast<int>(std::upper_bound(xs.begin(), xs.end(), x) - xs.begin()) - 1;
+    k = std::min(std::max(k, 0), n - 2);
+    double h = xs[k + 1] - xs[k];
+    double t = std::min(std::max((x - xs[k]) / h, 0.0), 1.0);
+    if (method == INTERP_LINEAR) return ys[k] + t * (ys[k + 1] - ys[k]);
+    return hermite(t, h, ys[k], slopes[k], ys[k + 1], slopes[k + 1]);
+}
+
+void check_increasing(const std::vector<double>& v, size_t at_least, const char* what)
+{
+    if (v.size() < at_least) throw std::invalid_argument(std::string("interp_table: too few ") + what + " breakpoints");
+    for (size_t k = 1; k < v.size(); k++)
+        if (!(v[k] > v[k - 1])) throw std::invalid_argument(std::string("interp_table: ") + what + " breakpoints must increase");
+}
+
+std::vector<std::string> split_csv(const std::string& line)
+{
+    std::vector<std::string> fields;
+    std::stringstream ss(line);
+    std::string field;
+    while (std::getline(ss, field, ',')) {
+        size_t first = field.find_first_not_of(" \t\r");
+        size_t last = field.find_last_not_of(" \t\r");
+        fields.push_back(first == std::string::npos ? "" : field.substr(first, last - first + 1));
+    }
+    return fields;
+}
+
+template <typename T>
+void write_raw(std::ofstream& out, const T& value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T read_raw(std::ifstream& in)
+{
+    T value;
+    if (!in.read(reinterpret_cast<char*>(&value), sizeof(T))) throw std::runtime_error("interp_table: binary file ends early");
+    return value;
+}
+}
+
+void pchip_slopes(const double* x, const double* y, int n, double* m)
+    //Description:      Computes Fritsch-Carlson slopes: zero at a local extremum, otherwise a weighted harmonic mean
+    //                  of the neighbouring secants; the end slopes are three point estimates limited to keep the shape.
+    //Preconditions:    n >= 1, x increasing when given.
+    //Postconditions:   The cubic Hermite curve with these slopes is monotone wherever the data is.
+{
+    if (n < 2) {
+        if (n == 1) m[0] = 0.0;
+        return;
+    }
+    auto step = [x](int k) { return x ? x[k + 1] - x[k] : 1.0; };
+    auto secant = [&](int k) { return (y[k + 1] - y[k]) / step(k); };
+    if (n == 2) {
+        m[0] = m[1] = secant(0);
+        return;
+    }
+    for (int k = 1; k < n - 1; k++) {
+        double d0 = secant(k - 1), d1 = secant(k);
+        if (d0 * d1 <= 0) {
+            m[k] = 0.0;
+            continue;
+        }
+        double h0 = step(k - 1), h1 = step(k);
+        double w1 = 2 * h1 + h0, w2 = h1 + 2 * h0;
+        m[k] = (w1 + w2) / (w1 / d0 + w2 / d1);
+    }
+    auto edge = [](double h0, double h1, double d0, double d1) {
+        double s = ((2 * h0 + h1) * d0 - h0 * d1) / (h0 + h1);
+        if (s * d0 <= 0) return 0.0;
+        if (d0 * d1 < 0 && std::fabs(s) > std::fabs(3 * d0)) return 3 * d0;
+        return s;
+    };
+    m[0] = edge(step(0), step(1), secant(0), secant(1));
+    m[n - 1] = edge(step(n - 2), step(n - 3), secant(n - 2), secant(n - 3));
+}
+
+interp_table::interp_table()
+    //Description:      Creates an empty table.
+    //Preconditions:    None
+    //Postconditions:   empty() is true until the table is set.
+    : x_min(0), x_max(0), y_min(0), y_max(0), dx_inv(0), dy_inv(0), nx(0), ny(0), method(INTERP_LINEAR)
+{
+}
+
+void interp_table::set_uniform(double x0, double x1, const std::vector<double>& v, interp_method m)
+    //Description:      Sets a one dimensional table over x0..x1.
+    //Preconditions:    x1 > x0, at least 2 values.
+    //Postconditions:   The table holds the values evenly spaced, first to last.
+{
+    set_uniform(x0, x1, static_cast<int>(v.size()), 0.0, 0.0, 1, v, m);
+}
+
+void interp_table::set_uniform(double x0, double x1, int points_x, double y0, double y1, int points_y,
+                               const std::vector<double>& v, interp_method m)
+    //Description:      Sets a two dimensional table over x0..x1 and y0..y1.
+    //Preconditions:    x1 > x0 and at least 2 points over x; y1 > y0 unless there is 1 point over y;
+    //                  points_x * points_y values.
+    //Postconditions:   The slopes of the cubic are computed.
+{
+    if (points_x < 2 || !(x1 > x0)) throw std::invalid_argument("interp_table: needs x1 > x0 and at least 2 points over x");
+    if (points_y < 1 || (points_y > 1 && !(y1 > y0))) throw std::invalid_argument("interp_table: needs y1 > y0 for more than 1 point over y");
+    if (v.size() != static_cast<size_t>(points_x) * points_y) throw std::invalid_argument("interp_table: number of values does not match the grid");
+    nx = points_x;
+    ny = points_y;
+    x_min = x0;
+    x_max = x1;
+    y_min = y0;
+    y_max = points_y > 1 ? y1 : y0;
+    dx_inv = (nx - 1) / (x1 - x0);
+    dy_inv = ny > 1 ? (ny - 1) / (y1 - y0) : 0.0;
+    method = m;
+    values = v;
+    update_slopes();
+}
+
+void interp_table::set_breakpoints(const std::vector<double>& xs, const std::vector<double>& ys,
+                                   const std::vector<double>& v, int points_x, int points_y, interp_method m)
+    //Description:      Resamples data on increasing breakpoints onto an even grid: along x with the table's method,
+    //                  along y linearly.
+    //Preconditions:    At least 2 x and 1 y breakpoints, both increasing; xs.size() * ys.size() values.
+    //Postconditions:   The grid spans the breakpoints; with one y breakpoint the table is one dimensional.
+{
+    check_increasing(xs, 2, "x");
+    check_increasing(ys, 1, "y");
+    if (v.size() != xs.size() * ys.size()) throw std::invalid_argument("interp_table: number of values does not match the breakpoints");
+    if (points_x < 2 || points_y < 1) throw std::invalid_argument("interp_table: needs at least 2 x 1 grid points");
+    if (ys.size() == 1) points_y = 1;
+    int n_x = static_cast<int>(xs.size()), n_y = static_cast<int>(ys.size());
+
+    // Along x, each breakpoint row onto the grid
+    std::vector<double> rows(static_cast<size_t>(n_y) * points_x);
+    std::vector<double> slope(n_x);
+    for (int j = 0; j < n_y; j++) {
+        const double* row = v.data() + static_cast<size_t>(j) * n_x;
+        pchip_slopes(xs.data(), row, n_x, slope.data());
+        for (int i = 0; i < points_x; i++) {
+            double x = xs.front() + (xs.back() - xs.front()) * i / (points_x - 1);
+            rows[static_cast<size_t>(j) * points_x + i] = curve_at(xs, row, slope.data(), x, m);
+        }
+    }
+
+    // Along y, between the resampled rows
+    std::vector<double> grid(static_cast<size_t>(points_x) * points_y);
+    for (int j = 0; j < points_y; j++) {
+        double y = points_y > 1 ? ys.front() + (ys.back() - ys.front()) * j / (points_y - 1) : ys.front();
+        int k = static_cast<int>(std::upper_bound(ys.begin(), ys.end(), y) - ys.begin()) - 1;
+        k = std::min(std::max(k, 0), std::max(n_y - 2, 0));
+        double s = n_y > 1 ? std::min(std::max((y - ys[k]) / (ys[k + 1] - ys[k]), 0.0), 1.0) : 0.0;
+        for (int i = 0; i < points_x; i++) {
+            double low = rows[static_cast<size_t>(k) * points_x + i];
+            double high = n_y > 1 ? rows[static_cast<size_t>(k + 1) * points_x + i] : low;
+            grid[static_cast<size_t>(j) * points_x + i] = low + s * (high - low);
+        }
+    }
+    set_uniform(xs.front(), xs.back(), points_x, ys.front(), ys.back(), points_y, grid, m);
+}
+
+void interp_table::update_slopes()
+{
+    if (method != INTERP_MONOTONE_CUBIC) {
+        slopes.clear();
+        return;
+    }
+    slopes.resize(values.size());
+    for (int j = 0; j < ny; j++) pchip_slopes(nullptr, values.data() + static_cast<size_t>(j) * nx, nx, slopes.data() + static_cast<size_t>(j) * nx);
+}
+
+double interp_table::value_at(double x, double y) const
+{
+    double fx = (std::min(std::max(x, x_min), x_max) - x_min) * dx_inv;
+    int i = std::min(static_cast<int>(fx), nx - 2);
+    double t = fx - i;
+
+    auto row = [&](int j) {
+        const double* v = values.data() + static_cast<size_t>(j) * nx + i;
+        if (method == INTERP_LINEAR) return v[0] + t * (v[1] - v[0]);
+        const double* m = slopes.data() + static_cast<size_t>(j) * nx + i;
+        return hermite(t, 1.0, v[0], m[0], v[1], m[1]);
+    };
+    if (ny == 1) return row(0);
+
+    double fy = (std::min(std::max(y, y_min), y_max) - y_min) * dy_inv;
+    int j = std::min(static_cast<int>(fy), ny - 2);
+    double s = fy - j;
+    double low = row(j);
+    return low + s * (row(j + 1) - low);
+}
+
+double interp_table::get(double x) const
+    //Description:      Looks up the first row of the table at x.
+    //Preconditions:    The table is set.
+    //Postconditions:   x outside the grid reads the nearest edge.
+{
+    if (nx == 0) throw std::logic_error("interp_table: read before it was set");
+    return value_at(x, y_min);
+}
+
+double interp_table::get(double x, double y) const
+    //Description:      Looks up the table at (x, y).
+    //Preconditions:    The table is set.
+    //Postconditions:   Coordinates outside the grid read the nearest edge.
+{
+    if (nx == 0) throw std::logic_error("interp_table: read before it was set");
+    return value_at(x, y);
+}
+
+void interp_table::get(const double* x, const double* y, double* out, int n) const
+    //Description:      Looks up n points.
+    //Preconditions:    The table is set; the arrays hold n values (y may be null).
+    //Postconditions:   out[k] is the value at (x[k], y[k]).
+{
+    if (nx == 0) throw std::logic_error("interp_table: read before it was set");
+    for (int k = 0; k < n; k++) out[k] = value_at(x[k], y ? y[k] : y_min);
+}
+
+bool interp_table::empty() const
+{
+    return nx == 0;
+}
+
+int interp_table::get_nx() const
+{
+    return nx;
+}
+
+int interp_table::get_ny() const
+{
+    return ny;
+}
+
+double interp_table::get_x_min() const
+{
+    return x_min;
+}
+
+double interp_table::get_x_max() const
+{
+    return x_max;
+}
+
+double interp_table::get_y_min() const
+{
+    return y_min;
+}
+
+double interp_table::get_y_max() const
+{
+    return y_max;
+}
+
+interp_method interp_table::get_method() const
+{
+    return method;
+}
+
+const std::vector<double>& interp_table::get_values() const
+{
+    return values;
+}
+
+table_set read_tables_csv(const std::string& path, int coordinates, int points_x, int points_y, interp_method method)
+    //Description:      Reads a table of points, a header row naming the columns and one row per point.
+    //Preconditions:    coordinates is 1 or 2; the points cover every combination of the coordinate values.
+    //Postconditions:   Returns one table per column after the coordinates, keyed by its header name.
+    //                  Throws std::runtime_error when the file cannot be read or is malformed.
+{
+    if (coordinates != 1 && coordinates != 2) throw std::invalid_argument("read_tables_csv: 1 or 2 coordinate columns");
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("read_tables_csv: cannot open " + path);
+
+    std::vector<std::string> header;
+    std::vector<std::vector<double>> rows;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(in, line)) {
+        line_number++;
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+        std::vector<std::string> fields = split_csv(line);
+        if (header.empty()) {
+            header = fields;
+            if (static_cast<int>(header.size()) <= coordinates) throw std::runtime_error("read_tables_csv: no value columns in " + path);
+            continue;
+        }
+        if (fields.size() != header.size())
+            throw std::runtime_error("read_tables_csv: wrong number of columns on line " + std::to_string(line_number) + " of " + path);
+        std::vector<double> row;
+        for (const std::string& f : fields) {
+            try {
+                row.push_back(std::stod(f));
+            } catch (const std::exception&) {
+                throw std::runtime_error("read_tables_csv: not a number on line " + std::to_string(line_number) + " of " + path);
+            }
+        }
+        rows.push_back(row);
+    }
+    if (rows.empty()) throw std::runtime_error("read_tables_csv: no points in " + path);
+
+    // Breakpoints are the distinct coordinate values
+    std::vector<double> xs, ys;
+    for (const std::vector<double>& r : rows) {
+        xs.push_back(r[0]);
+        ys.push_back(coordinates == 2 ? r[1] : 0.0);
+    }
+    for (std::vector<double>* v : {&xs, &ys}) {
+        std::sort(v->begin(), v->end());
+        v->erase(std::unique(v->begin(), v->end()), v->end());
+    }
+    if (rows.size() != xs.size() * ys.size())
+        throw std::runtime_error("read_tables_csv: the points do not cover a full grid in " + path);
+
+    table_set tables;
+    const double missing = std::numeric_limits<double>::quiet_NaN();
+    for (size_t c = coordinates; c < header.size(); c++) {
+        std::vector<double> v(xs.size() * ys.size(), missing);
+        for (const std::vector<double>& r : rows) {
+            size_t i = std::lower_bound(xs.begin(), xs.end(), r[0]) - xs.begin();
+            size_t j = coordinates == 2 ? std::lower_bound(ys.begin(), ys.end(), r[1]) - ys.begin() : 0;
+            v[j * xs.size() + i] = r[c];
+        }
+        for (double value : v)
+            if (std::isnan(value)) throw std::runtime_error("read_tables_csv: the points do not cover a full grid in " + path);
+        tables[header[c]].set_breakpoints(xs, ys, v, points_x, points_y, method);
+    }
+    return tables;
+}
+
+void write_tables_binary(const std::string& path, const table_set& tables)
+    //Description:      Writes tables with their grids and values.
+    //Preconditions:    Every table is set.
+    //Postconditions:   read_tables_binary gives the same tables back. Throws std::runtime_error when the file
+    //                  cannot be written.
+{
+    std::ofstream out(path, std::ios::binary);
+    if (!out) throw std::runtime_error("write_tables_binary: cannot open " + path);
+    out.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    write_raw(out, BINARY_VERSION);
+    write_raw(out, static_cast<uint32_t>(tables.size()));
+    for (const auto& entry : tables) {
+        const interp_table& t = entry.second;
+        write_raw(out, static_cast<uint32_t>(entry.first.size()));
+        out.write(entry.first.data(), entry.first.size());
+        write_raw(out, static_cast<int32_t>(t.get_method()));
+        write_raw(out, static_cast<int32_t>(t.get_nx()));
+        write_raw(out, static_cast<int32_t>(t.get_ny()));
+        for (double bound : {t.get_x_min(), t.get_x_max(), t.get_y_min(), t.get_y_max()}) write_raw(out, bound);
+        out.write(reinterpret_cast<const char*>(t.get_values().data()), t.get_values().size() * sizeof(double));
+    }
+    if (!out) throw std::runtime_error("write_tables_binary: cannot write " + path);
+}
+
+table_set read_tables_binary(const std::string& path)
+    //Description:      Reads tables written by write_tables_binary.
+    //Preconditions:    None
+    //Postconditions:   Returns the tables by name. Throws std::runtime_error when the file cannot be read or
+    //                  is not a table file.
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in) throw std::runtime_error("read_tables_binary: cannot open " + path);
+    char magic[sizeof(BINARY_MAGIC)];
+    if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), BINARY_MAGIC))
+        throw std::runtime_error("read_tables_binary: not a table file: " + path);
+    if (read_raw<uint32_t>(in) != BINARY_VERSION) throw std::runtime_error("read_tables_binary: unknown version in " + path);
+
+    table_set tables;
+    uint32_t count = read_raw<uint32_t>(in);
+    for (uint32_t k = 0; k < count; k++) {
+        std::string name(read_raw<uint32_t>(in), '\0');
+        if (!in.read(&name[0], name.size())) throw std::runtime_error("read_tables_binary: binary file ends early");
+        interp_method method = static_cast<interp_method>(read_raw<int32_t>(in));
+        int points_x = read_raw<int32_t>(in);
+        int points_y = read_raw<int32_t>(in);
+        double bounds[4];
+        for (double& b : bounds) b = read_raw<double>(in);
+        if (points_x < 2 || points_y < 1) throw std::runtime_error("read_tables_binary: bad grid in " + path);
+        std::vector<double> v(static_cast<size_t>(points_x) * points_y);
+        if (!in.read(reinterpret_cast<char*>(v.data()), v.size() * sizeof(double)))
+            throw std::runtime_error("read_tables_binary: binary file ends early");
+        tables[name].set_uniform(bounds[0], bounds[1], points_x, bounds[2], bounds[3], points_y, v, method);
+    }
+    return tables;
+}
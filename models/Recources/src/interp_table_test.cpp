@@ -0,0 +1,191 @@
+/*
+PURPOSE: (Checks the lookup tables: linear and bilinear data is reproduced
+          exactly, the monotone cubic passes through its points without
+          overshooting a step and converges on a smooth curve, uneven
+          breakpoints are resampled, CSV and binary files give the same
+          tables back and malformed files are refused, and times a lookup
+          for tables of different sizes.)
+COMMANDS:
+    : g++ -O2 src/interp_table.cpp src/interp_table_test.cpp -o interp_table_program
+*/
+
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "../include/interp_table.hh"
+#include "../include/test_checks.hh"
+
+using namespace std;
+
+// A curve with a sharp knee, like the open circuit voltage of a cell near empty
+double knee(double x) {
+    return 3.3 + 0.7 * x - 0.4 * exp(-25 * x);
+}
+
+int main(){
+    bool ok = true;
+
+    {
+        cout << "=== linear data ===\n";
+        interp_table line, plane;
+        vector<double> v1, v2;
+        for (int i = 0; i < 11; i++) v1.push_back(2.0 + 3.0 * i / 10.0);
+        line.set_uniform(0.0, 1.0, v1);
+        for (int j = 0; j < 4; j++)
+            for (int i = 0; i < 11; i++) v2.push_back(1.0 + 2.0 * (i / 10.0) - 0.5 * (j * 10.0) + 0.1 * (i / 10.0) * (j * 10.0));
+        plane.set_uniform(0.0, 1.0, 11, 0.0, 30.0, 4, v2);
+        double worst = 0.0;
+        for (double x = -0.2; x < 1.2; x += 0.013) {
+            double xc = min(max(x, 0.0), 1.0);
+            worst = max(worst, fabs(line.get(x) - (2.0 + 3.0 * xc)));
+            for (double y = 0; y <= 30; y += 2.9)
+                worst = max(worst, fabs(plane.get(x, y) - (1.0 + 2.0 * xc - 0.5 * y + 0.1 * xc * y)));
+        }
+        ok &= check_below("largest error, linear and bilinear, clamped outside", worst, 1e-12);
+    }
+
+    {
+        cout << "=== monotone cubic ===\n";
+        // A step: the cubic must stay inside the data range and keep the flat parts flat
+        vector<double> step = {0, 0, 0, 0, 1, 1, 1, 1};
+        interp_table t;
+        t.set_uniform(0.0, 7.0, step, INTERP_MONOTONE_CUBIC);
+        double lowest = 1, highest = 0, prev = -1;
+        bool monotone = true, flat = true;
+        for (double x = 0; x <= 7.0; x += 0.01) {
+            double v = t.get(x);
+            lowest = min(lowest, v);
+            highest = max(highest, v);
+            monotone = monotone && v >= prev - 1e-15;
+            if (x < 3.0 || x > 4.0) flat = flat && fabs(v - step[static_cast<int>(x)]) < 1e-15;
+            prev = v;
+        }
+        ok &= check_flag("no overshoot", lowest >= 0.0 && highest <= 1.0);
+        ok &= check_flag("monotone", monotone);
+        ok &= check_flag("flat parts stay flat", flat);
+
+        // Through its points and converging on a smooth curve
+        double err[2];
+        for (int level = 0; level < 2; level++) {
+            int n = 65 << level;
+            vector<double> v(n);
+            for (int i = 0; i < n; i++) v[i] = knee(i / double(n - 1));
+            interp_table c;
+            c.set_uniform(0.0, 1.0, v, INTERP_MONOTONE_CUBIC);
+            double through = 0.0;
+            for (int i = 0; i < n; i++) through = max(through, fabs(c.get(i / double(n - 1)) - v[i]));
+            if (level == 0) ok &= check_below("error at the points", through, 1e-14);
+            err[level] = 0.0;
+            for (double x = 0; x <= 1.0; x += 1e-4) err[level] = max(err[level], fabs(c.get(x) - knee(x)));
+        }
+        interp_table lin;
+        vector<double> v(65);
+        for (int i = 0; i < 65; i++) v[i] = knee(i / 64.0);
+        lin.set_uniform(0.0, 1.0, v);
+        double err_lin = 0.0;
+        for (double x = 0; x <= 1.0; x += 1e-4) err_lin = max(err_lin, fabs(lin.get(x) - knee(x)));
+        cout << "  largest error with 65 points: cubic " << err[0] << ", linear " << err_lin << "\n";
+        ok &= check_below("cubic error against linear", err[0], 0.5 * err_lin);
+        ok &= check("order of the cubic", log2(err[0] / err[1]), 3.0, 0.35);
+    }
+
+    {
+        cout << "=== uneven breakpoints, resampled ===\n";
+        // Dense where the curve bends, two temperatures with an offset between them
+        vector<double> xs = {0.0, 0.02, 0.05, 0.1, 0.15, 0.2, 0.3, 0.5, 0.7, 0.9, 1.0}, ys = {273.15, 323.15}, v;
+        for (double y : ys)
+            for (double x : xs) v.push_back(knee(x) - 0.002 * (y - 273.15));
+        interp_table t;
+        t.set_breakpoints(xs, ys, v, 201, 3, INTERP_MONOTONE_CUBIC);
+        double at_points = 0.0, between = 0.0;
+        for (size_t j = 0; j < ys.size(); j++)
+            for (size_t i = 0; i < xs.size(); i++) at_points = max(at_points, fabs(t.get(xs[i], ys[j]) - v[j * xs.size() + i]));
+        for (double x = 0; x <= 1.0; x += 1e-3) between = max(between, fabs(t.get(x, 298.15) - (knee(x) - 0.05)));
+        ok &= check_below("error at the breakpoints", at_points, 2e-3);
+        ok &= check_below("error between them, between the temperatures", between, 5e-3);
+        ok &= check("grid", t.get_nx() * 10 + t.get_ny(), 2013, 0);
+    }
+
+    {
+        cout << "=== files ===\n";
+        {
+            ofstream out("interp_table_test_points.csv");
+            out << "# soc, T, two quantities\nsoc, T, ocv, R0\n";
+            // Rows in any order
+            for (double T : {323.15, 273.15})
+                for (double s : {1.0, 0.0, 0.25, 0.5, 0.75}) out << s << ", " << T << ", " << 3.0 + s + 0.001 * T << ", " << 0.01 + 0.0001 * (323.15 - T) << "\n";
+        }
+        table_set tables = read_tables_csv("interp_table_test_points.csv", 2, 5, 2);
+        ok &= check("tables read", tables.size(), 2, 0);
+        ok &= check("ocv at (0.6, 298.15)", tables["ocv"].get(0.6, 298.15), 3.6 + 0.29815, 1e-12);
+        ok &= check("R0 at (0.6, 273.15)", tables["R0"].get(0.6, 273.15), 0.015, 1e-12);
+
+        write_tables_binary("interp_table_test_tables.bin", tables);
+        table_set back = read_tables_binary("interp_table_test_tables.bin");
+        bool same = back.size() == tables.size();
+        for (auto& entry : tables) same = same && back[entry.first].get_values() == entry.second.get_values()
+                                              && back[entry.first].get(0.33, 300.0) == entry.second.get(0.33, 300.0);
+        ok &= check_flag("binary round trip is exact", same);
+
+        {
+            ofstream out("interp_table_test_points.csv");
+            out << "soc, T, ocv\n0, 273, 3\n1, 273, 4\n0, 323, 3\n";
+        }
+        bool refused = false;
+        try {
+            read_tables_csv("interp_table_test_points.csv", 2, 5, 2);
+        } catch (const runtime_error&) {
+            refused = true;
+        }
+        ok &= check_flag("a grid with a point missing is refused", refused);
+        refused = false;
+        try {
+            read_tables_binary("interp_table_test_points.csv");
+        } catch (const runtime_error&) {
+            refused = true;
+        }
+        ok &= check_flag("a CSV is not read as binary", refused);
+        remove("interp_table_test_points.csv");
+        remove("interp_table_test_tables.bin");
+    }
+
+    {
+        cout << "=== nanoseconds per lookup, two dimensions ===\n"
+             << "    points  linear   cubic\n";
+        mt19937 gen(3);
+        uniform_real_distribution<double> u(0.0, 1.0);
+        const int n = 100000;
+        vector<double> x(n), y(n), out(n);
+        for (int k = 0; k < n; k++) {
+            x[k] = u(gen);
+            y[k] = 273.15 + 50 * u(gen);
+        }
+        for (int nx : {11, 1001, 100001}) {
+            double t_method[2];
+            for (int m = 0; m < 2; m++) {
+                vector<double> v;
+                for (int j = 0; j < 5; j++)
+                    for (int i = 0; i < nx; i++) v.push_back(knee(i / double(nx - 1)) - 0.01 * j);
+                interp_table t;
+                t.set_uniform(0.0, 1.0, nx, 273.15, 323.15, 5, v, m ? INTERP_MONOTONE_CUBIC : INTERP_LINEAR);
+                auto start = chrono::steady_clock::now();
+                const int reps = 20;
+                double sum = 0.0;
+                for (int r = 0; r < reps; r++) {
+                    t.get(x.data(), y.data(), out.data(), n);
+                    sum += out[r];
+                }
+                t_method[m] = chrono::duration<double>(chrono::steady_clock::now() - start).count() / (reps * n);
+                ok &= isfinite(sum);
+            }
+            printf("  %8d  %6.1f  %6.1f\n", nx * 5, 1e9 * t_method[0], 1e9 * t_method[1]);
+        }
+    }
+
+    return report(ok);
+}
@@ -0,0 +1,131 @@
+/*
+PURPOSE:    Benchmarks the Linear_Algebra expression templates against
+            eager operators that build a temporary for every operation
+            (the behaviour before expression templates), on the compound
+            expressions the models evaluate every frame. Also checks that
+            both give identical results.
+COMMANDS:
+    : g++ -O2 -ffp-contract=off src/Linear_Algebra.cpp src/linear_algebra_benchmark.cpp -o linear_algebra_benchmark
+*/
+
+#include "../include/Linear_Algebra.hh"
+#include <chrono>
+#include <random>
+#include <vector>
+
+// One function per operator, each returning a finished value, like the old member operators
+namespace eager {
+    Vector3d add(const Vector3d& a, const Vector3d& b) { return Vector3d(a.x + b.x, a.y + b.y, a.z + b.z); }
+    Vector3d sub(const Vector3d& a, const Vector3d& b) { return Vector3d(a.x - b.x, a.y - b.y, a.z - b.z); }
+    Vector3d scale(const Vector3d& a, double s) { return Vector3d(a.x * s, a.y * s, a.z * s); }
+    Vector3d div(const Vector3d& a, double s) {
+        if (s == 0) throw std::invalid_argument("Division by zero");
+        return Vector3d(a.x / s, a.y / s, a.z / s);
+    }
+    Vector3d mul(const Matrix3d& m, const Vector3d& v) { return m.multiply(v); }
+    Matrix3d mul(const Matrix3d& a, const Matrix3d& b) { Matrix3d r; Matrix3d::multiply(a, b, r); return r; }
+    Matrix3d add(const Matrix3d& a, const Matrix3d& b) {
+        Matrix3d r;
+        r.insert(a(0, 0) + b(0, 0), a(0, 1) + b(0, 1), a(0, 2) + b(0, 2),
+                 a(1, 0) + b(1, 0), a(1, 1) + b(1, 1), a(1, 2) + b(1, 2),
+                 a(2, 0) + b(2, 0), a(2, 1) + b(2, 1), a(2, 2) + b(2, 2));
+        return r;
+    }
+    Quaterniond mul(const Quaterniond& p, const Quaterniond& q) { return p.multiply(q); }
+}
+
+const int N = 4096;
+const int REPS = 400;
+
+template <typename Body>
+double ns_per_item(Body body) {
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < REPS; ++r) body();
+    return 1e9 * chrono::duration<double>(chrono::steady_clock::now() - start).count() / (double(REPS) * N);
+}
+
+void report(const char* name, double t_eager, double t_expr, bool same) {
+    cout << "  " << name << " | eager: " << t_eager << " ns | expression: " << t_expr
+         << " ns | speedup: " << t_eager / t_expr << (same ? "  [OK]" : "  [MISMATCH]") << "\n";
+}
+
+bool same(const vector<Vector3d>& a, const vector<Vector3d>& b) {
+    for (size_t n = 0; n < a.size(); ++n)
+        for (int i = 0; i < 3; ++i)
+            if (a[n][i] != b[n][i]) return false;
+    return true;
+}
+
+bool same(const vector<Matrix3d>& a, const vector<Matrix3d>& b) {
+    for (size_t n = 0; n < a.size(); ++n)
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                if (a[n](i, j) != b[n](i, j)) return false;
+    return true;
+}
+
+bool same(const vector<Quaterniond>& a, const vector<Quaterniond>& b) {
+    for (size_t n = 0; n < a.size(); ++n)
+        if (a[n].w() != b[n].w() || a[n].x() != b[n].x() || a[n].y() != b[n].y() || a[n].z() != b[n].z()) return false;
+    return true;
+}
+
+int main() {
+    mt19937 gen(3);
+    uniform_real_distribution<double> u(-1.0, 1.0);
+
+    vector<Matrix3d> R(N), I(N), I_inv(N);
+    vector<Vector3d> ref(N), ref_pos(N), w(N), T(N), a(N), b(N), c(N);
+    vector<Quaterniond> q(N), r(N), r_inv(N);
+    for (int i = 0; i < N; ++i) {
+        Quaterniond qi(u(gen), u(gen), u(gen), u(gen));
+        qi.normalize();
+        q[i] = qi;
+        r[i] = Quaterniond(qi.w(), qi.x(), -qi.z(), qi.y());
+        r_inv[i] = Quaterniond(qi.w(), -qi.x(), qi.z(), -qi.y());
+        R[i] = qi.toRotationMatrix();
+        I[i].insert(2 + u(gen), 0.1 * u(gen), 0.1 * u(gen), 0.1 * u(gen), 3 + u(gen), 0.1 * u(gen), 0.1 * u(gen), 0.1 * u(gen), 4 + u(gen));
+        I_inv[i] = I[i].inverse();
+        ref[i] = Vector3d(u(gen), u(gen), u(gen));
+        ref_pos[i] = Vector3d(u(gen), u(gen), u(gen));
+        w[i] = Vector3d(u(gen), u(gen), u(gen));
+        T[i] = Vector3d(u(gen), u(gen), u(gen));
+        a[i] = Vector3d(u(gen), u(gen), u(gen));
+        b[i] = Vector3d(u(gen), u(gen), u(gen));
+        c[i] = Vector3d(u(gen), u(gen), u(gen));
+    }
+
+    vector<Vector3d> v_eager(N), v_expr(N);
+    vector<Matrix3d> m_eager(N), m_expr(N);
+    vector<Quaterniond> q_eager(N), q_expr(N);
+    double te, tx;
+
+    cout << "=== Expression templates vs eager operators (" << N << " items) ===\n";
+
+    // motor / solar_cell update_pos
+    te = ns_per_item([&] { for (int i = 0; i < N; ++i) v_eager[i] = eager::add(ref[i], eager::mul(R[i], ref_pos[i])); });
+    tx = ns_per_item([&] { for (int i = 0; i < N; ++i) v_expr[i] = ref[i] + R[i] * ref_pos[i]; });
+    report("ref + R*p            ", te, tx, same(v_eager, v_expr));
+
+    // ridged_body angular acceleration
+    te = ns_per_item([&] { for (int i = 0; i < N; ++i) v_eager[i] = eager::mul(I_inv[i], eager::sub(T[i], w[i].cross(eager::mul(I[i], w[i])))); });
+    tx = ns_per_item([&] { for (int i = 0; i < N; ++i) v_expr[i] = I_inv[i] * (T[i] - w[i].cross(I[i] * w[i])); });
+    report("I^-1 (T - w x Iw)    ", te, tx, same(v_eager, v_expr));
+
+    // Elementwise chain
+    te = ns_per_item([&] { for (int i = 0; i < N; ++i) v_eager[i] = eager::sub(eager::add(eager::scale(a[i], 0.5), eager::scale(b[i], 2.0)), eager::div(c[i], 3.0)); });
+    tx = ns_per_item([&] { for (int i = 0; i < N; ++i) v_expr[i] = a[i] * 0.5 + b[i] * 2.0 - c[i] / 3.0; });
+    report("a*s + b*t - c/u      ", te, tx, same(v_eager, v_expr));
+
+    // Rotated frame with offset
+    te = ns_per_item([&] { for (int i = 0; i < N; ++i) m_eager[i] = eager::add(eager::mul(R[i], I[i]), I_inv[i]); });
+    tx = ns_per_item([&] { for (int i = 0; i < N; ++i) m_expr[i] = R[i] * I[i] + I_inv[i]; });
+    report("R*I + J              ", te, tx, same(m_eager, m_expr));
+
+    // update_QoriByAngle
+    te = ns_per_item([&] { for (int i = 0; i < N; ++i) q_eager[i] = eager::mul(eager::mul(r[i], q[i]), r_inv[i]); });
+    tx = ns_per_item([&] { for (int i = 0; i < N; ++i) q_expr[i] = r[i] * q[i] * r_inv[i]; });
+    report("r*q*r^-1             ", te, tx, same(q_eager, q_expr));
+
+    return 0;
+}
@@ -0,0 +1,112 @@
+/*
+PURPOSE:    Checks the value-type guarantees of Vector3d, Matrix3d and
+            Quaterniond (trivially copyable, unpadded, usable in constant
+            expressions), compares every product against the written-out
+            scalar formula, and times the hot operations.
+COMMANDS:
+    : g++ -O2 -ffp-contract=off src/Linear_Algebra.cpp src/linear_algebra_test.cpp -o linear_algebra_program
+    : g++ -O2 -ffp-contract=off -march=native src/Linear_Algebra.cpp src/linear_algebra_test.cpp -o linear_algebra_program   (AVX paths)
+*/
+
+#include "../include/Linear_Algebra.hh"
+#include <type_traits>
+#include <random>
+#include <chrono>
+#include <vector>
+
+static_assert(std::is_trivially_copyable<Vector3d>::value, "Vector3d must be trivially copyable");
+static_assert(std::is_trivially_copyable<Matrix3d>::value, "Matrix3d must be trivially copyable");
+static_assert(std::is_trivially_copyable<Quaterniond>::value, "Quaterniond must be trivially copyable");
+static_assert(sizeof(Vector3d) == 24 && sizeof(Matrix3d) == 72 && sizeof(Quaterniond) == 32, "no padding");
+
+constexpr Vector3d unit_z = Vector3d(1, 0, 0).cross(Vector3d(0, 1, 0));
+static_assert(unit_z[2] == 1.0 && unit_z.dot(unit_z) == 1.0, "constexpr vector operations");
+static_assert(Matrix3d(2.0)(1, 2) == 2.0, "constexpr matrix access");
+
+bool exact(const char* name, bool ok) {
+    cout << "  " << name << (ok ? "  [OK]" : "  [FAIL]") << "\n";
+    return ok;
+}
+
+int main() {
+#ifdef LINEAR_ALGEBRA_AVX
+    cout << "=== Linear algebra (AVX paths) ===\n";
+#else
+    cout << "=== Linear algebra (scalar paths) ===\n";
+#endif
+    mt19937 gen(7);
+    uniform_real_distribution<double> u(-2.0, 2.0);
+
+    bool mm = true, mv = true, qq = true, idx = true;
+    for (int n = 0; n < 10000; ++n) {
+        double a[3][3], b[3][3];
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j) {
+                a[i][j] = u(gen);
+                b[i][j] = u(gen);
+            }
+        Matrix3d A, B;
+        A.insert(a[0][0], a[0][1], a[0][2], a[1][0], a[1][1], a[1][2], a[2][0], a[2][1], a[2][2]);
+        B.insert(b[0][0], b[0][1], b[0][2], b[1][0], b[1][1], b[1][2], b[2][0], b[2][1], b[2][2]);
+        Vector3d v(u(gen), u(gen), u(gen));
+
+        Matrix3d C = A * B;
+        Vector3d w = A * v;
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                double ref = 0;
+                for (int k = 0; k < 3; ++k) ref += a[i][k] * b[k][j];
+                mm &= (C(i, j) == ref);
+            }
+            mv &= (w[i] == a[i][0] * v.x + a[i][1] * v.y + a[i][2] * v.z);
+        }
+        idx &= (v[0] == v.x && v[1] == v.y && v[2] == v.z && v(2) == v.z);
+
+        Quaterniond p(u(gen), u(gen), u(gen), u(gen)), q(u(gen), u(gen), u(gen), u(gen));
+        Quaterniond r = p * q;
+        qq &= (r.w() == p._w*q._w - p._x*q._x - p._y*q._y - p._z*q._z)
+           && (r.x() == p._w*q._x + p._x*q._w + p._y*q._z - p._z*q._y)
+           && (r.y() == p._w*q._y - p._x*q._z + p._y*q._w + p._z*q._x)
+           && (r.z() == p._w*q._z + p._x*q._y - p._y*q._x + p._z*q._w);
+    }
+
+    bool ok = true;
+    ok &= exact("Matrix3d * Matrix3d matches scalar formula", mm);
+    ok &= exact("Matrix3d * Vector3d matches scalar formula", mv);
+    ok &= exact("Quaterniond * Quaterniond matches scalar formula", qq);
+    ok &= exact("Vector3d [] and () access", idx);
+
+    // Throughput on a batch of attitude-like updates
+    const int N = 4096, reps = 500;
+    vector<Matrix3d> R(N);
+    vector<Vector3d> vin(N), vout(N);
+    vector<Quaterniond> qa(N), qout(N);
+    for (int i = 0; i < N; ++i) {
+        Quaterniond qi(u(gen), u(gen), u(gen), u(gen));
+        qi.normalize();
+        qa[i] = qi;
+        R[i] = qi.toRotationMatrix();
+        vin[i] = Vector3d(u(gen), u(gen), u(gen));
+    }
+
+    auto time_ns = [&](auto body) {
+        auto start = chrono::steady_clock::now();
+        for (int r = 0; r < reps; ++r) body();
+        return 1e9 * chrono::duration<double>(chrono::steady_clock::now() - start).count() / (double(reps) * N);
+    };
+    double t_mv = time_ns([&] { for (int i = 0; i < N; ++i) vout[i] = R[i] * vin[i]; });
+    double t_mm = time_ns([&] { for (int i = 0; i < N; ++i) R[i] = R[i] * R[(i + 1) % N]; });
+    double t_qq = time_ns([&] { for (int i = 0; i < N; ++i) qout[i] = qa[i] * qa[(i + 1) % N]; });
+    double t_cr = time_ns([&] { for (int i = 0; i < N; ++i) vout[i] = vin[i].cross(vout[i]); });
+    double t_ix = time_ns([&] { for (int i = 0; i < N; ++i) vout[i][i % 3] += vin[i][(i + 1) % 3]; });
+
+    cout << "=== Throughput (ns/op) ===\n"
+         << "  R * v:  " << t_mv << "\n"
+         << "  R * R:  " << t_mm << "\n"
+         << "  q * q:  " << t_qq << "\n"
+         << "  cross:  " << t_cr << "\n"
+         << "  v[i]:   " << t_ix << "\n";
+
+    cout << (ok ? "All checks passed.\n" : "Some checks FAILED.\n");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,59 @@
+/*
+PURPOSE:    This is the implementation of file 'multi_rate.hh'
+*/
+
+#include "../include/multi_rate.hh"
+#include <cmath>
+#include <stdexcept>
+
+multi_rate_scheduler::multi_rate_scheduler()
+    : frames(0)
+{
+}
+
+int multi_rate_scheduler::add_task(const std::function<void(double, double)>& step, int divisor, double max_step)
+    //Description:      Adds a task after the tasks added so far.
+    //Preconditions:    divisor >= 1, max_step >= 0.
+    //Postconditions:   The task runs on every frame whose number is a multiple of divisor.
+{
+    if (divisor < 1) throw std::invalid_argument("multi_rate_scheduler: divisor must be at least 1");
+    if (max_step < 0.0) throw std::invalid_argument("multi_rate_scheduler: max_step must not be negative");
+    tasks.push_back({step, divisor, max_step, 0});
+    return static_cast<int>(tasks.size()) - 1;
+}
+
+void multi_rate_scheduler::set_max_step(int task, double max_step)
+    //Description:      Changes the largest step of a task.
+    //Preconditions:    max_step >= 0.
+    //Postconditions:   Used from the next step of the task.
+{
+    if (max_step < 0.0) throw std::invalid_argument("multi_rate_scheduler: max_step must not be negative");
+    tasks.at(task).max_step = max_step;
+}
+
+void multi_rate_scheduler::run_frame(double t, double frame_dt)
+    //Description:      Runs the tasks due in this frame in the order they were added.
+    //Preconditions:    frame_dt > 0.
+    //Postconditions:   A task due steps from t over divisor frames, in equal substeps no longer than its largest step.
+{
+    for (task& tk : tasks) {
+        if (frames % tk.divisor != 0) continue;
+        double h = tk.divisor * frame_dt;
+        int n = 1;
+        if (tk.max_step > 0.0 && h > tk.max_step) n = static_cast<int>(std::ceil(h / tk.max_step * (1.0 - 1e-12)));
+        double sub = h / n;
+        for (int i = 0; i < n; i++) tk.step(t + i * sub, sub);
+        tk.substeps += n;
+    }
+    frames++;
+}
+
+long multi_rate_scheduler::get_substeps(int task) const
+{
+    return tasks.at(task).substeps;
+}
+
+long multi_rate_scheduler::get_frames() const
+{
+    return frames;
+}
@@ -0,0 +1,113 @@
+/*
+PURPOSE: (Checks the multi-rate scheduler: tasks run in the order they
+          were added, a task with a divisor steps once over that many
+          frames, a stiff RL circuit subcycled at its own step stays on
+          the exact exponential where one RK4 step per frame diverges,
+          and times a frame when an expensive slow model runs at the fast
+          rate against at its own rate.)
+COMMANDS:
+    : g++ -O2 src/multi_rate.cpp src/ode_integrator.cpp src/multi_rate_test.cpp -o multi_rate_program
+*/
+
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include "../include/multi_rate.hh"
+#include "../include/ode_integrator.hh"
+#include "../include/test_checks.hh"
+
+using namespace std;
+
+// A motor winding: dI/dt = (V - R I) / L, time constant L / R = 10 ms
+class rl_circuit : public ode_system {
+    public:
+        double V = 10.0, R = 1.0, L = 0.01, I = 0.0;
+
+        int state_size() const override { return 1; }
+        void state_deriv(double, const double* x, double* dxdt) override { dxdt[0] = (V - R * x[0]) / L; }
+
+        void propagate(ode_integrator& integrator, double t, double h) {
+            integrator.integrate(*this, t, &I, t + h);
+        }
+};
+
+// Stands in for a slow model that costs a lot per step (body and thrusters)
+double expensive_step(double t) {
+    double x = 0.0;
+    for (int k = 0; k < 20000; k++) x += sin(k * 1e-4 + t);
+    return x;
+}
+
+int main(){
+    bool ok = true;
+
+    {
+        cout << "=== order and rates ===\n";
+        multi_rate_scheduler scheduler;
+        string order;
+        double slow_t = -1.0, slow_h = 0.0;
+        int fast = scheduler.add_task([&order](double, double) { order += "c"; });
+        scheduler.add_task([&order](double, double) { order += "f"; }, 1, 0.003);
+        int slow = scheduler.add_task([&](double t, double h) { order += "s"; slow_t = t; slow_h = h; }, 4);
+        for (int f = 0; f < 8; f++) scheduler.run_frame(0.01 * f, 0.01);
+        ok &= check("order of the first frame", order.substr(0, 6) == "cffffs", 1, 0);
+        ok &= check("frames", scheduler.get_frames(), 8, 0);
+        ok &= check("steps of the frame task", scheduler.get_substeps(fast), 8, 0);
+        ok &= check("substeps of 10 ms frames with a 3 ms largest step", scheduler.get_substeps(1), 32, 0);
+        ok &= check("steps of the task every 4 frames", scheduler.get_substeps(slow), 2, 0);
+        ok &= check("start of its last step", slow_t, 0.04, 1e-12);
+        ok &= check("its step", slow_h, 0.04, 1e-12);
+
+        bool thrown = false;
+        try { scheduler.add_task([](double, double) {}, 0); } catch (const invalid_argument&) { thrown = true; }
+        ok &= check("divisor 0 refused", thrown, 1, 0);
+    }
+
+    {
+        cout << "=== stiff RL circuit, 100 ms frames ===\n";
+        ode_integrator integrator(ODE_RK4);
+        rl_circuit one, sub;
+        multi_rate_scheduler single, subcycled;
+        single.add_task([&](double t, double h) { one.propagate(integrator, t, h); });
+        subcycled.add_task([&](double t, double h) { sub.propagate(integrator, t, h); }, 1, sub.L / sub.R);
+        for (int f = 0; f < 10; f++) {
+            single.run_frame(0.1 * f, 0.1);
+            subcycled.run_frame(0.1 * f, 0.1);
+        }
+        ok &= check("one step per frame diverges, |I| > 1000 A", fabs(one.I) > 1e3, 1, 0);
+        ok &= check("subcycled current at 1 s", sub.I, 10.0 * (1.0 - exp(-100.0)), 1e-9);
+
+        rl_circuit early;
+        multi_rate_scheduler first;
+        first.add_task([&](double t, double h) { early.propagate(integrator, t, h); }, 1, early.L / early.R);
+        first.run_frame(0.0, 0.05);
+        ok &= check("subcycled current at 5 time constants", early.I, 10.0 * (1.0 - exp(-5.0)), 1e-3);
+    }
+
+    {
+        cout << "=== milliseconds for 1 s of 1 kHz electrics and an expensive slow model ===\n";
+        ode_integrator integrator(ODE_RK4);
+        rl_circuit a, b;
+        double sink = 0.0;
+        multi_rate_scheduler all_fast, multi;
+        all_fast.add_task([&](double t, double h) { a.propagate(integrator, t, h); });
+        all_fast.add_task([&](double t, double) { sink += expensive_step(t); });
+        multi.add_task([&](double t, double h) { b.propagate(integrator, t, h); }, 1, 0.001);
+        multi.add_task([&](double t, double) { sink += expensive_step(t); }, 1);
+
+        auto start = chrono::steady_clock::now();
+        for (int f = 0; f < 1000; f++) all_fast.run_frame(0.001 * f, 0.001);
+        double t_all_fast = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        start = chrono::steady_clock::now();
+        for (int f = 0; f < 40; f++) multi.run_frame(0.025 * f, 0.025);
+        double t_multi = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        ok &= check("same current", b.I, a.I, 1e-9);
+        ok &= isfinite(sink);
+        printf("  everything at 1 kHz              %7.2f\n  40 Hz frames, electrics at 1 kHz %7.2f\n", 1e3 * t_all_fast, 1e3 * t_multi);
+    }
+
+    return report(ok);
+}
@@ -0,0 +1,371 @@
+/*
+PURPOSE:    Implementation of the flat state vector integrators. See
+            ode_integrator.hh for the methods and terms.
+
+NOTE:       Coefficients:
+                Dormand-Prince 5(4) and its dense output - Hairer, Norsett,
+                Wanner, Solving Ordinary Differential Equations I, DOPRI5
+                Fehlberg 4(5) - Fehlberg, NASA TR R-315 (1969)
+*/
+
+#include "../include/ode_integrator.hh"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <algorithm>
+
+using namespace std;
+
+// Dormand-Prince 5(4)
+static const double DP_C2 = 1.0 / 5.0, DP_C3 = 3.0 / 10.0, DP_C4 = 4.0 / 5.0, DP_C5 = 8.0 / 9.0;
+static const double DP_A21 = 1.0 / 5.0;
+static const double DP_A31 = 3.0 / 40.0, DP_A32 = 9.0 / 40.0;
+static const double DP_A41 = 44.0 / 45.0, DP_A42 = -56.0 / 15.0, DP_A43 = 32.0 / 9.0;
+static const double DP_A51 = 19372.0 / 6561.0, DP_A52 = -25360.0 / 2187.0, DP_A53 = 64448.0 / 6561.0, DP_A54 = -212.0 / 729.0;
+static const double DP_A61 = 9017.0 / 3168.0, DP_A62 = -355.0 / 33.0, DP_A63 = 46732.0 / 5247.0, DP_A64 = 49.0 / 176.0, DP_A65 = -5103.0 / 18656.0;
+static const double DP_B1 = 35.0 / 384.0, DP_B3 = 500.0 / 1113.0, DP_B4 = 125.0 / 192.0, DP_B5 = -2187.0 / 6784.0, DP_B6 = 11.0 / 84.0;
+static const double DP_E1 = 71.0 / 57600.0, DP_E3 = -71.0 / 16695.0, DP_E4 = 71.0 / 1920.0, DP_E5 = -17253.0 / 339200.0, DP_E6 = 22.0 / 525.0, DP_E7 = -1.0 / 40.0;
+static const double DP_D1 = -12715105075.0 / 11282082432.0, DP_D3 = 87487479700.0 / 32700410799.0, DP_D4 = -10690763975.0 / 1880347072.0,
+                    DP_D5 = 701980252875.0 / 199316789632.0, DP_D6 = -1453857185.0 / 822651844.0, DP_D7 = 69997945.0 / 29380423.0;
+
+// Fehlberg 4(5), advancing with the fifth order weights
+static const double F_C2 = 1.0 / 4.0, F_C3 = 3.0 / 8.0, F_C4 = 12.0 / 13.0, F_C6 = 1.0 / 2.0;
+static const double F_A21 = 1.0 / 4.0;
+static const double F_A31 = 3.0 / 32.0, F_A32 = 9.0 / 32.0;
+static const double F_A41 = 1932.0 / 2197.0, F_A42 = -7200.0 / 2197.0, F_A43 = 7296.0 / 2197.0;
+static const double F_A51 = 439.0 / 216.0, F_A52 = -8.0, F_A53 = 3680.0 / 513.0, F_A54 = -845.0 / 4104.0;
+static const double F_A61 = -8.0 / 27.0, F_A62 = 2.0, F_A63 = -3544.0 / 2565.0, F_A64 = 1859.0 / 4104.0, F_A65 = -11.0 / 40.0;
+static const double F_B1 = 16.0 / 135.0, F_B3 = 6656.0 / 12825.0, F_B4 = 28561.0 / 56430.0, F_B5 = -9.0 / 50.0, F_B6 = 2.0 / 55.0;
+static const double F_E1 = 1.0 / 360.0, F_E3 = -128.0 / 4275.0, F_E4 = -2197.0 / 75240.0, F_E5 = 1.0 / 50.0, F_E6 = 2.0 / 55.0;
+
+// Step size controller
+static const double SAFETY = 0.9;
+static const double FAC_MIN = 0.2;
+static const double FAC_MAX = 5.0;
+
+ode_integrator::ode_integrator(ode_method m)
+    //Description:    Creates an integrator with default tolerances and no step limits
+    //Preconditions:  None
+    //Postconditions: Work arrays are sized on the first call
+{
+    method = m;
+    rtol = 1e-6;
+    atol = 1e-9;
+    h_min = 0.0;
+    h_max = numeric_limits<double>::infinity();
+    h_next = 0.0;
+    n = 0;
+    k1_valid = false;
+    dense_t = 0.0;
+    dense_h = 0.0;
+    reset_stats();
+}
+
+void ode_integrator::set_method(ode_method m)
+{
+    method = m;
+    k1_valid = false;
+    dense_h = 0.0;
+}
+
+void ode_integrator::set_tolerance(double r, double a)
+    //Description:    Sets the error tolerances of the adaptive methods
+    //Preconditions:  r and a are positive
+    //Postconditions: Steps are accepted when the RMS of err / (atol + rtol*|x|) is at most 1
+{
+    if (r <= 0.0 || a <= 0.0) throw invalid_argument("ode_integrator: tolerances must be positive");
+    rtol = r;
+    atol = a;
+}
+
+void ode_integrator::set_step_limits(double min_step, double max_step)
+    //Description:    Sets the smallest and largest step
+    //Preconditions:  0 <= min_step < max_step
+    //Postconditions: Adaptive steps stay within the limits; fixed step methods take steps of max_step
+{
+    if (min_step < 0.0 || max_step <= min_step) throw invalid_argument("ode_integrator: invalid step limits");
+    h_min = min_step;
+    h_max = max_step;
+    h_next = min(h_next, h_max);
+}
+
+void ode_integrator::resize(int size)
+    //Description:    Sizes the work arrays for a state of the given size
+    //Preconditions:  size > 0
+    //Postconditions: All pointers refer to one contiguous block
+{
+    if (size == n) return;
+    n = size;
+    work.assign(14 * static_cast<size_t>(n), 0.0);
+    double* p = work.data();
+    for (int i = 0; i < 7; i++) k[i] = p + i * n;
+    x_stage = p + 7 * n;
+    x_trial = p + 8 * n;
+    for (int i = 0; i < 5; i++) dense[i] = p + (9 + i) * n;
+    k1_valid = false;
+    dense_h = 0.0;
+}
+
+void ode_integrator::step(ode_system& system, double t, double* x, double h)
+    //Description:    Takes one step of size h with the chosen method
+    //Preconditions:  x holds state_size() values
+    //Postconditions: x is the state at t + h; adaptive methods also update the dense output
+{
+    resize(system.state_size());
+
+    system.state_deriv(t, x, k[0]);
+    evaluations++;
+
+    if (method == ODE_EULER) {
+        for (int i = 0; i < n; i++) x[i] += h * k[0][i];
+    }
+    else if (method == ODE_RK4) {
+        for (int i = 0; i < n; i++) x_stage[i] = x[i] + 0.5 * h * k[0][i];
+        system.state_deriv(t + 0.5 * h, x_stage, k[1]);
+        for (int i = 0; i < n; i++) x_stage[i] = x[i] + 0.5 * h * k[1][i];
+        system.state_deriv(t + 0.5 * h, x_stage, k[2]);
+        for (int i = 0; i < n; i++) x_stage[i] = x[i] + h * k[2][i];
+        system.state_deriv(t + h, x_stage, k[3]);
+        evaluations += 3;
+        for (int i = 0; i < n; i++) x[i] += h / 6.0 * (k[0][i] + 2.0 * k[1][i] + 2.0 * k[2][i] + k[3][i]);
+    }
+    else {
+        adaptive_trial(system, t, x, h, x_trial);
+        if (method == ODE_RKF45) {
+            system.state_deriv(t + h, x_trial, k[6]);
+            evaluations++;
+        }
+        store_dense(t, h, x, x_trial);
+        copy(x_trial, x_trial + n, x);
+    }
+    steps_accepted++;
+    k1_valid = false;
+}
+
+double ode_integrator::adaptive_trial(ode_system& system, double t, const double* x, double h, double* x_new)
+    //Description:    One trial step of the embedded pair; k[0] must hold f(t, x)
+    //Preconditions:  method is ODE_RKF45 or ODE_DOPRI5
+    //Postconditions: x_new holds the fifth order solution; returns the scaled RMS error of the step
+{
+    double** K = k;
+    double err = 0.0;
+
+    if (method == ODE_DOPRI5) {
+        for (int i = 0; i < n; i++) x_stage[i] = x[i] + h * DP_A21 * K[0][i];
+        system.state_deriv(t + DP_C2 * h, x_stage, K[1]);
+        for (int i = 0; i < n; i++) x_stage[i] = x[i] + h * (DP_A31 * K[0][i] + DP_A32 * K[1][i]);
+        system.state_deriv(t + DP_C3 * h, x_stage, K[2]);
+        for (int i = 0; i < n; i++) x_stage[i] = x[i] + h * (DP_A41 * K[0][i] + DP_A42 * K[1][i] + DP_A43 * K[2][i]);
+        system.state_deriv(t + DP_C4 * h, x_stage, K[3]);
+        for (int i = 0; i < n; i++) x_stage[i] = x[i] + h * (DP_A51 * K[0][i] + DP_A52 * K[1][i] + DP_A53 * K[2][i] + DP_A54 * K[3][i]);
+        system.state_deriv(t + DP_C5 * h, x_stage, K[4]);
+        for (int i = 0; i < n; i++) x_stage[i] = x[i] + h * (DP_A61 * K[0][i] + DP_A62 * K[1][i] + DP_A63 * K[2][i] + DP_A64 * K[3][i] + DP_A65 * K[4][i]);
+        system.state_deriv(t + h, x_stage, K[5]);
+        for (int i = 0; i < n; i++) x_new[i] = x[i] + h * (DP_B1 * K[0][i] + DP_B3 * K[2][i] + DP_B4 * K[3][i] + DP_B5 * K[4][i] + DP_B6 * K[5][i]);
+        system.state_deriv(t + h, x_new, K[6]);
+        evaluations += 6;
+
+        for (int i = 0; i < n; i++) {
+            double e = h * (DP_E1 * K[0][i] + DP_E3 * K[2][i] + DP_E4 * K[3][i] + DP_E5 * K[4][i] + DP_E6 * K[5][i] + DP_E7 * K[6][i]);
+            double sc = atol + rtol * max(fabs(x[i]), fabs(x_new[i]));
+            err += (e / sc) * (e / sc);
+        }
+    }
+    else {
+        for (int i = 0; i < n; i++) x_stage[i] = x[i] + h * F_A21 * K[0][i];
+        system.state_deriv(t + F_C2 * h, x_stage, K[1]);
+        for (int i = 0; i < n; i++) x_stage[i] = x[i] + h * (F_A31 * K[0][i] + F_A32 * K[1][i]);
+        system.state_deriv(t + F_C3 * h, x_stage, K[2]);
+        for (int i = 0; i < n; i++) x_stage[i] = x[i] + h * (F_A41 * K[0][i] + F_A42 * K[1][i] + F_A43 * K[2][i]);
+        system.state_deriv(t + F_C4 * h, x_stage, K[3]);
+        for (int i = 0; i < n; i++) x_stage[i] = x[i] + h * (F_A51 * K[0][i] + F_A52 * K[1][i] + F_A53 * K[2][i] + F_A54 * K[3][i]);
+        system.state_deriv(t + h, x_stage, K[4]);
+        for (int i = 0; i < n; i++) x_stage[i] = x[i] + h * (F_A61 * K[0][i] + F_A62 * K[1][i] + F_A63 * K[2][i] + F_A64 * K[3][i] + F_A65 * K[4][i]);
+        system.state_deriv(t + F_C6 * h, x_stage, K[5]);
+        evaluations += 5;
+
+        for (int i = 0; i < n; i++) {
+            x_new[i] = x[i] + h * (F_B1 * K[0][i] + F_B3 * K[2][i] + F_B4 * K[3][i] + F_B5 * K[4][i] + F_B6 * K[5][i]);
+            double e = h * (F_E1 * K[0][i] + F_E3 * K[2][i] + F_E4 * K[3][i] + F_E5 * K[4][i] + F_E6 * K[5][i]);
+            double sc = atol + rtol * max(fabs(x[i]), fabs(x_new[i]));
+            err += (e / sc) * (e / sc);
+        }
+    }
+    return sqrt(err / n);
+}
+
+double ode_integrator::initial_step(double t, const double* x, double t_end) const
+    //Description:    Guesses the first step from the size of the state and its derivative (k[0])
+    //Preconditions:  k[0] holds f(t, x)
+    //Postconditions: Returns a step within the limits and no longer than t_end - t
+{
+    double d0 = 0.0, d1 = 0.0;
+    for (int i = 0; i < n; i++) {
+        double sc = atol + rtol * fabs(x[i]);
+        d0 += (x[i] / sc) * (x[i] / sc);
+        d1 += (k[0][i] / sc) * (k[0][i] / sc);
+    }
+    d0 = sqrt(d0 / n);
+    d1 = sqrt(d1 / n);
+    double h = (d0 < 1e-5 || d1 < 1e-5) ? 1e-6 : 0.01 * d0 / d1;
+    return max(h_min, min({h, h_max, t_end - t}));
+}
+
+double ode_integrator::adaptive_step(ode_system& system, double t, double* x, double t_end)
+    //Description:    Takes one accepted step of an adaptive method, retrying with smaller steps while the error is too large
+    //Preconditions:  t < t_end
+    //Postconditions: x is the state at the returned time; the dense output covers the step
+{
+    if (!k1_valid) {
+        system.state_deriv(t, x, k[0]);
+        evaluations++;
+        k1_valid = true;
+    }
+
+    double h_proposed = (h_next > 0.0) ? min(h_next, h_max) : initial_step(t, x, t_end);
+    double h = h_proposed;
+    bool last = false;
+    if (t + 1.01 * h >= t_end) {
+        h = t_end - t;
+        last = true;
+    }
+
+    while (true) {
+        if (t + h == t) throw runtime_error("ode_integrator: step size underflow");
+        double err = adaptive_trial(system, t, x, h, x_trial);
+
+        if (err <= 1.0) {
+            if (method == ODE_RKF45) {
+                system.state_deriv(t + h, x_trial, k[6]);
+                evaluations++;
+            }
+            store_dense(t, h, x, x_trial);
+            copy(x_trial, x_trial + n, x);
+            swap(k[0], k[6]);   // f at the new point is the first stage of the next step
+
+            double fac = (err == 0.0) ? FAC_MAX : min(FAC_MAX, max(FAC_MIN, SAFETY * pow(err, -0.2)));
+            h_next = min(h_max, h * fac);
+            // A step cut short to land on t_end says nothing about the step the solution allows
+            if (last && h < h_proposed) h_next = max(h_next, h_proposed);
+            steps_accepted++;
+            return last ? t_end : t + h;
+        }
+
+        steps_rejected++;
+        h *= max(FAC_MIN, SAFETY * pow(err, -0.2));
+        last = false;
+        if (h < h_min) throw runtime_error("ode_integrator: required step is below the minimum step size");
+    }
+}
+
+void ode_integrator::store_dense(double t, double h, const double* x, const double* x_new)
+    //Description:    Keeps the interpolation coefficients of an accepted step; k[0] is f at the start, k[6] at the end
+    //Preconditions:  Called before k[0] and k[6] are swapped
+    //Postconditions: interpolate() is valid on [t, t + h]
+{
+    for (int i = 0; i < n; i++) {
+        double diff = x_new[i] - x[i];
+        double b = h * k[0][i] - diff;
+        dense[0][i] = x[i];
+        dense[1][i] = diff;
+        dense[2][i] = b;
+        dense[3][i] = diff - h * k[6][i] - b;
+        // Fehlberg has no fifth coefficient: what remains is the cubic Hermite interpolant
+        dense[4][i] = (method == ODE_DOPRI5)
+            ? h * (DP_D1 * k[0][i] + DP_D3 * k[2][i] + DP_D4 * k[3][i] + DP_D5 * k[4][i] + DP_D6 * k[5][i] + DP_D7 * k[6][i])
+            : 0.0;
+    }
+    dense_t = t;
+    dense_h = h;
+}
+
+void ode_integrator::interpolate(double t, double* x) const
+    //Description:    Evaluates the dense output of the last accepted adaptive step
+    //Preconditions:  t inside the last accepted step
+    //Postconditions: x holds the interpolated state
+{
+    if (dense_h == 0.0) throw logic_error("ode_integrator: no adaptive step to interpolate");
+    double theta = (t - dense_t) / dense_h;
+    if (theta < -1e-12 || theta > 1.0 + 1e-12) throw out_of_range("ode_integrator: time outside the last step");
+    double theta1 = 1.0 - theta;
+    for (int i = 0; i < n; i++) {
+        x[i] = dense[0][i] + theta * (dense[1][i] + theta1 * (dense[2][i] + theta * (dense[3][i] + theta1 * dense[4][i])));
+    }
+}
+
+void ode_integrator::integrate(ode_system& system, double t, double* x, double t_end)
+    //Description:    Advances the state from t to t_end
+    //Preconditions:  t <= t_end; for the fixed step methods a finite h_max must be set or one step is taken
+    //Postconditions: x is the state at t_end
+{
+    resize(system.state_size());
+    if (t_end <= t) return;
+
+    if (method == ODE_EULER || method == ODE_RK4) {
+        int steps = isfinite(h_max) ? max(1, static_cast<int>(ceil((t_end - t) / h_max - 1e-9))) : 1;
+        double h = (t_end - t) / steps;
+        for (int s = 0; s < steps; s++) step(system, t + s * h, x, h);
+        return;
+    }
+
+    // Inputs held by the model may have changed since the last call
+    k1_valid = false;
+    while (t < t_end) t = adaptive_step(system, t, x, t_end);
+}
+
+void ode_integrator::integrate(ode_system& system, double t, double* x, const double* t_out, int n_out, double* x_out)
+    //Description:    Advances the state to the last output time, writing the state at every output time
+    //Preconditions:  t_out is ascending; x_out has room for n_out states
+    //Postconditions: x is the state at t_out[n_out - 1]; the adaptive methods take their own steps and interpolate
+{
+    resize(system.state_size());
+    int j = 0;
+    for (; j < n_out && t_out[j] <= t; j++) copy(x, x + n, x_out + j * n);
+    if (j == n_out) return;
+
+    if (method == ODE_EULER || method == ODE_RK4) {
+        for (; j < n_out; j++) {
+            integrate(system, t, x, t_out[j]);
+            t = t_out[j];
+            copy(x, x + n, x_out + j * n);
+        }
+        return;
+    }
+
+    k1_valid = false;
+    double t_end = t_out[n_out - 1];
+    while (t < t_end) {
+        t = adaptive_step(system, t, x, t_end);
+        for (; j < n_out && t_out[j] <= t; j++) {
+            if (t_out[j] == t) copy(x, x + n, x_out + j * n);
+            else interpolate(t_out[j], x_out + j * n);
+        }
+    }
+}
+
+int ode_integrator::get_steps_accepted() const
+{
+    return steps_accepted;
+}
+
+int ode_integrator::get_steps_rejected() const
+{
+    return steps_rejected;
+}
+
+long ode_integrator::get_evaluations() const
+{
+    return evaluations;
+}
+
+void ode_integrator::reset_stats()
+{
+    steps_accepted = 0;
+    steps_rejected = 0;
+    evaluations = 0;
+}
+
+double ode_integrator::get_step_size() const
+{
+    return h_next;
+}
@@ -0,0 +1,132 @@
+/*
+PURPOSE: (Checks the integrators against problems with known solutions:
+          the order of every method on a harmonic oscillator, the accuracy
+          of the adaptive methods and their dense output on Kepler orbits,
+          and the step count of an adaptive run against fixed step RK4
+          on an eccentric orbit.)
+COMMANDS:
+    : g++ -O2 src/ode_integrator.cpp src/ode_integrator_test.cpp -o ode_integrator_program
+*/
+
+#include <iostream>
+#include <cmath>
+#include <stdexcept>
+#include "../include/ode_integrator.hh"
+
+using namespace std;
+
+// x'' = -x, solution x = cos t, v = -sin t
+class oscillator : public ode_system {
+    public:
+        int state_size() const override { return 2; }
+        void state_deriv(double, const double* x, double* dxdt) override {
+            dxdt[0] = x[1];
+            dxdt[1] = -x[0];
+        }
+};
+
+// Two body problem with mu = 1 in the plane: [x, y, vx, vy]
+class kepler : public ode_system {
+    public:
+        int state_size() const override { return 4; }
+        void state_deriv(double, const double* x, double* dxdt) override {
+            double r = sqrt(x[0] * x[0] + x[1] * x[1]);
+            double r3 = r * r * r;
+            dxdt[0] = x[2];
+            dxdt[1] = x[3];
+            dxdt[2] = -x[0] / r3;
+            dxdt[3] = -x[1] / r3;
+        }
+};
+
+const char* names[] = {"Euler", "RK4", "RKF45", "DOPRI5"};
+
+// Error at t = 1 of fixed steps of size h
+double oscillator_error(ode_method m, int steps) {
+    oscillator sys;
+    ode_integrator integ(m);
+    double x[2] = {1.0, 0.0};
+    double h = 1.0 / steps;
+    for (int s = 0; s < steps; s++) integ.step(sys, s * h, x, h);
+    return hypot(x[0] - cos(1.0), x[1] + sin(1.0));
+}
+
+// Periapsis start of an orbit with semi-major axis 1 and eccentricity e
+void kepler_start(double e, double x[4]) {
+    x[0] = 1.0 - e;
+    x[1] = 0.0;
+    x[2] = 0.0;
+    x[3] = sqrt((1.0 + e) / (1.0 - e));
+}
+
+int main(){
+    bool ok = true;
+    const double PI = 3.14159265358979323846;
+
+    cout << "=== order on x'' = -x (error ratio for h and h/2) ===\n";
+    const double expected[] = {1.0, 4.0, 5.0, 5.0};
+    for (int m = ODE_EULER; m <= ODE_DOPRI5; m++) {
+        double e1 = oscillator_error(static_cast<ode_method>(m), 20);
+        double e2 = oscillator_error(static_cast<ode_method>(m), 40);
+        double order = log2(e1 / e2);
+        bool pass = fabs(order - expected[m]) < 0.3;
+        ok &= pass;
+        cout << "  " << names[m] << ": error " << e2 << ", order " << order << (pass ? "" : "  FAIL") << "\n";
+    }
+
+    cout << "=== circular orbit, dense output at 200 times over one period ===\n";
+    for (ode_method m : {ODE_RKF45, ODE_DOPRI5}) {
+        kepler sys;
+        ode_integrator integ(m);
+        integ.set_tolerance(1e-10, 1e-12);
+        const int n_out = 200;
+        double t_out[n_out], x_out[4 * n_out];
+        for (int j = 0; j < n_out; j++) t_out[j] = 2.0 * PI * (j + 1) / n_out;
+        double x[4];
+        kepler_start(0.0, x);
+        integ.integrate(sys, 0.0, x, t_out, n_out, x_out);
+
+        double err = 0.0;
+        for (int j = 0; j < n_out; j++) {
+            err = max(err, hypot(x_out[4 * j] - cos(t_out[j]), x_out[4 * j + 1] - sin(t_out[j])));
+        }
+        bool pass = err < 1e-7 && x_out[4 * (n_out - 1)] == x[0];
+        ok &= pass;
+        cout << "  " << names[m] << ": " << integ.get_steps_accepted() << " steps, max position error " << err
+             << (pass ? "" : "  FAIL") << "\n";
+
+        bool thrown = false;
+        try { integ.interpolate(-1.0, x); }
+        catch (const out_of_range&) { thrown = true; }
+        ok &= thrown;
+    }
+
+    cout << "=== orbit with e = 0.9, one period ===\n";
+    {
+        kepler sys;
+        double x0[4], x[4];
+        kepler_start(0.9, x0);
+
+        ode_integrator adaptive(ODE_DOPRI5);
+        adaptive.set_tolerance(1e-9, 1e-12);
+        copy(x0, x0 + 4, x);
+        adaptive.integrate(sys, 0.0, x, 2.0 * PI);
+        double err_adaptive = hypot(x[0] - x0[0], x[1] - x0[1]);
+
+        ode_integrator fixed(ODE_RK4);
+        fixed.set_step_limits(0.0, 2.0 * PI / 5000);
+        copy(x0, x0 + 4, x);
+        fixed.integrate(sys, 0.0, x, 2.0 * PI);
+        double err_fixed = hypot(x[0] - x0[0], x[1] - x0[1]);
+
+        bool pass = err_adaptive < err_fixed && adaptive.get_evaluations() < fixed.get_evaluations();
+        ok &= pass;
+        cout << "  DOPRI5:    " << adaptive.get_steps_accepted() << " steps (" << adaptive.get_steps_rejected()
+             << " rejected), " << adaptive.get_evaluations() << " evaluations, error " << err_adaptive << "\n"
+             << "  RK4 fixed: " << fixed.get_steps_accepted() << " steps, " << fixed.get_evaluations()
+             << " evaluations, error " << err_fixed << (pass ? "" : "  FAIL") << "\n";
+    }
+
+    cout << (ok ? "ALL PASSED" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,102 @@
+/*
+PURPOSE:    Checks the batch exp, log and sqrt kernels against the
+            standard library and times them on a large array.
+COMMANDS:
+    : g++ -O2 src/vector_math_test.cpp -o vector_math_program
+*/
+
+#include "../include/vector_math.hh"
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+
+using namespace std;
+
+double max_rel_error(const vector<double>& ref, const vector<double>& y) {
+    double err = 0.0;
+    for (size_t i = 0; i < ref.size(); ++i) {
+        if (ref[i] == y[i]) continue;
+        double scale = max(fabs(ref[i]), 1e-300);
+        err = max(err, fabs(ref[i] - y[i]) / scale);
+    }
+    return err;
+}
+
+template <typename Batch>
+double time_batch(Batch batch, const vector<double>& x, vector<double>& y, int reps) {
+    auto start = chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) batch(x.data(), y.data(), x.size());
+    return 1e9 * chrono::duration<double>(chrono::steady_clock::now() - start).count() / (reps * x.size());
+}
+
+bool check(const char* name, double err, double tol) {
+    bool ok = err <= tol;
+    cout << "  " << name << " max rel error: " << err << (ok ? "  [OK]" : "  [FAIL]") << "\n";
+    return ok;
+}
+
+int main() {
+    const size_t N = 1 << 16;
+    const int reps = 200;
+    mt19937 gen(42);
+
+    vector<double> xe(N), xl(N), y(N), ref(N);
+    uniform_real_distribution<double> exp_range(-700.0, 700.0);
+    uniform_real_distribution<double> log_exponent(-300.0, 300.0);
+    for (size_t i = 0; i < N; ++i) {
+        xe[i] = exp_range(gen);
+        xl[i] = pow(10.0, log_exponent(gen));
+    }
+
+    bool ok = true;
+    cout << "=== Accuracy ===\n";
+
+    for (size_t i = 0; i < N; ++i) ref[i] = exp(xe[i]);
+    vexp(xe.data(), y.data(), N, MATH_HIGH);
+    ok &= check("vexp  HIGH", max_rel_error(ref, y), 1e-14);
+    vexp(xe.data(), y.data(), N, MATH_FAST);
+    ok &= check("vexp  FAST", max_rel_error(ref, y), 5e-7);
+
+    for (size_t i = 0; i < N; ++i) ref[i] = log(xl[i]);
+    vlog(xl.data(), y.data(), N, MATH_HIGH);
+    ok &= check("vlog  HIGH", max_rel_error(ref, y), 1e-14);
+    vlog(xl.data(), y.data(), N, MATH_FAST);
+    ok &= check("vlog  FAST", max_rel_error(ref, y), 5e-7);
+
+    for (size_t i = 0; i < N; ++i) ref[i] = sqrt(xl[i]);
+    vsqrt(xl.data(), y.data(), N);
+    ok &= check("vsqrt HIGH", max_rel_error(ref, y), 0.0);
+
+    // Special values
+    double sx[6] = {0.0, -1.0, 1e-320, numeric_limits<double>::infinity(), -800.0, 800.0};
+    double sy[6];
+    vlog(sx, sy, 4);
+    ok &= check("vlog  specials", (isinf(sy[0]) && sy[0] < 0 && isnan(sy[1]) && fabs(sy[2] - log(1e-320)) < 1e-12
+                                   && isinf(sy[3])) ? 0.0 : 1.0, 0.0);
+    vexp(sx + 4, sy + 4, 2);
+    ok &= check("vexp  specials", (sy[4] == 0.0 && isinf(sy[5])) ? 0.0 : 1.0, 0.0);
+
+    // Ends of the range: 2^k of the reduction is 2^1024 above 709.44 and subnormal below EXP_MIN
+    vector<double> ends = {709.5, 709.7, vector_math::EXP_MAX, vector_math::EXP_MIN - 1e-9, vector_math::EXP_MIN - 0.5, -1.0, 0.0, 1.0};
+    vector<double> ends_ref(ends.size()), ends_y(ends.size());
+    for (size_t i = 0; i < ends.size(); ++i) ends_ref[i] = exp(ends[i]);
+    vexp(ends.data(), ends_y.data(), ends.size(), MATH_HIGH);
+    ok &= check("vexp  HIGH at 709.5, 709.7, EXP_MAX, below EXP_MIN", max_rel_error(ends_ref, ends_y), 1e-14);
+    vexp(ends.data(), ends_y.data(), ends.size(), MATH_FAST);
+    ok &= check("vexp  FAST at 709.5, 709.7, EXP_MAX, below EXP_MIN", max_rel_error(ends_ref, ends_y), 5e-7);
+
+    cout << "=== Throughput (ns/element) ===\n";
+    cout << "  exp   libm: " << time_batch([](const double* a, double* b, size_t n) { vexp(a, b, n, MATH_EXACT); }, xe, y, reps)
+         << " | HIGH: " << time_batch([](const double* a, double* b, size_t n) { vexp(a, b, n, MATH_HIGH); }, xe, y, reps)
+         << " | FAST: " << time_batch([](const double* a, double* b, size_t n) { vexp(a, b, n, MATH_FAST); }, xe, y, reps) << "\n";
+    cout << "  log   libm: " << time_batch([](const double* a, double* b, size_t n) { vlog(a, b, n, MATH_EXACT); }, xl, y, reps)
+         << " | HIGH: " << time_batch([](const double* a, double* b, size_t n) { vlog(a, b, n, MATH_HIGH); }, xl, y, reps)
+         << " | FAST: " << time_batch([](const double* a, double* b, size_t n) { vlog(a, b, n, MATH_FAST); }, xl, y, reps) << "\n";
+    cout << "  sqrt  libm: " << time_batch([](const double* a, double* b, size_t n) { vsqrt(a, b, n, MATH_EXACT); }, xl, y, reps)
+         << " | HIGH: " << time_batch([](const double* a, double* b, size_t n) { vsqrt(a, b, n, MATH_HIGH); }, xl, y, reps) << "\n";
+
+    cout << (ok ? "All checks passed.\n" : "Some checks FAILED.\n");
+    return ok ? 0 : 1;
+}
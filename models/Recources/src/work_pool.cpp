@@ -0,0 +1,79 @@
+/*
+PURPOSE:    Implementation of the work stealing pool. See work_pool.hh.
+*/
+
+#include "../include/work_pool.hh"
+#include <thread>
+
+work_pool::work_pool(int n)
+    //Description:    Creates the queues of the pool; threads are started for each run
+    //Preconditions:  n >= 0
+    //Postconditions: size() workers, at least one
+{
+    if (n <= 0) n = static_cast<int>(std::thread::hardware_concurrency());
+    workers = (n > 0) ? n : 1;
+    for (int i = 0; i < workers; i++) queues.emplace_back(new queue);
+    steals = 0;
+}
+
+bool work_pool::next_task(int worker, int& task)
+    //Description:    Pops from the back of the worker's own queue, otherwise steals from the front of the others
+    //Preconditions:  No tasks are added while a run is in progress
+    //Postconditions: Returns false only when every queue is empty
+{
+    {
+        queue& own = *queues[worker];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+    for (int i = 1; i < workers; i++) {
+        queue& victim = *queues[(worker + i) % workers];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            std::lock_guard<std::mutex> count(steals_lock);
+            steals++;
+            return true;
+        }
+    }
+    return false;
+}
+
+void work_pool::run(int n, const std::function<void(int, int)>& task)
+    //Description:    Splits [0, n) into one contiguous block per worker and runs the workers until every queue is empty
+    //Preconditions:  task does not throw
+    //Postconditions: task has run exactly once for every index
+{
+    steals = 0;
+    for (int w = 0; w < workers; w++) {
+        int begin = static_cast<int>(static_cast<long>(n) * w / workers);
+        int end = static_cast<int>(static_cast<long>(n) * (w + 1) / workers);
+        // Own work is popped from the back, so the block is queued in reverse to start at its first index
+        for (int i = end - 1; i >= begin; i--) queues[w]->tasks.push_back(i);
+    }
+
+    auto work = [this, &task](int worker) {
+        int index;
+        while (next_task(worker, index)) task(index, worker);
+    };
+
+    std::vector<std::thread> threads;
+    for (int w = 1; w < workers; w++) threads.emplace_back(work, w);
+    work(0);
+    for (std::thread& t : threads) t.join();
+}
+
+int work_pool::size() const
+{
+    return workers;
+}
+
+long work_pool::get_steals() const
+{
+    return steals;
+}
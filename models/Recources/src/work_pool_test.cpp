@@ -0,0 +1,62 @@
+/*
+PURPOSE: (Checks that the work stealing pool runs every task exactly
+          once, also when the task costs are very uneven, and times a
+          CPU bound batch on one worker and on every hardware thread.)
+COMMANDS:
+    : g++ -O2 -pthread src/work_pool.cpp src/work_pool_test.cpp -o work_pool_program
+*/
+
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include "../include/work_pool.hh"
+
+using namespace std;
+
+// A task whose cost grows with i mod 17, so the blocks of the workers are not equally heavy
+double busy(int i) {
+    double x = 0.0;
+    int n = 2000 * (1 + (i % 17) * (i % 17));
+    for (int k = 0; k < n; k++) x += sin(k * 1e-3 + i);
+    return x;
+}
+
+double timed_run(work_pool& pool, int n, vector<double>& out) {
+    auto start = chrono::steady_clock::now();
+    pool.run(n, [&out](int task, int) { out[task] = busy(task); });
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+int main(){
+    bool ok = true;
+
+    for (int workers : {1, 3, 0}) {
+        work_pool pool(workers);
+        for (int n : {0, 1, 5, 1000}) {
+            vector<atomic<int>> runs(n);
+            for (auto& r : runs) r = 0;
+            pool.run(n, [&runs](int task, int) { runs[task]++; });
+            for (int i = 0; i < n; i++) ok &= runs[i] == 1;
+        }
+    }
+    cout << "every task run exactly once: " << (ok ? "yes" : "NO") << "\n";
+
+    const int n = 400;
+    vector<double> serial(n), parallel(n);
+    work_pool one(1), all;
+    double t1 = timed_run(one, n, serial);
+    double tn = timed_run(all, n, parallel);
+    bool same = serial == parallel;
+    ok &= same;
+
+    cout << "=== " << n << " uneven tasks ===\n"
+         << "  1 worker:   " << t1 << " s\n"
+         << "  " << all.size() << " workers: " << tn << " s (" << all.get_steals() << " steals)\n"
+         << "  speedup:    " << t1 / tn << "\n"
+         << "  results identical: " << (same ? "yes" : "NO") << "\n";
+
+    cout << (ok ? "ALL PASSED" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
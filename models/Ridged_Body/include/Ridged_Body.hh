@@ -1,12 +1,32 @@
 /*
 PURPOSE:    Simulate rigid body dynamics including linear
             and angular motion using Eigen vectors and matrices
+
+NOTE:       For the integrators in ode_integrator.hh the body is one flat
+            state of 13 doubles:
+                [0..2]   X - position
+                [3..5]   v - velocity
+                [6..8]   w - angular velocity
+                [9..12]  Qori - orientation quaternion (w, x, y, z)
+            Force and torque are inputs and stay constant during a step.
+
+            propagate_lie() steps the attitude on the rotation group instead:
+            the quaternion is only ever multiplied by unit quaternions, so it
+            stays unit length without renormalizing and large steps do not
+            drift off the sphere.
+
+            The rotation matrix R and the world frame inverse inertia
+            R * inv_I0 * R^T are derived from the quaternion on first use
+            and kept until the orientation changes, so the getters and
+            frame conversions called several times per frame by the
+            controllers share one evaluation.
 */
 
 #ifndef RIDGED_BODY_HH
 #define RIDGED_BODY_HH
 
-#include "../../Recources/src/Linear_Algebra.cpp"
+#include "../../Recources/include/Linear_Algebra.hh"
+#include "../../Recources/include/ode_integrator.hh"
 //#include "../../../Lib/eigen-3.4.0/Eigen/Dense"
 //#include "../../../Lib/eigen-3.4.0/Eigen/Geometry"
 #include "Satellite_Box.hh"
@@ -18,8 +38,11 @@ PURPOSE:    Simulate rigid body dynamics including linear
     {
 #endif
 
-class ridged_body{
+class ridged_body : public ode_system {
     public:
+        // Description: Number of doubles in the flat state
+        static const int STATE_SIZE = 13;
+
         // Description: Constructor initializing ridged body to default values
         ridged_body();
 
@@ -72,6 +95,24 @@ class ridged_body{
         // Description: Get the rate of change of quaternion (Qori)
         void state_deriv_getQori(double d_quat[4] /*quaternion*/);
 
+        // Description: Size of the flat state, always STATE_SIZE
+        int state_size() const override;
+
+        // Description: Copy the body into a flat state
+        void get_state(double x[STATE_SIZE] /*state*/);
+
+        // Description: Set the body from a flat state; the quaternion is normalized and R follows it
+        void set_state(const double x[STATE_SIZE] /*state*/);
+
+        // Description: Derivative of a flat state under the current force and torque
+        void state_deriv(double t /*time*/, const double* x /*state*/, double* dxdt /*derivative*/) override;
+
+        // Description: Advance the body by dt with the given integrator
+        void propagate(ode_integrator& integrator, double t /*time*/, double dt /*time step*/);
+
+        // Description: Advance the body by dt with a fourth order Lie group (RKMK) step for the attitude
+        void propagate_lie(double dt /*time step*/);
+
         // Description: Get the current angular momentum
         void get_L(double L[3] /*angular momentum*/);
 
@@ -112,7 +153,6 @@ class ridged_body{
         Vector3d F; // force
 
         // Angular Motion
-        Matrix3d R; // rotation matrix
         Quaterniond Qori; // orientation (quaternion)
         Vector3d w; // angular velocity (omega)
         Vector3d L; // angular momentum
@@ -128,6 +168,24 @@ class ridged_body{
         Matrix3d I0; //inertial tensor for I
 
         double m;
+
+        // Cached from the orientation, valid while the flags are set
+        mutable Matrix3d R; // rotation matrix
+        mutable Matrix3d inv_I_world; // inverse inertia tensor in the global frame, R * inv_I0 * R^T
+        mutable bool R_valid;
+        mutable bool inv_I_world_valid;
+
+        // Description: Rotation matrix of the current orientation, derived from Qori if it changed
+        const Matrix3d& rotation() const;
+
+        // Description: Inverse inertia tensor in the global frame for the current orientation
+        const Matrix3d& world_inv_inertia() const;
+
+        // Description: Marks everything derived from the orientation as stale
+        void orientation_changed();
+
+        // Description: Angular acceleration from Euler's equations for the angular velocity omega
+        Vector3d angular_accel(const Vector3d& omega /*angular velocity*/) const;
 };
 
 #ifdef __cplusplus
@@ -12,7 +12,7 @@ TERMS USED:
     -> l - length of the side of the satellite box
 */
 
-#include "../../Recources/src/Linear_Algebra.cpp"
+#include "../../Recources/include/Linear_Algebra.hh"
 
 //#include "../../../Lib/eigen-3.4.0/Eigen/Dense"
 #include "../../structs.hh"
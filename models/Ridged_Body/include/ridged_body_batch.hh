@@ -0,0 +1,92 @@
+/*
+PURPOSE:    Propagates many rigid bodies at once for formation and
+            constellation studies. ridged_body keeps one vehicle in
+            Vector3d/Matrix3d members and is read and written through
+            double[3] round trips; here every quantity of every vehicle
+            lives in its own array (structure of arrays), and one pass
+            per step moves all of them a SIMD block of vehicles at a time.
+
+NOTE:       The step is the same as ridged_body::propagate_lie():
+                translation - exact for the constant force
+                attitude    - fourth order Lie group (RKMK) step, q = q * exp(theta)
+            with the inertia tensor of each vehicle given in full, so
+            vehicles do not have to be cubes. The exponential is evaluated
+            by its series in the squared rotation angle, which keeps the
+            pass free of per-vehicle libm calls; steps that turn a vehicle
+            by more than pi fall back to sin and cos.
+
+            Torque is in the body frame, force in the global frame, as in
+            ridged_body. The arrays are padded to whole SIMD blocks with a
+            unit mass, unit inertia vehicle at rest that is never read.
+
+TERMS USED:
+    -> handle - index of a vehicle, returned when it is added
+    -> I      - inertia tensor in the body frame (symmetric)
+    -> w      - angular velocity in the body frame
+*/
+
+#ifndef RIDGED_BODY_BATCH_HH
+#define RIDGED_BODY_BATCH_HH
+
+#include <vector>
+
+#ifdef __cplusplus
+    extern "C"
+    {
+#endif
+
+class ridged_body_batch {
+    public:
+        // Description: Creates an empty batch
+        ridged_body_batch();
+
+        // Description: Adds a vehicle at rest with identity orientation and returns its handle
+        int add_body(double /*mass*/, const double I[3][3] /*inertia tensor*/, const double pos[3] /*position*/, const double vel[3] /*velocity*/);
+
+        // Description: Applied force (global frame) and torque (body frame) of a vehicle
+        void set_force(int /*handle*/, const double F[3] /*force*/);
+        void set_torque(int /*handle*/, const double T[3] /*torque*/);
+
+        // Description: Angular velocity and orientation of a vehicle; the quaternion is normalized
+        void set_w(int /*handle*/, const double w[3] /*angular velocity*/);
+        void set_Qori(int /*handle*/, const double q[4] /*quaternion*/);
+
+        // Description: State of a vehicle
+        void get_pos(int /*handle*/, double pos[3] /*position*/) const;
+        void get_v(int /*handle*/, double vel[3] /*velocity*/) const;
+        void get_w(int /*handle*/, double w[3] /*angular velocity*/) const;
+        void get_Qori(int /*handle*/, double q[4] /*quaternion*/) const;
+
+        // Description: Advances every vehicle by dt
+        void propagate(double dt /*time step*/);
+
+        // Description: Number of vehicles
+        int size() const;
+
+    private:
+        // Description: Grows every array to hold n vehicles, rounded up to whole SIMD blocks
+        void resize(int /*vehicle count*/);
+
+        int count;
+
+        // translation
+        std::vector<double> pos_x, pos_y, pos_z;
+        std::vector<double> vel_x, vel_y, vel_z;
+        std::vector<double> force_x, force_y, force_z;
+        std::vector<double> inv_mass;
+
+        // rotation
+        std::vector<double> q_w, q_x, q_y, q_z;
+        std::vector<double> w_x, w_y, w_z;
+        std::vector<double> torque_x, torque_y, torque_z;
+
+        // inertia and its inverse, upper triangle of the symmetric tensors
+        std::vector<double> I_xx, I_yy, I_zz, I_xy, I_xz, I_yz;
+        std::vector<double> inv_I_xx, inv_I_yy, inv_I_zz, inv_I_xy, inv_I_xz, inv_I_yz;
+};
+
+#ifdef __cplusplus
+    }
+#endif
+
+#endif
@@ -2,7 +2,9 @@
 PURPOSE: (Simulate A Motor)
 LIBRARY DEPENDENCY:
     ((Ridged_Body.o)
-     (Satellite_Box.o))
+     (Satellite_Box.o)
+     (Recources/src/Linear_Algebra.o)
+     (Recources/src/ode_integrator.o))
 *******************************************************************************/
 
 /*
@@ -23,6 +25,13 @@ TERMS USED:
 EQUATIONS TO MODEL:
     -> Newton's second law for translation: F = m * a
     -> Euler's equations for rotation: I * alpha = T - w × (I * w)
+    -> Attitude kinematics: dq/dt = 0.5 * q * (0, w)
+
+LIE GROUP STEP (propagate_lie):
+    -> q(t + h) = q(t) * exp(theta), exp(theta) the unit quaternion of the rotation vector theta
+    -> theta is integrated with RK4 from 0: dtheta/dt = w + 0.5 * theta × w + (1/12) * theta × (theta × w)
+       (inverse of the derivative of the exponential map, truncated after the terms fourth order needs)
+    -> w is integrated with the same RK4 stages
 */
 
 //#include "../../../Lib/eigen-3.4.0/Eigen/Dense"
@@ -37,6 +46,22 @@ EQUATIONS TO MODEL:
 //using namespace Eigen;
 using namespace std;
 
+// Unit quaternion of the rotation vector theta (rotation by |theta| about theta)
+static Quaterniond rotation_exp(const Vector3d& theta)
+{
+    double angle = theta.norm();
+    // sin(angle/2)/angle, with its series near zero
+    double s = (angle < 1e-4) ? 0.5 - angle * angle / 48.0 : sin(0.5 * angle) / angle;
+    return Quaterniond(cos(0.5 * angle), s * theta.x, s * theta.y, s * theta.z);
+}
+
+// Rate of the rotation vector theta for the body rate omega, q = q0 * exp(theta)
+static Vector3d dexp_inv(const Vector3d& theta, const Vector3d& omega)
+{
+    Vector3d t_x_w = theta.cross(omega);
+    return omega + 0.5 * t_x_w + (1.0 / 12.0) * theta.cross(t_x_w);
+}
+
 ridged_body::ridged_body()
 	//Description:  	Default constructor setting all variables for linear and angular motion to their default state.
 	//Preconditions:	None
@@ -54,7 +79,7 @@ ridged_body::ridged_body()
 	Qori.x(0);
 	Qori.y(0);
 	Qori.z(0);
-	R = Qori.toRotationMatrix(); // quaternion to rotation matrix
+	orientation_changed(); // R follows the quaternion on first use
 	w.insert(0, 0, 0); // angular velocity (omega)
 	L.insert(0, 0, 0); // angular momentum
 	alpha.insert(0, 0, 0); // angular acceleration
@@ -95,7 +120,7 @@ ridged_body::ridged_body(double pos[3], double vel[3], double acc[3])
 	Qori.x(0);
 	Qori.y(0);
 	Qori.z(0);
-	R = Qori.toRotationMatrix(); // quaternion to rotation matrix
+	orientation_changed(); // R follows the quaternion on first use
 	w.insert(0, 0, 0); // angular velocity (omega)
 	L.insert(0, 0, 0); // angular momentum
 	alpha.insert(0, 0, 0); // angular acceleration
@@ -136,6 +161,7 @@ void ridged_body::initialize_body(double mass, double length){
 	inv_I0.insert(inv_I_0[0][0], inv_I_0[0][1], inv_I_0[0][2],
           	inv_I_0[1][0], inv_I_0[1][1], inv_I_0[1][2],
           	inv_I_0[2][0], inv_I_0[2][1], inv_I_0[2][2]); // inverse inertial tensor
+    inv_I_world_valid = false;
 }
 
 void ridged_body::initialize_motion(double pos[3], double vel[3], double acc[3]){
@@ -167,11 +193,11 @@ void ridged_body::update_torque(double x, double y, double z)
 // Update angular momentum
 void ridged_body::update_L(double x, double y, double z)
     //Description:   Updates the angular momentum vector. This is used to compute angular velocity.
-    //Preconditions: Inertia matrix (inv_I0) and rotation matrix (R) must be set.
+    //Preconditions: Inertia matrix (inv_I0) and orientation must be set.
     //Postconditions: Angular momentum L and angular velocity w updated.
 {
     L.insert(x, y, z);
-    w = R * inv_I0 * R.transpose() * L;
+    w = world_inv_inertia() * L;
 }
 
 // Update angular velocity
@@ -211,7 +237,9 @@ void ridged_body::update_R(const double rot_matrix[3][3])
     input.insert(rot_matrix[0][0], rot_matrix[0][1], rot_matrix[0][2],
             rot_matrix[1][0], rot_matrix[1][1], rot_matrix[1][2],
             rot_matrix[2][0], rot_matrix[2][1], rot_matrix[2][2]);
-    R = R + input;
+    R = rotation() + input;
+    R_valid = true;
+    inv_I_world_valid = false;
 }
 
 // Update quaternion orientation
@@ -225,7 +253,7 @@ void ridged_body::update_Qori(double quat[4])
     Qori.y(quat[2]);
     Qori.z(quat[3]);
     Qori.normalize();
-    R = Qori.toRotationMatrix();
+    orientation_changed();
 }
 
 // Update quaternion by angle
@@ -247,9 +275,10 @@ void ridged_body::update_QoriByAngle(double angl)
                       sin(-angl / 2) * dir.y,
                       sin(-angl / 2) * dir.z);
 
-    Vector3d R_x = R.col(0);
-    Vector3d R_y = R.col(1);
-    Vector3d R_z = R.col(2);
+    const Matrix3d& R_m = rotation();
+    Vector3d R_x = R_m.col(0);
+    Vector3d R_y = R_m.col(1);
+    Vector3d R_z = R_m.col(2);
     Quaterniond QR_x(0, R_x[0], R_x[1], R_x[2]);
     Quaterniond QR_y(0, R_y[0], R_y[1], R_y[2]);
     Quaterniond QR_z(0, R_z[0], R_z[1], R_z[2]);
@@ -261,6 +290,8 @@ void ridged_body::update_QoriByAngle(double angl)
     R.insert(QR_x.x(), QR_y.x(), QR_z.x(),
         QR_x.y(), QR_y.y(), QR_z.y(),
         QR_x.z(), QR_y.z(), QR_z.z());
+    R_valid = true;
+    inv_I_world_valid = false;
 }
 
 // Get the state derivative of acceleration
@@ -308,9 +339,10 @@ void ridged_body::state_deriv_getCross(double cross_matrix[3][3])
     //Preconditions: Angular velocity w must be updated.
     //Postconditions: Returns the cross-product matrix for further kinematic calculations.
 {
-    Vector3d Rx = R.col(0);
-    Vector3d Ry = R.col(1);
-    Vector3d Rz = R.col(2);
+    const Matrix3d& R_m = rotation();
+    Vector3d Rx = R_m.col(0);
+    Vector3d Ry = R_m.col(1);
+    Vector3d Rz = R_m.col(2);
 
     Vector3d w_crossX = w.cross(Rx);
     Vector3d w_crossY = w.cross(Ry);
@@ -338,6 +370,144 @@ void ridged_body::state_deriv_getQori(double d_quat[4])
     d_quat[3] = dq.z() * 0.5;
 }
 
+int ridged_body::state_size() const
+{
+    return STATE_SIZE;
+}
+
+void ridged_body::get_state(double x[STATE_SIZE])
+    //Description:   Copies position, velocity, angular velocity and quaternion into a flat state.
+    //Preconditions: None
+    //Postconditions: x holds the layout described in Ridged_Body.hh.
+{
+    for (int i = 0; i < 3; i++){
+        x[i] = X[i];
+        x[3 + i] = v[i];
+        x[6 + i] = w[i];
+    }
+    x[9] = Qori.w();
+    x[10] = Qori.x();
+    x[11] = Qori.y();
+    x[12] = Qori.z();
+}
+
+void ridged_body::set_state(const double x[STATE_SIZE])
+    //Description:   Sets position, velocity, angular velocity and quaternion from a flat state.
+    //Preconditions: The quaternion entries must not all be zero.
+    //Postconditions: Quaternion normalized, rotation matrix R and acceleration a updated.
+{
+    X.insert(x[0], x[1], x[2]);
+    v.insert(x[3], x[4], x[5]);
+    w.insert(x[6], x[7], x[8]);
+    double quat[4] = {x[9], x[10], x[11], x[12]};
+    update_Qori(quat);
+    a = F / B.getmass();
+}
+
+void ridged_body::state_deriv(double, const double* x, double* dxdt)
+    //Description:   Derivative of a flat state: dX = v, dv = F/m, dw from Euler's equations, dq = 0.5 * q * (0, w).
+    //Preconditions: Force F and torque T must be updated; they are held constant over the step.
+    //Postconditions: dxdt holds STATE_SIZE derivatives; the body itself is not changed.
+{
+    Vector3d x_w(x[6], x[7], x[8]);
+    Vector3d acc = F / B.getmass();
+    Vector3d x_alpha = angular_accel(x_w);
+
+    for (int i = 0; i < 3; i++){
+        dxdt[i] = x[3 + i];
+        dxdt[3 + i] = acc[i];
+        dxdt[6 + i] = x_alpha[i];
+    }
+
+    Quaterniond q(x[9], x[10], x[11], x[12]);
+    Quaterniond quat_w(0, x_w[0], x_w[1], x_w[2]);
+    Quaterniond dq = q * quat_w;
+    dxdt[9] = 0.5 * dq.w();
+    dxdt[10] = 0.5 * dq.x();
+    dxdt[11] = 0.5 * dq.y();
+    dxdt[12] = 0.5 * dq.z();
+}
+
+void ridged_body::propagate(ode_integrator& integrator, double t, double dt)
+    //Description:   Advances the whole body state from t to t + dt.
+    //Preconditions: Force F and torque T must be updated.
+    //Postconditions: Position, velocity, angular velocity, quaternion and R at t + dt.
+{
+    double x[STATE_SIZE];
+    get_state(x);
+    integrator.integrate(*this, t, x, t + dt);
+    set_state(x);
+}
+
+void ridged_body::propagate_lie(double dt)
+    //Description:   Advances the body by dt; the attitude takes one RKMK4 step on the rotation group, the
+    //               translation is exact for the constant force.
+    //Preconditions: Force F and torque T must be updated.
+    //Postconditions: Position, velocity, angular velocity, quaternion and R at t + dt; the quaternion stays unit
+    //               length to rounding without renormalizing.
+{
+    Vector3d w0 = w;
+
+    Vector3d k1_t = w0;
+    Vector3d k1_w = angular_accel(w0);
+
+    Vector3d w_s = w0 + 0.5 * dt * k1_w;
+    Vector3d k2_t = dexp_inv(0.5 * dt * k1_t, w_s);
+    Vector3d k2_w = angular_accel(w_s);
+
+    w_s = w0 + 0.5 * dt * k2_w;
+    Vector3d k3_t = dexp_inv(0.5 * dt * k2_t, w_s);
+    Vector3d k3_w = angular_accel(w_s);
+
+    w_s = w0 + dt * k3_w;
+    Vector3d k4_t = dexp_inv(dt * k3_t, w_s);
+    Vector3d k4_w = angular_accel(w_s);
+
+    Vector3d theta = (dt / 6.0) * (k1_t + 2.0 * k2_t + 2.0 * k3_t + k4_t);
+    w = w0 + (dt / 6.0) * (k1_w + 2.0 * k2_w + 2.0 * k3_w + k4_w);
+    Qori = Qori * rotation_exp(theta);
+    orientation_changed();
+
+    a = F / B.getmass();
+    X = X + dt * v + (0.5 * dt * dt) * a;
+    v = v + dt * a;
+}
+
+const Matrix3d& ridged_body::rotation() const
+{
+    if (!R_valid) {
+        R = Qori.toRotationMatrix();
+        R_valid = true;
+    }
+    return R;
+}
+
+const Matrix3d& ridged_body::world_inv_inertia() const
+{
+    if (!inv_I_world_valid) {
+        const Matrix3d& R_m = rotation();
+        Matrix3d RI = R_m * inv_I0;
+        // Written element by element: assigning the product expression builds a temporary and copies it
+        auto W = RI * R_m.transpose();
+        inv_I_world.insert(W(0, 0), W(0, 1), W(0, 2),
+                           W(1, 0), W(1, 1), W(1, 2),
+                           W(2, 0), W(2, 1), W(2, 2));
+        inv_I_world_valid = true;
+    }
+    return inv_I_world;
+}
+
+void ridged_body::orientation_changed()
+{
+    R_valid = false;
+    inv_I_world_valid = false;
+}
+
+Vector3d ridged_body::angular_accel(const Vector3d& omega) const
+{
+    return inv_I0 * (T - omega.cross(I0 * omega));
+}
+
 void ridged_body::get_L(double l[3])
     //Description:   Returns the angular momentum vector.
     //Preconditions: Angular momentum L must be updated.
@@ -388,12 +558,13 @@ double ridged_body::get_w_mag()
 
 void ridged_body::get_R(double R_matrix[3][3])
     //Description:   Returns the rotation matrix representing the body's orientation.
-    //Preconditions: Rotation matrix R must be updated.
+    //Preconditions: Orientation must be updated.
     //Postconditions: Provides the 3x3 rotation matrix to the user.
 {
+    const Matrix3d& R_m = rotation();
     for (int i = 0; i < 3; i++){
         for (int j = 0; j < 3; j++){
-            R_matrix[i][j] = R(i, j);
+            R_matrix[i][j] = R_m(i, j);
         }
     }
 }
@@ -415,26 +586,26 @@ double ridged_body::get_mass(){
 
 void ridged_body::get_ref_i_vec(double vec[3])
 {
-    Vector3d Rx = R.col(0);
-    vec[0] = Rx(0);
-    vec[1] = Rx(1);
-    vec[2] = Rx(2);
+    const Matrix3d& R_m = rotation();
+    vec[0] = R_m(0, 0);
+    vec[1] = R_m(1, 0);
+    vec[2] = R_m(2, 0);
 }
 
 void ridged_body::get_ref_j_vec(double vec[3])
 {
-    Vector3d Ry = R.col(1);
-    vec[0] = Ry(0);
-    vec[1] = Ry(1);
-    vec[2] = Ry(2);
+    const Matrix3d& R_m = rotation();
+    vec[0] = R_m(0, 1);
+    vec[1] = R_m(1, 1);
+    vec[2] = R_m(2, 1);
 }
 
 void ridged_body::get_ref_k_vec(double vec[3])
 {
-    Vector3d Rz = R.col(2);
-    vec[0] = Rz(0);
-    vec[1] = Rz(1);
-    vec[2] = Rz(2);
+    const Matrix3d& R_m = rotation();
+    vec[0] = R_m(0, 2);
+    vec[1] = R_m(1, 2);
+    vec[2] = R_m(2, 2);
 }
 
 void ridged_body::convert_to_ref_frame(double vec[3])
@@ -445,7 +616,7 @@ void ridged_body::convert_to_ref_frame(double vec[3])
     v_global[1] = vec[1];
     v_global[2] = vec[2];
 
-    v_local = R * v_global;
+    v_local = rotation() * v_global;
     
     vec[0] = v_local[0];
     vec[1] = v_local[1];
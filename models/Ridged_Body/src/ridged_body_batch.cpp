@@ -0,0 +1,278 @@
+/*
+PURPOSE:    Implementation of the batched rigid body engine. See
+            ridged_body_batch.hh for the layout and terms.
+
+EQUATIONS TO MODEL:
+    -> Translation: X += v*dt + 0.5*a*dt^2, v += a*dt, a = F/m
+    -> Euler's equations: alpha = I^-1 * (T - w × (I * w))
+    -> Attitude: q(t + dt) = q(t) * exp(theta), theta from RK4 on
+       dtheta/dt = w + 0.5 * theta × w + (1/12) * theta × (theta × w)
+*/
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#include "../include/ridged_body_batch.hh"
+#include "../../Recources/include/Linear_Algebra.hh"
+#include "../../Recources/include/vector_math.hh"
+
+using vector_math::LANES;
+using vector_math::vdouble;
+using vector_math::splat;
+
+namespace {
+
+inline vdouble load(const std::vector<double>& a, size_t i) {
+    vdouble v;
+    std::memcpy(&v, &a[i], sizeof(v));
+    return v;
+}
+
+inline void store(std::vector<double>& a, size_t i, vdouble v) {
+    std::memcpy(&a[i], &v, sizeof(v));
+}
+
+// Three components of one SIMD block of vehicles
+struct vec3v {
+    vdouble x, y, z;
+};
+
+inline vec3v operator+(const vec3v& a, const vec3v& b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+inline vec3v operator-(const vec3v& a, const vec3v& b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+inline vec3v operator*(vdouble s, const vec3v& a) { return {s * a.x, s * a.y, s * a.z}; }
+
+inline vec3v cross(const vec3v& a, const vec3v& b) {
+    return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+// Symmetric tensor times vector, upper triangle (xx, yy, zz, xy, xz, yz)
+struct sym3v {
+    vdouble xx, yy, zz, xy, xz, yz;
+};
+
+inline vec3v operator*(const sym3v& m, const vec3v& v) {
+    return {m.xx * v.x + m.xy * v.y + m.xz * v.z,
+            m.xy * v.x + m.yy * v.y + m.yz * v.z,
+            m.xz * v.x + m.yz * v.y + m.zz * v.z};
+}
+
+inline vec3v angular_accel(const sym3v& I, const sym3v& inv_I, const vec3v& T, const vec3v& w) {
+    return inv_I * (T - cross(w, I * w));
+}
+
+inline vec3v dexp_inv(const vec3v& theta, const vec3v& w) {
+    vec3v t_x_w = cross(theta, w);
+    return w + splat(0.5) * t_x_w + splat(1.0 / 12.0) * cross(theta, t_x_w);
+}
+
+// Largest rotation per step the series of the exponential covers to rounding
+const double SERIES_MAX_ANGLE2 = 3.14159265358979323846 * 3.14159265358979323846;
+
+// Unit quaternion of the rotation vector theta: (cos(a/2), sin(a/2)/a * theta), a = |theta|
+inline void rotation_exp(const vec3v& theta, vdouble& c, vdouble& s) {
+    vdouble a2 = theta.x * theta.x + theta.y * theta.y + theta.z * theta.z;
+
+    bool series = true;
+    for (size_t l = 0; l < LANES; l++) series &= a2[l] <= SERIES_MAX_ANGLE2;
+
+    if (series) {
+        // x = a/2 <= pi/2: cos x and sin(x)/x to x^22, below 1e-16
+        vdouble x2 = 0.25 * a2;
+        vdouble pc = splat(1.0 / 1124000727777607680000.0);
+        pc = pc * x2 - 1.0 / 2432902008176640000.0;
+        pc = pc * x2 + 1.0 / 6402373705728000.0;
+        pc = pc * x2 - 1.0 / 20922789888000.0;
+        pc = pc * x2 + 1.0 / 87178291200.0;
+        pc = pc * x2 - 1.0 / 479001600.0;
+        pc = pc * x2 + 1.0 / 3628800.0;
+        pc = pc * x2 - 1.0 / 40320.0;
+        pc = pc * x2 + 1.0 / 720.0;
+        pc = pc * x2 - 1.0 / 24.0;
+        pc = pc * x2 + 0.5;
+        c = 1.0 - pc * x2;
+
+        vdouble ps = splat(1.0 / 25852016738884976640000.0);
+        ps = ps * x2 - 1.0 / 51090942171709440000.0;
+        ps = ps * x2 + 1.0 / 121645100408832000.0;
+        ps = ps * x2 - 1.0 / 355687428096000.0;
+        ps = ps * x2 + 1.0 / 1307674368000.0;
+        ps = ps * x2 - 1.0 / 6227020800.0;
+        ps = ps * x2 + 1.0 / 39916800.0;
+        ps = ps * x2 - 1.0 / 362880.0;
+        ps = ps * x2 + 1.0 / 5040.0;
+        ps = ps * x2 - 1.0 / 120.0;
+        ps = ps * x2 + 1.0 / 6.0;
+        s = 0.5 * (1.0 - ps * x2);      // sin(a/2)/a = 0.5 * sin(x)/x
+        return;
+    }
+
+    for (size_t l = 0; l < LANES; l++) {
+        double a = std::sqrt(a2[l]);
+        c[l] = std::cos(0.5 * a);
+        s[l] = (a < 1e-4) ? 0.5 - a2[l] / 48.0 : std::sin(0.5 * a) / a;
+    }
+}
+
+} // namespace
+
+ridged_body_batch::ridged_body_batch()
+    //Description:    Creates a batch with no vehicles
+    //Preconditions:  None
+    //Postconditions: size() is 0
+{
+    count = 0;
+}
+
+void ridged_body_batch::resize(int n)
+    //Description:    Grows every array to hold n vehicles, rounded up to whole SIMD blocks
+    //Preconditions:  n >= count
+    //Postconditions: Padding vehicles have unit mass and inertia, identity orientation and no motion
+{
+    size_t padded = (static_cast<size_t>(n) + LANES - 1) / LANES * LANES;
+    for (std::vector<double>* a : {&pos_x, &pos_y, &pos_z, &vel_x, &vel_y, &vel_z, &force_x, &force_y, &force_z,
+                                   &q_x, &q_y, &q_z, &w_x, &w_y, &w_z, &torque_x, &torque_y, &torque_z,
+                                   &I_xy, &I_xz, &I_yz, &inv_I_xy, &inv_I_xz, &inv_I_yz}) {
+        a->resize(padded, 0.0);
+    }
+    for (std::vector<double>* a : {&inv_mass, &q_w, &I_xx, &I_yy, &I_zz, &inv_I_xx, &inv_I_yy, &inv_I_zz}) {
+        a->resize(padded, 1.0);
+    }
+    count = n;
+}
+
+int ridged_body_batch::add_body(double mass, const double I[3][3], const double pos[3], const double vel[3])
+    //Description:    Adds a vehicle with the given mass, inertia tensor, position and velocity
+    //Preconditions:  mass > 0, I symmetric and invertible
+    //Postconditions: Returns the handle of the vehicle; no force, torque or rotation yet
+{
+    if (mass <= 0.0) throw std::invalid_argument("ridged_body_batch: mass must be positive");
+
+    Matrix3d I_m;
+    I_m.insert(I[0][0], I[0][1], I[0][2],
+               I[1][0], I[1][1], I[1][2],
+               I[2][0], I[2][1], I[2][2]);
+    Matrix3d inv_I = I_m.inverse();
+
+    int h = count;
+    resize(count + 1);
+    pos_x[h] = pos[0]; pos_y[h] = pos[1]; pos_z[h] = pos[2];
+    vel_x[h] = vel[0]; vel_y[h] = vel[1]; vel_z[h] = vel[2];
+    inv_mass[h] = 1.0 / mass;
+
+    I_xx[h] = I_m(0, 0); I_yy[h] = I_m(1, 1); I_zz[h] = I_m(2, 2);
+    I_xy[h] = I_m(0, 1); I_xz[h] = I_m(0, 2); I_yz[h] = I_m(1, 2);
+    inv_I_xx[h] = inv_I(0, 0); inv_I_yy[h] = inv_I(1, 1); inv_I_zz[h] = inv_I(2, 2);
+    inv_I_xy[h] = inv_I(0, 1); inv_I_xz[h] = inv_I(0, 2); inv_I_yz[h] = inv_I(1, 2);
+    return h;
+}
+
+void ridged_body_batch::set_force(int h, const double F[3])
+{
+    force_x[h] = F[0]; force_y[h] = F[1]; force_z[h] = F[2];
+}
+
+void ridged_body_batch::set_torque(int h, const double T[3])
+{
+    torque_x[h] = T[0]; torque_y[h] = T[1]; torque_z[h] = T[2];
+}
+
+void ridged_body_batch::set_w(int h, const double w[3])
+{
+    w_x[h] = w[0]; w_y[h] = w[1]; w_z[h] = w[2];
+}
+
+void ridged_body_batch::set_Qori(int h, const double q[4])
+    //Description:    Sets the orientation of a vehicle
+    //Preconditions:  q is not zero
+    //Postconditions: The stored quaternion is q normalized
+{
+    Quaterniond quat(q[0], q[1], q[2], q[3]);
+    quat.normalize();
+    q_w[h] = quat.w(); q_x[h] = quat.x(); q_y[h] = quat.y(); q_z[h] = quat.z();
+}
+
+void ridged_body_batch::get_pos(int h, double pos[3]) const
+{
+    pos[0] = pos_x[h]; pos[1] = pos_y[h]; pos[2] = pos_z[h];
+}
+
+void ridged_body_batch::get_v(int h, double vel[3]) const
+{
+    vel[0] = vel_x[h]; vel[1] = vel_y[h]; vel[2] = vel_z[h];
+}
+
+void ridged_body_batch::get_w(int h, double w[3]) const
+{
+    w[0] = w_x[h]; w[1] = w_y[h]; w[2] = w_z[h];
+}
+
+void ridged_body_batch::get_Qori(int h, double q[4]) const
+{
+    q[0] = q_w[h]; q[1] = q_x[h]; q[2] = q_y[h]; q[3] = q_z[h];
+}
+
+void ridged_body_batch::propagate(double dt)
+    //Description:    Advances every vehicle by dt, one SIMD block of vehicles at a time
+    //Preconditions:  Forces and torques set for the step
+    //Postconditions: Position, velocity, angular velocity and orientation at t + dt for every vehicle
+{
+    const vdouble h = splat(dt);
+    const vdouble h_half = splat(0.5 * dt);
+    const vdouble h_sixth = splat(dt / 6.0);
+    const vdouble two = splat(2.0);
+
+    size_t n = pos_x.size();
+    for (size_t i = 0; i < n; i += LANES) {
+        // Translation
+        vdouble im = load(inv_mass, i);
+        vec3v a = {load(force_x, i) * im, load(force_y, i) * im, load(force_z, i) * im};
+        vec3v v = {load(vel_x, i), load(vel_y, i), load(vel_z, i)};
+        vec3v X = {load(pos_x, i), load(pos_y, i), load(pos_z, i)};
+        X = X + h * v + (h_half * h) * a;
+        v = v + h * a;
+        store(pos_x, i, X.x); store(pos_y, i, X.y); store(pos_z, i, X.z);
+        store(vel_x, i, v.x); store(vel_y, i, v.y); store(vel_z, i, v.z);
+
+        // Rotation
+        sym3v I = {load(I_xx, i), load(I_yy, i), load(I_zz, i), load(I_xy, i), load(I_xz, i), load(I_yz, i)};
+        sym3v inv_I = {load(inv_I_xx, i), load(inv_I_yy, i), load(inv_I_zz, i),
+                       load(inv_I_xy, i), load(inv_I_xz, i), load(inv_I_yz, i)};
+        vec3v T = {load(torque_x, i), load(torque_y, i), load(torque_z, i)};
+        vec3v w0 = {load(w_x, i), load(w_y, i), load(w_z, i)};
+
+        vec3v k1_t = w0;
+        vec3v k1_w = angular_accel(I, inv_I, T, w0);
+
+        vec3v w_s = w0 + h_half * k1_w;
+        vec3v k2_t = dexp_inv(h_half * k1_t, w_s);
+        vec3v k2_w = angular_accel(I, inv_I, T, w_s);
+
+        w_s = w0 + h_half * k2_w;
+        vec3v k3_t = dexp_inv(h_half * k2_t, w_s);
+        vec3v k3_w = angular_accel(I, inv_I, T, w_s);
+
+        w_s = w0 + h * k3_w;
+        vec3v k4_t = dexp_inv(h * k3_t, w_s);
+        vec3v k4_w = angular_accel(I, inv_I, T, w_s);
+
+        vec3v theta = h_sixth * (k1_t + two * k2_t + two * k3_t + k4_t);
+        vec3v w = w0 + h_sixth * (k1_w + two * k2_w + two * k3_w + k4_w);
+        store(w_x, i, w.x); store(w_y, i, w.y); store(w_z, i, w.z);
+
+        // q = q * (c, s * theta)
+        vdouble c, s;
+        rotation_exp(theta, c, s);
+        vdouble ex = s * theta.x, ey = s * theta.y, ez = s * theta.z;
+        vdouble qw = load(q_w, i), qx = load(q_x, i), qy = load(q_y, i), qz = load(q_z, i);
+        store(q_w, i, qw * c - qx * ex - qy * ey - qz * ez);
+        store(q_x, i, qw * ex + qx * c + qy * ez - qz * ey);
+        store(q_y, i, qw * ey - qx * ez + qy * c + qz * ex);
+        store(q_z, i, qw * ez + qx * ey - qy * ex + qz * c);
+    }
+}
+
+int ridged_body_batch::size() const
+{
+    return count;
+}
@@ -12,7 +12,7 @@ PURPOSE: (This testing script checks if an
           This is an unofficial test script since
           the one I tried to get running was running
           into issues.
-g++ src/Ridged_Body.cpp src/Satellite_Box.cpp test/Ridged_test_2.cpp -o ridged_test_2         )
+g++ src/Ridged_Body.cpp src/Satellite_Box.cpp ../Recources/src/Linear_Algebra.cpp ../Recources/src/ode_integrator.cpp test/Ridged_test_2.cpp -o ridged_test_2         )
 COMMANDS:
     USE this G++ command until the make file is created
     : 
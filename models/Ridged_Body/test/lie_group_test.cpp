@@ -0,0 +1,110 @@
+#include <iostream>
+#include <cmath>
+
+#include "../include/Ridged_Body.hh"
+
+using namespace std;
+
+/*
+PURPOSE: (Compares the attitude after 20 s of a tumbling, torqued body
+          for the Lie group step, the component-wise quaternion update
+          the sims used (Euler, renormalized every step) and a tight
+          Dormand-Prince reference. The Lie group step must stay unit
+          length without renormalizing and be more accurate at 10x the
+          step of the component-wise update.)
+COMMANDS:
+    : g++ src/Ridged_Body.cpp src/Satellite_Box.cpp ../Recources/src/Linear_Algebra.cpp ../Recources/src/ode_integrator.cpp test/lie_group_test.cpp -o lie_group_program
+*/
+
+const double DURATION = 20.0;
+
+void start(ridged_body& body) {
+    body.initialize_body(1.0, 0.5);
+    body.update_w(0.8, -0.5, 1.2);
+    body.update_torque(0.004, 0.002, -0.006);
+}
+
+// Angle of the rotation between two unit quaternions (from the chord, acos loses the small angles)
+double angle_between(const double a[4], const double b[4]) {
+    double minus = 0.0, plus = 0.0;
+    for (int i = 0; i < 4; i++) {
+        minus += (a[i] - b[i]) * (a[i] - b[i]);
+        plus += (a[i] + b[i]) * (a[i] + b[i]);
+    }
+    return 4.0 * asin(0.5 * sqrt(min(minus, plus)));
+}
+
+double norm_error(const double q[4]) {
+    return fabs(sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]) - 1.0);
+}
+
+void run_componentwise(ridged_body& body, double dt, double q[4]) {
+    double w[3], dw[3], dq[4];
+    for (int s = 0; s < static_cast<int>(round(DURATION / dt)); s++) {
+        body.get_w(w);
+        body.get_Qori(q);
+        body.state_deriv_get_alpha(dw);
+        body.state_deriv_getQori(dq);
+        for (int i = 0; i < 3; i++) w[i] += dt * dw[i];
+        for (int i = 0; i < 4; i++) q[i] += dt * dq[i];
+        body.update_w(w[0], w[1], w[2]);
+        body.update_Qori(q);
+    }
+    body.get_Qori(q);
+}
+
+double run_lie(ridged_body& body, double dt, double q[4]) {
+    double drift = 0.0;
+    for (int s = 0; s < static_cast<int>(round(DURATION / dt)); s++) {
+        body.propagate_lie(dt);
+        body.get_Qori(q);
+        drift = max(drift, norm_error(q));
+    }
+    return drift;
+}
+
+int main(){
+    bool ok = true;
+
+    ridged_body ref_body;
+    start(ref_body);
+    ode_integrator integ(ODE_DOPRI5);
+    integ.set_tolerance(1e-13, 1e-15);
+    ref_body.propagate(integ, 0.0, DURATION);
+    double q_ref[4];
+    ref_body.get_Qori(q_ref);
+
+    double q[4];
+    ridged_body euler_body;
+    start(euler_body);
+    run_componentwise(euler_body, 0.01, q);
+    double err_euler = angle_between(q, q_ref);
+    cout << "component-wise, dt = 0.01: attitude error " << err_euler << " rad\n";
+
+    double err_lie_1x = 0.0;
+    for (double dt : {0.01, 0.1, 0.5}) {
+        ridged_body lie_body;
+        start(lie_body);
+        double drift = run_lie(lie_body, dt, q);
+        double err = angle_between(q, q_ref);
+        if (dt == 0.01) err_lie_1x = err;
+        cout << "Lie group,      dt = " << dt << ": attitude error " << err << " rad, largest |q| - 1 " << drift << "\n";
+        ok &= drift < 1e-13;
+        if (dt == 0.1) ok &= err < err_euler;
+    }
+    ok &= err_lie_1x < 1e-8;
+
+    // Torque free with equal moments of inertia: the rotation axis is fixed and one step of any size is exact
+    ridged_body spin;
+    spin.initialize_body(1.0, 0.5);
+    spin.update_w(0.0, 0.0, 2.0);
+    spin.propagate_lie(3.0);
+    spin.get_Qori(q);
+    double q_exact[4] = {cos(3.0), 0.0, 0.0, sin(3.0)};
+    double err_spin = angle_between(q, q_exact);
+    cout << "free spin, one 3 s step: attitude error " << err_spin << " rad\n";
+    ok &= err_spin < 1e-12;
+
+    cout << (ok ? "ALL PASSED" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,142 @@
+#include <iostream>
+#include <cmath>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "../include/Ridged_Body.hh"
+#include "../include/ridged_body_batch.hh"
+
+using namespace std;
+
+/*
+PURPOSE: (Checks the batched engine against one ridged_body per vehicle
+          for cube shaped vehicles, checks that angular momentum and
+          rotational energy are kept for a torque free vehicle with a
+          full inertia tensor, and times one step of a thousand vehicles
+          both ways.)
+COMMANDS:
+    : g++ -O2 src/Ridged_Body.cpp src/Satellite_Box.cpp src/ridged_body_batch.cpp ../Recources/src/Linear_Algebra.cpp ../Recources/src/ode_integrator.cpp test/ridged_body_batch_test.cpp -o ridged_body_batch_program
+*/
+
+const int N = 1000;
+
+double max_diff(const double* a, const double* b, int n) {
+    double d = 0.0;
+    for (int i = 0; i < n; i++) d = max(d, fabs(a[i] - b[i]));
+    return d;
+}
+
+// Angular momentum in the global frame and rotational energy of vehicle h
+void momentum_energy(const ridged_body_batch& batch, int h, const double I[3][3], double L[3], double& E) {
+    double q[4], w[3];
+    batch.get_Qori(h, q);
+    batch.get_w(h, w);
+    Quaterniond quat(q[0], q[1], q[2], q[3]);
+    Matrix3d I_m;
+    I_m.insert(I[0][0], I[0][1], I[0][2], I[1][0], I[1][1], I[1][2], I[2][0], I[2][1], I[2][2]);
+    Vector3d w_v(w[0], w[1], w[2]);
+    Vector3d Iw = I_m * w_v;
+    Vector3d L_v = quat.toRotationMatrix() * Iw;
+    L[0] = L_v.x; L[1] = L_v.y; L[2] = L_v.z;
+    E = 0.5 * w_v.dot(Iw);
+}
+
+int main(){
+    bool ok = true;
+    mt19937 gen(5);
+    uniform_real_distribution<double> u(-1.0, 1.0);
+
+    // Cube vehicles: the batch must follow ridged_body::propagate_lie
+    vector<ridged_body> bodies(N);
+    ridged_body_batch batch;
+    for (int i = 0; i < N; i++) {
+        double mass = 2.0 + u(gen), side = 0.6 + 0.2 * u(gen);
+        double pos[3] = {100 * u(gen), 100 * u(gen), 100 * u(gen)};
+        double vel[3] = {u(gen), u(gen), u(gen)};
+        double zero[3] = {0, 0, 0};
+        double w[3] = {u(gen), u(gen), u(gen)};
+        double F[3] = {0.1 * u(gen), 0.1 * u(gen), 0.1 * u(gen)};
+        double T[3] = {0.01 * u(gen), 0.01 * u(gen), 0.01 * u(gen)};
+
+        bodies[i].initialize_body(mass, side);
+        bodies[i].initialize_motion(pos, vel, zero);
+        bodies[i].update_w(w[0], w[1], w[2]);
+        bodies[i].update_force(F[0], F[1], F[2]);
+        bodies[i].update_torque(T[0], T[1], T[2]);
+
+        satellite_box box(mass, side);
+        box.initialize_points(0, 0, 0);
+        box.calc_I_0();
+        double I[3][3];
+        box.get_I_0(I);
+        int h = batch.add_body(mass, I, pos, vel);
+        batch.set_w(h, w);
+        batch.set_force(h, F);
+        batch.set_torque(h, T);
+    }
+
+    for (int s = 0; s < 100; s++) {
+        batch.propagate(0.1);
+        for (int i = 0; i < N; i++) bodies[i].propagate_lie(0.1);
+    }
+
+    double d_pos = 0, d_v = 0, d_w = 0, d_q = 0;
+    for (int i = 0; i < N; i++) {
+        double a[4], b[4];
+        batch.get_pos(i, a); bodies[i].get_pos(b); d_pos = max(d_pos, max_diff(a, b, 3));
+        batch.get_v(i, a); bodies[i].get_v(b); d_v = max(d_v, max_diff(a, b, 3));
+        batch.get_w(i, a); bodies[i].get_w(b); d_w = max(d_w, max_diff(a, b, 3));
+        batch.get_Qori(i, a); bodies[i].get_Qori(b); d_q = max(d_q, max_diff(a, b, 4));
+    }
+    bool same = d_pos < 1e-10 && d_v < 1e-12 && d_w < 1e-12 && d_q < 1e-12;
+    ok &= same;
+    cout << "=== " << N << " cube vehicles, 100 steps of 0.1 s against ridged_body ===\n"
+         << "  largest difference: position " << d_pos << ", velocity " << d_v
+         << ", angular velocity " << d_w << ", quaternion " << d_q << (same ? "" : "  FAIL") << "\n";
+
+    // Torque free, full inertia tensor: |L| in the global frame and the energy are constants of motion
+    {
+        ridged_body_batch one;
+        double I[3][3] = {{1.0, 0.1, -0.05}, {0.1, 2.0, 0.2}, {-0.05, 0.2, 3.0}};
+        double zero[3] = {0, 0, 0};
+        double w0[3] = {0.3, 1.5, -0.4};
+        int h = one.add_body(1.0, I, zero, zero);
+        one.set_w(h, w0);
+
+        double L0[3], L[3], E0, E;
+        momentum_energy(one, h, I, L0, E0);
+        double drift_L = 0.0, drift_E = 0.0;
+        for (int s = 0; s < 10000; s++) {
+            one.propagate(0.01);
+            momentum_energy(one, h, I, L, E);
+            drift_L = max(drift_L, max_diff(L, L0, 3));
+            drift_E = max(drift_E, fabs(E - E0) / E0);
+        }
+        bool kept = drift_L < 1e-8 && drift_E < 1e-8;
+        ok &= kept;
+        cout << "=== torque free asymmetric vehicle, 100 s ===\n"
+             << "  largest change: angular momentum " << drift_L << ", energy (relative) " << drift_E
+             << (kept ? "" : "  FAIL") << "\n";
+    }
+
+    // Timing
+    const int steps = 200;
+    auto start = chrono::steady_clock::now();
+    for (int s = 0; s < steps; s++) {
+        for (int i = 0; i < N; i++) bodies[i].propagate_lie(1e-3);
+    }
+    double t_each = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    start = chrono::steady_clock::now();
+    for (int s = 0; s < steps; s++) batch.propagate(1e-3);
+    double t_batch = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << "=== ns per vehicle step, " << N << " vehicles ===\n"
+         << "  one ridged_body each: " << 1e9 * t_each / (steps * N) << "\n"
+         << "  ridged_body_batch:    " << 1e9 * t_batch / (steps * N) << "\n"
+         << "  speedup:              " << t_each / t_batch << "\n";
+
+    cout << (ok ? "ALL PASSED" : "FAILED") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+/*
+PURPOSE: (Times the per-step call pattern of the simulations on a
+          ridged_body: many small setters, getters and state derivatives,
+          each a call from this translation unit into Ridged_Body.cpp and
+          on into the Linear_Algebra library. Build it once normally and
+          once with LTO=1 to see what inlining across translation units
+          buys; the final state printed must be the same for both.
+          The second loop is a controller frame: one attitude update
+          followed by the rotation matrix, frame axis and frame
+          conversion reads the ACS and body modules make.)
+COMMANDS:
+    : make benchmark            (release build)
+    : make benchmark LTO=1      (link-time optimized build)
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+
+#include "../include/Ridged_Body.hh"
+
+using namespace std;
+
+int main(){
+    const int steps = 2000000;
+    const double dt = 0.001;
+
+    ridged_body body;
+    body.initialize_body(12.0, 0.3);
+    body.update_L(0.9, 0.1, -0.6);
+
+    double w[3], alpha[3], dL[3], L[3], R[3][3];
+    double checksum = 0.0;
+
+    auto start = chrono::steady_clock::now();
+    for(int n = 0; n < steps; n++){
+        double t = n * dt;
+        body.update_torque(1e-3 * sin(t), 1e-3 * cos(t), 0.0);
+        body.state_deriv_get_dL(dL);
+        body.get_L(L);
+        body.update_L(L[0] + dL[0] * dt, L[1] + dL[1] * dt, L[2] + dL[2] * dt);
+        body.state_deriv_get_alpha(alpha);
+        body.get_w(w);
+        body.update_QoriByAngle(body.get_w_mag() * dt);
+        body.get_R(R);
+        checksum += R[0][0] + alpha[0];
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    body.get_w(w);
+    cout << "=== ridged_body step (" << steps << " steps) ===\n"
+         << "  " << 1e9 * seconds / steps << " ns/step\n"
+         << setprecision(12)
+         << "  final w: " << w[0] << " " << w[1] << " " << w[2] << "\n"
+         << "  checksum: " << checksum << "\n";
+
+    double q[4], axis[3], target[3];
+    double frame_checksum = 0.0;
+    start = chrono::steady_clock::now();
+    for(int n = 0; n < steps; n++){
+        double t = n * dt;
+        body.get_Qori(q);
+        q[1] += 1e-4 * sin(t);
+        body.update_Qori(q);
+        body.get_R(R);
+        body.get_ref_i_vec(axis);
+        frame_checksum += axis[0];
+        body.get_ref_j_vec(axis);
+        frame_checksum += axis[1];
+        body.get_ref_k_vec(axis);
+        frame_checksum += axis[2];
+        for(int k = 0; k < 2; k++){
+            target[0] = 1.0; target[1] = t; target[2] = -1.0;
+            body.convert_to_ref_frame(target);
+            frame_checksum += target[k];
+        }
+        body.get_L(L);
+        body.update_L(L[0], L[1], L[2]);
+        body.update_L(L[0] + 1e-6, L[1], L[2]);
+        body.get_w(w);
+        frame_checksum += R[1][2] + w[0];
+    }
+    seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cout << "=== controller frame reads (" << steps << " frames) ===\n"
+         << setprecision(6) << "  " << 1e9 * seconds / steps << " ns/frame\n"
+         << setprecision(12)
+         << "  checksum: " << frame_checksum << "\n";
+    return 0;
+}
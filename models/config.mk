@@ -0,0 +1,74 @@
+# Shared build configuration for the model makefiles.
+#
+# Each model directory builds its src/ files once into a static library in
+# build/<config>/ and links its test programs against that library and the
+# Recources library (Linear_Algebra and the force helpers). Headers are
+# tracked, so editing a header rebuilds only what includes it.
+#
+#   make                          optimized build (-O2), portable
+#   make ARCH_FLAGS=-march=native let the compiler use AVX/FMA on this machine
+#   make LTO=1                    link-time optimization: inlining across
+#                                 translation units and libraries
+#   make OPT="-O0 -g"             debug build
+#
+# Every configuration has its own build directory, so switching between them
+# does not mix objects.
+
+.DEFAULT_GOAL := all
+
+CXX = g++
+OPT ?= -O2
+ARCH_FLAGS ?=
+CXXFLAGS = -std=c++17 $(OPT) $(ARCH_FLAGS)
+LDFLAGS =
+AR = ar
+CONFIG = release
+
+ifeq ($(LTO),1)
+    CXXFLAGS += -flto=auto
+    LDFLAGS += -flto=auto
+    # The archive index of LTO objects needs the linker plugin
+    AR = gcc-ar
+    CONFIG = lto
+endif
+
+ifneq ($(ARCH_FLAGS),)
+    CONFIG := $(CONFIG)_arch
+endif
+ifneq ($(OPT),-O2)
+    CONFIG := $(CONFIG)_custom
+endif
+
+# Objects and libraries for this configuration
+BUILD_DIR = build/$(CONFIG)
+
+# Library of the Recources model, used by every other model
+RESOURCES_DIR = ../Recources
+RESOURCES_LIB = $(RESOURCES_DIR)/$(BUILD_DIR)/libresources.a
+
+# Object files of a library from its sources: src/name.cpp -> build/<config>/name.o
+lib_objects = $(patsubst $(SRC_DIR)/%.cpp,$(BUILD_DIR)/%.o,$(1))
+
+$(BUILD_DIR)/%.o: src/%.cpp
+	@mkdir -p $(BUILD_DIR)
+	$(CXX) $(CXXFLAGS) -MMD -MP -c $< -o $@
+
+$(BUILD_DIR)/%.a:
+	@mkdir -p $(BUILD_DIR)
+	rm -f $@
+	$(AR) rcs $@ $^
+
+# The Recources library is built by its own makefile; the sub-make only
+# touches the archive when one of its objects changed
+ifneq ($(notdir $(CURDIR)),Recources)
+$(RESOURCES_LIB): FORCE
+	@$(MAKE) --no-print-directory -C $(RESOURCES_DIR) lib
+endif
+
+# Each makefile adds its library as a prerequisite of lib
+lib:
+	@:
+
+FORCE:
+
+.PHONY: FORCE lib